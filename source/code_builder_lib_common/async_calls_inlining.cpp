@@ -7,6 +7,7 @@
 #include <llvm/IR/DebugInfoMetadata.h>
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/Intrinsics.h>
+#include <llvm/Support/TimeProfiler.h>
 #include <llvm/Transforms/Utils/Cloning.h>
 #include "pop_llvm_warnings.hpp"
 
@@ -901,6 +902,8 @@ void RemoveNotUsedAnyMoreFunctions( const llvm::ArrayRef<InliningOrderElement> e
 
 void InlineAsyncCalls( llvm::Module& module )
 {
+	const llvm::TimeTraceScope time_trace_scope( "InlineAsyncCalls" );
+
 	AsyncCallsGraph async_call_graph= BuildAsyncCallsGraph( module );
 
 	llvm::SmallVector< std::pair<llvm::Function*, AsyncFunctionCalls> , 8> inlining_order_head;
@@ -1,10 +1,13 @@
+#include <algorithm>
 #include "push_disable_llvm_warnings.hpp"
+#include <llvm/Demangle/Demangle.h>
 #include <llvm/IR/Constants.h>
 #include <llvm/IR/DebugInfoMetadata.h>
 #include <llvm/IR/GlobalVariable.h>
 #include <llvm/IR/InstrTypes.h>
 #include <llvm/IR/Intrinsics.h>
 #include <llvm/IR/Operator.h>
+#include <llvm/Support/TimeProfiler.h>
 #include "pop_llvm_warnings.hpp"
 
 #include "../lex_synt_lib_common/assert.hpp"
@@ -38,7 +41,10 @@ Interpreter::ResultConstexpr Interpreter::EvaluateConstexpr(
 	const llvm::ArrayRef<const llvm::Constant*> args,
 	llvm::Type& return_type )
 {
+	const llvm::TimeTraceScope time_trace_scope( "ConstexprEvaluation", [&]{ return llvm::demangle( llvm_function->getName().str() ); } );
+
 	instructions_executed_= 0;
+	++evaluation_index_;
 
 	stack_.resize(16u); // reserve null pointer
 
@@ -48,6 +54,7 @@ Interpreter::ResultConstexpr Interpreter::EvaluateConstexpr(
 	size_t s_ret_ptr= 0u;
 
 	// Fill arguments
+	current_function_frame_.slots.resize( llvm_function->arg_size() );
 	size_t i= 0u;
 	for( const llvm::Argument& param : llvm_function->args() )
 	{
@@ -68,25 +75,25 @@ Interpreter::ResultConstexpr Interpreter::EvaluateConstexpr(
 
 				llvm::GenericValue val;
 				val.IntVal= llvm::APInt( pointer_size_in_bits_, uint64_t(s_ret_ptr) );
-				current_function_frame_.instructions_map[ &param ]= std::move(val);
+				current_function_frame_.slots[ param.getArgNo() ]= std::move(val);
 			}
 			else
 			{
 				// Assume this is reference param.
 				llvm::GenericValue val;
 				val.IntVal= llvm::APInt( pointer_size_in_bits_, uint64_t( MoveConstantToStack( *args[i] ) ) );
-				current_function_frame_.instructions_map[ &param ]= std::move(val);
+				current_function_frame_.slots[ param.getArgNo() ]= std::move(val);
 			}
 		}
 		else if( param.getType() == args[i]->getType() )
-			current_function_frame_.instructions_map[ &param ]= GetVal( args[i] );
+			current_function_frame_.slots[ param.getArgNo() ]= GetVal( args[i] );
 		else
 		{
 			// Assume we have a constant of type compatible with parameter type.
 			// Convert it into expected type, using load-store, which is effectively equivalent to bitcast.
 			const size_t offset= MoveConstantToStack( *args[i] );
 			const std::byte* const data_ptr= GetMemoryForVirtualAddress( offset );
-			current_function_frame_.instructions_map[ &param ]= DoLoad( data_ptr, param.getType() );
+			current_function_frame_.slots[ param.getArgNo() ]= DoLoad( data_ptr, param.getType() );
 		}
 
 		++i;
@@ -131,7 +138,7 @@ Interpreter::ResultConstexpr Interpreter::EvaluateConstexpr(
 		ReportError( "returning pointer in constexpr function" );
 	else U_ASSERT(false);
 
-	current_function_frame_.instructions_map.clear();
+	current_function_frame_= CallFrame();
 	stack_.clear();
 	globals_stack_.clear();
 	heap_.clear();
@@ -146,17 +153,19 @@ Interpreter::ResultGeneric Interpreter::EvaluateGeneric(
 	const llvm::ArrayRef<llvm::GenericValue> args )
 {
 	instructions_executed_= 0;
+	++evaluation_index_;
 
 	stack_.resize(16u); // reserve null pointer
 
 	U_ASSERT( args.size() == llvm_function->getFunctionType()->getNumParams() );
 
 	// Fill arguments
+	current_function_frame_.slots.resize( llvm_function->arg_size() );
 	size_t i= 0u;
 	for( const llvm::Argument& param : llvm_function->args() )
 	{
 		U_ASSERT( ! param.getType()->isPointerTy() );
-		current_function_frame_.instructions_map[ &param ]= args[i];
+		current_function_frame_.slots[ param.getArgNo() ]= args[i];
 
 		++i;
 	}
@@ -167,7 +176,7 @@ Interpreter::ResultGeneric Interpreter::EvaluateGeneric(
 	res.errors= std::move(errors_);
 	errors_= {};
 
-	current_function_frame_.instructions_map.clear();
+	current_function_frame_= CallFrame();
 	stack_.clear();
 
 	// Preserve globals, heap and external constants here.
@@ -212,126 +221,365 @@ llvm::GenericValue Interpreter::CallFunction( const llvm::Function& llvm_functio
 		return llvm::GenericValue();
 	}
 
-	return CallFunctionImpl( &*bb.begin() );
+	CompiledFunction* const compiled_function= GetCompiledFunction( llvm_function );
+	if( compiled_function == nullptr )
+		return llvm::GenericValue();
+
+	// Arguments are already set.
+	current_function_frame_.function= compiled_function;
+	current_function_frame_.slots.resize( compiled_function->num_slots );
+
+	return CallFunctionImpl( *compiled_function, 0u, 0u );
+}
+
+Interpreter::CompiledFunction* Interpreter::GetCompiledFunction( const llvm::Function& llvm_function )
+{
+	std::unique_ptr<CompiledFunction>& compiled_function= compiled_functions_[ &llvm_function ];
+
+	// Compile function again if previous function was deleted and new one was created at the same address.
+	if( compiled_function == nullptr || static_cast<llvm::Value*>( compiled_function->llvm_function ) != &llvm_function )
+		compiled_function= CompileFunction( llvm_function );
+
+	return compiled_function.get();
+}
+
+std::unique_ptr<Interpreter::CompiledFunction> Interpreter::CompileFunction( const llvm::Function& llvm_function )
+{
+	auto function= std::make_unique<CompiledFunction>();
+	function->llvm_function= const_cast<llvm::Function*>( &llvm_function );
+
+	// Assign slots for arguments and instructions.
+	// Arguments slots are the same as arguments indices.
+	llvm::DenseMap<const llvm::Value*, uint32_t> slots;
+	llvm::DenseMap<const llvm::BasicBlock*, uint32_t> basic_blocks;
+
+	for( const llvm::Argument& arg : llvm_function.args() )
+		slots.insert( std::make_pair( &arg, uint32_t( slots.size() ) ) );
+
+	for( const llvm::BasicBlock& basic_block : llvm_function )
+	{
+		if( basic_block.empty() )
+		{
+			ReportError( "executing function \"" + std::string(llvm_function.getName()) + "\" with empty basic block" );
+			return nullptr;
+		}
+
+		basic_blocks.insert( std::make_pair( &basic_block, uint32_t( basic_blocks.size() ) ) );
+		for( const llvm::Instruction& instruction : basic_block )
+			slots.insert( std::make_pair( &instruction, uint32_t( slots.size() ) ) );
+	}
+
+	function->num_slots= uint32_t( slots.size() );
+
+	llvm::DenseMap<const llvm::Value*, uint32_t> constants_indices;
+
+	const auto get_operand=
+		[&]( const llvm::Value* const value ) -> uint32_t
+		{
+			if( const auto it= slots.find( value ); it != slots.end() )
+				return it->second;
+
+			const auto it_inserted= constants_indices.insert( std::make_pair( value, uint32_t( function->constants.size() ) ) );
+			if( it_inserted.second )
+			{
+				CompiledConstant constant;
+				constant.value= value;
+				if( llvm::isa<llvm::ConstantInt>( value ) ||
+					llvm::isa<llvm::ConstantPointerNull>( value ) ||
+					( llvm::isa<llvm::ConstantFP>( value ) && ( value->getType()->isFloatTy() || value->getType()->isDoubleTy() ) ) )
+				{
+					constant.cached_value= GetVal( value );
+					constant.is_state_independent= true;
+				}
+
+				function->constants.push_back( std::move(constant) );
+			}
+
+			return function->num_slots + it_inserted.first->second;
+		};
+
+	const auto add_all_operands=
+		[&]( const llvm::Instruction& instruction )
+		{
+			for( const llvm::Value* const operand : instruction.operands() )
+				function->operands.push_back( get_operand( operand ) );
+		};
+
+	function->instructions.reserve( slots.size() - llvm_function.arg_size() );
+	function->basic_blocks_start.reserve( basic_blocks.size() );
+
+	for( const llvm::BasicBlock& basic_block : llvm_function )
+	{
+		function->basic_blocks_start.push_back( uint32_t( function->instructions.size() ) );
+
+		for( const llvm::Instruction& instruction : basic_block )
+		{
+			CompiledInstruction compiled_instruction;
+			compiled_instruction.llvm_instruction= &instruction;
+			compiled_instruction.result_slot= slots[ &instruction ];
+			compiled_instruction.operands_begin= uint32_t( function->operands.size() );
+			compiled_instruction.targets_begin= uint32_t( function->branch_targets.size() );
+
+			switch( instruction.getOpcode() )
+			{
+			case llvm::Instruction::Alloca:
+				compiled_instruction.kind= OpKind::Alloca;
+				compiled_instruction.immediate= uint64_t( data_layout_.getTypeAllocSize( llvm::cast<llvm::AllocaInst>( instruction ).getAllocatedType() ) );
+				break;
+
+			case llvm::Instruction::Load:
+				compiled_instruction.kind= OpKind::Load;
+				add_all_operands( instruction );
+				break;
+
+			case llvm::Instruction::Store:
+				compiled_instruction.kind= OpKind::Store;
+				add_all_operands( instruction );
+				break;
+
+			case llvm::Instruction::GetElementPtr:
+				{
+					add_all_operands( instruction );
+
+					// Calculate offset now if all indices are constant.
+					llvm::SmallVector<uint64_t, 8> indices;
+					for( auto it= std::next( instruction.op_begin() ); it != instruction.op_end(); ++it )
+					{
+						if( const auto constant_int= llvm::dyn_cast<llvm::ConstantInt>( it->get() ) )
+							indices.push_back( constant_int->getValue().getLimitedValue() );
+						else
+							break;
+					}
+
+					if( indices.size() + 1u == instruction.getNumOperands() )
+					{
+						compiled_instruction.kind= OpKind::GEPConstantOffset;
+						compiled_instruction.immediate= CalculateGEPOffset( &instruction, indices );
+					}
+					else
+						compiled_instruction.kind= OpKind::GEP;
+				}
+				break;
+
+			case llvm::Instruction::Call:
+				compiled_instruction.kind= OpKind::Call;
+				add_all_operands( instruction );
+				break;
+
+			case llvm::Instruction::Br:
+				{
+					const auto& branch_instruction= llvm::cast<llvm::BranchInst>( instruction );
+					if( branch_instruction.isUnconditional() )
+					{
+						compiled_instruction.kind= OpKind::Br;
+						function->branch_targets.push_back( basic_blocks[ branch_instruction.getSuccessor(0u) ] );
+					}
+					else
+					{
+						compiled_instruction.kind= OpKind::CondBr;
+						function->operands.push_back( get_operand( branch_instruction.getCondition() ) );
+						function->branch_targets.push_back( basic_blocks[ branch_instruction.getSuccessor(0u) ] );
+						function->branch_targets.push_back( basic_blocks[ branch_instruction.getSuccessor(1u) ] );
+					}
+				}
+				break;
+
+			case llvm::Instruction::Switch:
+				{
+					const auto& switch_instruction= llvm::cast<llvm::SwitchInst>( instruction );
+					compiled_instruction.kind= OpKind::Switch;
+					function->operands.push_back( get_operand( switch_instruction.getCondition() ) );
+					function->branch_targets.push_back( basic_blocks[ switch_instruction.getDefaultDest() ] );
+					for( const auto& case_handle : switch_instruction.cases() )
+					{
+						function->operands.push_back( get_operand( case_handle.getCaseValue() ) );
+						function->branch_targets.push_back( basic_blocks[ case_handle.getCaseSuccessor() ] );
+					}
+				}
+				break;
+
+			case llvm::Instruction::PHI:
+				{
+					const auto& phi_node= llvm::cast<llvm::PHINode>( instruction );
+					compiled_instruction.kind= OpKind::PHI;
+					for( uint32_t i= 0u; i < phi_node.getNumIncomingValues(); ++i )
+					{
+						function->operands.push_back( basic_blocks[ phi_node.getIncomingBlock(i) ] );
+						function->operands.push_back( get_operand( phi_node.getIncomingValue(i) ) );
+					}
+				}
+				break;
+
+			case llvm::Instruction::Ret:
+				compiled_instruction.kind= OpKind::Ret;
+				add_all_operands( instruction );
+				break;
+
+			case llvm::Instruction::Select:
+				compiled_instruction.kind= OpKind::Select;
+				add_all_operands( instruction );
+				break;
+
+			case llvm::Instruction::AtomicCmpXchg:
+				compiled_instruction.kind= OpKind::AtomicCmpXchg;
+				add_all_operands( instruction );
+				break;
+
+			case llvm::Instruction::Fence:
+				compiled_instruction.kind= OpKind::Fence;
+				break;
+
+			case llvm::Instruction::Unreachable:
+				compiled_instruction.kind= OpKind::Unreachable;
+				break;
+
+			default:
+				// Report unknown instructions only if they are actually executed.
+				if( instruction.getNumOperands() == 1u )
+					compiled_instruction.kind= OpKind::UnaryArithmetic;
+				else if( instruction.getNumOperands() == 2u )
+					compiled_instruction.kind= OpKind::BinaryArithmetic;
+				else
+					compiled_instruction.kind= OpKind::Unknown;
+
+				if( compiled_instruction.kind != OpKind::Unknown )
+					add_all_operands( instruction );
+				break;
+			};
+
+			compiled_instruction.operands_end= uint32_t( function->operands.size() );
+			function->instructions.push_back( compiled_instruction );
+		}
+	}
+
+	return function;
 }
 
-llvm::GenericValue Interpreter::CallFunctionImpl( const llvm::Instruction* instruction )
+llvm::GenericValue Interpreter::CallFunctionImpl( CompiledFunction& function, uint32_t instruction_index, const uint32_t basic_block_index )
 {
 	const size_t prev_stack_size= stack_.size();
 
-	const llvm::BasicBlock* prev_basic_block= nullptr;
-	const llvm::BasicBlock* current_basic_block= instruction->getParent();
+	uint32_t prev_basic_block_index= ~0u;
+	uint32_t current_basic_block_index= basic_block_index;
 
 	while( errors_.empty() )
 	{
-		if( instruction == nullptr )
+		if( instruction_index >= function.instructions.size() )
 		{
 			ReportError( "Reached null instruction!" );
 			break;
 		}
 
+		const CompiledInstruction& instruction= function.instructions[ instruction_index ];
+
 		++instructions_executed_;
 		if( instructions_executed_ >= options_.max_instructions_executed )
 		{
-			ReportError( "Interpreter instructions limit (" + std::to_string( instructions_executed_ ) + ") reached", *instruction );
+			ReportError( "Interpreter instructions limit (" + std::to_string( instructions_executed_ ) + ") reached", *instruction.llvm_instruction );
 			break;
 		}
 
-		switch( instruction->getOpcode() )
+		// Dense kinds enum allows compiler to generate a jump table here.
+		switch( instruction.kind )
 		{
-		case llvm::Instruction::Alloca:
+		case OpKind::Unknown:
+			ReportError( std::string( "executing unknown instruction \"" ) + instruction.llvm_instruction->getOpcodeName() + "\"", *instruction.llvm_instruction );
+			return llvm::GenericValue();
+
+		case OpKind::Alloca:
 			ProcessAlloca(instruction);
 			break;
 
-		case llvm::Instruction::Load:
+		case OpKind::Load:
 			ProcessLoad(instruction);
 			break;
 
-		case llvm::Instruction::Store:
+		case OpKind::Store:
 			ProcessStore(instruction);
 			break;
 
-		case llvm::Instruction::GetElementPtr:
+		case OpKind::GEP:
 			ProcessGEP(instruction);
 			break;
 
-		case llvm::Instruction::Call:
-			{
-				const auto call_instruction= llvm::dyn_cast<llvm::CallInst>(instruction);
-				call_stack_.push_back( call_instruction );
-				ProcessCall( call_instruction );
-				call_stack_.pop_back();
-			}
+		case OpKind::GEPConstantOffset:
+			ProcessGEPConstantOffset(instruction);
 			break;
 
-		case llvm::Instruction::Br:
-			prev_basic_block= current_basic_block;
-			if( instruction->getNumOperands() == 1u ) // Unconditional
-				current_basic_block= llvm::dyn_cast<llvm::BasicBlock>(instruction->getOperand(0u));
-			else
+		case OpKind::Call:
+			call_stack_.push_back( llvm::cast<llvm::CallInst>( instruction.llvm_instruction ) );
+			ProcessCall( instruction );
+			call_stack_.pop_back();
+			break;
+
+		case OpKind::Br:
+			prev_basic_block_index= current_basic_block_index;
+			current_basic_block_index= function.branch_targets[ instruction.targets_begin ];
+			instruction_index= function.basic_blocks_start[ current_basic_block_index ];
+			continue; // Continue loop without advancing instruction.
+
+		case OpKind::CondBr:
 			{
-				const llvm::GenericValue val= GetVal(instruction->getOperand(0u));
-				current_basic_block= llvm::dyn_cast<llvm::BasicBlock>(instruction->getOperand( val.IntVal.getBoolValue() ? 2u : 1u ));
+				prev_basic_block_index= current_basic_block_index;
+				const llvm::GenericValue& val= GetOperand( instruction, 0u );
+				current_basic_block_index= function.branch_targets[ instruction.targets_begin + ( val.IntVal.getBoolValue() ? 0u : 1u ) ];
+				instruction_index= function.basic_blocks_start[ current_basic_block_index ];
 			}
-			instruction= current_basic_block->empty() ? nullptr : &current_basic_block->front();
 			continue; // Continue loop without advancing instruction.
 
-		case llvm::Instruction::Switch:
+		case OpKind::Switch:
 			{
-				prev_basic_block= current_basic_block;
-				const uint64_t index= GetVal(instruction->getOperand(0u)).IntVal.getLimitedValue();
-				current_basic_block= llvm::dyn_cast<llvm::BasicBlock>(instruction->getOperand(1u));
-				for( uint32_t i = 2; i < instruction->getNumOperands(); i+= 2 )
+				prev_basic_block_index= current_basic_block_index;
+				const uint64_t index= GetOperand( instruction, 0u ).IntVal.getLimitedValue();
+				current_basic_block_index= function.branch_targets[ instruction.targets_begin ];
+				const uint32_t num_cases= instruction.operands_end - instruction.operands_begin - 1u;
+				for( uint32_t i= 0u; i < num_cases; ++i )
 				{
-					if( GetVal( instruction->getOperand(i) ).IntVal.getLimitedValue() == index )
+					if( GetOperand( instruction, 1u + i ).IntVal.getLimitedValue() == index )
 					{
-						current_basic_block= llvm::dyn_cast<llvm::BasicBlock>( instruction->getOperand( i + 1 ) );
+						current_basic_block_index= function.branch_targets[ instruction.targets_begin + 1u + i ];
 						break;
 					}
 				}
-				instruction= current_basic_block->empty() ? nullptr : &current_basic_block->front();
+				instruction_index= function.basic_blocks_start[ current_basic_block_index ];
 			}
 			continue; // Continue loop without advancing instruction.
 
-		case llvm::Instruction::PHI:
+		case OpKind::PHI:
+			for( uint32_t i= 0u; instruction.operands_begin + i < instruction.operands_end; i+= 2u )
 			{
-				const auto phi_node= llvm::dyn_cast<llvm::PHINode>(instruction);
-
-				for (uint32_t i= 0u; i < phi_node->getNumIncomingValues(); ++i )
+				if( function.operands[ instruction.operands_begin + i ] == prev_basic_block_index )
 				{
-					if( phi_node->getIncomingBlock(i) == prev_basic_block)
-					{
-						current_function_frame_.instructions_map[instruction]= GetVal( phi_node->getIncomingValue(i) );
-						break;
-					}
-					U_ASSERT( i + 1u != phi_node->getNumIncomingValues() );
+					SetResult( instruction, GetOperand( instruction, i + 1u ) );
+					break;
 				}
+				U_ASSERT( instruction.operands_begin + i + 2u != instruction.operands_end );
 			}
 			break;
 
-		case llvm::Instruction::Ret:
+		case OpKind::Ret:
 			{
 				llvm::GenericValue res;
-				if( instruction->getNumOperands() != 0u )
-					res= GetVal( instruction->getOperand(0u) );
+				if( instruction.operands_end != instruction.operands_begin )
+					res= GetOperand( instruction, 0u );
 
 				stack_.resize( prev_stack_size );
 				return res;
 			}
 
-		case llvm::Instruction::Select:
+		case OpKind::Select:
 			{
-				const llvm::GenericValue bool_val= GetVal(instruction->getOperand(0u));
-				current_function_frame_.instructions_map[instruction]= GetVal( instruction->getOperand( bool_val.IntVal.getBoolValue() ? 1u : 2u ) );
+				const llvm::GenericValue& bool_val= GetOperand( instruction, 0u );
+				SetResult( instruction, GetOperand( instruction, bool_val.IntVal.getBoolValue() ? 1u : 2u ) );
 			}
 			break;
 
-		case llvm::Instruction::AtomicCmpXchg:
+		case OpKind::AtomicCmpXchg:
 			{
-				const llvm::GenericValue op0= GetVal(instruction->getOperand(0u));
-				const llvm::GenericValue op1= GetVal(instruction->getOperand(1u));
-				const llvm::GenericValue op2= GetVal(instruction->getOperand(2u));
-				llvm::Type* const read_type= instruction->getOperand(1u)->getType();
+				const llvm::GenericValue& op0= GetOperand( instruction, 0u );
+				const llvm::GenericValue& op1= GetOperand( instruction, 1u );
+				const llvm::GenericValue& op2= GetOperand( instruction, 2u );
+				llvm::Type* const read_type= instruction.llvm_instruction->getOperand(1u)->getType();
 
 				std::byte* const data_ptr= GetMemoryForVirtualAddress( size_t(op0.IntVal.getLimitedValue()) );
 				const llvm::GenericValue load_result= DoLoad( data_ptr, read_type );
@@ -348,32 +596,29 @@ llvm::GenericValue Interpreter::CallFunctionImpl( const llvm::Instruction* instr
 
 				llvm::GenericValue val;
 				val.AggregateVal= { load_result, success_val };
-				current_function_frame_.instructions_map[ instruction ]= val;
+				SetResult( instruction, std::move(val) );
 			}
 			break;
 
-		case llvm::Instruction::Fence:
+		case OpKind::Fence:
 			// Interpreter is single-threaded, memory fences aren't necessary.
 			break;
 
-		case llvm::Instruction::Unreachable:
-			ReportError( "executing Unreachable instruction", *instruction );
+		case OpKind::Unreachable:
+			ReportError( "executing Unreachable instruction", *instruction.llvm_instruction );
 			return llvm::GenericValue();
 
-		default:
-			if( instruction->getNumOperands() == 1u )
-				ProcessUnaryArithmeticInstruction(instruction);
-			else if( instruction->getNumOperands() == 2u )
-				ProcessBinaryArithmeticInstruction(instruction);
-			else
-			{
-				ReportError( std::string( "executing unknown instruction \"" ) + instruction->getOpcodeName() + "\"", *instruction );
-				return llvm::GenericValue();
-			}
+		case OpKind::UnaryArithmetic:
+			ProcessUnaryArithmeticInstruction(instruction);
+			break;
+
+		case OpKind::BinaryArithmetic:
+			ProcessBinaryArithmeticInstruction(instruction);
+			break;
 		};
 
 		// If this is not a terminal instruction, just advance to next instruction in block.
-		instruction= instruction->getNextNode();
+		++instruction_index;
 	}
 
 	// Return a dummy in case of errors.
@@ -430,7 +675,7 @@ void Interpreter::CopyConstantToStack( const llvm::Constant& constant, const siz
 				if( llvm::ConstantExpr* const constant_expression= llvm::dyn_cast<llvm::ConstantExpr>( element ) )
 				{
 					if( constant_expression->getOpcode() == llvm::Instruction::GetElementPtr )
-						element_ptr= size_t( BuildGEP( constant_expression ).IntVal.getLimitedValue() );
+						element_ptr= size_t( BuildConstantGEP( *constant_expression ).IntVal.getLimitedValue() );
 					else U_ASSERT(false);
 				}
 				else if( const auto global_variable= llvm::dyn_cast<llvm::GlobalVariable>(element) )
@@ -548,48 +793,55 @@ llvm::Constant* Interpreter::ReadConstantFromStack( llvm::Type* const type, cons
 	return nullptr;
 }
 
-llvm::GenericValue Interpreter::BuildGEP( const llvm::User* const instruction )
+llvm::GenericValue Interpreter::BuildConstantGEP( const llvm::ConstantExpr& constant_expression )
 {
-	U_ASSERT( instruction->getNumOperands() >= 2u );
+	U_ASSERT( constant_expression.getNumOperands() >= 2u );
+
+	const llvm::GenericValue ptr= GetVal( constant_expression.getOperand(0u) );
 
-	llvm::User::const_op_iterator op= instruction->op_begin();
-	const llvm::User::const_op_iterator op_end= instruction->op_end();
+	llvm::SmallVector<uint64_t, 8> indices;
+	for( uint32_t i= 1u; i < constant_expression.getNumOperands(); ++i )
+		indices.push_back( GetVal( constant_expression.getOperand(i) ).IntVal.getLimitedValue() );
 
-	const llvm::GenericValue ptr= GetVal( op->get() );
-	++op;
+	return BuildGEP( &constant_expression, ptr, indices );
+}
 
-	const llvm::GenericValue first_index= GetVal( op->get() );
-	++op;
+llvm::GenericValue Interpreter::BuildGEP( const llvm::User* const instruction, const llvm::GenericValue& ptr, const llvm::ArrayRef<uint64_t> indices )
+{
+	llvm::GenericValue new_ptr;
+	new_ptr.IntVal= ptr.IntVal + llvm::APInt( ptr.IntVal.getBitWidth(), CalculateGEPOffset( instruction, indices ) );
+	return new_ptr;
+}
+
+uint64_t Interpreter::CalculateGEPOffset( const llvm::User* const instruction, const llvm::ArrayRef<uint64_t> indices )
+{
+	U_ASSERT( !indices.empty() );
 
 	// TODO - check if this is correct cast.
 	llvm::Type* const ptr_element_type= llvm::dyn_cast<llvm::GEPOperator>(instruction)->getSourceElementType();
 
-	uint64_t offset_accumulated= first_index.IntVal.getLimitedValue() * data_layout_.getTypeAllocSize( ptr_element_type );
+	uint64_t offset_accumulated= indices.front() * data_layout_.getTypeAllocSize( ptr_element_type );
 	llvm::Type* aggregate_type= ptr_element_type;
 
-	for(; op != op_end; ++op)
+	for( const uint64_t index : indices.drop_front() )
 	{
-		const llvm::GenericValue index= GetVal( op->get() );
-
 		if( const auto array_type= llvm::dyn_cast<llvm::ArrayType>(aggregate_type) )
 		{
 			const auto element_type= array_type->getElementType();
-			offset_accumulated+= index.IntVal.getLimitedValue() * data_layout_.getTypeAllocSize( element_type );
+			offset_accumulated+= index * data_layout_.getTypeAllocSize( element_type );
 			aggregate_type= element_type;
 		}
 		else if( const auto struct_type= llvm::dyn_cast<llvm::StructType>(aggregate_type) )
 		{
 			const llvm::StructLayout& struct_layout= *data_layout_.getStructLayout( struct_type );
-			const uint32_t element_index= uint32_t(index.IntVal.getLimitedValue());
+			const uint32_t element_index= uint32_t(index);
 			offset_accumulated+= struct_layout.getElementOffset( element_index );
 			aggregate_type= aggregate_type->getStructElementType( element_index );
 		}
 		else U_ASSERT(false);
 	}
 
-	llvm::GenericValue new_ptr;
-	new_ptr.IntVal= ptr.IntVal + llvm::APInt( ptr.IntVal.getBitWidth(), offset_accumulated );
-	return new_ptr;
+	return offset_accumulated;
 }
 
 llvm::GenericValue Interpreter::GetVal( const llvm::Value* const val )
@@ -663,22 +915,39 @@ llvm::GenericValue Interpreter::GetVal( const llvm::Value* const val )
 	else if( const auto constant_expression= llvm::dyn_cast<llvm::ConstantExpr>( val ) )
 	{
 		if( constant_expression->getOpcode() == llvm::Instruction::GetElementPtr )
-			res= BuildGEP( constant_expression );
+			res= BuildConstantGEP( *constant_expression );
 		else U_ASSERT(false);
 	}
-	else
+	else U_ASSERT(false); // Arguments and instructions should be accessed via slots.
+	return res;
+}
+
+const llvm::GenericValue& Interpreter::GetOperand( const CompiledInstruction& instruction, const uint32_t index )
+{
+	U_ASSERT( instruction.operands_begin + index < instruction.operands_end );
+
+	CompiledFunction& function= *current_function_frame_.function;
+	const uint32_t operand= function.operands[ instruction.operands_begin + index ];
+	if( operand < function.num_slots )
+		return current_function_frame_.slots[ operand ];
+
+	CompiledConstant& constant= function.constants[ operand - function.num_slots ];
+	if( !constant.is_state_independent && constant.cached_value_evaluation_index != evaluation_index_ )
 	{
-		U_ASSERT( current_function_frame_.instructions_map.find( val ) != current_function_frame_.instructions_map.end() );
-		res= current_function_frame_.instructions_map[val];
+		constant.cached_value= GetVal( constant.value );
+		constant.cached_value_evaluation_index= evaluation_index_;
 	}
-	return res;
+	return constant.cached_value;
 }
 
-void Interpreter::ProcessAlloca( const llvm::Instruction* const instruction )
+void Interpreter::SetResult( const CompiledInstruction& instruction, llvm::GenericValue val )
 {
-	const auto alloca_instruction= llvm::dyn_cast<llvm::AllocaInst>(instruction);
-	llvm::Type* const element_type= alloca_instruction->getAllocatedType();
-	const size_t element_size= size_t(data_layout_.getTypeAllocSize( element_type ));
+	current_function_frame_.slots[ instruction.result_slot ]= std::move(val);
+}
+
+void Interpreter::ProcessAlloca( const CompiledInstruction& instruction )
+{
+	const size_t element_size= size_t(instruction.immediate);
 
 	size_t address= 0u;
 	if( current_function_frame_.is_coroutine )
@@ -689,7 +958,7 @@ void Interpreter::ProcessAlloca( const llvm::Instruction* const instruction )
 		const size_t new_heap_size= heap_.size() + element_size;
 		if( new_heap_size >= g_max_heap_segment_size )
 		{
-			ReportError( "Max heap size (" + std::to_string( g_max_heap_segment_size ) + ") reached", *instruction );
+			ReportError( "Max heap size (" + std::to_string( g_max_heap_segment_size ) + ") reached", *instruction.llvm_instruction );
 			return;
 		}
 		heap_.resize( new_heap_size );
@@ -708,7 +977,7 @@ void Interpreter::ProcessAlloca( const llvm::Instruction* const instruction )
 
 	llvm::GenericValue val;
 	val.IntVal= llvm::APInt( pointer_size_in_bits_, uint64_t(address) );
-	current_function_frame_.instructions_map[ instruction ]= val;
+	SetResult( instruction, val );
 }
 
 std::byte* Interpreter::GetMemoryForVirtualAddress( const size_t offset )
@@ -722,13 +991,13 @@ std::byte* Interpreter::GetMemoryForVirtualAddress( const size_t offset )
 	return stack_.data() + offset;
 }
 
-void Interpreter::ProcessLoad( const llvm::Instruction* const instruction )
+void Interpreter::ProcessLoad( const CompiledInstruction& instruction )
 {
-	const llvm::GenericValue address_val= GetVal( instruction->getOperand(0u) );
+	const llvm::GenericValue& address_val= GetOperand( instruction, 0u );
 
 	const size_t offset= size_t(address_val.IntVal.getLimitedValue());
 	const std::byte* const data_ptr= GetMemoryForVirtualAddress( offset );
-	current_function_frame_.instructions_map[ instruction ]= DoLoad( data_ptr, instruction->getType() );
+	SetResult( instruction, DoLoad( data_ptr, instruction.llvm_instruction->getType() ) );
 }
 
 llvm::GenericValue Interpreter::DoLoad( const std::byte* ptr, llvm::Type* const t )
@@ -781,15 +1050,15 @@ llvm::GenericValue Interpreter::DoLoad( const std::byte* ptr, llvm::Type* const
 	return val;
 }
 
-void Interpreter::ProcessStore( const llvm::Instruction* const instruction )
+void Interpreter::ProcessStore( const CompiledInstruction& instruction )
 {
-	const llvm::GenericValue address_val= GetVal( instruction->getOperand(1u) );
+	const llvm::GenericValue& address_val= GetOperand( instruction, 1u );
 
 	const size_t offset= size_t(address_val.IntVal.getLimitedValue());
 	std::byte* const data_ptr= GetMemoryForVirtualAddress( offset );
 
-	const auto value_operand= instruction->getOperand(0u);
-	DoStore( data_ptr, GetVal( value_operand ), value_operand->getType() );
+	const auto value_operand= instruction.llvm_instruction->getOperand(0u);
+	DoStore( data_ptr, GetOperand( instruction, 0u ), value_operand->getType() );
 }
 
 void Interpreter::DoStore( std::byte* const ptr, const llvm::GenericValue& val, llvm::Type* const t )
@@ -843,26 +1112,46 @@ void Interpreter::DoStore( std::byte* const ptr, const llvm::GenericValue& val,
 	else U_ASSERT(false);
 }
 
-void Interpreter::ProcessGEP( const llvm::Instruction* const instruction )
+void Interpreter::ProcessGEP( const CompiledInstruction& instruction )
+{
+	const llvm::GenericValue& ptr= GetOperand( instruction, 0u );
+
+	llvm::SmallVector<uint64_t, 8> indices;
+	for( uint32_t i= 1u; instruction.operands_begin + i < instruction.operands_end; ++i )
+		indices.push_back( GetOperand( instruction, i ).IntVal.getLimitedValue() );
+
+	SetResult( instruction, BuildGEP( instruction.llvm_instruction, ptr, indices ) );
+}
+
+void Interpreter::ProcessGEPConstantOffset( const CompiledInstruction& instruction )
 {
-	current_function_frame_.instructions_map[instruction]= BuildGEP( instruction );
+	const llvm::GenericValue& ptr= GetOperand( instruction, 0u );
+
+	llvm::GenericValue new_ptr;
+	new_ptr.IntVal= ptr.IntVal + llvm::APInt( ptr.IntVal.getBitWidth(), instruction.immediate );
+	SetResult( instruction, std::move(new_ptr) );
 }
 
-void Interpreter::ProcessCall( const llvm::CallInst* const instruction )
+void Interpreter::ProcessCall( const CompiledInstruction& instruction )
 {
-	const llvm::Value* const calle= instruction->getCalledOperand();
+	const auto call_instruction= llvm::cast<llvm::CallInst>( instruction.llvm_instruction );
+	const llvm::Value* const calle= call_instruction->getCalledOperand();
 	const llvm::Function* function= llvm::dyn_cast<llvm::Function>(calle);
 	if( function == nullptr )
-		function= reinterpret_cast<const llvm::Function*>( size_t( GetVal( calle ).IntVal.getLimitedValue() ) );
+	{
+		// Called operand is the last one.
+		const uint32_t calle_operand_index= instruction.operands_end - instruction.operands_begin - 1u;
+		function= reinterpret_cast<const llvm::Function*>( size_t( GetOperand( instruction, calle_operand_index ).IntVal.getLimitedValue() ) );
+	}
 
 	if( function == nullptr )
 	{
-		ReportError( "Calling zero functon pointer", *instruction );
+		ReportError( "Calling zero functon pointer", *instruction.llvm_instruction );
 		return;
 	}
 
 	// It is possible to call function by providing more arguments, than needed.
-	U_ASSERT( function->arg_size() <= instruction->getNumOperands() - 1u );
+	U_ASSERT( function->arg_size() <= call_instruction->getNumOperands() - 1u );
 
 	const llvm::StringRef function_name= function->getName();
 
@@ -963,9 +1252,9 @@ void Interpreter::ProcessCall( const llvm::CallInst* const instruction )
 		llvm::SmallVector<llvm::GenericValue, 8> args;
 		args.reserve( function->arg_size() );
 		for( size_t i= 0; i < function->arg_size(); ++i )
-			args.push_back( GetVal( instruction->getOperand(uint32_t(i)) ) );
+			args.push_back( GetOperand( instruction, uint32_t(i) ) );
 
-		current_function_frame_.instructions_map[instruction]= func( function->getFunctionType(), args );
+		SetResult( instruction, func( function->getFunctionType(), args ) );
 		return;
 	}
 
@@ -974,10 +1263,12 @@ void Interpreter::ProcessCall( const llvm::CallInst* const instruction )
 
 	const size_t prev_stack_size= stack_.size();
 
+	call_frame.slots.resize( function->arg_size() );
+
 	uint32_t i= 0u;
 	for( const llvm::Argument& arg : function->args() )
 	{
-		llvm::GenericValue val= GetVal( instruction->getOperand(i) );
+		llvm::GenericValue val= GetOperand( instruction, i );
 
 		if( arg.hasByValAttr() )
 		{
@@ -1003,7 +1294,7 @@ void Interpreter::ProcessCall( const llvm::CallInst* const instruction )
 			val.IntVal= llvm::APInt( pointer_size_in_bits_, uint64_t(new_address_value) );
 		}
 
-		call_frame.instructions_map[ &arg ]= std::move(val);
+		call_frame.slots[ arg.getArgNo() ]= std::move(val);
 
 		++i;
 	}
@@ -1013,16 +1304,16 @@ void Interpreter::ProcessCall( const llvm::CallInst* const instruction )
 	std::swap( call_frame, current_function_frame_ );
 
 	if( !function->getReturnType()->isVoidTy() )
-		current_function_frame_.instructions_map[instruction]= result_val;
+		SetResult( instruction, result_val );
 
 	stack_.resize( prev_stack_size ); // Drop temporary byval arguments.
 }
 
-void Interpreter::ProcessMemmove( const llvm::Instruction* const instruction )
+void Interpreter::ProcessMemmove( const CompiledInstruction& instruction )
 {
-	const size_t dst_offset= size_t( GetVal( instruction->getOperand(0u) ).IntVal.getLimitedValue() );
-	const size_t src_offset= size_t( GetVal( instruction->getOperand(1u) ).IntVal.getLimitedValue() );
-	const size_t size= size_t( GetVal( instruction->getOperand(2u) ).IntVal.getLimitedValue() );
+	const size_t dst_offset= size_t( GetOperand( instruction, 0u ).IntVal.getLimitedValue() );
+	const size_t src_offset= size_t( GetOperand( instruction, 1u ).IntVal.getLimitedValue() );
+	const size_t size= size_t( GetOperand( instruction, 2u ).IntVal.getLimitedValue() );
 
 	std::byte* const dst_ptr= GetMemoryForVirtualAddress( dst_offset );
 	const std::byte* const src_ptr= GetMemoryForVirtualAddress( src_offset );
@@ -1032,16 +1323,16 @@ void Interpreter::ProcessMemmove( const llvm::Instruction* const instruction )
 
 constexpr size_t g_malloc_header_size= sizeof(size_t);
 
-void Interpreter::ProcessMalloc( const llvm::CallInst* const instruction )
+void Interpreter::ProcessMalloc( const CompiledInstruction& instruction )
 {
-	const size_t size= size_t( GetVal( instruction->getOperand(0u) ).IntVal.getLimitedValue() );
+	const size_t size= size_t( GetOperand( instruction, 0u ).IntVal.getLimitedValue() );
 
 	const size_t offset= heap_.size();
 
 	const size_t new_size= offset + size + g_malloc_header_size;
 	if( new_size >= g_max_heap_segment_size )
 	{
-		ReportError( "Max heap size (" + std::to_string( g_max_heap_segment_size ) + ") reached", *instruction );
+		ReportError( "Max heap size (" + std::to_string( g_max_heap_segment_size ) + ") reached", *instruction.llvm_instruction );
 		return;
 	}
 	heap_.resize( new_size );
@@ -1051,15 +1342,15 @@ void Interpreter::ProcessMalloc( const llvm::CallInst* const instruction )
 
 	llvm::GenericValue val;
 	val.IntVal= llvm::APInt( pointer_size_in_bits_, uint64_t(offset + g_malloc_header_size + g_heap_segment_offset) );
-	current_function_frame_.instructions_map[ instruction ]= val;
+	SetResult( instruction, val );
 }
 
-void Interpreter::ProcessRealloc( const llvm::CallInst* const instruction )
+void Interpreter::ProcessRealloc( const CompiledInstruction& instruction )
 {
 	// Just allocate new memory block and copy contents of old one into new.
 
-	const llvm::GenericValue op0= GetVal( instruction->getOperand(0u) );
-	const llvm::GenericValue op1= GetVal( instruction->getOperand(1u) );
+	const llvm::GenericValue& op0= GetOperand( instruction, 0u );
+	const llvm::GenericValue& op1= GetOperand( instruction, 1u );
 
 	const size_t prev_offset= size_t( op0.IntVal.getLimitedValue() ) - g_heap_segment_offset;
 
@@ -1071,7 +1362,7 @@ void Interpreter::ProcessRealloc( const llvm::CallInst* const instruction )
 	if( size <= prev_size )
 	{
 		// If resizing down - just reuse previous block.
-		current_function_frame_.instructions_map[ instruction ]= op0;
+		SetResult( instruction, op0 );
 		return;
 	}
 
@@ -1080,7 +1371,7 @@ void Interpreter::ProcessRealloc( const llvm::CallInst* const instruction )
 	const size_t new_size= offset + size + g_malloc_header_size;
 	if( new_size >= g_max_heap_segment_size )
 	{
-		ReportError( "Max heap size (" + std::to_string( g_max_heap_segment_size ) + ") reached", *instruction );
+		ReportError( "Max heap size (" + std::to_string( g_max_heap_segment_size ) + ") reached", *instruction.llvm_instruction );
 		return;
 	}
 	heap_.resize( new_size );
@@ -1096,21 +1387,21 @@ void Interpreter::ProcessRealloc( const llvm::CallInst* const instruction )
 
 	llvm::GenericValue val;
 	val.IntVal= llvm::APInt( pointer_size_in_bits_, uint64_t(offset + g_malloc_header_size + g_heap_segment_offset) );
-	current_function_frame_.instructions_map[ instruction ]= val;
+	SetResult( instruction, val );
 }
 
-void Interpreter::ProcessFree( const llvm::CallInst* const instruction )
+void Interpreter::ProcessFree( const CompiledInstruction& instruction )
 {
 	(void) instruction;
 	// Now we manage heap as stack and can't properly free memory from it.
 }
 
-void Interpreter::ProcessCoroId( const llvm::CallInst* const instruction )
+void Interpreter::ProcessCoroId( const CompiledInstruction& instruction )
 {
-	const llvm::GenericValue alignment= GetVal( instruction->getOperand(0u) );
-	const llvm::GenericValue promise= GetVal( instruction->getOperand(1u) );
-	const llvm::GenericValue coroaddr= GetVal( instruction->getOperand(2u) );
-	const llvm::GenericValue fnaddrs= GetVal( instruction->getOperand(3u) );
+	const llvm::GenericValue& alignment= GetOperand( instruction, 0u );
+	const llvm::GenericValue& promise= GetOperand( instruction, 1u );
+	const llvm::GenericValue& coroaddr= GetOperand( instruction, 2u );
+	const llvm::GenericValue& fnaddrs= GetOperand( instruction, 3u );
 
 	(void)alignment;
 	(void)coroaddr;
@@ -1127,104 +1418,106 @@ void Interpreter::ProcessCoroId( const llvm::CallInst* const instruction )
 
 	llvm::GenericValue val;
 	val.IntVal= llvm::APInt( pointer_size_in_bits_, uint64_t( coroutine_id ) );
-	current_function_frame_.instructions_map[ instruction ]= val;
+	SetResult( instruction, val );
 }
 
-void Interpreter::ProcessCoroAlloc( const llvm::CallInst* const instruction )
+void Interpreter::ProcessCoroAlloc( const CompiledInstruction& instruction )
 {
 	// Do not allocate memory for coroutine - return false.
 	llvm::GenericValue val;
 	val.IntVal= llvm::APInt( 1u, uint64_t(0u) );
-	current_function_frame_.instructions_map[ instruction ]= val;
+	SetResult( instruction, val );
 }
 
-void Interpreter::ProcessCoroFree( const llvm::CallInst* const instruction )
+void Interpreter::ProcessCoroFree( const CompiledInstruction& instruction )
 {
-	const llvm::GenericValue token= GetVal( instruction->getOperand(0u) );
+	const llvm::GenericValue& token= GetOperand( instruction, 0u );
 	const uint32_t coroutine_id= uint32_t(token.IntVal.getLimitedValue());
 	coroutines_data_.erase( coroutine_id );
 
 	// Return "false" in order to signal, that there is no need to call "free".
 	llvm::GenericValue val;
 	val.IntVal= llvm::APInt( pointer_size_in_bits_, uint64_t(0u) );
-	current_function_frame_.instructions_map[ instruction ]= val;
+	SetResult( instruction, val );
 }
 
-void Interpreter::ProcessCoroSize( const llvm::CallInst* const instruction )
+void Interpreter::ProcessCoroSize( const CompiledInstruction& instruction )
 {
 	// Do not allocate memory for coroutine - return zero size.
 	llvm::GenericValue val;
 	val.IntVal= llvm::APInt( pointer_size_in_bits_, uint64_t(0) );
-	current_function_frame_.instructions_map[ instruction ]= val;
+	SetResult( instruction, val );
 }
 
-void Interpreter::ProcessCoroBegin( const llvm::CallInst* const instruction )
+void Interpreter::ProcessCoroBegin( const CompiledInstruction& instruction )
 {
-	const llvm::GenericValue token= GetVal( instruction->getOperand(0u) );
-	const llvm::GenericValue memory= GetVal( instruction->getOperand(1u) );
+	const llvm::GenericValue& token= GetOperand( instruction, 0u );
+	const llvm::GenericValue& memory= GetOperand( instruction, 1u );
 
 	(void)memory;
 
 	// Reuse token also as coroutine handle.
-	current_function_frame_.instructions_map[ instruction ]= token;
+	SetResult( instruction, token );
 }
 
-void Interpreter::ProcessCoroEnd( const llvm::CallInst* const instruction )
+void Interpreter::ProcessCoroEnd( const CompiledInstruction& instruction )
 {
 	// Do nothing here
 	(void) instruction;
 }
 
-void Interpreter::ProcessCoroSuspend( const llvm::CallInst* const instruction )
+void Interpreter::ProcessCoroSuspend( const CompiledInstruction& instruction )
 {
 	U_ASSERT( current_function_frame_.coroutine_data != nullptr );
 
-	// const llvm::GenericValue token_save= GetVal( instruction->getOperand(0u) );
-	const llvm::GenericValue is_final= GetVal( instruction->getOperand(1u) );
+	// const llvm::GenericValue& token_save= GetOperand( instruction, 0u );
+	const llvm::GenericValue& is_final= GetOperand( instruction, 1u );
 
-	current_function_frame_.coroutine_data->instructions_map= current_function_frame_.instructions_map;
-	current_function_frame_.coroutine_data->suspend_instruction= instruction;
+	CompiledFunction& function= *current_function_frame_.function;
+	current_function_frame_.coroutine_data->function= &function;
+	current_function_frame_.coroutine_data->slots= current_function_frame_.slots;
+	current_function_frame_.coroutine_data->suspend_instruction_index= uint32_t( &instruction - function.instructions.data() );
 	current_function_frame_.coroutine_data->done= is_final.IntVal.isAllOnes();
 
 	llvm::GenericValue val;
 	val.IntVal= llvm::APInt( 8u, uint64_t(255) ); // return -1 as result for suspension.
-	current_function_frame_.instructions_map[ instruction ]= val;
+	SetResult( instruction, val );
 }
 
-void Interpreter::ProcessCoroResume( const llvm::CallInst* const instruction )
+void Interpreter::ProcessCoroResume( const CompiledInstruction& instruction )
 {
 	ResumeCoroutine( instruction, false );
 }
 
-void Interpreter::ProcessCoroDestroy( const llvm::CallInst* const instruction )
+void Interpreter::ProcessCoroDestroy( const CompiledInstruction& instruction )
 {
 	ResumeCoroutine( instruction, true );
 }
 
-void Interpreter::ProcessCoroDone( const llvm::CallInst* const instruction )
+void Interpreter::ProcessCoroDone( const CompiledInstruction& instruction )
 {
-	const llvm::GenericValue handle= GetVal( instruction->getOperand(0u) );
+	const llvm::GenericValue& handle= GetOperand( instruction, 0u );
 	const uint32_t coroutine_id= uint32_t(handle.IntVal.getLimitedValue());
 	const CoroutineData& coroutine_data= coroutines_data_[coroutine_id];
 
 	llvm::GenericValue val;
 	val.IntVal= llvm::APInt( 1u, coroutine_data.done ? uint64_t(1) : uint64_t(0) );
-	current_function_frame_.instructions_map[ instruction ]= val;
+	SetResult( instruction, val );
 }
 
-void Interpreter::ProcessCoroPromise( const llvm::CallInst* const instruction )
+void Interpreter::ProcessCoroPromise( const CompiledInstruction& instruction )
 {
-	const llvm::GenericValue handle= GetVal( instruction->getOperand(0u) );
+	const llvm::GenericValue& handle= GetOperand( instruction, 0u );
 	const uint32_t coroutine_id= uint32_t(handle.IntVal.getLimitedValue());
 	const CoroutineData& coroutine_data= coroutines_data_[coroutine_id];
 
-	current_function_frame_.instructions_map[ instruction ]= coroutine_data.promise;
+	SetResult( instruction, coroutine_data.promise );
 }
 
-void Interpreter::ProcessSAddWithOverflow( const llvm::CallInst* const instruction )
+void Interpreter::ProcessSAddWithOverflow( const CompiledInstruction& instruction )
 {
-	const llvm::APInt a= GetVal( instruction->getOperand(0u) ).IntVal;
-	const llvm::APInt b= GetVal( instruction->getOperand(1u) ).IntVal;
+	const llvm::APInt a= GetOperand( instruction, 0u ).IntVal;
+	const llvm::APInt b= GetOperand( instruction, 1u ).IntVal;
 
 	bool overflow= false;
 	const llvm::APInt result= a.sadd_ov( b, overflow );
@@ -1237,13 +1530,13 @@ void Interpreter::ProcessSAddWithOverflow( const llvm::CallInst* const instructi
 
 	llvm::GenericValue val;
 	val.AggregateVal= { result_val, overflow_val };
-	current_function_frame_.instructions_map[ instruction ]= val;
+	SetResult( instruction, val );
 }
 
-void Interpreter::ProcessUAddWithOverflow( const llvm::CallInst* const instruction )
+void Interpreter::ProcessUAddWithOverflow( const CompiledInstruction& instruction )
 {
-	const llvm::APInt a= GetVal( instruction->getOperand(0u) ).IntVal;
-	const llvm::APInt b= GetVal( instruction->getOperand(1u) ).IntVal;
+	const llvm::APInt a= GetOperand( instruction, 0u ).IntVal;
+	const llvm::APInt b= GetOperand( instruction, 1u ).IntVal;
 
 	bool overflow= false;
 	const llvm::APInt result= a.uadd_ov( b, overflow );
@@ -1256,13 +1549,13 @@ void Interpreter::ProcessUAddWithOverflow( const llvm::CallInst* const instructi
 
 	llvm::GenericValue val;
 	val.AggregateVal= { result_val, overflow_val };
-	current_function_frame_.instructions_map[ instruction ]= val;
+	SetResult( instruction, val );
 }
 
-void Interpreter::ProcessSSubWithOverflow( const llvm::CallInst* const instruction )
+void Interpreter::ProcessSSubWithOverflow( const CompiledInstruction& instruction )
 {
-	const llvm::APInt a= GetVal( instruction->getOperand(0u) ).IntVal;
-	const llvm::APInt b= GetVal( instruction->getOperand(1u) ).IntVal;
+	const llvm::APInt a= GetOperand( instruction, 0u ).IntVal;
+	const llvm::APInt b= GetOperand( instruction, 1u ).IntVal;
 
 	bool overflow= false;
 	const llvm::APInt result= a.ssub_ov( b, overflow );
@@ -1275,13 +1568,13 @@ void Interpreter::ProcessSSubWithOverflow( const llvm::CallInst* const instructi
 
 	llvm::GenericValue val;
 	val.AggregateVal= { result_val, overflow_val };
-	current_function_frame_.instructions_map[ instruction ]= val;
+	SetResult( instruction, val );
 }
 
-void Interpreter::ProcessUSubWithOverflow( const llvm::CallInst* const instruction )
+void Interpreter::ProcessUSubWithOverflow( const CompiledInstruction& instruction )
 {
-	const llvm::APInt a= GetVal( instruction->getOperand(0u) ).IntVal;
-	const llvm::APInt b= GetVal( instruction->getOperand(1u) ).IntVal;
+	const llvm::APInt a= GetOperand( instruction, 0u ).IntVal;
+	const llvm::APInt b= GetOperand( instruction, 1u ).IntVal;
 
 	bool overflow= false;
 	const llvm::APInt result= a.usub_ov( b, overflow );
@@ -1294,13 +1587,13 @@ void Interpreter::ProcessUSubWithOverflow( const llvm::CallInst* const instructi
 
 	llvm::GenericValue val;
 	val.AggregateVal= { result_val, overflow_val };
-	current_function_frame_.instructions_map[ instruction ]= val;
+	SetResult( instruction, val );
 }
 
-void Interpreter::ProcessSMulWithOverflow( const llvm::CallInst* const instruction )
+void Interpreter::ProcessSMulWithOverflow( const CompiledInstruction& instruction )
 {
-	const llvm::APInt a= GetVal( instruction->getOperand(0u) ).IntVal;
-	const llvm::APInt b= GetVal( instruction->getOperand(1u) ).IntVal;
+	const llvm::APInt a= GetOperand( instruction, 0u ).IntVal;
+	const llvm::APInt b= GetOperand( instruction, 1u ).IntVal;
 
 	bool overflow= false;
 	const llvm::APInt result= a.smul_ov( b, overflow );
@@ -1313,13 +1606,13 @@ void Interpreter::ProcessSMulWithOverflow( const llvm::CallInst* const instructi
 
 	llvm::GenericValue val;
 	val.AggregateVal= { result_val, overflow_val };
-	current_function_frame_.instructions_map[ instruction ]= val;
+	SetResult( instruction, val );
 }
 
-void Interpreter::ProcessUMulWithOverflow( const llvm::CallInst* const instruction )
+void Interpreter::ProcessUMulWithOverflow( const CompiledInstruction& instruction )
 {
-	const llvm::APInt a= GetVal( instruction->getOperand(0u) ).IntVal;
-	const llvm::APInt b= GetVal( instruction->getOperand(1u) ).IntVal;
+	const llvm::APInt a= GetOperand( instruction, 0u ).IntVal;
+	const llvm::APInt b= GetOperand( instruction, 1u ).IntVal;
 
 	bool overflow= false;
 	const llvm::APInt result= a.umul_ov( b, overflow );
@@ -1332,38 +1625,43 @@ void Interpreter::ProcessUMulWithOverflow( const llvm::CallInst* const instructi
 
 	llvm::GenericValue val;
 	val.AggregateVal= { result_val, overflow_val };
-	current_function_frame_.instructions_map[ instruction ]= val;
+	SetResult( instruction, val );
 }
 
-void Interpreter::ProcessStacksave( const llvm::CallInst* const instruction )
+void Interpreter::ProcessStacksave( const CompiledInstruction& instruction )
 {
 	// For now just do not bother with it - produce nullptr.
 	llvm::GenericValue val;
 	val.IntVal= llvm::APInt( pointer_size_in_bits_, uint64_t(0) );
-	current_function_frame_.instructions_map[ instruction ]= val;
+	SetResult( instruction, val );
 }
 
-void Interpreter::ProcessStackrestore( const llvm::CallInst* const instruction )
+void Interpreter::ProcessStackrestore( const CompiledInstruction& instruction )
 {
 	// For now ignore this instruction.
 	U_UNUSED(instruction);
 }
 
-void Interpreter::ProcessThreadLocalAddress( const llvm::CallInst* const instruction )
+void Interpreter::ProcessThreadLocalAddress( const CompiledInstruction& instruction )
 {
 	// Just return variable itself. For now we don't support handling thread-local variables properly (with TLS creation).
-	llvm::GenericValue val= GetVal( instruction->getArgOperand(0) );
-	current_function_frame_.instructions_map[ instruction ]= std::move(val);
+	llvm::GenericValue val= GetOperand( instruction, 0u );
+	SetResult( instruction, std::move(val) );
 }
 
-void Interpreter::ResumeCoroutine( const llvm::CallInst* instruction, const bool destroy )
+void Interpreter::ResumeCoroutine( const CompiledInstruction& instruction, const bool destroy )
 {
-	const llvm::GenericValue handle= GetVal( instruction->getOperand(0u) );
+	const llvm::GenericValue& handle= GetOperand( instruction, 0u );
 	const uint32_t coroutine_id= uint32_t(handle.IntVal.getLimitedValue());
 	CoroutineData& coroutine_data= coroutines_data_[coroutine_id];
 
+	U_ASSERT( coroutine_data.function != nullptr );
+	CompiledFunction& function= *coroutine_data.function;
+
 	CallFrame call_frame;
-	call_frame.instructions_map= coroutine_data.instructions_map;
+	call_frame.function= &function;
+	// Saved state isn't needed anymore - it will be saved again on next suspend.
+	call_frame.slots= std::move(coroutine_data.slots);
 	call_frame.coroutine_data= &coroutine_data;
 	call_frame.is_coroutine= true;
 
@@ -1374,10 +1672,13 @@ void Interpreter::ResumeCoroutine( const llvm::CallInst* instruction, const bool
 	{ // Set result of "suspend" instriction.
 		llvm::GenericValue val;
 		val.IntVal= llvm::APInt( 8u, destroy ? uint64_t(1) : uint64_t(0) );
-		current_function_frame_.instructions_map[ coroutine_data.suspend_instruction ]= val;
+		current_function_frame_.slots[ function.instructions[ coroutine_data.suspend_instruction_index ].result_slot ]= val;
 	}
 	// Continue execution starting with next instruction.
-	CallFunctionImpl( coroutine_data.suspend_instruction->getNextNode() );
+	// Suspend instruction isn't a terminator, so, next instruction is in the same basic block.
+	const uint32_t basic_block_index=
+		uint32_t( std::upper_bound( function.basic_blocks_start.begin(), function.basic_blocks_start.end(), coroutine_data.suspend_instruction_index ) - function.basic_blocks_start.begin() ) - 1u;
+	CallFunctionImpl( function, coroutine_data.suspend_instruction_index + 1u, basic_block_index );
 
 	std::swap( call_frame, current_function_frame_ );
 
@@ -1385,19 +1686,19 @@ void Interpreter::ResumeCoroutine( const llvm::CallInst* instruction, const bool
 	U_ASSERT( stack_.size() == prev_stack_size );
 }
 
-void Interpreter::ProcessUnaryArithmeticInstruction( const llvm::Instruction* const instruction )
+void Interpreter::ProcessUnaryArithmeticInstruction( const CompiledInstruction& instruction )
 {
-	llvm::Value* const operand0= instruction->getOperand(0u);
-	const llvm::GenericValue op= GetVal( operand0 );
+	llvm::Value* const operand0= instruction.llvm_instruction->getOperand(0u);
+	const llvm::GenericValue& op= GetOperand( instruction, 0u );
 
-	llvm::Type* const dst_type= instruction->getType();
+	llvm::Type* const dst_type= instruction.llvm_instruction->getType();
 	llvm::Type* const src_type= operand0->getType();
 	llvm::GenericValue val;
-	switch(instruction->getOpcode())
+	switch(instruction.llvm_instruction->getOpcode())
 	{
 	case llvm::Instruction::ExtractValue:
 		val= op;
-		for( const auto index : llvm::dyn_cast<llvm::ExtractValueInst>(instruction)->indices() )
+		for( const auto index : llvm::dyn_cast<llvm::ExtractValueInst>(instruction.llvm_instruction)->indices() )
 		{
 			U_ASSERT( index < val.AggregateVal.size() );
 			val= val.AggregateVal[index];
@@ -1517,7 +1818,7 @@ void Interpreter::ProcessUnaryArithmeticInstruction( const llvm::Instruction* co
 				std::memcpy(&val.FloatVal, bytes, sizeof(float));
 			}
 			else
-				ReportError( "Invalid int to float cast", *instruction );
+				ReportError( "Invalid int to float cast", *instruction.llvm_instruction );
 		}
 		else if( dst_type->isIntegerTy() && src_type->isFloatingPointTy() )
 		{
@@ -1538,7 +1839,7 @@ void Interpreter::ProcessUnaryArithmeticInstruction( const llvm::Instruction* co
 				val.IntVal= llvm::APInt( sizeof(float) * 8, uint64_t(v) );
 			}
 			else
-				ReportError( "Invalid float to int cast", *instruction );
+				ReportError( "Invalid float to int cast", *instruction.llvm_instruction );
 		}
 		else
 		{
@@ -1548,21 +1849,21 @@ void Interpreter::ProcessUnaryArithmeticInstruction( const llvm::Instruction* co
 		break;
 
 	default:
-		ReportError( std::string( "executing unknown unary instruction \"" ) + instruction->getOpcodeName() + "\"", *instruction );
+		ReportError( std::string( "executing unknown unary instruction \"" ) + instruction.llvm_instruction->getOpcodeName() + "\"", *instruction.llvm_instruction );
 		break;
 	}
 
-	current_function_frame_.instructions_map[instruction]= val;
+	SetResult( instruction, val );
 }
 
-void Interpreter::ProcessBinaryArithmeticInstruction( const llvm::Instruction* const instruction )
+void Interpreter::ProcessBinaryArithmeticInstruction( const CompiledInstruction& instruction )
 {
-	const llvm::GenericValue op0= GetVal( instruction->getOperand(0u) );
-	const llvm::GenericValue op1= GetVal( instruction->getOperand(1u) );
+	const llvm::GenericValue& op0= GetOperand( instruction, 0u );
+	const llvm::GenericValue& op1= GetOperand( instruction, 1u );
 
-	llvm::Type* const type= instruction->getOperand(0u)->getType();
+	llvm::Type* const type= instruction.llvm_instruction->getOperand(0u)->getType();
 	llvm::GenericValue val;
-	switch(instruction->getOpcode())
+	switch(instruction.llvm_instruction->getOpcode())
 	{
 	case llvm::Instruction::Add:
 		U_ASSERT(type->isIntegerTy());
@@ -1584,7 +1885,7 @@ void Interpreter::ProcessBinaryArithmeticInstruction( const llvm::Instruction* c
 		if( op1.IntVal.getBoolValue() )
 			val.IntVal= op0.IntVal.sdiv(op1.IntVal);
 		else
-			ReportError( "constexpr division by zero", *instruction );
+			ReportError( "constexpr division by zero", *instruction.llvm_instruction );
 		break;
 
 	case llvm::Instruction::UDiv:
@@ -1592,7 +1893,7 @@ void Interpreter::ProcessBinaryArithmeticInstruction( const llvm::Instruction* c
 		if( op1.IntVal.getBoolValue() )
 			val.IntVal= op0.IntVal.udiv(op1.IntVal);
 		else
-			ReportError( "constexpr division by zero", *instruction );
+			ReportError( "constexpr division by zero", *instruction.llvm_instruction );
 		break;
 
 	case llvm::Instruction::SRem:
@@ -1600,7 +1901,7 @@ void Interpreter::ProcessBinaryArithmeticInstruction( const llvm::Instruction* c
 		if( op1.IntVal.getBoolValue() )
 			val.IntVal= op0.IntVal.srem(op1.IntVal);
 		else
-			ReportError( "constexpr division by zero", *instruction );
+			ReportError( "constexpr division by zero", *instruction.llvm_instruction );
 		break;
 
 	case llvm::Instruction::URem:
@@ -1608,7 +1909,7 @@ void Interpreter::ProcessBinaryArithmeticInstruction( const llvm::Instruction* c
 		if( op1.IntVal.getBoolValue() )
 			val.IntVal= op0.IntVal.urem(op1.IntVal);
 		else
-			ReportError( "constexpr division by zero", *instruction );
+			ReportError( "constexpr division by zero", *instruction.llvm_instruction );
 		break;
 
 	case llvm::Instruction::And:
@@ -1691,7 +1992,7 @@ void Interpreter::ProcessBinaryArithmeticInstruction( const llvm::Instruction* c
 
 	case llvm::Instruction::ICmp:
 		U_ASSERT(type->isIntegerTy() || type->isPointerTy());
-		switch(llvm::dyn_cast<llvm::CmpInst>(instruction)->getPredicate())
+		switch(llvm::dyn_cast<llvm::CmpInst>(instruction.llvm_instruction)->getPredicate())
 		{
 		case llvm::CmpInst::ICMP_EQ : val.IntVal= op0.IntVal.eq (op1.IntVal); break;
 		case llvm::CmpInst::ICMP_NE : val.IntVal= op0.IntVal.ne (op1.IntVal); break;
@@ -1715,7 +2016,7 @@ void Interpreter::ProcessBinaryArithmeticInstruction( const llvm::Instruction* c
 				cmp_result= llvm::APFloat(op0.FloatVal).compare(llvm::APFloat(op1.FloatVal));
 			else
 				cmp_result= llvm::APFloat(op0.DoubleVal).compare(llvm::APFloat(op1.DoubleVal));
-			switch(llvm::dyn_cast<llvm::CmpInst>(instruction)->getPredicate())
+			switch(llvm::dyn_cast<llvm::CmpInst>(instruction.llvm_instruction)->getPredicate())
 			{
 			// see llvm-3.7.1.src/lib/IR/ConstantFold.cpp:1752
 			default: U_ASSERT(false); break;
@@ -1742,11 +2043,11 @@ void Interpreter::ProcessBinaryArithmeticInstruction( const llvm::Instruction* c
 	case llvm::Instruction::AtomicRMW:
 		{
 			std::byte* const data_ptr= GetMemoryForVirtualAddress( size_t(op0.IntVal.getLimitedValue()) );
-			const llvm::GenericValue load_result= DoLoad( data_ptr, instruction->getType() );
+			const llvm::GenericValue load_result= DoLoad( data_ptr, instruction.llvm_instruction->getType() );
 			val= load_result;
 
 			llvm::GenericValue new_value;
-			const auto operation= llvm::dyn_cast<llvm::AtomicRMWInst>(instruction)->getOperation();
+			const auto operation= llvm::dyn_cast<llvm::AtomicRMWInst>(instruction.llvm_instruction)->getOperation();
 			switch(operation)
 			{
 			case llvm::AtomicRMWInst::Xchg:
@@ -1771,20 +2072,20 @@ void Interpreter::ProcessBinaryArithmeticInstruction( const llvm::Instruction* c
 				new_value.IntVal= load_result.IntVal ^ op1.IntVal;
 				break;
 			default:
-				ReportError( ( std::string("Unsupported atomic operation \"") + llvm::AtomicRMWInst::getOperationName(operation) + "\"" ).str(), *instruction );
+				ReportError( ( std::string("Unsupported atomic operation \"") + llvm::AtomicRMWInst::getOperationName(operation) + "\"" ).str(), *instruction.llvm_instruction );
 				new_value= op1;
 				break;
 			}
-			DoStore( data_ptr, new_value, instruction->getType() );
+			DoStore( data_ptr, new_value, instruction.llvm_instruction->getType() );
 		}
 		break;
 
 	default:
-		ReportError( std::string("executing unknown binary instruction \"") + instruction->getOpcodeName() + "\"", *instruction );
+		ReportError( std::string("executing unknown binary instruction \"") + instruction.llvm_instruction->getOpcodeName() + "\"", *instruction.llvm_instruction );
 		break;
 	};
 
-	current_function_frame_.instructions_map[instruction]= val;
+	SetResult( instruction, val );
 }
 
 void Interpreter::ReportDataStackOverflow()
@@ -1,5 +1,6 @@
 #pragma once
 #include <cstddef>
+#include <memory>
 #include <unordered_map>
 #include "push_disable_llvm_warnings.hpp"
 #include <llvm/ADT/DenseMap.h>
@@ -7,6 +8,7 @@
 #include <llvm/IR/Constant.h>
 #include <llvm/IR/DataLayout.h>
 #include <llvm/IR/Instructions.h>
+#include <llvm/IR/ValueHandle.h>
 #include <llvm/ExecutionEngine/GenericValue.h>
 #include "pop_llvm_warnings.hpp"
 #include "small_types.hpp"
@@ -73,11 +75,80 @@ public:
 	// Read data from address space of execution engine.
 	void ReadExecutinEngineData( void* dst, uint64_t address, size_t size ) const;
 
+private:
+	// Each function is translated before its first execution into a compact form, more suitable for execution.
+	// All arguments and instructions results are stored in a flat array of slots.
+	// Operands, branch targets and some other things like allocation sizes are resolved during translation.
+
+	enum class OpKind : uint8_t
+	{
+		Unknown,
+		Alloca,
+		Load,
+		Store,
+		GEP,
+		GEPConstantOffset,
+		Call,
+		Br,
+		CondBr,
+		Switch,
+		PHI,
+		Ret,
+		Select,
+		AtomicCmpXchg,
+		Fence,
+		Unreachable,
+		UnaryArithmetic,
+		BinaryArithmetic,
+	};
+
+	struct CompiledInstruction
+	{
+		const llvm::Instruction* llvm_instruction= nullptr;
+		uint64_t immediate= 0; // Allocation size for "alloca", offset for "getelementptr" with constant indices.
+		uint32_t result_slot= 0;
+		// Range in operands list.
+		uint32_t operands_begin= 0;
+		uint32_t operands_end= 0;
+		// Start in branch targets list.
+		uint32_t targets_begin= 0;
+		OpKind kind= OpKind::Unknown;
+	};
+
+	struct CompiledConstant
+	{
+		const llvm::Value* value= nullptr;
+		// Values of some constants (globals, constant expressions, etc.) depend on interpreter state.
+		// So, calculate them once per evaluation. Simple scalar constants are calculated only once.
+		llvm::GenericValue cached_value;
+		uint64_t cached_value_evaluation_index= 0;
+		bool is_state_independent= false;
+	};
+
+	struct CompiledFunction
+	{
+		llvm::WeakVH llvm_function; // Becomes null if the function is deleted.
+		uint32_t num_slots= 0;
+		std::vector<CompiledInstruction> instructions;
+		// Operand is a slot index or (if it isn't less than number of slots) a constant index plus number of slots.
+		// For "phi" operands are pairs of incoming basic block index and incoming value.
+		std::vector<uint32_t> operands;
+		// Basic blocks indices.
+		// For conditional branches - true and false targets, for "switch" - default target and targets of all cases.
+		std::vector<uint32_t> branch_targets;
+		// Index of first instruction of each basic block.
+		std::vector<uint32_t> basic_blocks_start;
+		std::vector<CompiledConstant> constants;
+	};
+
 private:
 	ResultConstexpr PrepareResultAndClear();
 
+	CompiledFunction* GetCompiledFunction( const llvm::Function& llvm_function );
+	std::unique_ptr<CompiledFunction> CompileFunction( const llvm::Function& llvm_function );
+
 	llvm::GenericValue CallFunction( const llvm::Function& llvm_function );
-	llvm::GenericValue CallFunctionImpl( const llvm::Instruction* instruction );
+	llvm::GenericValue CallFunctionImpl( CompiledFunction& function, uint32_t instruction_index, uint32_t basic_block_index );
 
 	// Returns offset
 	size_t MoveConstantToStack( const llvm::Constant& constant );
@@ -85,54 +156,61 @@ private:
 
 	llvm::Constant* ReadConstantFromStack( llvm::Type* type, size_t value_ptr );
 
-	llvm::GenericValue BuildGEP( const llvm::User* instruction );
+	llvm::GenericValue BuildConstantGEP( const llvm::ConstantExpr& constant_expression );
+	llvm::GenericValue BuildGEP( const llvm::User* instruction, const llvm::GenericValue& ptr, llvm::ArrayRef<uint64_t> indices );
+	uint64_t CalculateGEPOffset( const llvm::User* instruction, llvm::ArrayRef<uint64_t> indices );
 
+	// Get value of a constant.
 	llvm::GenericValue GetVal( const llvm::Value* val );
-	void ProcessAlloca( const llvm::Instruction* instruction );
+	const llvm::GenericValue& GetOperand( const CompiledInstruction& instruction, uint32_t index );
+	void SetResult( const CompiledInstruction& instruction, llvm::GenericValue val );
+
+	void ProcessAlloca( const CompiledInstruction& instruction );
 
 	std::byte* GetMemoryForVirtualAddress( size_t offset );
 
-	void ProcessLoad( const llvm::Instruction* instruction );
+	void ProcessLoad( const CompiledInstruction& instruction );
 	llvm::GenericValue DoLoad( const std::byte* ptr, llvm::Type* t );
 
-	void ProcessStore( const llvm::Instruction* instruction );
+	void ProcessStore( const CompiledInstruction& instruction );
 	void DoStore( std::byte* ptr, const llvm::GenericValue& val, llvm::Type* t );
 
-	void ProcessGEP( const llvm::Instruction* instruction );
-	void ProcessCall( const llvm::CallInst* instruction );
-	void ProcessMemmove( const llvm::Instruction* instruction );
-	void ProcessMalloc( const llvm::CallInst* instruction );
-	void ProcessRealloc( const llvm::CallInst* instruction );
-	void ProcessFree( const llvm::CallInst* instruction );
-
-	void ProcessCoroId( const llvm::CallInst* instruction );
-	void ProcessCoroAlloc( const llvm::CallInst* instruction );
-	void ProcessCoroFree( const llvm::CallInst* instruction );
-	void ProcessCoroSize( const llvm::CallInst* instruction );
-	void ProcessCoroBegin( const llvm::CallInst* instruction );
-	void ProcessCoroEnd( const llvm::CallInst* instruction );
-	void ProcessCoroSuspend( const llvm::CallInst* instruction );
-	void ProcessCoroResume( const llvm::CallInst* instruction );
-	void ProcessCoroDestroy( const llvm::CallInst* instruction );
-	void ProcessCoroDone( const llvm::CallInst* instruction );
-	void ProcessCoroPromise( const llvm::CallInst* instruction );
-
-	void ProcessSAddWithOverflow( const llvm::CallInst* instruction );
-	void ProcessUAddWithOverflow( const llvm::CallInst* instruction );
-	void ProcessSSubWithOverflow( const llvm::CallInst* instruction );
-	void ProcessUSubWithOverflow( const llvm::CallInst* instruction );
-	void ProcessSMulWithOverflow( const llvm::CallInst* instruction );
-	void ProcessUMulWithOverflow( const llvm::CallInst* instruction );
-
-	void ProcessStacksave( const llvm::CallInst* instruction );
-	void ProcessStackrestore( const llvm::CallInst* instruction );
-
-	void ProcessThreadLocalAddress( const llvm::CallInst* instruction );
-
-	void ResumeCoroutine( const llvm::CallInst* instruction, bool destroy );
-
-	void ProcessUnaryArithmeticInstruction( const llvm::Instruction* instruction );
-	void ProcessBinaryArithmeticInstruction( const llvm::Instruction* instruction );
+	void ProcessGEP( const CompiledInstruction& instruction );
+	void ProcessGEPConstantOffset( const CompiledInstruction& instruction );
+	void ProcessCall( const CompiledInstruction& instruction );
+	void ProcessMemmove( const CompiledInstruction& instruction );
+	void ProcessMalloc( const CompiledInstruction& instruction );
+	void ProcessRealloc( const CompiledInstruction& instruction );
+	void ProcessFree( const CompiledInstruction& instruction );
+
+	void ProcessCoroId( const CompiledInstruction& instruction );
+	void ProcessCoroAlloc( const CompiledInstruction& instruction );
+	void ProcessCoroFree( const CompiledInstruction& instruction );
+	void ProcessCoroSize( const CompiledInstruction& instruction );
+	void ProcessCoroBegin( const CompiledInstruction& instruction );
+	void ProcessCoroEnd( const CompiledInstruction& instruction );
+	void ProcessCoroSuspend( const CompiledInstruction& instruction );
+	void ProcessCoroResume( const CompiledInstruction& instruction );
+	void ProcessCoroDestroy( const CompiledInstruction& instruction );
+	void ProcessCoroDone( const CompiledInstruction& instruction );
+	void ProcessCoroPromise( const CompiledInstruction& instruction );
+
+	void ProcessSAddWithOverflow( const CompiledInstruction& instruction );
+	void ProcessUAddWithOverflow( const CompiledInstruction& instruction );
+	void ProcessSSubWithOverflow( const CompiledInstruction& instruction );
+	void ProcessUSubWithOverflow( const CompiledInstruction& instruction );
+	void ProcessSMulWithOverflow( const CompiledInstruction& instruction );
+	void ProcessUMulWithOverflow( const CompiledInstruction& instruction );
+
+	void ProcessStacksave( const CompiledInstruction& instruction );
+	void ProcessStackrestore( const CompiledInstruction& instruction );
+
+	void ProcessThreadLocalAddress( const CompiledInstruction& instruction );
+
+	void ResumeCoroutine( const CompiledInstruction& instruction, bool destroy );
+
+	void ProcessUnaryArithmeticInstruction( const CompiledInstruction& instruction );
+	void ProcessBinaryArithmeticInstruction( const CompiledInstruction& instruction );
 
 	void ReportDataStackOverflow();
 	void ReportGlobalsStackOverflow();
@@ -142,22 +220,25 @@ private:
 	std::string GetCurrentCallStackDescription();
 
 private:
-	using InstructionsMap= llvm::DenseMap< const llvm::Value*, llvm::GenericValue >;
+	using SlotsVector= std::vector<llvm::GenericValue>;
 
 	struct CoroutineData;
 
 	struct CallFrame
 	{
-		InstructionsMap instructions_map;
+		CompiledFunction* function= nullptr;
+		SlotsVector slots;
 		CoroutineData* coroutine_data= nullptr; // observer ptr
 		bool is_coroutine= false;
 	};
 
 	struct CoroutineData
 	{
-		InstructionsMap instructions_map; // Save here all instruction in case of suspend.
+		// Save here function state in case of suspend.
+		CompiledFunction* function= nullptr;
+		SlotsVector slots;
 		llvm::GenericValue promise;
-		const llvm::CallInst* suspend_instruction= nullptr;
+		uint32_t suspend_instruction_index= 0;
 		bool done= false;
 	};
 
@@ -178,10 +259,14 @@ private:
 
 	llvm::DenseMap<const llvm::Constant*, size_t> external_constant_mapping_;
 
+	// Translated functions are preserved between evaluations.
+	llvm::DenseMap<const llvm::Function*, std::unique_ptr<CompiledFunction>> compiled_functions_;
+
 	llvm::StringMap<CustomFunction> custom_functions_;
 
 	llvm::SmallVector<const llvm::CallInst*, 8> call_stack_;
 	uint64_t instructions_executed_= 0;
+	uint64_t evaluation_index_= 0;
 
 	std::vector<std::string> errors_;
 };
@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <tuple>
+#include <unordered_map>
+
+#include "push_disable_llvm_warnings.hpp"
+#include <llvm/Support/JSON.h>
+#include <llvm/Support/raw_ostream.h>
+#include "pop_llvm_warnings.hpp"
+
+#include "template_instantiation_stats.hpp"
+
+namespace U
+{
+
+void MergeTemplateInstantiationStats( TemplateInstantiationStatsList& dst, const TemplateInstantiationStatsList& src )
+{
+	std::unordered_map<std::string, size_t> dst_indices;
+	const auto make_key=
+		[]( const TemplateInstantiationStats& stats )
+		{
+			return stats.name + '\0' + stats.file_path + '\0' + std::to_string( stats.line );
+		};
+
+	for( size_t i= 0; i < dst.size(); ++i )
+		dst_indices.emplace( make_key( dst[i] ), i );
+
+	for( const TemplateInstantiationStats& src_stats : src )
+	{
+		const auto it= dst_indices.find( make_key( src_stats ) );
+		if( it == dst_indices.end() )
+		{
+			dst_indices.emplace( make_key( src_stats ), dst.size() );
+			dst.push_back( src_stats );
+			continue;
+		}
+
+		TemplateInstantiationStats& dst_stats= dst[ it->second ];
+		dst_stats.instantiations+= src_stats.instantiations;
+		dst_stats.cache_hits+= src_stats.cache_hits;
+		dst_stats.llvm_functions+= src_stats.llvm_functions;
+		dst_stats.total_time_us+= src_stats.total_time_us;
+		dst_stats.self_time_us+= src_stats.self_time_us;
+	}
+}
+
+void SortTemplateInstantiationStats( TemplateInstantiationStatsList& stats, const TemplateInstantiationStatsSortKey sort_key )
+{
+	const auto get_key=
+		[sort_key]( const TemplateInstantiationStats& s ) -> uint64_t
+		{
+			switch( sort_key )
+			{
+			case TemplateInstantiationStatsSortKey::SelfTime: return s.self_time_us;
+			case TemplateInstantiationStatsSortKey::TotalTime: return s.total_time_us;
+			case TemplateInstantiationStatsSortKey::Instantiations: return s.instantiations;
+			case TemplateInstantiationStatsSortKey::LLVMFunctions: return s.llvm_functions;
+			}
+			return 0;
+		};
+
+	// Use name and location for deterministic order of templates with equal keys.
+	std::sort(
+		stats.begin(), stats.end(),
+		[&]( const TemplateInstantiationStats& l, const TemplateInstantiationStats& r )
+		{
+			const uint64_t l_key= get_key(l), r_key= get_key(r);
+			if( l_key != r_key )
+				return l_key > r_key;
+			return std::tie( l.name, l.file_path, l.line ) < std::tie( r.name, r.file_path, r.line );
+		} );
+}
+
+void WriteTemplateInstantiationStatsJSON( const TemplateInstantiationStatsList& stats, llvm::raw_ostream& stream )
+{
+	llvm::json::OStream json_stream( stream, 1 );
+	json_stream.array(
+		[&]
+		{
+			for( const TemplateInstantiationStats& s : stats )
+			{
+				json_stream.object(
+					[&]
+					{
+						json_stream.attribute( "name", s.name );
+						json_stream.attribute( "kind", s.is_function_template ? "function" : "type" );
+						json_stream.attribute( "file", s.file_path );
+						json_stream.attribute( "line", int64_t(s.line) );
+						json_stream.attribute( "instantiations", int64_t(s.instantiations) );
+						json_stream.attribute( "cache_hits", int64_t(s.cache_hits) );
+						json_stream.attribute( "llvm_functions", int64_t(s.llvm_functions) );
+						json_stream.attribute( "total_time_us", int64_t(s.total_time_us) );
+						json_stream.attribute( "self_time_us", int64_t(s.self_time_us) );
+					} );
+			}
+		} );
+	stream << "\n";
+}
+
+} // namespace U
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace llvm
+{
+class raw_ostream;
+}
+
+namespace U
+{
+
+// Statistics of instantiations of a single type or function template.
+struct TemplateInstantiationStats
+{
+	std::string name; // Including names of enclosing namespaces and classes.
+	std::string file_path;
+	uint32_t line= 0;
+	bool is_function_template= false;
+
+	uint64_t instantiations= 0; // Number of unique instantiations.
+	uint64_t cache_hits= 0; // Number of requests for already existing instantiations.
+	uint64_t llvm_functions= 0; // Number of LLVM functions with bodies in all instantiations.
+
+	// Time of instantiation and building of instantiated things, in microseconds.
+	// Total time includes time of nested instantiations of other templates, self time doesn't include it.
+	uint64_t total_time_us= 0;
+	uint64_t self_time_us= 0;
+};
+
+using TemplateInstantiationStatsList= std::vector<TemplateInstantiationStats>;
+
+enum class TemplateInstantiationStatsSortKey : uint8_t
+{
+	SelfTime,
+	TotalTime,
+	Instantiations,
+	LLVMFunctions,
+};
+
+// Sum stats for same templates (with same name and location), for example, for templates from common imports of different files.
+void MergeTemplateInstantiationStats( TemplateInstantiationStatsList& dst, const TemplateInstantiationStatsList& src );
+
+// Sort in descending order of given key.
+void SortTemplateInstantiationStats( TemplateInstantiationStatsList& stats, TemplateInstantiationStatsSortKey sort_key );
+
+// Write stats as JSON array of objects.
+void WriteTemplateInstantiationStatsJSON( const TemplateInstantiationStatsList& stats, llvm::raw_ostream& stream );
+
+} // namespace U
@@ -89,7 +89,7 @@ bool SingleExpressionIsUselessImpl( const Synt::CoroutineType& ) { return true;
 bool SingleExpressionIsUselessImpl( const Synt::Mixin& ) { return true; }
 
 template<typename T>
-bool SingleExpressionIsUselessImpl( const std::unique_ptr<T>& t )
+bool SingleExpressionIsUselessImpl( const ArenaPtr<T>& t )
 {
 	return SingleExpressionIsUselessImpl(*t);
 }
@@ -2695,7 +2695,7 @@ CodeBuilder::BlockBuildInfo CodeBuilder::BuildBlockElementImpl(
 		// Make exception for "take" operator, since it may be used for in-place default value construction.
 		if( variable_ptr->type.IsNoDiscard() &&
 			!(  std::holds_alternative<Synt::MoveOperator>( single_expression_operator.expression ) ||
-				std::holds_alternative<std::unique_ptr<const Synt::TakeOperator>>( single_expression_operator.expression ) ) )
+				std::holds_alternative<ArenaPtr<const Synt::TakeOperator>>( single_expression_operator.expression ) ) )
 			REPORT_ERROR( DiscardingValueOfNodiscardType, names_scope.GetErrors(), Synt::GetSrcLoc( single_expression_operator.expression ), variable_ptr->type );
 
 		if( variable_ptr->no_discard )
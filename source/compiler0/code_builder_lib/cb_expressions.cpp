@@ -1944,12 +1944,21 @@ Value CodeBuilder::BuildExpressionCodeImpl(
 		if( !vfs_->IsImportingFileAllowed( full_file_path ) )
 			REPORT_ERROR( EmbeddingThisFileIsNotAllowed, names_scope.GetErrors(), embed.src_loc, full_file_path );
 
-		std::optional<IVfs::FileContent> loaded_file= vfs_->LoadFileContent( full_file_path );
+		// Load file contents as buffer in order to avoid copying of (possibly large) file contents.
+		IEmbedFilesCache::EntryPtr loaded_file;
+		if( shared_embed_files_cache_ != nullptr )
+			loaded_file= shared_embed_files_cache_->LoadFile( *vfs_, full_file_path, CalculateLongStableHash );
+		else if( IVfs::FileContentBufferPtr content= vfs_->LoadFileContentBuffer( full_file_path ); content != nullptr )
+		{
+			auto entry= std::make_shared<IEmbedFilesCache::Entry>();
+			entry->content_hash= CalculateLongStableHash( content->GetContent() );
+			entry->content= std::move(content);
+			loaded_file= std::move(entry);
+		}
 		cache_it= embed_files_cache_.emplace( std::move(full_file_path), std::move(loaded_file) ).first;
 	}
 
-	const std::optional<IVfs::FileContent> loaded_file= cache_it->second;
-	if( loaded_file == std::nullopt )
+	if( cache_it->second == nullptr )
 	{
 		REPORT_ERROR( EmbedFileNotFound, names_scope.GetErrors(), embed.src_loc, file_path );
 		return ErrorValue();
@@ -1978,11 +1987,13 @@ Value CodeBuilder::BuildExpressionCodeImpl(
 		// Do not care if in case of char8 element embedded file contents isn't valid UTF-8.
 	}
 
+	const std::string_view loaded_file= cache_it->second->content->GetContent();
+
 	llvm::Type* const element_llvm_type= GetFundamentalLLVMType( element_type );
 
 	ArrayType result_array_type;
 	result_array_type.element_type= FundamentalType( element_type, element_llvm_type );
-	result_array_type.element_count= loaded_file->size();
+	result_array_type.element_count= loaded_file.size();
 	result_array_type.llvm_type= llvm::ArrayType::get( element_llvm_type, result_array_type.element_count );
 
 	const auto result= Variable::Create(
@@ -1990,9 +2001,9 @@ Value CodeBuilder::BuildExpressionCodeImpl(
 		ValueType::ReferenceImut,
 		Variable::Location::Pointer,
 		// Use contents hash-based names for embed arrays.
-		"_embed_array_" + CalculateLongStableHash( *loaded_file ),
+		"_embed_array_" + cache_it->second->content_hash,
 		nullptr,
-		llvm::ConstantDataArray::getString( llvm_context_, *loaded_file, false /* not null terminated */ ) );
+		llvm::ConstantDataArray::getString( llvm_context_, llvm::StringRef( loaded_file.data(), loaded_file.size() ), false /* not null terminated */ ) );
 
 	result->llvm_value= CreateGlobalConstantVariable( result->type, result->name, result->constexpr_value );
 
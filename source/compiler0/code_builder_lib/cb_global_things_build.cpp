@@ -1,3 +1,7 @@
+#include "../../code_builder_lib_common/push_disable_llvm_warnings.hpp"
+#include <llvm/Support/DJB.h>
+#include "../../code_builder_lib_common/pop_llvm_warnings.hpp"
+
 #include "../../lex_synt_lib_common/assert.hpp"
 #include "keywords.hpp"
 #include "error_reporting.hpp"
@@ -275,6 +279,9 @@ void CodeBuilder::BuildFunctionsSetBodies( NamesScope& names_scope, OverloadedFu
 			continue;
 		}
 
+		if( !IsFunctionBodyInCurrentPartition( names_scope, function_variable ) )
+			continue; // Body of this function is built by other code builder instance.
+
 		if( function_variable.syntax_element != nullptr &&
 			function_variable.syntax_element->block != nullptr &&
 			!function_variable.has_body &&
@@ -290,6 +297,28 @@ void CodeBuilder::BuildFunctionsSetBodies( NamesScope& names_scope, OverloadedFu
 	}
 }
 
+bool CodeBuilder::IsFunctionBodyPartitioned( const NamesScope& names_scope, const FunctionVariable& function_variable )
+{
+	// Partition only ordinary functions of the main file.
+	// Bodies of constexpr functions are needed in each partition for constexpr evaluation.
+	// Template functions and functions from imported files may be instantiated/used in any partition - so, build them in each partition.
+	return
+		function_bodies_partitions_count_ > 1 &&
+		function_variable.constexpr_kind == FunctionVariable::ConstexprKind::NonConstexpr &&
+		!function_variable.is_generated &&
+		!names_scope.IsInsideTemplate() &&
+		IsSrcLocFromMainFile( function_variable.body_src_loc );
+}
+
+bool CodeBuilder::IsFunctionBodyInCurrentPartition( const NamesScope& names_scope, const FunctionVariable& function_variable )
+{
+	if( !IsFunctionBodyPartitioned( names_scope, function_variable ) )
+		return true;
+
+	// Use stable hash of the mangled name in order to choose the same partition for the function in all code builder instances.
+	return llvm::djbHash( function_variable.llvm_function->name_mangled ) % function_bodies_partitions_count_ == function_bodies_partition_index_;
+}
+
 void CodeBuilder::PrepareFunctionsSetAndBuildConstexprBodies( NamesScope& names_scope, OverloadedFunctionsSet& functions_set )
 {
 	PrepareFunctionsSet( names_scope, functions_set );
@@ -386,6 +415,12 @@ void CodeBuilder::GlobalThingBuildClass( const ClassPtr class_type )
 		return;
 	}
 
+	// Attribute building of template classes to their templates.
+	const auto base_template= std::get_if<Class::BaseTemplate>( &the_class.generated_class_data );
+	const TemplateInstantiationStatsCollector::Scope template_stats_scope(
+		template_instantiation_stats_collector_.get(),
+		base_template == nullptr ? nullptr : base_template->class_template.get() );
+
 	GlobalThingPrepareClassParentsList( class_type );
 
 	const Synt::Class& class_declaration= *the_class.syntax_element;
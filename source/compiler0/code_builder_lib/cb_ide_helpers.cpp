@@ -2,6 +2,7 @@
 #include "keywords.hpp"
 #include "../../lex_synt_lib_common/assert.hpp"
 #include "../lex_synt_lib/program_writer.hpp"
+#include "error_reporting.hpp"
 #include "code_builder.hpp"
 
 namespace U
@@ -46,6 +47,42 @@ std::vector<SrcLoc> CodeBuilder::GetAllOccurrences( const SrcLoc& src_loc )
 	return result;
 }
 
+std::vector< std::pair<SrcLoc, SrcLoc> > CodeBuilder::GetAllDefinitionPoints() const
+{
+	std::vector< std::pair<SrcLoc, SrcLoc> > result;
+	result.reserve( definition_points_.size() );
+	for( const auto& definition_point_pair : definition_points_ )
+		result.emplace_back( definition_point_pair.first, definition_point_pair.second.src_loc );
+
+	std::sort( result.begin(), result.end() );
+	return result;
+}
+
+CodeBuilderErrorsContainer CodeBuilder::CheckFunctions(
+	const llvm::ArrayRef< std::pair< std::vector<CompletionRequestPrefixComponent>, const Synt::Function* > > functions,
+	const Synt::MacroExpansionContexts& macro_expansion_contexts )
+{
+	// Remove errors of previous completion requests.
+	global_errors_->clear();
+
+	// Use completion request index in order to create new lambdas, rather than reusing lambdas from previous function bodies.
+	++completion_request_index_;
+
+	// Do not collect definitions, since given functions are located in another source graph with different positions.
+	const auto prev_collect_definition_points= collect_definition_points_;
+	collect_definition_points_= false;
+
+	for( const auto& prefix_and_function : functions )
+	{
+		if( const NamesScopePtr names_scope= GetNamesScopeForCompletion( prefix_and_function.first ) )
+			BuildElementForCompletionImpl( *names_scope, *prefix_and_function.second );
+	}
+
+	collect_definition_points_= prev_collect_definition_points;
+
+	return NormalizeErrors( TakeErrors(), macro_expansion_contexts );
+}
+
 void CodeBuilder::DeleteFunctionsBodies()
 {
 	// Delete bodies of in code.
@@ -437,7 +474,7 @@ void CodeBuilder::BuildElementForCompletionImpl( NamesScope& names_scope, const
 				ResolveValue( names_scope, function_context, parent_name );
 
 			// Complete names in non-sync tag.
-			if( const auto non_sync_expression= std::get_if< std::unique_ptr<const Synt::Expression> >( &class_.non_sync_tag ) )
+			if( const auto non_sync_expression= std::get_if< ArenaPtr<const Synt::Expression> >( &class_.non_sync_tag ) )
 			{
 				if( *non_sync_expression != nullptr )
 					BuildExpressionCode( **non_sync_expression, names_scope, function_context );
@@ -174,7 +174,7 @@ void CodeBuilder::ExpandNamespaceMixin( NamesScope& names_scope, Mixin& mixin )
 		Synt::NamespaceParsingResult synt_result=
 			Synt::ParseNamespaceElements(
 				*lexems,
-				source_graph_node.ast.macros, // Macros should not be modified.
+				source_graph_node.ast->macros, // Macros should not be modified.
 				source_graph_->macro_expansion_contexts, // Populate contexts, if necessary.
 				source_graph_node.file_path_hash );
 
@@ -187,11 +187,11 @@ void CodeBuilder::ExpandNamespaceMixin( NamesScope& names_scope, Mixin& mixin )
 		}
 
 		// We need to preserve syntax result, because we store raw pointers to syntax elements.
-		it= namespace_mixin_expansions_.emplace( std::move(key), std::move(synt_result.namespace_elements) ).first;
+		it= namespace_mixin_expansions_.emplace( std::move(key), std::move(synt_result) ).first;
 	}
 
-	NamesScopeFill( names_scope, it->second );
-	NamesScopeFillOutOfLineElements( names_scope, it->second );
+	NamesScopeFill( names_scope, it->second.namespace_elements );
+	NamesScopeFillOutOfLineElements( names_scope, it->second.namespace_elements );
 }
 
 void CodeBuilder::ExpandClassMixin( const ClassPtr class_type, Mixin& mixin )
@@ -219,7 +219,7 @@ void CodeBuilder::ExpandClassMixin( const ClassPtr class_type, Mixin& mixin )
 		Synt::ClassElementsParsingResult synt_result=
 			Synt::ParseClassElements(
 				*lexems,
-				source_graph_node.ast.macros, // Macros should not be modified.
+				source_graph_node.ast->macros, // Macros should not be modified.
 				source_graph_->macro_expansion_contexts, // Populate contexts, if necessary.
 				source_graph_node.file_path_hash );
 
@@ -232,7 +232,7 @@ void CodeBuilder::ExpandClassMixin( const ClassPtr class_type, Mixin& mixin )
 		}
 
 		// We need to preserve syntax result, because we store raw pointers to syntax elements.
-		it= class_mixin_expansions_.emplace( std::move(key), std::move(synt_result.class_elements) ).first;
+		it= class_mixin_expansions_.emplace( std::move(key), std::move(synt_result) ).first;
 	}
 
 	Synt::ClassKindAttribute class_kind= Synt::ClassKindAttribute::Struct;
@@ -245,7 +245,7 @@ void CodeBuilder::ExpandClassMixin( const ClassPtr class_type, Mixin& mixin )
 	else
 		class_name= class_members.GetThisNamespaceName();
 
-	FillClassNamesScope( class_type, class_name, class_kind, it->second, mixin.visibility );
+	FillClassNamesScope( class_type, class_name, class_kind, it->second.class_elements, mixin.visibility );
 }
 
 const Synt::BlockElementsList* CodeBuilder::ExpandBlockMixin( NamesScope& names_scope, FunctionContext& function_context, const Synt::Mixin& mixin )
@@ -276,7 +276,7 @@ const Synt::BlockElementsList* CodeBuilder::ExpandBlockMixin( NamesScope& names_
 		Synt::BlockElementsParsingResult synt_result=
 			Synt::ParseBlockElements(
 				*lexems,
-				source_graph_node.ast.macros, // Macros should not be modified.
+				source_graph_node.ast->macros, // Macros should not be modified.
 				source_graph_->macro_expansion_contexts, // Populate contexts, if necessary.
 				source_graph_node.file_path_hash );
 
@@ -289,10 +289,10 @@ const Synt::BlockElementsList* CodeBuilder::ExpandBlockMixin( NamesScope& names_
 		}
 
 		// We need to preserve syntax result, because we store raw pointers to syntax elements.
-		it= block_mixin_expansions_.emplace( std::move(key), std::move(synt_result.block_elements) ).first;
+		it= block_mixin_expansions_.emplace( std::move(key), std::move(synt_result) ).first;
 	}
 
-	return &it->second;
+	return &it->second.block_elements;
 }
 
 const Synt::TypeName* CodeBuilder::ExpandTypeNameMixin( NamesScope& names_scope, FunctionContext& function_context, const Synt::Mixin& mixin )
@@ -323,7 +323,7 @@ const Synt::TypeName* CodeBuilder::ExpandTypeNameMixin( NamesScope& names_scope,
 		Synt::TypeNameParsingResult synt_result=
 			Synt::ParseTypeName(
 				*lexems,
-				source_graph_node.ast.macros, // Macros should not be modified.
+				source_graph_node.ast->macros, // Macros should not be modified.
 				source_graph_->macro_expansion_contexts, // Populate contexts, if necessary.
 				source_graph_node.file_path_hash );
 
@@ -336,10 +336,10 @@ const Synt::TypeName* CodeBuilder::ExpandTypeNameMixin( NamesScope& names_scope,
 		}
 
 		// We need to preserve syntax result, because we store raw pointers to syntax elements.
-		it= type_name_mixin_expansions_.emplace( std::move(key), std::move(synt_result.type_name) ).first;
+		it= type_name_mixin_expansions_.emplace( std::move(key), std::move(synt_result) ).first;
 	}
 
-	return &it->second;
+	return &it->second.type_name;
 }
 
 const Synt::Expression* CodeBuilder::ExpandExpressionMixin( NamesScope& names_scope, FunctionContext& function_context, const Synt::Mixin& mixin )
@@ -370,7 +370,7 @@ const Synt::Expression* CodeBuilder::ExpandExpressionMixin( NamesScope& names_sc
 		Synt::ExpressionParsingResult synt_result=
 			Synt::ParseExpression(
 				*lexems,
-				source_graph_node.ast.macros, // Macros should not be modified.
+				source_graph_node.ast->macros, // Macros should not be modified.
 				source_graph_->macro_expansion_contexts, // Populate contexts, if necessary.
 				source_graph_node.file_path_hash );
 
@@ -383,10 +383,10 @@ const Synt::Expression* CodeBuilder::ExpandExpressionMixin( NamesScope& names_sc
 		}
 
 		// We need to preserve syntax result, because we store raw pointers to syntax elements.
-		it= expression_mixin_expansions_.emplace( std::move(key), std::move(synt_result.expression) ).first;
+		it= expression_mixin_expansions_.emplace( std::move(key), std::move(synt_result) ).first;
 	}
 
-	return &it->second;
+	return &it->second.expression;
 }
 
 void CodeBuilder::EvaluateMixinExpression( NamesScope& names_scope, FunctionContext& function_context, Mixin& mixin )
@@ -103,13 +103,13 @@ bool CodeBuilder::GetTypeNonSyncImpl( llvm::SmallVectorImpl<Type>& prev_types_st
 				prev_types_stack.pop_back();
 				return true;
 			}
-			else if( const auto expression_ptr= std::get_if< std::unique_ptr<const Synt::Expression> >( &class_type->syntax_element->non_sync_tag ) )
+			else if( const auto expression_ptr= std::get_if< ArenaPtr<const Synt::Expression> >( &class_type->syntax_element->non_sync_tag ) )
 			{
 				const Synt::Expression& expression= **expression_ptr;
 
 				// Evaluate non_sync condition using initial class members parent scope.
 				NamesScope& class_parent_scope= *class_type->members_initial->GetParent();
-				if( const auto non_sync_expression_ptr= std::get_if< std::unique_ptr<const Synt::NonSyncExpression> >( &expression ) )
+				if( const auto non_sync_expression_ptr= std::get_if< ArenaPtr<const Synt::NonSyncExpression> >( &expression ) )
 				{
 					// Process "non_sync</T/>" expression specially to handle cases with recursive dependencies.
 					// TODO - handle also simple logical expressions with "non_sync" tag?
@@ -204,7 +204,7 @@ bool CodeBuilder::ImmediateEvaluateNonSyncTag( NamesScope& names_scope, Function
 		return false;
 	if( std::holds_alternative<Synt::NonSyncTagTrue>( non_sync_tag ) )
 		return true;
-	if( const auto expression_ptr= std::get_if< std::unique_ptr<const Synt::Expression> >( &non_sync_tag ) )
+	if( const auto expression_ptr= std::get_if< ArenaPtr<const Synt::Expression> >( &non_sync_tag ) )
 		return EvaluateBoolConstantExpression( names_scope, function_context, **expression_ptr );
 	U_ASSERT(false); // Unhandled non_sync tag kind.
 	return false;
@@ -214,7 +214,7 @@ void CodeBuilder::CheckClassNonSyncTagExpression( const ClassPtr class_type )
 {
 	if( class_type->syntax_element != nullptr )
 	{
-		if( const auto expression_ptr= std::get_if< std::unique_ptr<const Synt::Expression> >( &class_type->syntax_element->non_sync_tag ) )
+		if( const auto expression_ptr= std::get_if< ArenaPtr<const Synt::Expression> >( &class_type->syntax_element->non_sync_tag ) )
 		{
 			WithGlobalFunctionContext(
 				[&]( FunctionContext& function_context )
@@ -743,6 +743,13 @@ const FunctionVariable* CodeBuilder::GetOverloadedFunction(
 {
 	U_ASSERT( !( first_actual_arg_is_this && actual_args.empty() ) );
 
+	// Results for the same args are the same, if functions set isn't changed. So, reuse them.
+	// This also includes selected template functions, since template functions instantiation results are cached too.
+	if( const auto cached_function= functions_set.resolution_cache.Find( functions_set, actual_args, first_actual_arg_is_this ) )
+		return cached_function;
+
+	const size_t prev_errors_count= errors_container.size();
+
 	llvm::SmallVector<OverloadingResolutionItem, 8> matched_functions;
 	FetchMatchedOverloadedFunctions( functions_set, actual_args, first_actual_arg_is_this, errors_container, src_loc, true, matched_functions );
 	if( matched_functions.empty() )
@@ -751,10 +758,22 @@ const FunctionVariable* CodeBuilder::GetOverloadedFunction(
 		return nullptr;
 	}
 
-	if( const auto item= SelectOverloadedFunction( actual_args, first_actual_arg_is_this, errors_container, src_loc, matched_functions ) )
-		return FinalizeSelectedFunction( *item, errors_container, src_loc );
+	const auto item= SelectOverloadedFunction( actual_args, first_actual_arg_is_this, errors_container, src_loc, matched_functions );
+	if( item == nullptr )
+		return nullptr;
+
+	const FunctionVariable* const function= FinalizeSelectedFunction( *item, errors_container, src_loc );
 
-	return nullptr;
+	// Cache only successful results for complete functions sets.
+	// Errors should be reported for each resolution attempt.
+	if( function != nullptr &&
+		errors_container.size() == prev_errors_count &&
+		functions_set.syntax_elements.empty() &&
+		functions_set.out_of_line_syntax_elements.empty() &&
+		functions_set.template_syntax_elements.empty() )
+		functions_set.resolution_cache.Add( functions_set, actual_args, first_actual_arg_is_this, function );
+
+	return function;
 }
 
 const FunctionVariable* CodeBuilder::GetOverloadedOperator(
@@ -415,20 +415,58 @@ CodeBuilder::NameLookupResult CodeBuilder::LookupName( NamesScope& names_scope,
 	NamesScope* last_space= &names_scope;
 	NamesScopeValue* value= nullptr;
 
+	// Scope, starting from which lookup result may be cached.
+	NamesScope* cache_scope= nullptr;
+	NamesScope::LookupCacheEntry cache_entry;
+	bool can_cache= true;
+
 	do
 	{
+		if( cache_scope == nullptr && last_space->IsLookupCacheAllowed() )
+		{
+			// Rest of the scopes chain is changed rarely. Try to reuse previous lookup result.
+			if( const auto cached_entry= last_space->GetLookupCache().Find( name, last_space->GetLookupCachesGeneration() ) )
+			{
+				value= cached_entry->value;
+				if( cached_entry->class_ != nullptr && names_scope.GetAccessFor( cached_entry->class_ ) < cached_entry->visibility )
+					REPORT_ERROR( AccessingNonpublicClassMember, names_scope.GetErrors(), src_loc, name, cached_entry->space->GetThisNamespaceName() );
+				last_space= cached_entry->space;
+				break;
+			}
+			cache_scope= last_space;
+		}
+
 		if( const auto class_type= last_space->GetClass() )
 		{
+			// Resolving in incomplete class may trigger its build, which may change lookup result.
+			can_cache&= class_type->is_complete;
+
 			const auto class_value= ResolveClassValue( class_type, name );
 			value= class_value.first;
 			if( names_scope.GetAccessFor( class_type ) < class_value.second )
 				REPORT_ERROR( AccessingNonpublicClassMember, names_scope.GetErrors(), src_loc, name, last_space->GetThisNamespaceName() );
+
+			cache_entry.class_= class_type;
+			cache_entry.visibility= class_value.second;
 		}
 		else
+		{
 			value= last_space->GetThisScopeValue( name );
 
+			cache_entry.class_= nullptr;
+			cache_entry.visibility= ClassMemberVisibility::Public;
+		}
+
 		if( value != nullptr )
+		{
+			if( cache_scope != nullptr && can_cache )
+			{
+				cache_entry.space= last_space;
+				cache_entry.value= value;
+				cache_scope->GetLookupCache().Add( name, cache_entry, cache_scope->GetLookupCachesGeneration() );
+			}
 			break;
+		}
 
 		last_space= last_space->GetParent();
 	} while( last_space != nullptr );
@@ -443,7 +481,18 @@ CodeBuilder::NameLookupResult CodeBuilder::LookupName( NamesScope& names_scope,
 
 std::pair<NamesScopeValue*, ClassMemberVisibility> CodeBuilder::ResolveClassValue( const ClassPtr class_type, const std::string_view name )
 {
-	return ResolveClassValueImpl( class_type, name );
+	// Complete classes are changed rarely, so, cache their members (including inherited ones) in order to avoid walking over parents.
+	// All necessary building is performed during first resolve.
+	if( !class_type->is_complete )
+		return ResolveClassValueImpl( class_type, name );
+
+	if( const auto cached_value= class_type->members_lookup_cache.Find( name, class_type->members->GetLookupCachesGeneration() ) )
+		return *cached_value;
+
+	const auto result= ResolveClassValueImpl( class_type, name );
+	if( result.first != nullptr )
+		class_type->members_lookup_cache.Add( name, result, class_type->members->GetLookupCachesGeneration() );
+	return result;
 }
 
 std::pair<NamesScopeValue*, ClassMemberVisibility> CodeBuilder::ResolveClassValueImpl( ClassPtr class_type, const std::string_view name, const bool recursive_call )
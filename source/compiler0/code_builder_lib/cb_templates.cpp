@@ -4,6 +4,7 @@
 #include <llvm/IR/Constant.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/GlobalVariable.h>
+#include <llvm/Support/TimeProfiler.h>
 #include "../../code_builder_lib_common/pop_llvm_warnings.hpp"
 
 #include "../../lex_synt_lib_common/assert.hpp"
@@ -18,7 +19,7 @@ namespace U
 namespace
 {
 
-void CreateTemplateErrorsContext(
+const TemplateErrorsContext& CreateTemplateErrorsContext(
 	CodeBuilderErrorsContainer& errors_container,
 	const SrcLoc& src_loc,
 	const NamesScopePtr& template_args_namespace,
@@ -69,6 +70,8 @@ void CreateTemplateErrorsContext(
 
 		template_error_context->context_name= std::move(name);
 	}
+
+	return *template_error_context;
 }
 
 void CheckSignatureParamIsValidForTemplateValueArgumentType(
@@ -565,7 +568,7 @@ TemplateSignatureParam CodeBuilder::CreateTemplateSignatureParameterImpl(
 			{
 				// Process a case with single trivial type alias.
 				// Expand it, if it's possible.
-				if( const auto type_alias_ptr= std::get_if< std::unique_ptr<const Synt::TypeAlias> >( &single_type_template->syntax_element->something ) )
+				if( const auto type_alias_ptr= std::get_if< ArenaPtr<const Synt::TypeAlias> >( &single_type_template->syntax_element->something ) )
 				{
 					if( single_type_template->signature_params.size() == specialized_template_params.size() )
 					{
@@ -1148,6 +1151,9 @@ std::optional<Type> CodeBuilder::FinishTemplateTypeGeneration(
 		// Check, if type already generated.
 		if( const auto it= generated_template_things_storage_.find( template_key ); it != generated_template_things_storage_.end() )
 		{
+			if( template_instantiation_stats_collector_ != nullptr )
+				template_instantiation_stats_collector_->AddCacheHit( type_template );
+
 			const NamesScopePtr template_parameters_space= it->second;
 			U_ASSERT( template_parameters_space != nullptr );
 			if( const auto value= template_parameters_space->GetThisScopeValue( Class::c_template_class_name ) )
@@ -1162,14 +1168,21 @@ std::optional<Type> CodeBuilder::FinishTemplateTypeGeneration(
 		AddNewTemplateThing( std::move(template_key), template_args_namespace );
 	}
 
-	CreateTemplateErrorsContext(
-		arguments_names_scope.GetErrors(),
-		src_loc,
-		template_args_namespace,
-		type_template,
-		type_template.syntax_element->name );
+	const TemplateErrorsContext& template_errors_context=
+		CreateTemplateErrorsContext(
+			arguments_names_scope.GetErrors(),
+			src_loc,
+			template_args_namespace,
+			type_template,
+			type_template.syntax_element->name );
+
+	const llvm::TimeTraceScope time_trace_scope(
+		"InstantiateTypeTemplate",
+		[&]{ return template_errors_context.context_name + " " + template_errors_context.parameters_description; } );
 
-	if( const auto class_ptr= std::get_if< std::unique_ptr<const Synt::Class> >( &type_template.syntax_element->something ) )
+	const TemplateInstantiationStatsCollector::Scope template_stats_scope( template_instantiation_stats_collector_.get(), &type_template );
+
+	if( const auto class_ptr= std::get_if< ArenaPtr<const Synt::Class> >( &type_template.syntax_element->something ) )
 	{
 		U_ASSERT( (*class_ptr)->name == Class::c_template_class_name );
 
@@ -1184,7 +1197,7 @@ std::optional<Type> CodeBuilder::FinishTemplateTypeGeneration(
 
 		return Type(class_type);
 	}
-	if( const auto type_alias= std::get_if< std::unique_ptr<const Synt::TypeAlias> >( &type_template.syntax_element->something ) )
+	if( const auto type_alias= std::get_if< ArenaPtr<const Synt::TypeAlias> >( &type_template.syntax_element->something ) )
 	{
 		Value& type_alias_value=
 			template_args_namespace->AddName(
@@ -1355,6 +1368,9 @@ const FunctionVariable* CodeBuilder::FinishTemplateFunctionGeneration(
 
 	if( const auto it= generated_template_things_storage_.find( template_key ); it != generated_template_things_storage_.end() )
 	{
+		if( template_instantiation_stats_collector_ != nullptr )
+			template_instantiation_stats_collector_->AddCacheHit( *template_key.template_ );
+
 		//Function for this template arguments already generated.
 		const NamesScopePtr template_parameters_space= it->second;
 		U_ASSERT( template_parameters_space != nullptr );
@@ -1364,9 +1380,16 @@ const FunctionVariable* CodeBuilder::FinishTemplateFunctionGeneration(
 		else
 			return nullptr; // May be in case of error or in case of "enable_if".
 	}
+	const TemplateInstantiationStatsCollector::Scope template_stats_scope( template_instantiation_stats_collector_.get(), template_key.template_.get() );
+
 	AddNewTemplateThing( std::move(template_key), template_args_namespace );
 
-	CreateTemplateErrorsContext( errors_container, src_loc, template_args_namespace, function_template, func_name );
+	const TemplateErrorsContext& template_errors_context=
+		CreateTemplateErrorsContext( errors_container, src_loc, template_args_namespace, function_template, func_name );
+
+	const llvm::TimeTraceScope time_trace_scope(
+		"InstantiateFunctionTemplate",
+		[&]{ return template_errors_context.context_name + " " + template_errors_context.parameters_description; } );
 
 	// First, prepare only as prototype.
 	NamesScopeFillFunction( *template_args_namespace, *function_template.syntax_element->function, func_name_in_namespace, function_template.base_class, ClassMemberVisibility::Public );
@@ -1444,7 +1467,14 @@ OverloadedFunctionsSetPtr CodeBuilder::ParameterizeFunctionTemplate(
 	ParameterizedFunctionTemplateKey template_key{ functions_set_ptr, arguments_calculated };
 
 	if( const auto it= parameterized_template_functions_cache_.find( template_key ); it != parameterized_template_functions_cache_.end() )
+	{
+		if( template_instantiation_stats_collector_ != nullptr )
+		{
+			for( const FunctionTemplatePtr& function_template : function_templates )
+				template_instantiation_stats_collector_->AddCacheHit( *function_template );
+		}
 		return it->second; // Already generated.
+	}
 
 	auto result= std::make_shared<OverloadedFunctionsSet>();
 	result->base_class= functions_set_ptr->base_class;
@@ -1613,8 +1643,89 @@ void CodeBuilder::FillKnownFunctionTemplateArgsIntoNamespace(
 
 void CodeBuilder::AddNewTemplateThing( TemplateKey key, NamesScopePtr thing )
 {
+	if( template_instantiation_stats_collector_ != nullptr )
+		template_instantiation_stats_collector_->AddInstantiation( *key.template_ );
+
 	generated_template_things_sequence_.push_back( key );
 	generated_template_things_storage_.insert( std::make_pair( std::move(key), std::move(thing) ) );
 }
 
+TemplateInstantiationStatsList CodeBuilder::CollectTemplateInstantiationStats()
+{
+	TemplateInstantiationStatsList result;
+	if( template_instantiation_stats_collector_ == nullptr )
+		return result;
+
+	std::unordered_map<const TemplateBase*, uint64_t> llvm_functions_count;
+	for( const auto& key_value_pair : generated_template_things_storage_ )
+		llvm_functions_count[ key_value_pair.first.template_.get() ]+= CountFunctionsWithBodies_r( *key_value_pair.second );
+
+	for( const auto& template_counters_pair : template_instantiation_stats_collector_->GetCounters() )
+	{
+		const TemplateBase& template_= *template_counters_pair.first;
+		const TemplateInstantiationStatsCollector::Counters& counters= template_counters_pair.second;
+
+		TemplateInstantiationStats stats;
+		stats.name= template_.parent_namespace->ToString();
+		if( !stats.name.empty() )
+			stats.name+= "::";
+		if( const auto type_template= dynamic_cast<const TypeTemplate*>( &template_ ) )
+			stats.name+= type_template->syntax_element->name;
+		else if( const auto function_template= dynamic_cast<const FunctionTemplate*>( &template_ ) )
+		{
+			stats.name+= function_template->syntax_element->function->name.back().name;
+			stats.is_function_template= true;
+		}
+
+		// Templates from macro expansions have no file.
+		if( const uint32_t file_index= template_.src_loc.GetFileIndex(); file_index < source_graph_->nodes_storage.size() )
+			stats.file_path= source_graph_->nodes_storage[ file_index ].file_path;
+		stats.line= template_.src_loc.GetLine();
+
+		stats.instantiations= counters.instantiations;
+		stats.cache_hits= counters.cache_hits;
+		if( const auto it= llvm_functions_count.find( &template_ ); it != llvm_functions_count.end() )
+			stats.llvm_functions= it->second;
+
+		using std::chrono::duration_cast;
+		using std::chrono::microseconds;
+		stats.total_time_us= uint64_t( duration_cast<microseconds>( counters.total_time ).count() );
+		stats.self_time_us= uint64_t( duration_cast<microseconds>( counters.self_time ).count() );
+
+		result.push_back( std::move(stats) );
+	}
+
+	return result;
+}
+
+uint64_t CodeBuilder::CountFunctionsWithBodies_r( const NamesScope& names_scope )
+{
+	uint64_t result= 0;
+	names_scope.ForEachValueInThisScope(
+		[&]( const Value& value )
+		{
+			if( const NamesScopePtr inner_namespace= value.GetNamespace() )
+				result+= CountFunctionsWithBodies_r( *inner_namespace );
+			else if( const OverloadedFunctionsSetPtr functions_set= value.GetFunctionsSet() )
+			{
+				for( const FunctionVariable& function_variable : functions_set->functions )
+				{
+					if( function_variable.llvm_function->function != nullptr && !function_variable.llvm_function->function->isDeclaration() )
+						++result;
+				}
+			}
+			else if( const Type* const type= value.GetTypeName() )
+			{
+				if( const ClassPtr class_type= type->GetClassType() )
+				{
+					// Process classes only from parent namespace.
+					// Otherwise we can get loop, using type alias.
+					if( class_type->members->GetParent() == &names_scope )
+						result+= CountFunctionsWithBodies_r( *class_type->members );
+				}
+			}
+		});
+	return result;
+}
+
 } // namespace U
@@ -368,7 +368,7 @@ llvm::FunctionType* CodeBuilder::GetLLVMFunctionType(
 CallingConvention CodeBuilder::PrepareCallingConvention(
 	NamesScope& names_scope,
 	FunctionContext& function_context,
-	const std::unique_ptr<const Synt::Expression>& calling_convention_name )
+	const ArenaPtr<const Synt::Expression>& calling_convention_name )
 {
 	if( calling_convention_name == nullptr )
 		return CallingConvention::Default;
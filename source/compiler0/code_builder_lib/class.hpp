@@ -71,6 +71,9 @@ public:
 	// Has no visibility for member, means it is public.
 	llvm::StringMap< ClassMemberVisibility > members_visibility;
 
+	// Resolved members of complete class, including inherited members.
+	NamesLookupCache< std::pair<NamesScopeValue*, ClassMemberVisibility> > members_lookup_cache;
+
 	const Synt::Class* syntax_element= nullptr;
 	SrcLoc src_loc;
 
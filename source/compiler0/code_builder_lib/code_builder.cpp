@@ -1,7 +1,9 @@
 #include "../../code_builder_lib_common/push_disable_llvm_warnings.hpp"
 #include <llvm/IR/Constant.h>
+#include <llvm/Demangle/Demangle.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/TimeProfiler.h>
 #include <llvm/TargetParser/Host.h>
 #include "../../code_builder_lib_common/pop_llvm_warnings.hpp"
 
@@ -59,7 +61,12 @@ CodeBuilder::BuildResult CodeBuilder::BuildProgram(
 	for( const auto& pair : code_builder.embed_files_cache_ )
 		embedded_files.push_back( pair.first );
 
-	return BuildResult{ code_builder.TakeErrors(), std::move(code_builder.module_), std::move(embedded_files) };
+	return BuildResult{
+		code_builder.TakeErrors(),
+		std::move(code_builder.module_),
+		std::move(embedded_files),
+		code_builder.CollectTemplateInstantiationStats(),
+		std::move(code_builder.unused_global_names_errors_) };
 }
 
 std::unique_ptr<CodeBuilder> CodeBuilder::BuildProgramAndLeaveInternalState(
@@ -110,11 +117,15 @@ CodeBuilder::CodeBuilder(
 	, report_about_unused_names_( options.report_about_unused_names )
 	, collect_definition_points_( options.collect_definition_points )
 	, skip_building_generated_functions_( options.skip_building_generated_functions )
+	, function_bodies_partitions_count_( options.function_bodies_partitions_count )
+	, function_bodies_partition_index_( options.function_bodies_partition_index )
 	, vfs_( std::move(vfs) )
+	, shared_embed_files_cache_( options.embed_files_cache )
 	, calling_convention_infos_( CreateCallingConventionInfos( target_triple_, data_layout_ ) )
 	, constexpr_function_evaluator_( data_layout_ )
 	, mangler_( CreateMangler( options.mangling_scheme, data_layout_ ) )
 	, tbaa_metadata_builder_( llvm_context_, data_layout, mangler_ )
+	, template_instantiation_stats_collector_( options.collect_template_instantiation_stats ? std::make_unique<TemplateInstantiationStatsCollector>() : nullptr )
 {
 	fundamental_llvm_types_.i8_  = llvm::Type::getInt8Ty  ( llvm_context_ );
 	fundamental_llvm_types_.u8_  = llvm::Type::getInt8Ty  ( llvm_context_ );
@@ -299,7 +310,17 @@ void CodeBuilder::BuildProgramInternal( const SourceGraphPtr& source_graph )
 	}
 
 	// Check for unused names in root file.
+	const size_t errors_count_before_unused_names_check= global_errors_->size();
 	CheckForUnusedGlobalNames( *compiled_sources_[0].names_map );
+	if( function_bodies_partitions_count_ > 1 )
+	{
+		// Some names may be referenced only within functions bodies of other partitions, so, collect unused names errors separately.
+		unused_global_names_errors_.assign(
+			std::make_move_iterator( global_errors_->begin() + std::ptrdiff_t(errors_count_before_unused_names_check) ),
+			std::make_move_iterator( global_errors_->end() ) );
+		global_errors_->resize( errors_count_before_unused_names_check );
+		unused_global_names_errors_= NormalizeErrors( unused_global_names_errors_, *source_graph->macro_expansion_contexts );
+	}
 
 	// Leave internal structures intact.
 
@@ -353,6 +374,7 @@ void CodeBuilder::BuildSourceGraphNode( const SourceGraph& source_graph, const s
 
 	result.names_map= std::make_unique<NamesScope>( "", nullptr );
 	result.names_map->SetErrors( global_errors_ );
+	result.names_map->SetLookupCachesGenerationCounter( &lookup_caches_generation_ );
 
 	if( source_graph_node.child_nodes_indices.empty() )
 	{
@@ -375,10 +397,16 @@ void CodeBuilder::BuildSourceGraphNode( const SourceGraph& source_graph, const s
 	}
 
 	// Do work for this node.
-	NamesScopeFill( *result.names_map, source_graph_node.ast.program_elements );
-	NamesScopeFillOutOfLineElements( *result.names_map, source_graph_node.ast.program_elements );
-	ProcessMixins( *result.names_map );
-	GlobalThingBuildNamespace( *result.names_map );
+	{
+		const llvm::TimeTraceScope time_trace_scope( "NamesScopeFill", source_graph_node.file_path );
+		NamesScopeFill( *result.names_map, source_graph_node.ast->program_elements );
+		NamesScopeFillOutOfLineElements( *result.names_map, source_graph_node.ast->program_elements );
+		ProcessMixins( *result.names_map );
+	}
+	{
+		const llvm::TimeTraceScope time_trace_scope( "GlobalThingsBuild", source_graph_node.file_path );
+		GlobalThingBuildNamespace( *result.names_map );
+	}
 
 	// In case of language server (with generated functions building skipping) do not build internals of templates,
 	// if it's not necessary.
@@ -387,11 +415,17 @@ void CodeBuilder::BuildSourceGraphNode( const SourceGraph& source_graph, const s
 	// like errors in non-called functions or errors in static asserts.
 	if( !skip_building_generated_functions_ )
 	{
+		const llvm::TimeTraceScope time_trace_scope( "TemplateThingsBuild", source_graph_node.file_path );
+
 		// Finalize building template things.
 		// Each new template thing added into this vector, so, by iterating through we will build all template things.
 		// It's important to use an index instead of iterators during iteration because this vector may be chaged in process.
 		for( size_t i= 0; i < generated_template_things_sequence_.size(); ++i )
 		{
+			const TemplateInstantiationStatsCollector::Scope template_stats_scope(
+				template_instantiation_stats_collector_.get(),
+				generated_template_things_sequence_[i].template_.get() );
+
 			const NamesScopePtr namespace_= generated_template_things_storage_[generated_template_things_sequence_[i]];
 			GlobalThingBuildNamespace( *namespace_ );
 		}
@@ -464,6 +498,8 @@ void CodeBuilder::MergeNameScopes(
 								class_namespace_copy->CopyAccessRightsFrom( *src_members_namespace );
 								// It's fine to modify "members", since we preserve actual namespaces in the table.
 								class_->members= class_namespace_copy;
+								// Cached lookups may contain values from previous members namespace of this class.
+								dst.InvalidateLookupCaches();
 							}
 						}
 					}
@@ -1585,6 +1621,8 @@ void CodeBuilder::BuildFuncCode(
 
 	llvm::Function* const llvm_function= EnsureLLVMFunctionCreated( func_variable );
 
+	const llvm::TimeTraceScope time_trace_scope( "BuildFunction", [&]{ return llvm::demangle( llvm_function->getName().str() ); } );
+
 	// Mark this function specially in order to prevent its execution in constexpr context during its building.
 	llvm_function->setMetadata( "__U_incomplete_function_marker", llvm::MDNode::get( llvm_context_, {} ) );
 
@@ -1633,6 +1671,15 @@ void CodeBuilder::BuildFuncCode(
 		llvm_function->setVisibility( visibility );
 	}
 
+	if( llvm_function->hasPrivateLinkage() && IsFunctionBodyPartitioned( parent_names_scope, func_variable ) )
+	{
+		// This function may be called from functions of other partitions, where it is only declared.
+		// So, use external linkage for now. Private linkage should be restored after linking of all partitions.
+		llvm_function->setLinkage( llvm::GlobalValue::ExternalLinkage );
+		llvm_function->setVisibility( llvm::GlobalValue::HiddenVisibility );
+		llvm_function->setMetadata( c_partition_private_function_metadata_name, llvm::MDNode::get( llvm_context_, {} ) );
+	}
+
 	// Ensure completeness only for functions body.
 	// Require full completeness even for reference arguments.
 	for( const FunctionType::Param& param : function_type.params )
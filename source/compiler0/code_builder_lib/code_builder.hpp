@@ -10,9 +10,11 @@
 #include <llvm/IR/Module.h>
 #include "../../code_builder_lib_common/pop_llvm_warnings.hpp"
 
+#include "../lex_synt_lib/i_embed_files_cache.hpp"
 #include "../lex_synt_lib/source_graph_loader.hpp"
 #include "../../code_builder_lib_common/interpreter.hpp"
 #include "../../code_builder_lib_common/mangling.hpp"
+#include "../../code_builder_lib_common/template_instantiation_stats.hpp"
 #include "calling_convention_info.hpp"
 #include "class.hpp"
 #include "debug_info_builder.hpp"
@@ -21,6 +23,7 @@
 #include "lambdas.hpp"
 #include "mangling.hpp"
 #include "tbaa_metadata_builder.hpp"
+#include "template_instantiation_stats_collector.hpp"
 #include "template_signature_param.hpp"
 #include "template_types.hpp"
 
@@ -39,9 +42,23 @@ struct CodeBuilderOptions
 	// Such option produces incomplete module, but for some cases (testing, language server) it is enough.
 	// The main reason for this option to exist is to speed-up code for such purposes.
 	bool skip_building_generated_functions= false;
+	// Collect counts and time of templates instantiations. This slightly slows down compilation.
+	bool collect_template_instantiation_stats= false;
+	// If partitions count is greater than 1, bodies of non-template non-constexpr functions of the main file are distributed between partitions
+	// and only bodies of functions of given partition are built. All other things are built as usual.
+	// Result modules of all partitions (built by different code builder instances) should be linked together, see "c_partition_private_function_metadata_name".
+	uint32_t function_bodies_partitions_count= 1;
+	uint32_t function_bodies_partition_index= 0;
 	ManglingScheme mangling_scheme= ManglingScheme::ItaniumABI;
+	// Optional cache for embedded files, which may be shared between code builder instances. Should outlive the code builder.
+	IEmbedFilesCache* embed_files_cache= nullptr;
 };
 
+// Functions which bodies are built only in one of partitions have external linkage, since they may be called from other partitions.
+// Functions which should have private linkage are marked with metadata with this name.
+// Linkage of such functions should be changed to private after linking of modules of all partitions.
+constexpr const char c_partition_private_function_metadata_name[]= "__U_partition_private_function";
+
 class CodeBuilder
 {
 public:
@@ -50,6 +67,11 @@ public:
 		std::vector<CodeBuilderError> errors;
 		std::unique_ptr<llvm::Module> module;
 		std::vector<IVfs::Path> embedded_files;
+		TemplateInstantiationStatsList template_instantiation_stats; // Empty if collection isn't enabled.
+		// Filled instead of reporting into "errors" if functions bodies partitioning is enabled,
+		// since some global names may be used only within functions of other partitions.
+		// Only errors reported for all partitions should be considered.
+		CodeBuilderErrorsContainer unused_global_names_errors;
 	};
 
 	using CompletionRequestPrefixComponent= std::variant<
@@ -119,6 +141,10 @@ public: // IDE helpers.
 	// Result lost is sorted and contains unique entrires.
 	std::vector<SrcLoc> GetAllOccurrences( const SrcLoc& src_loc );
 
+	// Get all collected pairs of usage point and definition point.
+	// Works only if definition collection is enabled in options.
+	std::vector< std::pair<SrcLoc, SrcLoc> > GetAllDefinitionPoints() const;
+
 	// Try to compile given program element, including internal completion syntax element.
 	// Return completion result.
 	// Prefix is used to find proper namespace/class (name lookups are used).
@@ -149,6 +175,14 @@ public: // IDE helpers.
 		return SignatureHelpResultFinalize();
 	}
 
+	// Build given functions (including bodies) using existing program state and return errors for them.
+	// This allows to check modified functions without full rebuilding, if nothing else was changed.
+	// Each function is specified together with prefix, like for completion.
+	// Macro expansion contexts are used for errors normalization and should be taken from source graph of given functions.
+	CodeBuilderErrorsContainer CheckFunctions(
+		llvm::ArrayRef< std::pair< std::vector<CompletionRequestPrefixComponent>, const Synt::Function* > > functions,
+		const Synt::MacroExpansionContexts& macro_expansion_contexts );
+
 	// Delete bodies of functions (excepth constexpr ones).
 	// This breaks result module and should not be used for a program compilation (with result object file).
 	// But this is usable for ide helpers in order to reduce memory usage.
@@ -290,7 +324,7 @@ private:
 	Type PrepareType( const Synt::TypeName& type_name, NamesScope& names_scope, FunctionContext& function_context );
 
 	template<typename T>
-	Type PrepareTypeImpl( NamesScope& names_scope, FunctionContext& function_context, const std::unique_ptr<T>& el )
+	Type PrepareTypeImpl( NamesScope& names_scope, FunctionContext& function_context, const ArenaPtr<T>& el )
 	{
 		return PrepareTypeImpl( names_scope, function_context, *el );
 	}
@@ -323,7 +357,7 @@ private:
 	CallingConvention PrepareCallingConvention(
 		NamesScope& names_scope,
 		FunctionContext& function_context,
-		const std::unique_ptr<const Synt::Expression>& calling_convention_name );
+		const ArenaPtr<const Synt::Expression>& calling_convention_name );
 
 	llvm::CallingConv::ID GetLLVMCallingConvention( CallingConvention calling_convention );
 
@@ -403,7 +437,7 @@ private:
 		FunctionContext& function_context,
 		llvm::ArrayRef<TemplateParameter> template_parameters,
 		llvm::SmallVectorImpl<bool>& template_parameters_usage_flags,
-		const std::unique_ptr<T>& el )
+		const ArenaPtr<T>& el )
 	{
 		return CreateTemplateSignatureParameterImpl( names_scope, function_context, template_parameters, template_parameters_usage_flags, *el );
 	}
@@ -608,6 +642,9 @@ private:
 
 	void AddNewTemplateThing( TemplateKey key, NamesScopePtr thing );
 
+	TemplateInstantiationStatsList CollectTemplateInstantiationStats();
+	static uint64_t CountFunctionsWithBodies_r( const NamesScope& names_scope );
+
 	// Constructors/destructors
 	void TryGenerateDefaultConstructor( ClassPtr class_type );
 	void TryGenerateCopyConstructor( ClassPtr class_type );
@@ -742,7 +779,7 @@ private:
 	Value BuildExpressionCode( const Synt::Expression& expression, NamesScope& names_scope, FunctionContext& function_context );
 
 	template<typename T>
-	Value BuildExpressionCodeImpl( NamesScope& names_scope, FunctionContext& function_context, const std::unique_ptr<T>& el )
+	Value BuildExpressionCodeImpl( NamesScope& names_scope, FunctionContext& function_context, const ArenaPtr<T>& el )
 	{
 		return BuildExpressionCodeImpl( names_scope, function_context, *el );
 	}
@@ -1051,7 +1088,7 @@ private:
 	Value ResolveValue( NamesScope& names_scope, FunctionContext& function_context, const Synt::ComplexName& complex_name );
 
 	template<typename T>
-	Value ResolveValueImpl( NamesScope& names_scope, FunctionContext& function_context, const std::unique_ptr<T>& el )
+	Value ResolveValueImpl( NamesScope& names_scope, FunctionContext& function_context, const ArenaPtr<T>& el )
 	{
 		return ResolveValueImpl( names_scope, function_context, *el );
 	}
@@ -1387,6 +1424,9 @@ private:
 	void GlobalThingBuildNamespace( NamesScope& names_scope );
 	void PrepareFunctionsSet( NamesScope& names_scope, OverloadedFunctionsSet& functions_set );
 	void BuildFunctionsSetBodies( NamesScope& names_scope, OverloadedFunctionsSet& functions_set );
+	// Returns true if body of this function should be built only in one of functions bodies partitions.
+	bool IsFunctionBodyPartitioned( const NamesScope& names_scope, const FunctionVariable& function_variable );
+	bool IsFunctionBodyInCurrentPartition( const NamesScope& names_scope, const FunctionVariable& function_variable );
 	void PrepareFunctionsSetAndBuildConstexprBodies( NamesScope& names_scope, OverloadedFunctionsSet& functions_set );
 	void GlobalThingPrepareClassParentsList( ClassPtr class_type );
 	void GlobalThingBuildClass( ClassPtr class_type );
@@ -1475,10 +1515,13 @@ private:
 	const bool generate_lifetime_start_end_debug_calls_;
 	const bool generate_tbaa_metadata_;
 	const bool report_about_unused_names_;
-	const bool collect_definition_points_;
+	bool collect_definition_points_;
 	bool skip_building_generated_functions_;
+	const uint32_t function_bodies_partitions_count_;
+	const uint32_t function_bodies_partition_index_;
 
 	const IVfsSharedPtr vfs_;
+	IEmbedFilesCache* const shared_embed_files_cache_; // May be null.
 	const CallingConventionInfos calling_convention_infos_;
 
 	struct
@@ -1547,6 +1590,10 @@ private:
 
 	std::unique_ptr<llvm::Module> module_;
 	const std::shared_ptr<CodeBuilderErrorsContainer> global_errors_= std::make_shared<CodeBuilderErrorsContainer>();
+	CodeBuilderErrorsContainer unused_global_names_errors_; // Used only for functions bodies partitioning.
+
+	// Incremented after changes in names scopes of this code builder, which may affect cached lookup results.
+	uint64_t lookup_caches_generation_= 1;
 
 	// Current source graph.
 	// Store shared_ptr because we need to keep it alive, because some internal structures contain raw pointers to its contents.
@@ -1575,6 +1622,9 @@ private:
 	// Cache results of template functions parameterization.
 	std::unordered_map<ParameterizedFunctionTemplateKey, OverloadedFunctionsSetPtr, ParameterizedFunctionTemplateKeyHasher> parameterized_template_functions_cache_;
 
+	// Null if stats collection isn't enabled.
+	const std::unique_ptr<TemplateInstantiationStatsCollector> template_instantiation_stats_collector_;
+
 	std::vector<GlobalThing> global_things_stack_;
 
 	std::optional<DebugInfoBuilder> debug_info_builder_;
@@ -1584,19 +1634,19 @@ private:
 	std::unordered_map<LambdaKey, std::unique_ptr<Class>, LambdaKeyHasher> lambda_classes_table_;
 	std::unique_ptr<Class> lambda_preprocessing_dummy_class_; // Lazily created.
 
-	// Store here mixin expansion results, because we need syntax elements to be alive, because they may be accessed during code building via raw pointers.
+	// Store here mixin expansion results (together with arenas of their syntax elements), because we need syntax elements to be alive, because they may be accessed during code building via raw pointers.
 	// Also it's useful to reuse expansions of same mixins in different templates if result text is identical.
 	// Important note: unordered_map doesn't invalidate pointers/references to elements after new elements are inserted.
 	// This makes it safe to store somewhere pointers to elements of this container, assuming no elements are deleted.
 	template<typename T> using MixinExpansionsMap= std::unordered_map<MixinExpansionKey, T, MixinExpansionKeyHasher>;
-	MixinExpansionsMap<Synt::ProgramElementsList> namespace_mixin_expansions_;
-	MixinExpansionsMap<Synt::ClassElementsList> class_mixin_expansions_;
-	MixinExpansionsMap<Synt::BlockElementsList> block_mixin_expansions_;
-	MixinExpansionsMap<Synt::TypeName> type_name_mixin_expansions_;
-	MixinExpansionsMap<Synt::Expression> expression_mixin_expansions_;
+	MixinExpansionsMap<Synt::NamespaceParsingResult> namespace_mixin_expansions_;
+	MixinExpansionsMap<Synt::ClassElementsParsingResult> class_mixin_expansions_;
+	MixinExpansionsMap<Synt::BlockElementsParsingResult> block_mixin_expansions_;
+	MixinExpansionsMap<Synt::TypeNameParsingResult> type_name_mixin_expansions_;
+	MixinExpansionsMap<Synt::ExpressionParsingResult> expression_mixin_expansions_;
 
 	// Full file path to file contents map.
-	std::unordered_map<IVfs::Path, std::optional<IVfs::FileContent>> embed_files_cache_;
+	std::unordered_map<IVfs::Path, IEmbedFilesCache::EntryPtr> embed_files_cache_; // Contains null for files which can't be loaded.
 
 	// Definition points. Collected during code building (if it is required).
 	// Only single result is stored, that affects template stuff and other places in source code with multiple building passes.
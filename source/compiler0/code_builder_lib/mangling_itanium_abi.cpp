@@ -27,9 +27,39 @@ public:
 public:
 	class NodeHolder;
 
+	struct NodeBound
+	{
+		LenType pos;
+		bool is_start;
+	};
+
+	// Uncompressed encoding of some element (type, namespace) with bounds of its nodes.
+	// It doesn't depend on previously encoded elements, so, it may be reused.
+	// Replaying of such encoding performs the same substitutions as encoding of the element itself.
+	struct EncodedPart
+	{
+		std::string full;
+		llvm::SmallVector<NodeBound, 8> nodes_bounds;
+	};
+
+	struct PartStart
+	{
+		LenType pos;
+		size_t nodes_bounds_index;
+	};
+
+	PartStart StartPart() const;
+	EncodedPart FinishPart( const PartStart& start ) const;
+	void ReplayPart( const EncodedPart& part );
+
+	// Caches for already encoded elements. They are preserved between mangling of different names.
+	std::unordered_map<Type, EncodedPart, TypeHasher> types_cache;
+	std::unordered_map<const NamesScope*, EncodedPart> namespace_prefixes_cache;
+
 private:
 	LenType GetCurrentPos() const;
 	LenType GetCurrentCompressedPos() const;
+	void BeginNode();
 	void FinalizePart( LenType start, LenType compressed_start );
 
 private:
@@ -43,6 +73,8 @@ private:
 	llvm::SmallVector<Substitution, 16> substitutions_;
 	std::string result_full_;
 	std::string result_compressed_;
+	// Bounds of all nodes of current name in order of their creation and finalization.
+	std::vector<NodeBound> nodes_bounds_;
 };
 
 // Mangling with Itanium ABI rules.
@@ -101,16 +133,64 @@ std::string ManglerState::TakeResult()
 	substitutions_.clear();
 	result_full_.clear();
 	result_compressed_.clear();
+	nodes_bounds_.clear();
 
 	return result;
 }
 
+ManglerState::PartStart ManglerState::StartPart() const
+{
+	return PartStart{ GetCurrentPos(), nodes_bounds_.size() };
+}
+
+ManglerState::EncodedPart ManglerState::FinishPart( const PartStart& start ) const
+{
+	EncodedPart part;
+	part.full= result_full_.substr( start.pos );
+
+	part.nodes_bounds.reserve( nodes_bounds_.size() - start.nodes_bounds_index );
+	for( size_t i= start.nodes_bounds_index; i < nodes_bounds_.size(); ++i )
+		part.nodes_bounds.push_back( NodeBound{ LenType( nodes_bounds_[i].pos - start.pos ), nodes_bounds_[i].is_start } );
+
+	return part;
+}
+
+void ManglerState::ReplayPart( const EncodedPart& part )
+{
+	// Repeat the same sequence of actions as during the initial encoding of this part.
+	llvm::SmallVector<std::pair<LenType, LenType>, 8> nodes_stack;
+
+	size_t pos= 0;
+	for( const NodeBound& bound : part.nodes_bounds )
+	{
+		Push( std::string_view(part.full).substr( pos, bound.pos - pos ) );
+		pos= bound.pos;
+
+		if( bound.is_start )
+		{
+			nodes_stack.emplace_back( GetCurrentPos(), GetCurrentCompressedPos() );
+			BeginNode();
+		}
+		else
+		{
+			U_ASSERT( !nodes_stack.empty() );
+			FinalizePart( nodes_stack.back().first, nodes_stack.back().second );
+			nodes_stack.pop_back();
+		}
+	}
+	U_ASSERT( nodes_stack.empty() );
+
+	Push( std::string_view(part.full).substr( pos ) );
+}
+
 class ManglerState::NodeHolder
 {
 public:
 	explicit NodeHolder( ManglerState& state )
 		: state_(state), start_(state.GetCurrentPos()), compressed_start_(state.GetCurrentCompressedPos())
-	{}
+	{
+		state_.BeginNode();
+	}
 
 	~NodeHolder()
 	{
@@ -133,10 +213,17 @@ ManglerState::LenType ManglerState::GetCurrentCompressedPos() const
 	return LenType( result_compressed_.size() );
 }
 
+void ManglerState::BeginNode()
+{
+	nodes_bounds_.push_back( NodeBound{ GetCurrentPos(), true } );
+}
+
 void ManglerState::FinalizePart( const LenType start, const LenType compressed_start )
 {
 	U_ASSERT( start <= result_full_.size() );
 	U_ASSERT( compressed_start <= result_compressed_.size() );
+	nodes_bounds_.push_back( NodeBound{ GetCurrentPos(), false } );
+
 	const auto size= LenType( result_full_.size() - start );
 
 	const std::string_view current_part= std::string_view(result_full_).substr( start, size );
@@ -340,7 +427,22 @@ void EncodeLambdaClassName( ManglerState& mangler_state, const Class& the_class
 	}
 }
 
+void EncodeNamespacePrefixImpl( ManglerState& mangler_state, const NamesScope& names_scope );
+
 void EncodeNamespacePrefix_r( ManglerState& mangler_state, const NamesScope& names_scope )
+{
+	if( const auto it= mangler_state.namespace_prefixes_cache.find( &names_scope ); it != mangler_state.namespace_prefixes_cache.end() )
+	{
+		mangler_state.ReplayPart( it->second );
+		return;
+	}
+
+	const ManglerState::PartStart part_start= mangler_state.StartPart();
+	EncodeNamespacePrefixImpl( mangler_state, names_scope );
+	mangler_state.namespace_prefixes_cache.emplace( &names_scope, mangler_state.FinishPart( part_start ) );
+}
+
+void EncodeNamespacePrefixImpl( ManglerState& mangler_state, const NamesScope& names_scope )
 {
 	if( const ClassPtr the_class= names_scope.GetClass() )
 	{
@@ -624,11 +726,31 @@ void EncodeCoroutineType( ManglerState& mangler_state, const ClassPtr class_type
 	mangler_state.Push( 'E' );
 }
 
+void EncodeTypeNameImpl( ManglerState& mangler_state, const Type& type );
+
 void EncodeTypeName( ManglerState& mangler_state, const Type& type )
 {
+	// Fundamental types are trivial, there is no reason to cache them.
 	if( const auto fundamental_type= type.GetFundamentalType() )
+	{
 		mangler_state.Push( EncodeFundamentalType( fundamental_type->fundamental_type ) );
-	else if( const auto array_type= type.GetArrayType() )
+		return;
+	}
+
+	if( const auto it= mangler_state.types_cache.find( type ); it != mangler_state.types_cache.end() )
+	{
+		mangler_state.ReplayPart( it->second );
+		return;
+	}
+
+	const ManglerState::PartStart part_start= mangler_state.StartPart();
+	EncodeTypeNameImpl( mangler_state, type );
+	mangler_state.types_cache.emplace( type, mangler_state.FinishPart( part_start ) );
+}
+
+void EncodeTypeNameImpl( ManglerState& mangler_state, const Type& type )
+{
+	if( const auto array_type= type.GetArrayType() )
 	{
 		const ManglerState::NodeHolder result_node( mangler_state );
 		mangler_state.Push( 'A' );
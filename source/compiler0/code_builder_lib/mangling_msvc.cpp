@@ -239,14 +239,37 @@ private:
 	void EncodeReturnInnerReferences( ManglerState& mangler_state, const FunctionType::ReturnInnerReferences& return_inner_references ) const;
 	void EncodeParamReference( ManglerState& mangler_state, const FunctionType::ParamReference& param_reference ) const;
 
+	template<typename EncodeFunc>
+	const std::string& GetTemplateName( const Type& type, const EncodeFunc& encode_func ) const;
+
 private:
 	const std::string_view pointer_types_modifier_;
+
+	// Template names of types are encoded using separate backreferences tables, so, they don't depend on context and may be reused.
+	mutable std::unordered_map<Type, std::string, TypeHasher> template_names_cache_;
 };
 
 ManglerMSVC::ManglerMSVC(const bool is_32_bit)
 	: pointer_types_modifier_(is_32_bit ? "" : "E")
 {}
 
+template<typename EncodeFunc>
+const std::string& ManglerMSVC::GetTemplateName( const Type& type, const EncodeFunc& encode_func ) const
+{
+	if( const auto it= template_names_cache_.find( type ); it != template_names_cache_.end() )
+		return it->second;
+
+	// Use separate backreferences table.
+	std::string template_name;
+	{
+		ManglerState template_mangler_state( template_name );
+		encode_func( template_mangler_state );
+	}
+
+	// It's fine to return reference to map value, since it isn't invalidated by insertion of other values.
+	return template_names_cache_.emplace( type, std::move(template_name) ).first->second;
+}
+
 std::string ManglerMSVC::MangleFunction(
 	const NamesScope& parent_scope,
 	const std::string_view function_name,
@@ -369,20 +392,20 @@ void ManglerMSVC::EncodeType( ManglerState& mangler_state, const Type& type ) co
 		// Encode tuples, like type templates.
 		mangler_state.PushElement( g_class_type_prefix );
 
-		// Use separate backreferences table.
-		std::string template_name;
-		{
-			ManglerState template_mangler_state( template_name );
-
-			template_mangler_state.PushElement( g_template_prefix );
-			template_mangler_state.EncodeName( Keyword( Keywords::tup_ ) );
+		const std::string& template_name=
+			GetTemplateName(
+				type,
+				[&]( ManglerState& template_mangler_state )
+				{
+					template_mangler_state.PushElement( g_template_prefix );
+					template_mangler_state.EncodeName( Keyword( Keywords::tup_ ) );
 
-			for( const Type& element_type : tuple_type->element_types )
-				EncodeTemplateArgImpl( template_mangler_state, element_type );
+					for( const Type& element_type : tuple_type->element_types )
+						EncodeTemplateArgImpl( template_mangler_state, element_type );
 
-			// Finish list of template arguments.
-			template_mangler_state.PushElement( g_terminator );
-		}
+					// Finish list of template arguments.
+					template_mangler_state.PushElement( g_terminator );
+				} );
 		mangler_state.EncodeNameNoTerminator( template_name );
 		// Finish class name.
 		mangler_state.PushElement( g_terminator );
@@ -395,17 +418,17 @@ void ManglerMSVC::EncodeType( ManglerState& mangler_state, const Type& type ) co
 		{
 			// Encode typeinfo, like type template.
 
-			// Use separate backreferences table.
-			std::string template_name;
-			{
-				ManglerState template_mangler_state( template_name );
-
-				template_mangler_state.PushElement( g_template_prefix );
-				template_mangler_state.EncodeName( class_type->members->GetThisNamespaceName() );
-				EncodeType( template_mangler_state, typeinfo_class_description->source_type );
-				// Finish list of template arguments.
-				template_mangler_state.PushElement( g_terminator );
-			}
+			const std::string& template_name=
+				GetTemplateName(
+					type,
+					[&]( ManglerState& template_mangler_state )
+					{
+						template_mangler_state.PushElement( g_template_prefix );
+						template_mangler_state.EncodeName( class_type->members->GetThisNamespaceName() );
+						EncodeType( template_mangler_state, typeinfo_class_description->source_type );
+						// Finish list of template arguments.
+						template_mangler_state.PushElement( g_terminator );
+					} );
 			mangler_state.EncodeNameNoTerminator( template_name );
 			// Finish class name.
 			mangler_state.PushElement( g_terminator );
@@ -708,15 +731,15 @@ void ManglerMSVC::EncodeTemplateClassName( ManglerState& mangler_state, const Cl
 	const TypeTemplatePtr& type_template= base_template->class_template;
 	const auto namespace_containing_template= type_template->parent_namespace;
 
-	// Use separate backreferences table.
-	std::string template_name;
-	{
-		ManglerState template_mangler_state( template_name );
-
-		template_mangler_state.PushElement( g_template_prefix );
-		template_mangler_state.EncodeName( type_template->syntax_element->name );
-		EncodeTemplateArgs( template_mangler_state, base_template->signature_args );
-	}
+	const std::string& template_name=
+		GetTemplateName(
+			the_class,
+			[&]( ManglerState& template_mangler_state )
+			{
+				template_mangler_state.PushElement( g_template_prefix );
+				template_mangler_state.EncodeName( type_template->syntax_element->name );
+				EncodeTemplateArgs( template_mangler_state, base_template->signature_args );
+			} );
 	mangler_state.EncodeNameNoTerminator( template_name );
 
 	if( namespace_containing_template->GetParent() != nullptr )
@@ -735,15 +758,15 @@ void ManglerMSVC::EncodeLambdaClassName( ManglerState& mangler_state, const Clas
 	}
 	else
 	{
-		// Use separate backreferences table.
-		std::string template_name;
-		{
-			ManglerState template_mangler_state( template_name );
-
-			template_mangler_state.PushElement( g_template_prefix );
-			template_mangler_state.EncodeName( the_class->members->GetThisNamespaceName() );
-			EncodeTemplateArgs( template_mangler_state, lambda_class_data->template_args );
-		}
+		const std::string& template_name=
+			GetTemplateName(
+				the_class,
+				[&]( ManglerState& template_mangler_state )
+				{
+					template_mangler_state.PushElement( g_template_prefix );
+					template_mangler_state.EncodeName( the_class->members->GetThisNamespaceName() );
+					EncodeTemplateArgs( template_mangler_state, lambda_class_data->template_args );
+				} );
 		mangler_state.EncodeNameNoTerminator( template_name );
 
 		EncodeNamespacePostfix_r( mangler_state, *the_class->members->GetParent()->GetParent() );
@@ -756,47 +779,47 @@ void ManglerMSVC::EncodeCoroutineClassName( ManglerState& mangler_state, const C
 	U_ASSERT( coroutine_type_description != nullptr );
 
 	// Encode coroutine as template.
-	// Use separate backreferences table.
-	std::string template_name;
-	{
-		ManglerState template_mangler_state( template_name );
-
-		template_mangler_state.PushElement( g_template_prefix );
-		template_mangler_state.EncodeName( the_class->members->GetThisNamespaceName() );
+	const std::string& template_name=
+		GetTemplateName(
+			the_class,
+			[&]( ManglerState& template_mangler_state )
+			{
+				template_mangler_state.PushElement( g_template_prefix );
+				template_mangler_state.EncodeName( the_class->members->GetThisNamespaceName() );
 
-		// Return value.
-		if( coroutine_type_description->return_value_type != ValueType::Value )
-		{
-			template_mangler_state.PushElement( g_reference_prefix );
-			template_mangler_state.PushElement( pointer_types_modifier_ );
-			template_mangler_state.PushElement( coroutine_type_description->return_value_type == ValueType::ReferenceMut ? g_mut_prefix : g_imut_prefix );
-		}
-		EncodeType( template_mangler_state, coroutine_type_description->return_type );
+				// Return value.
+				if( coroutine_type_description->return_value_type != ValueType::Value )
+				{
+					template_mangler_state.PushElement( g_reference_prefix );
+					template_mangler_state.PushElement( pointer_types_modifier_ );
+					template_mangler_state.PushElement( coroutine_type_description->return_value_type == ValueType::ReferenceMut ? g_mut_prefix : g_imut_prefix );
+				}
+				EncodeType( template_mangler_state, coroutine_type_description->return_type );
 
-		// non-sync tag.
-		if( coroutine_type_description->non_sync )
-		{
-			template_mangler_state.PushElement( GetFundamentalTypeMangledName( U_FundamentalType::bool_ ) );
-			template_mangler_state.PushElement( g_numeric_template_arg_prefix );
-			EncodeNumber( template_mangler_state, llvm::APInt( 1u, uint64_t(1) ), false );
-		}
+				// non-sync tag.
+				if( coroutine_type_description->non_sync )
+				{
+					template_mangler_state.PushElement( GetFundamentalTypeMangledName( U_FundamentalType::bool_ ) );
+					template_mangler_state.PushElement( g_numeric_template_arg_prefix );
+					EncodeNumber( template_mangler_state, llvm::APInt( 1u, uint64_t(1) ), false );
+				}
 
-		// Inner references.
-		for( const InnerReferenceKind inner_reference : coroutine_type_description->inner_references )
-		{
-			template_mangler_state.PushElement( GetFundamentalTypeMangledName( U_FundamentalType::u32_ ) );
-			template_mangler_state.PushElement( g_numeric_template_arg_prefix );
-			EncodeNumber( template_mangler_state, llvm::APInt( 64u, uint64_t(inner_reference) ), false );
-		}
+				// Inner references.
+				for( const InnerReferenceKind inner_reference : coroutine_type_description->inner_references )
+				{
+					template_mangler_state.PushElement( GetFundamentalTypeMangledName( U_FundamentalType::u32_ ) );
+					template_mangler_state.PushElement( g_numeric_template_arg_prefix );
+					EncodeNumber( template_mangler_state, llvm::APInt( 64u, uint64_t(inner_reference) ), false );
+				}
 
-		if( !coroutine_type_description->return_references.empty() )
-			EncodeReturnReferences( template_mangler_state, coroutine_type_description->return_references );
-		if( !coroutine_type_description->return_inner_references.empty() )
-			EncodeReturnInnerReferences( template_mangler_state, coroutine_type_description->return_inner_references );
+				if( !coroutine_type_description->return_references.empty() )
+					EncodeReturnReferences( template_mangler_state, coroutine_type_description->return_references );
+				if( !coroutine_type_description->return_inner_references.empty() )
+					EncodeReturnInnerReferences( template_mangler_state, coroutine_type_description->return_inner_references );
 
-		// Finish list of template arguments.
-		template_mangler_state.PushElement( g_terminator );
-	}
+				// Finish list of template arguments.
+				template_mangler_state.PushElement( g_terminator );
+			} );
 	mangler_state.EncodeNameNoTerminator( template_name );
 }
 
@@ -10,6 +10,8 @@ namespace U
 NamesScope::NamesScope( std::string name, NamesScope* const parent )
 	: name_(std::move(name) )
 	, parent_(parent)
+	, is_lookup_cache_allowed_( !IsLocal() && ( parent_ == nullptr || parent_->is_lookup_cache_allowed_ ) )
+	, lookup_caches_generation_( parent_ == nullptr ? nullptr : parent_->lookup_caches_generation_ )
 {}
 
 const std::string& NamesScope::GetThisNamespaceName() const
@@ -37,13 +39,19 @@ NamesScopeValue* NamesScope::AddName( const std::string_view name, NamesScopeVal
 	auto it_bool_pair= names_map_.insert( std::make_pair( llvm::StringRef(name), std::move( value ) ) );
 
 	if( it_bool_pair.second )
+	{
+		// Local scopes can't affect cached lookups, since cache isn't used for them and their children.
+		if( used_for_lookup_ && !IsLocal() )
+			InvalidateLookupCaches();
 		return &it_bool_pair.first->second;
+	}
 
 	return nullptr;
 }
 
 NamesScopeValue* NamesScope::GetThisScopeValue( const std::string_view name )
 {
+	used_for_lookup_= true;
 	const auto it= names_map_.find( name );
 	if( it != names_map_.end() )
 		return &it->second;
@@ -55,6 +63,39 @@ const NamesScopeValue* NamesScope::GetThisScopeValue( const std::string_view nam
 	return const_cast<NamesScope*>(this)->GetThisScopeValue( name );
 }
 
+bool NamesScope::IsLocal() const
+{
+	return name_.empty() && parent_ != nullptr;
+}
+
+bool NamesScope::IsLookupCacheAllowed() const
+{
+	return is_lookup_cache_allowed_ && lookup_caches_generation_ != nullptr;
+}
+
+NamesLookupCache<NamesScope::LookupCacheEntry>& NamesScope::GetLookupCache()
+{
+	return lookup_cache_;
+}
+
+void NamesScope::SetLookupCachesGenerationCounter( uint64_t* const counter )
+{
+	U_ASSERT( parent_ == nullptr );
+	lookup_caches_generation_= counter;
+}
+
+uint64_t NamesScope::GetLookupCachesGeneration() const
+{
+	U_ASSERT( lookup_caches_generation_ != nullptr );
+	return *lookup_caches_generation_;
+}
+
+void NamesScope::InvalidateLookupCaches()
+{
+	if( lookup_caches_generation_ != nullptr )
+		++*lookup_caches_generation_;
+}
+
 NamesScope* NamesScope::GetParent()
 {
 	return parent_;
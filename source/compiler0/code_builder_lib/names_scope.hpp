@@ -10,6 +10,21 @@ namespace U
 
 using Synt::ClassMemberVisibility;
 
+// Cache for names lookup results.
+// It's invalidated as whole after addition of a name into a non-local names scope, where some name was searched before.
+// Current generation should be obtained from names scope.
+template<typename T>
+class NamesLookupCache
+{
+public:
+	T* Find( std::string_view name, uint64_t current_generation );
+	void Add( std::string_view name, T value, uint64_t current_generation );
+
+private:
+	llvm::StringMap<T> map_;
+	uint64_t generation_= 0;
+};
+
 class NamesScope
 {
 public:
@@ -30,6 +45,30 @@ public:
 	NamesScopeValue* GetThisScopeValue( std::string_view name );
 	const NamesScopeValue* GetThisScopeValue( std::string_view name ) const;
 
+	// Local scopes are unnamed scopes of functions and their blocks. They are changed frequently, so, lookups in them aren't cached.
+	bool IsLocal() const;
+	// Lookup cache may be used only in non-local scopes without local parents.
+	bool IsLookupCacheAllowed() const;
+
+	struct LookupCacheEntry
+	{
+		NamesScope* space= nullptr;
+		NamesScopeValue* value= nullptr;
+		ClassPtr class_= nullptr; // Class, where value was found, if it was found in a class.
+		ClassMemberVisibility visibility= ClassMemberVisibility::Public;
+	};
+
+	// Cached results of names lookup, starting from this scope.
+	NamesLookupCache<LookupCacheEntry>& GetLookupCache();
+
+	// Set counter of lookup caches generation for root scope. Child scopes inherit it.
+	// Counter should be common for all scopes trees of single code builder,
+	// since cached lookup results may depend on many scopes, including scopes of parent classes from other files.
+	void SetLookupCachesGenerationCounter( uint64_t* counter );
+	uint64_t GetLookupCachesGeneration() const;
+	// Call it after changes, which aren't tracked automatically.
+	void InvalidateLookupCaches();
+
 	NamesScope* GetParent();
 	const NamesScope* GetParent() const;
 	NamesScope* GetRoot();
@@ -90,6 +129,10 @@ public:
 private:
 	const std::string name_;
 	NamesScope* const parent_;
+	const bool is_lookup_cache_allowed_;
+	uint64_t* lookup_caches_generation_= nullptr;
+	// Set if this scope was used for names lookup. Addition of a name into such scope may change lookup results.
+	bool used_for_lookup_= false;
 
 	ClassPtr class_= nullptr;
 
@@ -99,6 +142,36 @@ private:
 	std::unordered_map<ClassPtr, ClassMemberVisibility> access_rights_;
 
 	std::shared_ptr<CodeBuilderErrorsContainer> errors_;
+
+	NamesLookupCache<LookupCacheEntry> lookup_cache_;
 };
 
+template<typename T>
+T* NamesLookupCache<T>::Find( const std::string_view name, const uint64_t current_generation )
+{
+	if( generation_ != current_generation )
+	{
+		map_.clear();
+		generation_= current_generation;
+		return nullptr;
+	}
+
+	const auto it= map_.find( name );
+	if( it != map_.end() )
+		return &it->second;
+	return nullptr;
+}
+
+template<typename T>
+void NamesLookupCache<T>::Add( const std::string_view name, T value, const uint64_t current_generation )
+{
+	if( generation_ != current_generation )
+	{
+		map_.clear();
+		generation_= current_generation;
+	}
+
+	map_.insert_or_assign( name, std::move(value) );
+}
+
 } // namespace U
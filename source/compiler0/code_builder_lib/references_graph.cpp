@@ -1,3 +1,4 @@
+#include <algorithm>
 #include "../../code_builder_lib_common/push_disable_llvm_warnings.hpp"
 #include <llvm/ADT/Hashing.h>
 #include "../../code_builder_lib_common/pop_llvm_warnings.hpp"
@@ -9,16 +10,28 @@
 namespace U
 {
 
-bool ReferencesGraph::Link::operator==( const ReferencesGraph::Link& r ) const
+ReferencesGraph::ReferencesGraph( const ReferencesGraph& other )
 {
-	return this->src == r.src && this->dst == r.dst;
+	other.FreezeChanges();
+	layer_= other.layer_;
+}
+
+ReferencesGraph& ReferencesGraph::operator=( const ReferencesGraph& other )
+{
+	if( this != &other )
+	{
+		other.FreezeChanges();
+		layer_= other.layer_;
+		changes_.clear();
+	}
+	return *this;
 }
 
 void ReferencesGraph::AddNode( const VariablePtr& node )
 {
 	U_ASSERT( node != nullptr );
-	U_ASSERT( nodes_.count(node) == 0 );
-	nodes_.emplace( node, NodeState() );
+	U_ASSERT( GetNodeState(node) == nullptr );
+	AddNodeState( node, NodeState() );
 
 	if( node->parent.lock() == nullptr )
 		for( const VariablePtr& inner_reference_node : node->inner_reference_nodes )
@@ -27,8 +40,8 @@ void ReferencesGraph::AddNode( const VariablePtr& node )
 
 void ReferencesGraph::AddNodeIfNotExists( const VariablePtr& node )
 {
-	if( nodes_.count( node ) == 0 )
-		nodes_.emplace( node, NodeState() );
+	if( GetNodeState( node ) == nullptr )
+		AddNodeState( node, NodeState() );
 
 	for( const VariablePtr& inner_reference_node : node->inner_reference_nodes )
 		AddNodeIfNotExists( inner_reference_node );
@@ -36,7 +49,7 @@ void ReferencesGraph::AddNodeIfNotExists( const VariablePtr& node )
 
 void ReferencesGraph::RemoveNode( const VariablePtr& node )
 {
-	if( nodes_.count(node) == 0 )
+	if( GetNodeState(node) == nullptr )
 		return;
 
 	if( node->parent.lock() == nullptr )
@@ -49,26 +62,25 @@ void ReferencesGraph::RemoveNode( const VariablePtr& node )
 
 	RemoveNodeLinks( node );
 
-	nodes_.erase( node );
+	EraseNodeState( node );
 }
 
 void ReferencesGraph::AddLink( const VariablePtr& from, const VariablePtr& to )
 {
 	U_ASSERT( from != nullptr );
 	U_ASSERT( to != nullptr );
-	U_ASSERT( nodes_.count(from) != 0 );
-	U_ASSERT( nodes_.count(to  ) != 0 );
+	U_ASSERT( GetNodeState(from) != nullptr );
+	U_ASSERT( GetNodeState(to  ) != nullptr );
 
 	if( from == to )
 		return;
 
-	Link link{from, to};
-	for( const Link& prev_lik : links_ )
-	{
-		if( link == prev_lik )
-			return;
-	}
-	links_.push_back( std::move(link) );
+	const NodeState& from_state= *GetNodeState( from );
+	if( std::find( from_state.out_links.begin(), from_state.out_links.end(), to ) != from_state.out_links.end() )
+		return; // Already has such link.
+
+	GetNodeStateForModification( from ).out_links.push_back( to );
+	GetNodeStateForModification( to ).in_links.push_back( from );
 }
 
 void ReferencesGraph::TryAddLink( const VariablePtr& from, const VariablePtr& to, CodeBuilderErrorsContainer& errors_container, const SrcLoc& src_loc )
@@ -178,9 +190,9 @@ bool ReferencesGraph::HasOutgoingMutableNodes( const VariablePtr& from ) const
 
 void ReferencesGraph::MoveNode( const VariablePtr& node )
 {
-	U_ASSERT( nodes_.count(node) != 0 );
+	U_ASSERT( GetNodeState(node) != nullptr );
 
-	NodeState& node_state= nodes_[node];
+	NodeState& node_state= GetNodeStateForModification( node );
 
 	U_ASSERT( !node_state.moved );
 	node_state.moved= true;
@@ -190,7 +202,7 @@ void ReferencesGraph::MoveNode( const VariablePtr& node )
 
 	// Move child nodes first in order to replace links from children with links from parent.
 	for( const VariablePtr& child : node->children )
-		if( child != nullptr && nodes_.count(child) != 0 ) // Children nodes are lazily-added.
+		if( child != nullptr && GetNodeState(child) != nullptr ) // Children nodes are lazily-added.
 			MoveNode( child );
 
 	RemoveNodeLinks( node );
@@ -198,11 +210,11 @@ void ReferencesGraph::MoveNode( const VariablePtr& node )
 
 bool ReferencesGraph::NodeMoved( const VariablePtr& node ) const
 {
-	const auto it= nodes_.find(node);
-	if( it == nodes_.end() ) // Can be for global constants, for example.
+	const NodeState* const node_state= GetNodeState( node );
+	if( node_state == nullptr ) // Can be for global constants, for example.
 		return false;
 
-	return it->second.moved;
+	return node_state->moved;
 }
 
 ReferencesGraph::NodesSet ReferencesGraph::GetAllAccessibleVariableNodes( const VariablePtr& node ) const
@@ -219,9 +231,8 @@ ReferencesGraph::NodesSet ReferencesGraph::GetNodeInputLinks( const VariablePtr&
 	VariablePtr current_node= node;
 	do
 	{
-		for( const Link& link : links_ )
-			if( link.dst == current_node )
-				result.insert( link.src );
+		if( const NodeState* const node_state= GetNodeState( current_node ) )
+			result.insert( node_state->in_links.begin(), node_state->in_links.end() );
 
 		current_node= current_node->parent.lock();
 	}
@@ -244,32 +255,72 @@ void ReferencesGraph::TryAddLinkToAllAccessibleVariableNodesInnerReferences( con
 	TryAddLinkToAllAccessibleVariableNodesInnerReferences_r( from, to, errors_container, src_loc );
 }
 
+template<typename Func>
+void ReferencesGraph::ForEachNode( const Func& func ) const
+{
+	// Visit each node only once, in its most recent state.
+	NodesSet visited_nodes;
+
+	for( const auto& node_pair : changes_ )
+	{
+		visited_nodes.insert( node_pair.first );
+		if( node_pair.second != std::nullopt )
+			func( node_pair.first, *node_pair.second );
+	}
+
+	for( const Layer* layer= layer_.get(); layer != nullptr; layer= layer->parent.get() )
+	{
+		for( const auto& node_pair : layer->nodes )
+		{
+			if( visited_nodes.insert( node_pair.first ).second && node_pair.second != std::nullopt )
+				func( node_pair.first, *node_pair.second );
+		}
+	}
+}
+
 ReferencesGraph::MergeResult ReferencesGraph::MergeVariablesStateAfterIf( const llvm::ArrayRef<ReferencesGraph> branches_variables_state, const SrcLoc& src_loc )
 {
 	ReferencesGraph result;
 	std::vector<CodeBuilderError> errors;
 
+	if( branches_variables_state.empty() )
+		return std::make_pair( std::move(result), std::move(errors) );
+
+	// Start with state of first branch. It's cheap, since layers are shared.
+	result= branches_variables_state.front();
+
 	// Number of nodes in different branches may be different - child nodes and global variable nodes may be added.
 
-	for( const ReferencesGraph& branch_state : branches_variables_state )
+	for( const ReferencesGraph& branch_state : branches_variables_state.drop_front() )
 	{
-		for( const auto& node_pair : branch_state.nodes_ )
-		{
-			if( result.nodes_.find( node_pair.first ) == result.nodes_.end() )
-				result.nodes_[ node_pair.first ]= node_pair.second;
+		// Branches are usually created from the same state and thus share most of layers.
+		// So, process only nodes changed in this branch or in result, other nodes have same states.
+		const NodesSet changed_nodes= GetChangedNodes( result, branch_state );
 
-			const NodeState& src_state= node_pair.second;
-			const NodeState& result_state= result.nodes_[ node_pair.first ];
+		for( const VariablePtr& node : changed_nodes )
+		{
+			const NodeState* const branch_node_state= branch_state.GetNodeState( node );
+			if( branch_node_state == nullptr )
+				continue;
 
-			if( result_state.moved != src_state.moved )
-				REPORT_ERROR( ConditionalMove, errors, src_loc, node_pair.first->name );
+			if( const NodeState* const result_state= result.GetNodeState( node ) )
+			{
+				if( result_state->moved != branch_node_state->moved )
+					REPORT_ERROR( ConditionalMove, errors, src_loc, node->name );
+			}
+			else
+			{
+				NodeState state;
+				state.moved= branch_node_state->moved;
+				result.AddNodeState( node, std::move(state) );
+			}
 		}
 
-		for( const auto& src_link : branch_state.links_ )
-		{
-			if( std::find( result.links_.begin(), result.links_.end(), src_link ) == result.links_.end() )
-				result.links_.push_back( src_link );
-		}
+		// Link changes affect both nodes, so, it's enough to process only links of changed nodes.
+		for( const VariablePtr& node : changed_nodes )
+			if( const NodeState* const branch_node_state= branch_state.GetNodeState( node ) )
+				for( const VariablePtr& dst : branch_node_state->out_links )
+					result.AddLink( node, dst );
 	}
 
 	// Technically it's possible to create mutliple mutable references to same node or mutable reference + immutable reference.
@@ -284,43 +335,153 @@ std::vector<CodeBuilderError> ReferencesGraph::CheckVariablesStateAfterLoop( con
 {
 	std::vector<CodeBuilderError> errors;
 
-	U_ASSERT( state_before.nodes_.size() <= state_after.nodes_.size() ); // Child nodes and global variable nodes may be added.
+	// State wasn't changed in loop.
+	if( GetChangedNodes( state_before, state_after ).empty() )
+		return errors;
 
-	for( const auto& var_before : state_before.nodes_ )
-	{
-		const VariablePtr& node= var_before.first;
-		U_ASSERT( state_after.nodes_.find(node) != state_after.nodes_.end() );
-		const auto& var_after= *state_after.nodes_.find( node );
+	state_before.ForEachNode(
+		[&]( const VariablePtr& node, const NodeState& node_state_before )
+		{
+			const NodeState* const var_after_state= state_after.GetNodeState( node );
+			U_ASSERT( var_after_state != nullptr ); // Child nodes and global variable nodes may be added, but not removed.
 
-		if( !var_before.second.moved && var_after.second.moved )
-			REPORT_ERROR( OuterVariableMoveInsideLoop, errors, src_loc, var_before.first->name );
+			if( !node_state_before.moved && var_after_state->moved )
+				REPORT_ERROR( OuterVariableMoveInsideLoop, errors, src_loc, node->name );
 
-		if( node->value_type == ValueType::Value )
-		{
-			// If this is a variable node with inner references check if no input links was added in loop body.
-			// Reference nodes also may have inner reference nodes, but adding of input links (pollution) for them is not possible, so, ignore them.
-			for( const VariablePtr& inner_reference_node : node->inner_reference_nodes )
+			if( node->value_type == ValueType::Value )
 			{
-				const NodesSet nodes_before= state_before.GetNodeInputLinks( inner_reference_node );
-				NodesSet nodes_after= state_after.GetNodeInputLinks( inner_reference_node );
-				for( const auto& node : nodes_before )
-					nodes_after.erase(node);
-
-				for( const auto& newly_linked_node : nodes_after )
-					REPORT_ERROR( ReferencePollutionOfOuterLoopVariable, errors, src_loc, node->name, newly_linked_node->name );
+				// If this is a variable node with inner references check if no input links was added in loop body.
+				// Reference nodes also may have inner reference nodes, but adding of input links (pollution) for them is not possible, so, ignore them.
+				for( const VariablePtr& inner_reference_node : node->inner_reference_nodes )
+				{
+					const NodesSet nodes_before= state_before.GetNodeInputLinks( inner_reference_node );
+					NodesSet nodes_after= state_after.GetNodeInputLinks( inner_reference_node );
+					for( const auto& node : nodes_before )
+						nodes_after.erase(node);
+
+					for( const auto& newly_linked_node : nodes_after )
+						REPORT_ERROR( ReferencePollutionOfOuterLoopVariable, errors, src_loc, node->name, newly_linked_node->name );
+				}
 			}
+		} );
+
+	return errors;
+}
+
+void ReferencesGraph::FreezeChanges() const
+{
+	if( changes_.empty() )
+		return;
+
+	auto layer= std::make_shared<Layer>();
+	layer->nodes= std::move(changes_);
+	changes_.clear();
+
+	// Merge previous layers into new one while they aren't much bigger.
+	// Thus layers sizes grow geometrically and layers chain remains short.
+	LayerPtr parent= layer_;
+	while( parent != nullptr && parent->nodes.size() <= layer->nodes.size() * 2 )
+	{
+		for( const auto& node_pair : parent->nodes )
+			layer->nodes.insert( node_pair ); // Doesn't replace newer states.
+		parent= parent->parent;
+	}
+
+	if( parent == nullptr )
+	{
+		// There is no need to keep removed nodes in the bottom layer.
+		for( auto it= layer->nodes.begin(); it != layer->nodes.end(); )
+		{
+			if( it->second == std::nullopt )
+				it= layer->nodes.erase( it );
+			else
+				++it;
 		}
 	}
-	return errors;
+
+	layer->parent= std::move(parent);
+	layer_= std::move(layer);
 }
 
-bool ReferencesGraph::HasDirectOutgoingLinks( const VariablePtr& from ) const
+ReferencesGraph::NodesSet ReferencesGraph::GetChangedNodes( const ReferencesGraph& l, const ReferencesGraph& r )
 {
-	for( const auto& link : links_ )
-		if( link.src == from )
-			return true;
+	// Find closest common layer. Layers chains are short, so, it's fine to use linear search.
+	llvm::SmallVector<const Layer*, 16> l_layers;
+	for( const Layer* layer= l.layer_.get(); layer != nullptr; layer= layer->parent.get() )
+		l_layers.push_back( layer );
 
-	return false;
+	const Layer* common_layer= nullptr;
+	for( const Layer* layer= r.layer_.get(); layer != nullptr; layer= layer->parent.get() )
+	{
+		if( std::find( l_layers.begin(), l_layers.end(), layer ) != l_layers.end() )
+		{
+			common_layer= layer;
+			break;
+		}
+	}
+
+	NodesSet result;
+	CollectChangedNodes( l, common_layer, result );
+	CollectChangedNodes( r, common_layer, result );
+	return result;
+}
+
+void ReferencesGraph::CollectChangedNodes( const ReferencesGraph& graph, const Layer* const common_layer, NodesSet& out_nodes )
+{
+	for( const auto& node_pair : graph.changes_ )
+		out_nodes.insert( node_pair.first );
+
+	for( const Layer* layer= graph.layer_.get(); layer != common_layer; layer= layer->parent.get() )
+		for( const auto& node_pair : layer->nodes )
+			out_nodes.insert( node_pair.first );
+}
+
+const ReferencesGraph::NodeState* ReferencesGraph::GetNodeState( const VariablePtr& node ) const
+{
+	if( const auto it= changes_.find( node ); it != changes_.end() )
+		return it->second == std::nullopt ? nullptr : &*it->second;
+
+	for( const Layer* layer= layer_.get(); layer != nullptr; layer= layer->parent.get() )
+	{
+		if( const auto it= layer->nodes.find( node ); it != layer->nodes.end() )
+			return it->second == std::nullopt ? nullptr : &*it->second;
+	}
+
+	return nullptr;
+}
+
+ReferencesGraph::NodeState& ReferencesGraph::GetNodeStateForModification( const VariablePtr& node )
+{
+	if( const auto it= changes_.find( node ); it != changes_.end() )
+	{
+		U_ASSERT( it->second != std::nullopt );
+		return *it->second;
+	}
+
+	// Copy state of only this node from shared layers.
+	const NodeState* const node_state= GetNodeState( node );
+	U_ASSERT( node_state != nullptr );
+	return *changes_.emplace( node, *node_state ).first->second;
+}
+
+void ReferencesGraph::AddNodeState( const VariablePtr& node, NodeState state )
+{
+	changes_[node]= std::move(state);
+}
+
+void ReferencesGraph::EraseNodeState( const VariablePtr& node )
+{
+	changes_.erase( node );
+
+	// Mark node as removed if it still exists in shared layers.
+	if( GetNodeState( node ) != nullptr )
+		changes_.emplace( node, std::nullopt );
+}
+
+bool ReferencesGraph::HasDirectOutgoingLinks( const VariablePtr& from ) const
+{
+	const NodeState* const node_state= GetNodeState( from );
+	return node_state != nullptr && !node_state->out_links.empty();
 }
 
 bool ReferencesGraph::HasOutgoingLinksIncludingChildrenLinks_r( const VariablePtr& from ) const
@@ -330,7 +491,7 @@ bool ReferencesGraph::HasOutgoingLinksIncludingChildrenLinks_r( const VariablePt
 
 	for( const VariablePtr& child : from->children )
 		if( child != nullptr &&
-			nodes_.count(child) != 0 && // Children nodes are lazily-added.
+			GetNodeState(child) != nullptr && // Children nodes are lazily-added.
 			HasOutgoingLinksIncludingChildrenLinks_r( child ) )
 			return true;
 
@@ -339,9 +500,12 @@ bool ReferencesGraph::HasOutgoingLinksIncludingChildrenLinks_r( const VariablePt
 
 bool ReferencesGraph::HasDirectOutgoingMutableNodes( const VariablePtr& from ) const
 {
-	for( const auto& link : links_ )
-		if( link.src == from && link.dst->value_type == ValueType::ReferenceMut )
-			return true;
+	if( const NodeState* const node_state= GetNodeState( from ) )
+	{
+		for( const VariablePtr& dst : node_state->out_links )
+			if( dst->value_type == ValueType::ReferenceMut )
+				return true;
+	}
 
 	return false;
 }
@@ -353,7 +517,7 @@ bool ReferencesGraph::HasOutgoingMutableNodesIncludingChildrenNodes_r( const Var
 
 	for( const VariablePtr& child : from->children )
 		if( child != nullptr &&
-			nodes_.count(child) != 0 && // Children nodes are lazily-added.
+			GetNodeState(child) != nullptr && // Children nodes are lazily-added.
 			HasOutgoingMutableNodesIncludingChildrenNodes_r( child ) )
 			return true;
 
@@ -362,31 +526,27 @@ bool ReferencesGraph::HasOutgoingMutableNodesIncludingChildrenNodes_r( const Var
 
 void ReferencesGraph::RemoveNodeLinks( const VariablePtr& node )
 {
-	// Collect in/out nodes.
-	NodesSet in_nodes;
-	NodesSet out_nodes;
-	for( const Link& link : links_ )
-	{
-		if( link.src == link.dst ) // Self loop link.
-			continue;
+	const NodeState* const node_state= GetNodeState( node );
+	if( node_state == nullptr || ( node_state->in_links.empty() && node_state->out_links.empty() ) )
+		return;
 
-		if( link.src == node )
-			out_nodes.insert( link.dst );
-		if( link.dst == node )
-			in_nodes.insert( link.src );
-	}
+	// Collect in/out nodes and remove links.
+	NodeState& state= GetNodeStateForModification( node );
+
+	const llvm::SmallVector<VariablePtr, 2> in_nodes= std::move( state.in_links );
+	const llvm::SmallVector<VariablePtr, 2> out_nodes= std::move( state.out_links );
+	state.in_links.clear();
+	state.out_links.clear();
 
-	// Remove links.
-	for( size_t i= 0; i < links_.size(); )
+	for( const VariablePtr& src : in_nodes )
 	{
-		if( links_[i].src == node || links_[i].dst == node )
-		{
-			if( i + 1 < links_.size() )
-				links_[i]= std::move( links_.back() );
-			links_.pop_back();
-		}
-		else
-			++i;
+		auto& src_out_links= GetNodeStateForModification( src ).out_links;
+		src_out_links.erase( std::remove( src_out_links.begin(), src_out_links.end(), node ), src_out_links.end() );
+	}
+	for( const VariablePtr& dst : out_nodes )
+	{
+		auto& dst_in_links= GetNodeStateForModification( dst ).in_links;
+		dst_in_links.erase( std::remove( dst_in_links.begin(), dst_in_links.end(), node ), dst_in_links.end() );
 	}
 
 	// Create new links.
@@ -409,7 +569,8 @@ void ReferencesGraph::GetAllAccessibleVariableNodes_r(
 	NodesSet& visited_nodes_set,
 	NodesSet& result_set ) const
 {
-	U_ASSERT( nodes_.find(node) != nodes_.end() );
+	const NodeState* const node_state= GetNodeState( node );
+	U_ASSERT( node_state != nullptr );
 
 	if( !visited_nodes_set.insert(node).second )
 		return; // Already visited
@@ -417,9 +578,8 @@ void ReferencesGraph::GetAllAccessibleVariableNodes_r(
 	if( node->value_type == ValueType::Value )
 		result_set.emplace( node );
 
-	for( const auto& link : links_ )
-		if( link.dst == node )
-			GetAllAccessibleVariableNodes_r( link.src, visited_nodes_set, result_set );
+	for( const VariablePtr& src : node_state->in_links )
+		GetAllAccessibleVariableNodes_r( src, visited_nodes_set, result_set );
 
 	if( const VariablePtr parent= node->parent.lock() )
 		GetAllAccessibleVariableNodes_r( parent, visited_nodes_set, result_set );
@@ -435,17 +595,18 @@ void ReferencesGraph::GetAllAccessibleNonInnerNodes_r(
 	if( !visited_nodes_set.insert(node).second )
 		return; // Already visited
 
-	for( const auto& link : links_ )
+	const NodeState* const node_state= GetNodeState( node );
+	if( node_state == nullptr )
+		return;
+
+	for( const VariablePtr& src : node_state->in_links )
 	{
-		if( link.dst == node )
+		if( src->is_inner_reference_node )
+			GetAllAccessibleNonInnerNodes_r( src, visited_nodes_set, result_set );
+		else
 		{
-			if( link.src->is_inner_reference_node )
-				GetAllAccessibleNonInnerNodes_r( link.src, visited_nodes_set, result_set );
-			else
-			{
-				// Do not go further if a variable/reference or child node is reached.
-				result_set.insert( link.src );
-			}
+			// Do not go further if a variable/reference or child node is reached.
+			result_set.insert( src );
 		}
 	}
 }
@@ -459,9 +620,8 @@ void ReferencesGraph::TryAddLinkToAllAccessibleVariableNodesInnerReferences_r( c
 		// Fill container with reachable nodes and only that perform recursive calls.
 		// Do this in order to avoid iteration over container of links, which may be modified in recursive call.
 		llvm::SmallVector< VariablePtr, 12 > src_nodes;
-		for( const Link& link : links_ )
-			if( link.dst == to )
-				src_nodes.push_back( link.src );
+		if( const NodeState* const node_state= GetNodeState( to ) )
+			src_nodes.append( node_state->in_links.begin(), node_state->in_links.end() );
 
 		for( const VariablePtr& src_node : src_nodes )
 			TryAddLinkToAllAccessibleVariableNodesInnerReferences_r( from, src_node, errors_container, src_loc );
@@ -482,10 +642,14 @@ bool ReferencesGraph::IsNodeReachable_r( const VariablePtr& from, const Variable
 	if( !visited_nodes_set.insert(to).second )
 		return false; // Already visited
 
-	for( const auto& link : links_ )
+	if( const NodeState* const node_state= GetNodeState( to ) )
 	{
-		if( link.dst == to && IsNodeReachable_r( from, link.src, visited_nodes_set ) )
-			return true;
+		// Copy is not needed here, since graph isn't modified during this search.
+		for( const VariablePtr& src : node_state->in_links )
+		{
+			if( IsNodeReachable_r( from, src, visited_nodes_set ) )
+				return true;
+		}
 	}
 
 	if( const VariablePtr parent= to->parent.lock() )
@@ -1,8 +1,12 @@
 #pragma once
 #include <memory>
+#include <optional>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
+#include "../../code_builder_lib_common/push_disable_llvm_warnings.hpp"
+#include <llvm/ADT/SmallVector.h>
+#include "../../code_builder_lib_common/pop_llvm_warnings.hpp"
 #include "../../code_builder_lib_common/code_builder_errors.hpp"
 #include "value.hpp"
 
@@ -12,6 +16,13 @@ namespace U
 class ReferencesGraph
 {
 public:
+	ReferencesGraph()= default;
+	// Copying makes current changes of source graph shared. It's cheap.
+	ReferencesGraph( const ReferencesGraph& other );
+	ReferencesGraph( ReferencesGraph&& other )= default;
+	ReferencesGraph& operator=( const ReferencesGraph& other );
+	ReferencesGraph& operator=( ReferencesGraph&& other )= default;
+
 	void AddNode( const VariablePtr& node );
 	void AddNodeIfNotExists( const VariablePtr& node );
 
@@ -61,17 +72,37 @@ private:
 	struct NodeState
 	{
 		bool moved= false;
+		// Destinations of links from this node and sources of links to this node. There are no duplicates.
+		llvm::SmallVector<VariablePtr, 2> out_links;
+		llvm::SmallVector<VariablePtr, 2> in_links;
 	};
 
-	struct Link
-	{
-		VariablePtr src;
-		VariablePtr dst;
+	// Empty optional means removed node.
+	using NodesChangesMap= std::unordered_map<VariablePtr, std::optional<NodeState>>;
 
-		bool operator==( const Link& r ) const;
+	// Immutable set of changes on top of parent layer.
+	struct Layer
+	{
+		std::shared_ptr<const Layer> parent;
+		NodesChangesMap nodes;
 	};
+	using LayerPtr= std::shared_ptr<const Layer>;
 
 private:
+	// Move current changes into new layer, which may be shared with copies of this graph.
+	void FreezeChanges() const;
+	// Returns nodes, which states may be different in given graphs.
+	static NodesSet GetChangedNodes( const ReferencesGraph& l, const ReferencesGraph& r );
+	static void CollectChangedNodes( const ReferencesGraph& graph, const Layer* common_layer, NodesSet& out_nodes );
+
+	template<typename Func> void ForEachNode( const Func& func ) const;
+
+	const NodeState* GetNodeState( const VariablePtr& node ) const;
+	// Copies node state into current changes if necessary. Node should exist.
+	NodeState& GetNodeStateForModification( const VariablePtr& node );
+	void AddNodeState( const VariablePtr& node, NodeState state );
+	void EraseNodeState( const VariablePtr& node );
+
 	bool HasDirectOutgoingLinks( const VariablePtr& from ) const;
 	bool HasOutgoingLinksIncludingChildrenLinks_r( const VariablePtr& from ) const;
 
@@ -89,8 +120,13 @@ private:
 	bool IsNodeReachable_r( const VariablePtr& from, const VariablePtr& to, NodesSet& visited_nodes_set ) const;
 
 private:
-	std::unordered_map<VariablePtr, NodeState> nodes_;
-	std::vector<Link> links_; // Check for duplicates before insertion!
+	// Graph is copied frequently (for each branch or loop), but copies are usually modified only slightly.
+	// So, store node states as chain of shared immutable layers with changes and own changes on top of them.
+	// Copying freezes own changes into new layer, modification copies only state of modified node.
+	// Doing so we can also find nodes, changed in one of copies, without visiting all nodes.
+	// Mutable, since copying of const graph freezes its changes.
+	mutable LayerPtr layer_;
+	mutable NodesChangesMap changes_;
 };
 
 } // namespace U
@@ -0,0 +1,61 @@
+#include <algorithm>
+
+#include "../../lex_synt_lib_common/assert.hpp"
+#include "template_instantiation_stats_collector.hpp"
+
+namespace U
+{
+
+TemplateInstantiationStatsCollector::Scope::Scope( TemplateInstantiationStatsCollector* const collector, const TemplateBase* const template_ )
+	: collector_( template_ == nullptr ? nullptr : collector )
+{
+	if( collector_ != nullptr )
+		collector_->BeginWork( *template_ );
+}
+
+TemplateInstantiationStatsCollector::Scope::~Scope()
+{
+	if( collector_ != nullptr )
+		collector_->EndWork();
+}
+
+void TemplateInstantiationStatsCollector::AddInstantiation( const TemplateBase& template_ )
+{
+	++counters_[ &template_ ].instantiations;
+}
+
+void TemplateInstantiationStatsCollector::AddCacheHit( const TemplateBase& template_ )
+{
+	++counters_[ &template_ ].cache_hits;
+}
+
+void TemplateInstantiationStatsCollector::BeginWork( const TemplateBase& template_ )
+{
+	WorkStackEntry entry;
+	entry.template_= &template_;
+	entry.start_time= Clock::now();
+	work_stack_.push_back( entry );
+}
+
+void TemplateInstantiationStatsCollector::EndWork()
+{
+	U_ASSERT( !work_stack_.empty() );
+	const WorkStackEntry entry= work_stack_.back();
+	work_stack_.pop_back();
+
+	const Clock::duration duration= Clock::now() - entry.start_time;
+
+	Counters& counters= counters_[ entry.template_ ];
+	counters.self_time+= duration - entry.nested_work_time;
+
+	// Do not count time of nested work for the same template twice.
+	if( std::none_of(
+			work_stack_.begin(), work_stack_.end(),
+			[&]( const WorkStackEntry& e ) { return e.template_ == entry.template_; } ) )
+		counters.total_time+= duration;
+
+	if( !work_stack_.empty() )
+		work_stack_.back().nested_work_time+= duration;
+}
+
+} // namespace U
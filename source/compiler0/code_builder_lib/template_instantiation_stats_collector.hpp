@@ -0,0 +1,61 @@
+#pragma once
+#include <chrono>
+#include <unordered_map>
+#include <vector>
+
+#include "template_types.hpp"
+
+namespace U
+{
+
+// Collects counts of templates instantiations and time spent for work related to each template.
+class TemplateInstantiationStatsCollector
+{
+public:
+	using Clock= std::chrono::steady_clock;
+
+	struct Counters
+	{
+		uint64_t instantiations= 0;
+		uint64_t cache_hits= 0;
+		Clock::duration total_time{};
+		Clock::duration self_time{};
+	};
+
+	// Measures time of work, related to given template, until destruction.
+	// Does nothing if collector or template is null.
+	class Scope
+	{
+	public:
+		Scope( TemplateInstantiationStatsCollector* collector, const TemplateBase* template_ );
+		Scope( const Scope& )= delete;
+		Scope& operator=( const Scope& )= delete;
+		~Scope();
+
+	private:
+		TemplateInstantiationStatsCollector* const collector_;
+	};
+
+public:
+	void AddInstantiation( const TemplateBase& template_ );
+	void AddCacheHit( const TemplateBase& template_ );
+
+	const std::unordered_map<const TemplateBase*, Counters>& GetCounters() const { return counters_; }
+
+private:
+	void BeginWork( const TemplateBase& template_ );
+	void EndWork();
+
+private:
+	struct WorkStackEntry
+	{
+		const TemplateBase* template_= nullptr;
+		Clock::time_point start_time;
+		Clock::duration nested_work_time{};
+	};
+
+	std::unordered_map<const TemplateBase*, Counters> counters_;
+	std::vector<WorkStackEntry> work_stack_;
+};
+
+} // namespace U
@@ -52,6 +52,75 @@ bool FunctionVariable::IsCoroutine() const
 	return false;
 }
 
+//
+// OverloadingResolutionCache
+//
+
+OverloadingResolutionCache& OverloadingResolutionCache::operator=( const OverloadingResolutionCache& other )
+{
+	(void)other;
+	entries_.clear();
+	functions_count_= 0;
+	template_functions_count_= 0;
+	return *this;
+}
+
+const FunctionVariable* OverloadingResolutionCache::Find(
+	const OverloadedFunctionsSet& functions_set,
+	const llvm::ArrayRef<FunctionType::Param> actual_args,
+	const bool first_actual_arg_is_this )
+{
+	ResetIfFunctionsSetChanged( functions_set );
+
+	const auto it= entries_.find( CalculateHash( actual_args, first_actual_arg_is_this ) );
+	if( it == entries_.end() )
+		return nullptr;
+
+	for( const Entry& entry : it->second )
+	{
+		if( entry.first_actual_arg_is_this == first_actual_arg_is_this &&
+			llvm::ArrayRef<FunctionType::Param>( entry.actual_args ) == actual_args )
+			return entry.function;
+	}
+
+	return nullptr;
+}
+
+void OverloadingResolutionCache::Add(
+	const OverloadedFunctionsSet& functions_set,
+	const llvm::ArrayRef<FunctionType::Param> actual_args,
+	const bool first_actual_arg_is_this,
+	const FunctionVariable* const function )
+{
+	ResetIfFunctionsSetChanged( functions_set );
+
+	Entry entry;
+	entry.actual_args.assign( actual_args.begin(), actual_args.end() );
+	entry.first_actual_arg_is_this= first_actual_arg_is_this;
+	entry.function= function;
+	entries_[ CalculateHash( actual_args, first_actual_arg_is_this ) ].push_back( std::move(entry) );
+}
+
+size_t OverloadingResolutionCache::CalculateHash( const llvm::ArrayRef<FunctionType::Param> actual_args, const bool first_actual_arg_is_this )
+{
+	size_t hash= size_t( first_actual_arg_is_this );
+	for( const FunctionType::Param& arg : actual_args )
+		hash= llvm::hash_combine( hash, arg.type.Hash(), arg.value_type );
+	return hash;
+}
+
+void OverloadingResolutionCache::ResetIfFunctionsSetChanged( const OverloadedFunctionsSet& functions_set )
+{
+	// Functions are only added into sets, so, it's enough to check sizes.
+	// Adding a function may also reallocate functions storage and thus invalidate stored pointers.
+	if( functions_set.functions.size() != functions_count_ || functions_set.template_functions.size() != template_functions_count_ )
+	{
+		entries_.clear();
+		functions_count_= functions_set.functions.size();
+		template_functions_count_= functions_set.template_functions.size();
+	}
+}
+
 //
 // Variable
 //
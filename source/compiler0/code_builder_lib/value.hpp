@@ -84,6 +84,38 @@ struct OverloadedFunctionsSet;
 using OverloadedFunctionsSetPtr= std::shared_ptr<OverloadedFunctionsSet>;
 using OverloadedFunctionsSetConstPtr= std::shared_ptr<const OverloadedFunctionsSet>;
 
+// Results of overloading resolution for a functions set.
+// Stored results are valid only until functions are added into the set.
+class OverloadingResolutionCache
+{
+public:
+	OverloadingResolutionCache()= default;
+	// Do not copy results, since they point to functions of the source set.
+	OverloadingResolutionCache( const OverloadingResolutionCache& ) {}
+	OverloadingResolutionCache& operator=( const OverloadingResolutionCache& );
+
+	const FunctionVariable* Find( const OverloadedFunctionsSet& functions_set, llvm::ArrayRef<FunctionType::Param> actual_args, bool first_actual_arg_is_this );
+	void Add( const OverloadedFunctionsSet& functions_set, llvm::ArrayRef<FunctionType::Param> actual_args, bool first_actual_arg_is_this, const FunctionVariable* function );
+
+private:
+	struct Entry
+	{
+		ArgsVector<FunctionType::Param> actual_args;
+		bool first_actual_arg_is_this= false;
+		const FunctionVariable* function= nullptr;
+	};
+
+private:
+	static size_t CalculateHash( llvm::ArrayRef<FunctionType::Param> actual_args, bool first_actual_arg_is_this );
+	void ResetIfFunctionsSetChanged( const OverloadedFunctionsSet& functions_set );
+
+private:
+	// Key is hash of args.
+	std::unordered_map< size_t, llvm::SmallVector<Entry, 1> > entries_;
+	size_t functions_count_= 0;
+	size_t template_functions_count_= 0;
+};
+
 struct OverloadedFunctionsSet
 {
 	std::vector<FunctionVariable> functions;
@@ -98,6 +130,8 @@ struct OverloadedFunctionsSet
 
 	bool has_nomangle_function= false;
 	bool has_unbuilt_constexpr_functions= false;
+
+	mutable OverloadingResolutionCache resolution_cache;
 };
 
 struct TypeTemplatesSet
@@ -1,3 +1,11 @@
+#include "../../code_builder_lib_common/push_disable_llvm_warnings.hpp"
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Linker/Linker.h>
+#include <llvm/Support/ThreadPool.h>
+#include <llvm/Support/TimeProfiler.h>
+#include "../../code_builder_lib_common/pop_llvm_warnings.hpp"
+
 #include "../../code_builder_lib_common/long_stable_hash.hpp"
 #include "../../compilers_common_lib/code_builder_launcher.hpp"
 #include "../lex_synt_lib/source_graph_loader.hpp"
@@ -6,6 +14,245 @@
 namespace U
 {
 
+namespace
+{
+
+bool ErrorsAreEqual_r( const CodeBuilderError& l, const CodeBuilderError& r );
+
+bool ErrorsContainersAreEqual_r( const CodeBuilderErrorsContainer& l, const CodeBuilderErrorsContainer& r )
+{
+	return std::equal( l.begin(), l.end(), r.begin(), r.end(), ErrorsAreEqual_r );
+}
+
+// Compare errors deeply, since different partitions create different templates contexts for the same errors.
+bool ErrorsAreEqual_r( const CodeBuilderError& l, const CodeBuilderError& r )
+{
+	if( !( l.code == r.code && l.src_loc == r.src_loc && l.text == r.text ) )
+		return false;
+
+	if( l.template_context == nullptr || r.template_context == nullptr )
+		return l.template_context == r.template_context;
+
+	return
+		l.template_context->context_declaration_src_loc == r.template_context->context_declaration_src_loc &&
+		l.template_context->context_name == r.template_context->context_name &&
+		l.template_context->parameters_description == r.template_context->parameters_description &&
+		ErrorsContainersAreEqual_r( l.template_context->errors, r.template_context->errors );
+}
+
+void SortErrorsAndRemoveDuplicates( CodeBuilderErrorsContainer& errors )
+{
+	std::stable_sort( errors.begin(), errors.end(),
+		[]( const CodeBuilderError& l, const CodeBuilderError& r )
+		{
+			// Ignore templates contexts addresses, since they are different for different partitions.
+			if( l.src_loc != r.src_loc )
+				return l.src_loc < r.src_loc;
+			if( l.code != r.code )
+				return l.code < r.code;
+			return l.text < r.text;
+		} );
+
+	errors.erase( std::unique( errors.begin(), errors.end(), ErrorsAreEqual_r ), errors.end() );
+}
+
+// Prepare module of a partition for linking into result module (which is null for the first partition).
+void PreparePartitionModuleForLinking( llvm::Module& module, const llvm::Module* const dst_module )
+{
+	for( llvm::Function& function : module.functions() )
+	{
+		if( function.isDeclaration() )
+			continue;
+
+		if( function.hasPrivateLinkage() && function.hasName() )
+		{
+			// Private functions (functions inside templates, generated methods, functions from imported files) are built identically in each partition.
+			// Make them "linkonce_odr" in order to link only one copy of each function.
+			function.setLinkage( llvm::GlobalValue::LinkOnceODRLinkage );
+			function.setVisibility( llvm::GlobalValue::HiddenVisibility );
+			function.setMetadata( c_partition_private_function_metadata_name, llvm::MDNode::get( module.getContext(), {} ) );
+		}
+		else if( dst_module != nullptr && !function.hasLocalLinkage() && !function.hasComdat() )
+		{
+			// Remove duplicated definitions of non-partitioned functions with external linkage (constexpr functions, for example).
+			if( const llvm::Function* const prev_function= dst_module->getFunction( function.getName() ) )
+				if( !prev_function->isDeclaration() )
+					function.deleteBody();
+		}
+	}
+
+	if( dst_module == nullptr )
+		return;
+
+	for( llvm::GlobalVariable& variable : module.globals() )
+	{
+		// Remove duplicated definitions of global variables of the main file.
+		if( variable.isDeclaration() || variable.hasLocalLinkage() || variable.hasComdat() )
+			continue;
+
+		if( const llvm::GlobalVariable* const prev_variable= dst_module->getGlobalVariable( variable.getName() ) )
+		{
+			if( !prev_variable->isDeclaration() )
+			{
+				variable.setInitializer( nullptr );
+				variable.setLinkage( llvm::GlobalValue::ExternalLinkage );
+			}
+		}
+	}
+}
+
+// Restore private linkage of functions, which had it before partitions linking.
+void RestorePartitionPrivateFunctionsLinkage( llvm::Module& module )
+{
+	for( llvm::Function& function : module.functions() )
+	{
+		if( function.getMetadata( c_partition_private_function_metadata_name ) == nullptr )
+			continue;
+
+		function.setMetadata( c_partition_private_function_metadata_name, nullptr );
+		if( !function.isDeclaration() )
+			function.setLinkage( llvm::GlobalValue::PrivateLinkage );
+	}
+}
+
+// Build the program using multiple code builder instances, each one builds only part of functions bodies.
+// Instances are running in parallel, each one has its own LLVM context.
+// Results are merged in deterministic order.
+CodeBuilder::BuildResult BuildProgramInPartitions(
+	const IVfs::Path& input_file,
+	const IVfsSharedPtr& vfs,
+	llvm::LLVMContext& llvm_context,
+	const llvm::DataLayout& data_layout,
+	const llvm::Triple& target_triple,
+	const CodeBuilderOptions& options,
+	const SourceGraph& source_graph,
+	const uint32_t num_partitions )
+{
+	struct PartitionResult
+	{
+		CodeBuilder::BuildResult build_result;
+		llvm::SmallVector<char, 0> module_bitcode;
+	};
+	std::vector<PartitionResult> partitions_results( num_partitions );
+
+	{
+		llvm::ThreadPool thread_pool( llvm::hardware_concurrency( num_partitions ) );
+		for( uint32_t i= 0; i < num_partitions; ++i )
+		{
+			thread_pool.async(
+				[&, i]
+				{
+					CodeBuilderOptions partition_options= options;
+					partition_options.function_bodies_partitions_count= num_partitions;
+					partition_options.function_bodies_partition_index= i;
+
+					// Macro expansion contexts are populated during mixins expansion, so, each partition needs its own copy of them.
+					// Syntax analysis results are immutable and may be shared.
+					const auto partition_source_graph= std::make_shared<SourceGraph>( source_graph );
+					partition_source_graph->macro_expansion_contexts= std::make_shared<Synt::MacroExpansionContexts>( *source_graph.macro_expansion_contexts );
+
+					PartitionResult& result= partitions_results[i];
+
+					llvm::LLVMContext thread_llvm_context;
+					result.build_result=
+						CodeBuilder::BuildProgram(
+							thread_llvm_context,
+							data_layout,
+							target_triple,
+							partition_options,
+							partition_source_graph,
+							vfs );
+
+					if( result.build_result.module != nullptr )
+					{
+						llvm::raw_svector_ostream stream( result.module_bitcode );
+						llvm::WriteBitcodeToFile( *result.build_result.module, stream );
+						// Destroy the module before destroying its context.
+						result.build_result.module= nullptr;
+					}
+				} );
+		}
+		thread_pool.wait();
+	}
+
+	CodeBuilder::BuildResult result;
+
+	// Collect errors of all partitions. Some errors (in global things, for example) are reported in each partition.
+	for( PartitionResult& partition_result : partitions_results )
+	{
+		for( CodeBuilderError& error : partition_result.build_result.errors )
+			result.errors.push_back( std::move(error) );
+	}
+
+	// Report about unused global name only if it's unused in all partitions.
+	for( CodeBuilderError& error : partitions_results.front().build_result.unused_global_names_errors )
+	{
+		bool unused_in_all_partitions= true;
+		for( size_t i= 1; i < partitions_results.size(); ++i )
+		{
+			const CodeBuilderErrorsContainer& partition_errors= partitions_results[i].build_result.unused_global_names_errors;
+			unused_in_all_partitions&=
+				std::find_if(
+					partition_errors.begin(), partition_errors.end(),
+					[&]( const CodeBuilderError& e ){ return ErrorsAreEqual_r( e, error ); } ) != partition_errors.end();
+		}
+		if( unused_in_all_partitions )
+			result.errors.push_back( std::move(error) );
+	}
+
+	SortErrorsAndRemoveDuplicates( result.errors );
+
+	// Embedded files lists are the same for all partitions, except files embedded within functions bodies.
+	for( PartitionResult& partition_result : partitions_results )
+	{
+		for( IVfs::Path& path : partition_result.build_result.embedded_files )
+			result.embedded_files.push_back( std::move(path) );
+	}
+	std::sort( result.embedded_files.begin(), result.embedded_files.end() );
+	result.embedded_files.erase( std::unique( result.embedded_files.begin(), result.embedded_files.end() ), result.embedded_files.end() );
+
+	if( !result.errors.empty() )
+		return result; // There is no reason to link modules with errors.
+
+	// Link modules of all partitions in partitions order.
+	for( PartitionResult& partition_result : partitions_results )
+	{
+		llvm::Expected<std::unique_ptr<llvm::Module>> module_opt=
+			llvm::parseBitcodeFile(
+				llvm::MemoryBufferRef(
+					llvm::StringRef( partition_result.module_bitcode.data(), partition_result.module_bitcode.size() ),
+					input_file ),
+				llvm_context );
+
+		// Free memory as soon as possible.
+		partition_result.module_bitcode= llvm::SmallVector<char, 0>();
+
+		if( !module_opt )
+		{
+			llvm::consumeError( module_opt.takeError() );
+			result.module= nullptr;
+			return result;
+		}
+
+		std::unique_ptr<llvm::Module> module= std::move(*module_opt);
+		PreparePartitionModuleForLinking( *module, result.module.get() );
+
+		if( result.module == nullptr )
+			result.module= std::move(module);
+		else if( llvm::Linker::linkModules( *result.module, std::move(module) ) )
+		{
+			result.module= nullptr;
+			return result;
+		}
+	}
+
+	RestorePartitionPrivateFunctionsLinkage( *result.module );
+
+	return result;
+}
+
+} // namespace
+
 CodeBuilderLaunchResult LaunchCodeBuilder(
 	const IVfs::Path& input_file,
 	const IVfsSharedPtr& vfs,
@@ -15,12 +262,32 @@ CodeBuilderLaunchResult LaunchCodeBuilder(
 	const bool generate_debug_info,
 	const bool generate_tbaa_metadata,
 	const bool allow_unused_names,
+	const bool collect_template_instantiation_stats,
 	const ManglingScheme mangling_scheme,
-	const std::string_view prelude_code )
+	const std::string_view prelude_code,
+	ISourceGraphCache* const source_graph_cache,
+	IEmbedFilesCache* const embed_files_cache,
+	SyntaxAnalysisResultsInterner* const syntax_analysis_results_interner,
+	const uint32_t num_source_graph_loading_threads,
+	const uint32_t num_function_bodies_building_threads,
+	ISourceGraphLoadingTracer* const source_graph_loading_tracer )
 {
 	CodeBuilderLaunchResult result;
 
-	SourceGraph source_graph= LoadSourceGraph( *vfs, CalculateLongStableHash, input_file, prelude_code );
+	SourceGraph source_graph;
+	{
+		const llvm::TimeTraceScope time_trace_scope( "LoadSourceGraph", input_file );
+		source_graph=
+			LoadSourceGraph(
+				*vfs,
+				CalculateLongStableHash,
+				input_file,
+				prelude_code,
+				source_graph_cache,
+				syntax_analysis_results_interner,
+				num_source_graph_loading_threads,
+				source_graph_loading_tracer );
+	}
 
 	result.dependent_files.reserve( source_graph.nodes_storage.size() );
 	for( const SourceGraph::Node& node : source_graph.nodes_storage )
@@ -35,18 +302,37 @@ CodeBuilderLaunchResult LaunchCodeBuilder(
 	options.mangling_scheme= mangling_scheme;
 	options.generate_tbaa_metadata= generate_tbaa_metadata;
 	options.report_about_unused_names= !allow_unused_names;
+	options.collect_template_instantiation_stats= collect_template_instantiation_stats;
+	options.embed_files_cache= embed_files_cache;
+
+	const llvm::TimeTraceScope time_trace_scope( "CodeBuilder", input_file );
 
-	CodeBuilder::BuildResult build_result=
-		CodeBuilder::BuildProgram(
-			llvm_context,
-			data_layout,
-			target_triple,
-			options,
-			std::make_shared<SourceGraph>( std::move(source_graph) ),
-			vfs );
+	CodeBuilder::BuildResult build_result;
+	// Partitioning isn't used for templates instantiation stats collection, since each partition instantiates templates independently.
+	if( num_function_bodies_building_threads > 1 && !collect_template_instantiation_stats )
+		build_result=
+			BuildProgramInPartitions(
+				input_file,
+				vfs,
+				llvm_context,
+				data_layout,
+				target_triple,
+				options,
+				source_graph,
+				num_function_bodies_building_threads );
+	else
+		build_result=
+			CodeBuilder::BuildProgram(
+				llvm_context,
+				data_layout,
+				target_triple,
+				options,
+				std::make_shared<SourceGraph>( std::move(source_graph) ),
+				vfs );
 
 	result.code_builder_errors= std::move( build_result.errors );
 	result.llvm_module= std::move( build_result.module );
+	result.template_instantiation_stats= std::move( build_result.template_instantiation_stats );
 
 	// Add embedded files into the list of dependencies.
 	for( IVfs::Path& path : build_result.embedded_files )
@@ -0,0 +1,26 @@
+#include <algorithm>
+#include "arena.hpp"
+
+namespace U
+{
+
+void* Arena::AllocateInNewChunk( const size_t size )
+{
+	// Memory returned by "new" is aligned at least as std::max_align_t, so, no additional alignment is needed for the first allocation in a chunk.
+	const size_t chunk_size= std::max( next_chunk_size_, size );
+	next_chunk_size_= std::min( next_chunk_size_ * 2, c_max_chunk_size );
+
+	std::unique_ptr<std::byte[]> chunk( new std::byte[ chunk_size ] );
+	std::byte* const result= chunk.get();
+	// Do not switch to the new chunk if it's allocated specially for a large object and the current chunk still has more free space.
+	if( current_ == nullptr || size_t( current_end_ - current_ ) < chunk_size - size )
+	{
+		current_= result + size;
+		current_end_= result + chunk_size;
+	}
+
+	chunks_.push_back( std::move(chunk) );
+	return result;
+}
+
+} // namespace U
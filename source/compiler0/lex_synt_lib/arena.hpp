@@ -0,0 +1,112 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "../../lex_synt_lib_common/assert.hpp"
+
+namespace U
+{
+
+// Deleter for objects, allocated in an arena. Only calls destructor, memory is released by the arena itself.
+template<typename T>
+struct ArenaDeleter
+{
+	ArenaDeleter() noexcept = default;
+
+	// Allow conversions like ArenaPtr<T> -> ArenaPtr<const T>.
+	template<typename Other, typename= std::enable_if_t< std::is_convertible_v< Other*, T* > > >
+	ArenaDeleter( const ArenaDeleter<Other>& ) noexcept {}
+
+	void operator()( T* const ptr ) const noexcept
+	{
+		ptr->~T();
+	}
+};
+
+// Owning pointer to an object, allocated in an arena. Arena must outlive it.
+template<typename T>
+using ArenaPtr= std::unique_ptr< T, ArenaDeleter<T> >;
+
+// Simple region allocator for many small objects, that are freed all at once.
+// Allocation is just a pointer increment in most cases, objects allocated one after another are placed close to each other in memory.
+// Memory is released only in arena destructor, so, arena must outlive all objects allocated in it.
+// Moving of an arena doesn't move allocated objects.
+class Arena
+{
+public:
+	Arena()= default;
+	Arena( const Arena& )= delete;
+	Arena( Arena&& other ) noexcept
+		: chunks_( std::move(other.chunks_) )
+		, current_( other.current_ )
+		, current_end_( other.current_end_ )
+		, next_chunk_size_( other.next_chunk_size_ )
+	{
+		other.chunks_.clear();
+		other.current_= nullptr;
+		other.current_end_= nullptr;
+		other.next_chunk_size_= c_initial_chunk_size;
+	}
+
+	Arena& operator=( const Arena& )= delete;
+
+	// Memory of this arena isn't released on assignment, since objects allocated in it may be still alive.
+	// So, it's just appended to memory of the other arena.
+	Arena& operator=( Arena&& other ) noexcept
+	{
+		if( this == &other )
+			return *this;
+
+		std::vector< std::unique_ptr<std::byte[]> > prev_chunks= std::move(chunks_);
+		chunks_= std::move(other.chunks_);
+		chunks_.insert( chunks_.end(), std::make_move_iterator( prev_chunks.begin() ), std::make_move_iterator( prev_chunks.end() ) );
+		current_= other.current_;
+		current_end_= other.current_end_;
+		next_chunk_size_= other.next_chunk_size_;
+
+		other.chunks_.clear();
+		other.current_= nullptr;
+		other.current_end_= nullptr;
+		other.next_chunk_size_= c_initial_chunk_size;
+		return *this;
+	}
+
+	template<typename T, typename ... Args>
+	ArenaPtr<T> New( Args&& ... args )
+	{
+		void* const mem= Allocate( sizeof(T), alignof(T) );
+		return ArenaPtr<T>( new(mem) T( std::forward<Args>(args)... ) );
+	}
+
+	void* Allocate( const size_t size, const size_t alignment )
+	{
+		U_ASSERT( alignment != 0 && ( alignment & ( alignment - 1 ) ) == 0 );
+		U_ASSERT( alignment <= alignof(std::max_align_t) );
+
+		const uintptr_t current_aligned= ( uintptr_t(current_) + alignment - 1 ) & ~uintptr_t( alignment - 1 );
+		if( current_ != nullptr && current_aligned + size <= uintptr_t(current_end_) )
+		{
+			current_= reinterpret_cast<std::byte*>( current_aligned + size );
+			return reinterpret_cast<void*>( current_aligned );
+		}
+
+		return AllocateInNewChunk( size );
+	}
+
+private:
+	void* AllocateInNewChunk( size_t size );
+
+private:
+	static constexpr size_t c_initial_chunk_size= 4096;
+	static constexpr size_t c_max_chunk_size= 1024 * 1024;
+
+	std::vector< std::unique_ptr<std::byte[]> > chunks_;
+	std::byte* current_= nullptr;
+	std::byte* current_end_= nullptr;
+	size_t next_chunk_size_= c_initial_chunk_size;
+};
+
+} // namespace U
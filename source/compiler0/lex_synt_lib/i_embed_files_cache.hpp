@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+#include "i_vfs.hpp"
+
+namespace U
+{
+
+// Cache for contents of files, loaded via "embed" expressions.
+// It may be shared between code builder instances, in order to avoid loading and hashing of the same files for each compiled file.
+// Implementations should be thread-safe, since multiple files may be compiled in parallel.
+class IEmbedFilesCache
+{
+public:
+	struct Entry
+	{
+		IVfs::FileContentBufferPtr content;
+		std::string content_hash;
+	};
+	using EntryPtr= std::shared_ptr<const Entry>;
+
+	using ContentHashingFunction= std::string(*)( std::string_view );
+
+	struct Stats
+	{
+		uint64_t num_files= 0; // Number of unique files loaded.
+		uint64_t num_requests= 0;
+		uint64_t num_hits= 0; // Number of requests for already loaded (and not changed) files.
+		uint64_t bytes_loaded= 0;
+		uint64_t bytes_reused= 0;
+	};
+
+public:
+	virtual ~IEmbedFilesCache()= default;
+
+	// Returns null if file can't be loaded.
+	// Hashing function is used only for new entries.
+	virtual EntryPtr LoadFile( IVfs& vfs, const IVfs::Path& full_file_path, ContentHashingFunction content_hashing_function )= 0;
+
+	virtual Stats GetStats()= 0;
+};
+
+} // namespace U
@@ -0,0 +1,24 @@
+#pragma once
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace U
+{
+
+// Persistent storage for results of source graph nodes loading.
+// Entries are identified by keys, which are file-name-safe hash strings.
+// Implementations should be thread-safe, since they may be used for loading of multiple source graphs in parallel.
+class ISourceGraphCache
+{
+public:
+	virtual ~ISourceGraphCache()= default;
+
+	// Returns empty optional if there is no such entry.
+	virtual std::optional<std::string> LoadEntry( const std::string& key )= 0;
+
+	// Errors are ignored, since cache is just an optimization.
+	virtual void StoreEntry( const std::string& key, std::string_view data )= 0;
+};
+
+} // namespace U
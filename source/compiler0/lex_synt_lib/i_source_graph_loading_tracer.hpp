@@ -0,0 +1,24 @@
+#pragma once
+#include <string_view>
+#include "i_vfs.hpp"
+
+namespace U
+{
+
+// Receives notifications about steps of source graph loading, in order to measure their duration.
+// Implementations should be thread-safe, since files may be loaded in parallel in threads created by the loader.
+class ISourceGraphLoadingTracer
+{
+public:
+	virtual ~ISourceGraphLoadingTracer()= default;
+
+	// Called at start and at finish of each additional thread, created by the loader.
+	virtual void OnThreadStart()= 0;
+	virtual void OnThreadFinish()= 0;
+
+	// Called at start and at finish of a step of given file processing in current thread.
+	virtual void BeginStep( std::string_view step_name, const IVfs::Path& file_path )= 0;
+	virtual void EndStep()= 0;
+};
+
+} // namespace U
@@ -2,6 +2,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace U
@@ -13,6 +14,16 @@ public:
 	using Path= std::string;
 	using FileContent= std::string;
 
+	// Immutable file contents, which may be shared without copying.
+	// Implementations may keep memory-mapped contents here.
+	class FileContentBuffer
+	{
+	public:
+		virtual ~FileContentBuffer()= default;
+		virtual std::string_view GetContent() const= 0;
+	};
+	using FileContentBufferPtr= std::shared_ptr<const FileContentBuffer>;
+
 	struct PathCompletionItem
 	{
 		Path completed_path;
@@ -24,6 +35,10 @@ public:
 
 	virtual std::optional<FileContent> LoadFileContent( const Path& full_file_path )= 0;
 
+	// Returns null if file can't be loaded.
+	// Default implementation copies result of "LoadFileContent". Override it in order to avoid copying.
+	virtual FileContentBufferPtr LoadFileContentBuffer( const Path& full_file_path );
+
 	// Empty "full_parent_file_path" means root file.
 	virtual Path GetFullFilePath( const Path& file_path, const Path& full_parent_file_path )= 0;
 
@@ -40,4 +55,23 @@ public:
 
 using IVfsSharedPtr= std::shared_ptr<IVfs>;
 
+inline IVfs::FileContentBufferPtr IVfs::LoadFileContentBuffer( const Path& full_file_path )
+{
+	class StringFileContentBuffer final : public FileContentBuffer
+	{
+	public:
+		explicit StringFileContentBuffer( FileContent content ) : content_( std::move(content) ) {}
+		std::string_view GetContent() const override { return content_; }
+
+	private:
+		const FileContent content_;
+	};
+
+	std::optional<FileContent> content= LoadFileContent( full_file_path );
+	if( content == std::nullopt )
+		return nullptr;
+
+	return std::make_shared<StringFileContentBuffer>( std::move(*content) );
+}
+
 } // namespace U
@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <cstring>
+#include <iterator>
 
 #include "../../lex_synt_lib_common/assert.hpp"
 #include "number_parsing_utils.hpp"
@@ -331,16 +332,18 @@ Lexem ParseIdentifier( Iterator& it, const Iterator it_end )
 	Lexem result;
 	result.type= Lexem::Type::Identifier;
 
+	const Iterator it_start= it;
 	while( it < it_end )
 	{
 		auto it_next= it;
 		if( !IsIdentifierChar( ReadNextUTF8Char( it_next, it_end ) ) )
 			break;
-
-		result.text.insert( result.text.end(), it, it_next );
 		it= it_next;
 	}
 
+	// Assign text at once, in order to avoid reallocations for long identifiers.
+	result.text.assign( it_start, it );
+
 	return result;
 }
 
@@ -355,13 +358,12 @@ Lexem ParseMacroIdentifier( Iterator& it, const Iterator it_end )
 	result.type= Lexem::Type::MacroIdentifier;
 
 	U_ASSERT(IsMacroIdentifierStartChar(sprache_char(*it)));
-	result.text.push_back(*it);
+	const Iterator it_start= it;
 	++it;
 
 	if( it < it_end && IsMacroIdentifierStartChar(sprache_char(*it)) )
 	{
 		result.type= Lexem::Type::MacroUniqueIdentifier;
-		result.text.push_back(*it);
 		++it;
 	}
 
@@ -370,11 +372,11 @@ Lexem ParseMacroIdentifier( Iterator& it, const Iterator it_end )
 		auto it_next= it;
 		if( !IsIdentifierChar( ReadNextUTF8Char( it_next, it_end ) ) )
 			break;
-
-		result.text.insert( result.text.end(), it, it_next );
 		it= it_next;
 	}
 
+	result.text.assign( it_start, it );
+
 	return result;
 }
 
@@ -492,17 +494,27 @@ std::string GetColumnLimitMessage()
 
 LexicalAnalysisResult LexicalAnalysis( const std::string_view program_text )
 {
-	LexicalAnalysisResult result;
+	if( program_text.size() >= 3u && program_text.substr(0, 3) == "\xEF\xBB\xBF" )
+		return LexicalAnalysis( program_text.substr( 3 ), 1, 0 ); // Skip UTF-8 byte order mark.
 
-	Iterator it= program_text.data();
-	const Iterator it_end= it + program_text.size();
+	return LexicalAnalysis( program_text, 1, 0 ); // Count lines from "1", in human-readable format.
+}
 
-	if( program_text.size() >= 3u && program_text.substr(0, 3) == "\xEF\xBB\xBF" )
-		it+= 3; // Skip UTF-8 byte order mark.
+LexicalAnalysisResult LexicalAnalysis( const std::string_view program_text_part, const uint32_t start_line, const uint32_t start_column )
+{
+	LexicalAnalysisResult result;
 
+	Iterator it= program_text_part.data();
+	const Iterator it_end= it + program_text_part.size();
 
-	uint32_t line= 1; // Count lines from "1", in human-readable format.
-	uint32_t column= 0u;
+	// Reserve lexems storage in order to avoid reallocations (with moving of all lexems) for large files.
+	// Typical Ü code contains approximately one lexem per 5-6 bytes, dense code - one lexem per 4-5 bytes.
+	// Reserve for dense code, since even single reallocation of large storage is costly.
+	// Overestimation is cheap - memory pages of unused storage tail are usually not even touched.
+	result.lexems.reserve( program_text_part.size() / 4u + 1u );
+
+	uint32_t line= start_line;
+	uint32_t column= start_column;
 
 	#define CHECK_RETURN_COLUMN_LIMIT\
 		if( column > SrcLoc::c_max_column ) \
@@ -580,13 +592,13 @@ LexicalAnalysisResult LexicalAnalysis( const std::string_view program_text )
 						if( it < it_end )
 						{
 							auto it_copy= it;
-							if( IsNewlineSequence( c, ReadNextUTF8Char( it_copy, it ) ) )
+							if( IsNewlineSequence( c, ReadNextUTF8Char( it_copy, it_end ) ) )
 								it= it_copy;
 						}
+						continue;
 					}
-					else
-						ReadNextUTF8Char( it, it_end );
 
+					ReadNextUTF8Char( it, it_end );
 					++column;
 					CHECK_RETURN_COLUMN_LIMIT
 				}
@@ -813,6 +825,67 @@ void BuildLineToLinearPositionIndex( std::string_view text, LineToLinearPosition
 	}
 }
 
+void UpdateLineToLinearPositionIndex(
+	const std::string_view new_text,
+	const TextLinearPosition range_start,
+	const TextLinearPosition range_end,
+	const TextLinearPosition new_count,
+	LineToLinearPositionIndex& index )
+{
+	U_ASSERT( index.size() >= 2 ); // Should contains at least dummy and first line.
+	U_ASSERT( range_start <= range_end );
+
+	// Start scanning from the line containing symbol before changed range, since this symbol may form two-symbol line ending with inserted text.
+	const uint32_t first_line= LinearPositionToLine( index, range_start > 0 ? range_start - 1 : 0 );
+	const TextLinearPosition new_range_end= range_start + new_count;
+	const int64_t delta= int64_t(new_count) - int64_t(range_end - range_start);
+
+	const char* const it_start= new_text.data();
+	const char* const it_end= new_text.data() + new_text.size();
+	const char* it= it_start + index[first_line];
+
+	// Scan until reaching line start after changed range, which is also present in old index.
+	// Text after such line start is unchanged, so, all following lines are the same (but with shifted positions).
+	LineToLinearPositionIndex new_lines;
+	auto old_tail_it= index.end();
+	while( it < it_end )
+	{
+		const sprache_char c= ReadNextUTF8Char( it, it_end );
+		if( IsNewline( c ) )
+		{
+			// Handle cases with two-symbol line ending.
+			if( it < it_end )
+			{
+				auto it_copy= it;
+				const sprache_char next_c= ReadNextUTF8Char( it_copy, it_end );
+				if( IsNewlineSequence( c, next_c ) )
+					it= it_copy;
+			}
+
+			const TextLinearPosition position= TextLinearPosition(it - it_start);
+			if( position >= new_range_end )
+			{
+				const TextLinearPosition old_position= TextLinearPosition( int64_t(position) - delta );
+				const auto old_it= std::lower_bound( index.begin() + first_line + 1, index.end(), old_position );
+				if( old_it != index.end() && *old_it == old_position )
+				{
+					old_tail_it= old_it;
+					break;
+				}
+			}
+
+			new_lines.push_back( position );
+		}
+	}
+
+	const size_t old_tail_offset= size_t( old_tail_it - index.begin() );
+	for( size_t i= old_tail_offset; i < index.size(); ++i )
+		index[i]= TextLinearPosition( int64_t(index[i]) + delta );
+
+	index.erase( index.begin() + first_line + 1, index.begin() + std::ptrdiff_t(old_tail_offset) );
+	index.insert( index.begin() + first_line + 1, new_lines.begin(), new_lines.end() );
+}
+
 uint32_t LinearPositionToLine( const LineToLinearPositionIndex& index, const TextLinearPosition position )
 {
 	U_ASSERT( index.size() >= 2 ); // Should contains at least dummy and first line.
@@ -830,6 +903,145 @@ uint32_t LinearPositionToLine( const LineToLinearPositionIndex& index, const Tex
 	return  uint32_t( size_t( prev_it - index.begin() ) );
 }
 
+bool ContainsNonASCIINewlines( const std::string_view text )
+{
+	// Search for UTF-8 sequences of U+0085, U+2028, U+2029.
+	return
+		text.find( "\xC2\x85" ) != std::string_view::npos ||
+		text.find( "\xE2\x80\xA8" ) != std::string_view::npos ||
+		text.find( "\xE2\x80\xA9" ) != std::string_view::npos;
+}
+
+bool UpdateLexems(
+	const std::string_view new_text,
+	const LineToLinearPositionIndex& line_index,
+	const TextLinearPosition range_start,
+	const TextLinearPosition new_count,
+	Lexems& lexems )
+{
+	U_ASSERT( line_index.size() >= 2 ); // Should contains at least dummy and first line.
+
+	if( lexems.empty() || lexems.back().type != Lexem::Type::EndOfFile )
+		return false; // Analysis of old text was interrupted.
+	if( line_index.size() > SrcLoc::c_max_line )
+		return false;
+
+	// End of file lexem is located at last line, so, it may be used to calculate number of lines in old text.
+	const int64_t line_delta= int64_t(line_index.size() - 1) - int64_t(lexems.back().src_loc.GetLine());
+
+	const uint32_t first_line= LinearPositionToLine( line_index, range_start > 0 ? range_start - 1 : 0 );
+	const uint32_t end_line= LinearPositionToLine( line_index, range_start + new_count );
+
+	const auto lexem_src_loc_less=
+		[]( const Lexem& lexem, const SrcLoc& src_loc )
+		{
+			if( lexem.src_loc.GetLine() != src_loc.GetLine() )
+				return lexem.src_loc.GetLine() < src_loc.GetLine();
+			return lexem.src_loc.GetColumn() < src_loc.GetColumn();
+		};
+
+	const auto lexems_equal=
+		[]( const Lexem& l, const Lexem& r )
+		{
+			return l.type == r.type && l.src_loc == r.src_loc && l.text == r.text;
+		};
+
+	// Restart analysis from the last lexem before first changed line.
+	// Lexems can't span multiple lines, so, such lexem and all previous lexems are unchanged.
+	// Restarting from lexem start (and not from line start) is needed, since line may start inside multiline comment.
+	size_t restart_lexem_index=
+		size_t( std::lower_bound( lexems.begin(), lexems.end(), SrcLoc( 0, first_line, 0 ), lexem_src_loc_less ) - lexems.begin() );
+	// Literal suffix can't be analyzed separately from literal itself.
+	while( restart_lexem_index > 0 && lexems[ restart_lexem_index - 1 ].type == Lexem::Type::LiteralSuffix )
+		--restart_lexem_index;
+	if( restart_lexem_index > 0 && lexems[ restart_lexem_index - 1 ].src_loc.GetLine() > 1 )
+		--restart_lexem_index;
+	else
+		restart_lexem_index= 0; // Restart from text start (with byte order mark skipping).
+
+	TextLinearPosition restart_position= 0;
+	if( restart_lexem_index > 0 )
+	{
+		const SrcLoc& src_loc= lexems[ restart_lexem_index ].src_loc;
+		const TextLinearPosition line_start= line_index[ src_loc.GetLine() ];
+		const auto column_utf8= Utf32PositionToUtf8Position( new_text.substr( line_start ), src_loc.GetColumn() );
+		if( column_utf8 == std::nullopt )
+			return false;
+		restart_position= line_start + *column_utf8;
+	}
+
+	// Analyze window after restart position, ending at line start.
+	// Lexems can't span multiple lines, so, window lexems are the same as lexems obtained via analysis of whole text.
+	// Search lexem after changed lines, which is equal to old lexem (with adjusted line).
+	// Text after it is unchanged, so, following lexems are also equal.
+	// Increase window if such lexem isn't found.
+	uint64_t window_extra_lines= 4;
+	while( true )
+	{
+		const uint64_t window_end_line= uint64_t(end_line) + 1u + window_extra_lines;
+		const bool reached_end= window_end_line >= line_index.size();
+		const TextLinearPosition window_end= reached_end ? TextLinearPosition( new_text.size() ) : line_index[ size_t(window_end_line) ];
+
+		const std::string_view window_text= new_text.substr( restart_position, window_end - restart_position );
+		Lexems window_lexems=
+			restart_lexem_index == 0
+				? LexicalAnalysis( window_text ).lexems
+				: LexicalAnalysis( window_text, lexems[ restart_lexem_index ].src_loc.GetLine(), lexems[ restart_lexem_index ].src_loc.GetColumn() ).lexems;
+
+		if( window_lexems.empty() || window_lexems.back().type != Lexem::Type::EndOfFile )
+			return false; // Some limit is reached.
+
+		// Make sure restart position is correct.
+		if( restart_lexem_index > 0 && !lexems_equal( window_lexems.front(), lexems[ restart_lexem_index ] ) )
+			return false;
+
+		if( reached_end )
+		{
+			lexems.erase( lexems.begin() + std::ptrdiff_t(restart_lexem_index), lexems.end() );
+			lexems.insert( lexems.end(), std::make_move_iterator( window_lexems.begin() ), std::make_move_iterator( window_lexems.end() ) );
+			return true;
+		}
+
+		window_lexems.pop_back(); // Remove end of file lexem.
+
+		for( size_t i= 0; i < window_lexems.size(); ++i )
+		{
+			const Lexem& new_lexem= window_lexems[i];
+			if( new_lexem.src_loc.GetLine() <= end_line )
+				continue;
+
+			Lexem old_lexem_expected= new_lexem;
+			old_lexem_expected.src_loc.SetLine( uint32_t( int64_t(new_lexem.src_loc.GetLine()) - line_delta ) );
+
+			const auto old_it=
+				std::lower_bound(
+					lexems.begin() + std::ptrdiff_t(restart_lexem_index),
+					lexems.end(),
+					old_lexem_expected.src_loc,
+					lexem_src_loc_less );
+			if( old_it == lexems.end() || !lexems_equal( *old_it, old_lexem_expected ) )
+				continue;
+
+			const size_t old_index= size_t( old_it - lexems.begin() );
+			lexems.erase( lexems.begin() + std::ptrdiff_t(restart_lexem_index), lexems.begin() + std::ptrdiff_t(old_index) );
+			lexems.insert(
+				lexems.begin() + std::ptrdiff_t(restart_lexem_index),
+				std::make_move_iterator( window_lexems.begin() ),
+				std::make_move_iterator( window_lexems.begin() + std::ptrdiff_t(i) ) );
+
+			if( line_delta != 0 )
+			{
+				for( size_t j= restart_lexem_index + i; j < lexems.size(); ++j )
+					lexems[j].src_loc.SetLine( uint32_t( int64_t(lexems[j].src_loc.GetLine()) + line_delta ) );
+			}
+
+			return true;
+		}
+
+		window_extra_lines*= 4u;
+	}
+}
+
 std::optional<TextLinearPosition> GetIdentifierStartForPosition( const std::string_view text, const TextLinearPosition position )
 {
 	if( position >= text.size() )
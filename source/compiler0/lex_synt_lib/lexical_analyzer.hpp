@@ -126,6 +126,10 @@ struct LexicalAnalysisResult
 
 LexicalAnalysisResult LexicalAnalysis( std::string_view program_text );
 
+// Perform lexical analysis of a part of program text, starting with given line and column.
+// The part should start outside comments and literals. Byte order mark isn't skipped.
+LexicalAnalysisResult LexicalAnalysis( std::string_view program_text_part, uint32_t start_line, uint32_t start_column );
+
 //
 // Additional text-related stuff.
 //
@@ -144,9 +148,35 @@ LineToLinearPositionIndex BuildLineToLinearPositionIndex( std::string_view text
 // Build index, reusing provided output container.
 void BuildLineToLinearPositionIndex( std::string_view text, LineToLinearPositionIndex& out_index );
 
+// Update index of old text after replacing of range [range_start, range_end) with "new_count" bytes.
+// Only lines near changed range are scanned, positions of following lines are just shifted.
+void UpdateLineToLinearPositionIndex(
+	std::string_view new_text,
+	TextLinearPosition range_start,
+	TextLinearPosition range_end,
+	TextLinearPosition new_count,
+	LineToLinearPositionIndex& index );
+
 // Get line number (starting from 0).
 uint32_t LinearPositionToLine( const LineToLinearPositionIndex& index, TextLinearPosition position );
 
+// Returns true if text contains non-ASCII newline symbols (U+0085, U+2028, U+2029).
+// Lexical analyzer doesn't count them as line breaks inside comments and literals, so, lexems can't be updated incrementally for such text.
+bool ContainsNonASCIINewlines( std::string_view text );
+
+// Update lexems of old text after replacing of range starting with "range_start" with "new_count" bytes.
+// Only damaged region is analyzed again, lexems after it are reused (with adjusted lines).
+// Lexems should be result of lexical analysis of old text, line index should be already updated for new text.
+// Both old and new texts should not contain non-ASCII newlines.
+// Returns false if incremental update isn't possible - full lexical analysis is required in such case.
+// Lexical errors aren't collected.
+bool UpdateLexems(
+	std::string_view new_text,
+	const LineToLinearPositionIndex& line_index,
+	TextLinearPosition range_start,
+	TextLinearPosition new_count,
+	Lexems& lexems );
+
 // Get position of the start of identifier at given position.
 // Returns none if there is no identifier here.
 std::optional<TextLinearPosition> GetIdentifierStartForPosition( std::string_view text, TextLinearPosition position );
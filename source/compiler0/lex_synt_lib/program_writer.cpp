@@ -101,13 +101,13 @@ void WriteRawMixin( const Mixin& mixin ) const
 public:
 
 template<typename T>
-void ElementWrite( const std::unique_ptr<const T>& el ) const
+void ElementWrite( const ArenaPtr<const T>& el ) const
 {
 	ElementWrite( *el );
 }
 
 template<typename T>
-void ElementWrite( const std::unique_ptr<T>& el ) const
+void ElementWrite( const ArenaPtr<T>& el ) const
 {
 	ElementWrite( *el );
 }
@@ -125,7 +125,7 @@ void ElementWrite( const ComplexName& complex_name ) const
 
 void ElementWrite( const TypeName& type_name ) const
 {
-	if( const auto mixin_ptr= std::get_if< std::unique_ptr<const Mixin> >( &type_name ) )
+	if( const auto mixin_ptr= std::get_if< ArenaPtr<const Mixin> >( &type_name ) )
 	{
 		// Hack to distinguish between mixins in type names and in blocks/global space.
 		WriteRawMixin( **mixin_ptr );
@@ -136,7 +136,7 @@ void ElementWrite( const TypeName& type_name ) const
 
 void ElementWrite( const Expression& expression ) const
 {
-	if( const auto mixin_ptr= std::get_if< std::unique_ptr<const Mixin> >( &expression ) )
+	if( const auto mixin_ptr= std::get_if< ArenaPtr<const Mixin> >( &expression ) )
 	{
 		// Hack to distinguish between mixins in expressions and in blocks/global space.
 		WriteRawMixin( **mixin_ptr );
@@ -832,7 +832,7 @@ void ElementWrite( const NonSyncTag& non_sync_tag ) const
 	{}
 	else if( std::holds_alternative<NonSyncTagTrue>( non_sync_tag ) )
 		stream_ << " " << Keyword( Keywords::non_sync_ );
-	else if( const auto expression_ptr = std::get_if< std::unique_ptr<const Expression> >( &non_sync_tag ) )
+	else if( const auto expression_ptr = std::get_if< ArenaPtr<const Expression> >( &non_sync_tag ) )
 	{
 		stream_ << Keyword( Keywords::non_sync_ ) << " ( ";
 		ElementWrite( **expression_ptr );
@@ -1,7 +1,14 @@
 #include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "../../lex_synt_lib_common/assert.hpp"
 
+#include "source_graph_serialization.hpp"
 #include "source_graph_loader.hpp"
 
 namespace U
@@ -10,16 +17,386 @@ namespace U
 namespace
 {
 
+// Result of file loading, which doesn't depend on position of the file in source graph.
+// So, files may be loaded in parallel.
+// File indices in source locations are not set.
+struct LoadedFile
+{
+	IVfs::Path full_file_path;
+	IVfs::FileContentBufferPtr content; // Null if loading failed.
+	bool importing_allowed= false;
+	SourceGraph::Node::Category category= SourceGraph::Node::Category::SourceOrInternalImport;
+
+	std::string file_key;
+
+	std::optional<std::string> cache_entry_data;
+	std::optional<SerializedSourceGraphNode> cached_node; // Points into cache entry data.
+
+	// Lexical analysis is skipped if imports are known from cache or interner.
+	std::optional<LexicalAnalysisResult> lex_result;
+
+	std::vector<Synt::Import> imports;
+	std::vector<IVfs::Path> imports_full_paths;
+
+	// Result of preliminary syntax analysis, performed in parallel for all files.
+	// It may be used only if no macro expansions were performed, since macro expansion indices depend on order of syntax analysis.
+	size_t preliminary_node_index= ~0u;
+	std::shared_ptr<const Synt::SyntaxAnalysisResult> preliminary_ast;
+	bool preliminary_ast_has_macro_expansions= false;
+
+	bool preliminary_ast_used= false;
+};
+
+using LoadedFiles= std::unordered_map<IVfs::Path, std::unique_ptr<LoadedFile>>;
+
+struct LoadingContext
+{
+	IVfs& vfs;
+	const SourceFilePathHashigFunction source_file_path_hashing_function;
+	ISourceGraphCache* const cache;
+	SyntaxAnalysisResultsInterner* const interner;
+	ISourceGraphLoadingTracer* const tracer;
+
+	LoadedFiles files;
+};
+
+// Notifies tracer (if it exists) about start and finish of a file processing step.
+class TracedStep
+{
+public:
+	TracedStep( ISourceGraphLoadingTracer* const tracer, const std::string_view step_name, const IVfs::Path& file_path )
+		: tracer_(tracer)
+	{
+		if( tracer_ != nullptr )
+			tracer_->BeginStep( step_name, file_path );
+	}
+
+	TracedStep( const TracedStep& )= delete;
+	TracedStep& operator=( const TracedStep& )= delete;
+
+	~TracedStep()
+	{
+		if( tracer_ != nullptr )
+			tracer_->EndStep();
+	}
+
+private:
+	ISourceGraphLoadingTracer* const tracer_;
+};
+
+// Runs tasks in given number of threads until all tasks (including tasks added by other tasks) are finished.
+class ParallelTasksRunner
+{
+public:
+	using Task= std::function<void()>;
+
+	explicit ParallelTasksRunner( ISourceGraphLoadingTracer* const tracer )
+		: tracer_(tracer)
+	{}
+
+	void AddTask( Task task )
+	{
+		{
+			const std::lock_guard<std::mutex> lock( mutex_ );
+			tasks_.push_back( std::move(task) );
+		}
+		condition_variable_.notify_one();
+	}
+
+	void Run( const size_t num_threads )
+	{
+		std::vector<std::thread> threads;
+		threads.reserve( num_threads );
+		for( size_t i= 1; i < num_threads; ++i )
+			threads.emplace_back(
+				[this]
+				{
+					if( tracer_ != nullptr )
+						tracer_->OnThreadStart();
+					RunWorker();
+					if( tracer_ != nullptr )
+						tracer_->OnThreadFinish();
+				} );
+
+		// Use also current thread.
+		RunWorker();
+
+		for( std::thread& thread : threads )
+			thread.join();
+	}
+
+private:
+	void RunWorker()
+	{
+		std::unique_lock<std::mutex> lock( mutex_ );
+		while(true)
+		{
+			if( !tasks_.empty() )
+			{
+				Task task= std::move( tasks_.back() );
+				tasks_.pop_back();
+				++num_running_tasks_;
+
+				lock.unlock();
+				task();
+				lock.lock();
+
+				--num_running_tasks_;
+				if( tasks_.empty() && num_running_tasks_ == 0 )
+					condition_variable_.notify_all(); // Notify other threads about finish.
+			}
+			else if( num_running_tasks_ == 0 )
+				return;
+			else
+				condition_variable_.wait( lock );
+		}
+	}
+
+private:
+	ISourceGraphLoadingTracer* const tracer_;
+	std::mutex mutex_;
+	std::condition_variable condition_variable_;
+	std::vector<Task> tasks_;
+	size_t num_running_tasks_= 0;
+};
+
+// Thread-safe if VFS, cache, interner and tracer are thread-safe.
+void LoadFile( IVfs& vfs, const SourceFilePathHashigFunction source_file_path_hashing_function, ISourceGraphCache* const cache, SyntaxAnalysisResultsInterner* const interner, ISourceGraphLoadingTracer* const tracer, LoadedFile& file )
+{
+	const TracedStep traced_step( tracer, "LoadFile", file.full_file_path );
+
+	file.category=
+		vfs.IsFileFromSourcesDirectory( file.full_file_path )
+			? SourceGraph::Node::Category::SourceOrInternalImport
+			: SourceGraph::Node::Category::OtherImport;
+
+	file.content= vfs.LoadFileContentBuffer( file.full_file_path );
+	if( file.content == nullptr )
+		return;
+
+	file.importing_allowed= vfs.IsImportingFileAllowed( file.full_file_path );
+	if( !file.importing_allowed )
+		return;
+
+	// File path is a part of the key, since it affects file path hash and thus generated names.
+	// Hash contents separately in order to avoid copying them.
+	if( cache != nullptr || interner != nullptr )
+		file.file_key= source_file_path_hashing_function( file.full_file_path + '\0' + source_file_path_hashing_function( file.content->GetContent() ) );
+
+	// Try to take syntax analysis result from cache.
+	if( cache != nullptr )
+	{
+		file.cache_entry_data= cache->LoadEntry( file.file_key );
+		if( file.cache_entry_data != std::nullopt )
+			file.cached_node= ReadSerializedSourceGraphNode( *file.cache_entry_data, 0u );
+	}
+
+	// Avoid lexical analysis if imports are known.
+	std::optional< std::vector<Synt::Import> > interned_imports;
+	if( file.cached_node != std::nullopt )
+		file.imports= file.cached_node->imports;
+	else if( interner != nullptr && ( interned_imports= interner->GetImports( file.file_key ) ) != std::nullopt )
+		file.imports= std::move(*interned_imports);
+	else
+	{
+		file.lex_result= LexicalAnalysis( file.content->GetContent() );
+		if( !file.lex_result->errors.empty() )
+			return;
+		file.imports= Synt::ParseImports( file.lex_result->lexems );
+	}
+
+	file.imports_full_paths.reserve( file.imports.size() );
+	for( const Synt::Import& import : file.imports )
+		file.imports_full_paths.push_back( vfs.GetFullFilePath( import.import_name, file.full_file_path ) );
+}
+
+LoadedFile& GetLoadedFile( LoadingContext& context, const IVfs::Path& full_file_path )
+{
+	std::unique_ptr<LoadedFile>& file= context.files[ full_file_path ];
+	if( file == nullptr )
+	{
+		// Not preloaded - load it now.
+		file= std::make_unique<LoadedFile>();
+		file->full_file_path= full_file_path;
+		LoadFile( context.vfs, context.source_file_path_hashing_function, context.cache, context.interner, context.tracer, *file );
+	}
+	return *file;
+}
+
+// Load all files of the imports graph in parallel.
+void PreloadFiles( LoadingContext& context, const IVfs::Path& root_file_full_path, const size_t num_threads )
+{
+	ParallelTasksRunner tasks_runner( context.tracer );
+	std::mutex files_mutex;
+
+	std::function<void(LoadedFile&)> load_file=
+	[&]( LoadedFile& file )
+	{
+		LoadFile( context.vfs, context.source_file_path_hashing_function, context.cache, context.interner, context.tracer, file );
+
+		const std::lock_guard<std::mutex> lock( files_mutex );
+		for( const IVfs::Path& import_full_path : file.imports_full_paths )
+		{
+			std::unique_ptr<LoadedFile>& imported_file= context.files[ import_full_path ];
+			if( imported_file == nullptr )
+			{
+				imported_file= std::make_unique<LoadedFile>();
+				imported_file->full_file_path= import_full_path;
+				tasks_runner.AddTask( [&load_file, &file= *imported_file]{ load_file( file ); } );
+			}
+		}
+	};
+
+	std::unique_ptr<LoadedFile>& root_file= context.files[ root_file_full_path ];
+	root_file= std::make_unique<LoadedFile>();
+	root_file->full_file_path= root_file_full_path;
+	tasks_runner.AddTask( [&load_file, &file= *root_file]{ load_file( file ); } );
+
+	tasks_runner.Run( num_threads );
+}
+
+bool CanBeParsed( const LoadedFile& file )
+{
+	return
+		file.content != nullptr &&
+		file.importing_allowed &&
+		file.lex_result != std::nullopt &&
+		file.lex_result->errors.empty();
+}
+
+// Calculate node indices in the same way as "LoadNode_r" does.
+void AssignPreliminaryNodeIndices_r( LoadingContext& context, const IVfs::Path& full_file_path, std::vector<const LoadedFile*>& processed_files_stack, size_t& next_node_index )
+{
+	const auto it= context.files.find( full_file_path );
+	if( it == context.files.end() )
+		return;
+	LoadedFile& file= *it->second;
+
+	if( std::find( processed_files_stack.begin(), processed_files_stack.end(), &file ) != processed_files_stack.end() )
+		return; // Import loop.
+
+	if( file.preliminary_node_index != ~0u )
+		return; // Already visited.
+
+	file.preliminary_node_index= next_node_index;
+	++next_node_index;
+
+	if( !CanBeParsed( file ) )
+		return;
+
+	processed_files_stack.push_back( &file );
+	for( const IVfs::Path& import_full_path : file.imports_full_paths )
+		AssignPreliminaryNodeIndices_r( context, import_full_path, processed_files_stack, next_node_index );
+	processed_files_stack.pop_back();
+}
+
+// Perform syntax analysis of independent files in parallel, processing each file after all its imports.
+// Results are used later only if they are identical to results of sequential analysis.
+void PerformPreliminarySyntaxAnalysis( LoadingContext& context, const IVfs::Path& root_file_full_path, const size_t num_threads )
+{
+	size_t next_node_index= 0;
+	std::vector<const LoadedFile*> processed_files_stack;
+	AssignPreliminaryNodeIndices_r( context, root_file_full_path, processed_files_stack, next_node_index );
+
+	struct FileDependencies
+	{
+		size_t num_unprocessed_imports= 0;
+		std::vector<LoadedFile*> dependent_files;
+	};
+	std::unordered_map<LoadedFile*, FileDependencies> dependencies;
+
+	for( const auto& file_pair : context.files )
+	{
+		LoadedFile& file= *file_pair.second;
+		if( !CanBeParsed( file ) || file.preliminary_node_index == ~0u )
+			continue;
+
+		FileDependencies& file_dependencies= dependencies[ &file ];
+		std::unordered_set<LoadedFile*> imported_files;
+		for( const IVfs::Path& import_full_path : file.imports_full_paths )
+		{
+			const auto it= context.files.find( import_full_path );
+			if( it != context.files.end() && CanBeParsed( *it->second ) && imported_files.insert( it->second.get() ).second )
+			{
+				++file_dependencies.num_unprocessed_imports;
+				dependencies[ it->second.get() ].dependent_files.push_back( &file );
+			}
+		}
+	}
+
+	ParallelTasksRunner tasks_runner( context.tracer );
+	std::mutex dependencies_mutex;
+
+	std::function<void(LoadedFile&)> parse_file=
+	[&]( LoadedFile& file )
+	{
+		// Merge macroses in the same way as "LoadNode_r" does, but ignore redefinition errors.
+		Synt::MacrosByContextMap merged_macroses;
+		for( const IVfs::Path& import_full_path : file.imports_full_paths )
+		{
+			const auto it= context.files.find( import_full_path );
+			if( it == context.files.end() || it->second->preliminary_ast == nullptr || it->second->preliminary_ast->macros == nullptr )
+				continue;
+
+			for( const auto& context_macro_map_pair : *it->second->preliminary_ast->macros )
+			{
+				Synt::MacroMap& dst_map= merged_macroses[context_macro_map_pair.first];
+				for( const auto& macro_map_pair : context_macro_map_pair.second )
+					dst_map.emplace( macro_map_pair.first, macro_map_pair.second );
+			}
+		}
+
+		for( Lexem& lexem : file.lex_result->lexems )
+			lexem.src_loc.SetFileIndex( uint32_t(file.preliminary_node_index) );
+
+		const TracedStep traced_step( context.tracer, "SyntaxAnalysis", file.full_file_path );
+
+		const auto macro_expansion_contexts= std::make_shared<Synt::MacroExpansionContexts>();
+		Synt::SyntaxAnalysisResult synt_result=
+			Synt::SyntaxAnalysis(
+				file.lex_result->lexems,
+				std::move(merged_macroses),
+				macro_expansion_contexts,
+				context.source_file_path_hashing_function( file.full_file_path ) );
+
+		file.preliminary_ast_has_macro_expansions= !macro_expansion_contexts->empty();
+		file.preliminary_ast= std::make_shared<const Synt::SyntaxAnalysisResult>( std::move(synt_result) );
+
+		const std::lock_guard<std::mutex> lock( dependencies_mutex );
+		for( LoadedFile* const dependent_file : dependencies[ &file ].dependent_files )
+		{
+			FileDependencies& dependent_file_dependencies= dependencies[ dependent_file ];
+			U_ASSERT( dependent_file_dependencies.num_unprocessed_imports > 0 );
+			--dependent_file_dependencies.num_unprocessed_imports;
+			if( dependent_file_dependencies.num_unprocessed_imports == 0 )
+				tasks_runner.AddTask( [&parse_file, dependent_file]{ parse_file( *dependent_file ); } );
+		}
+	};
+
+	// Files in import loops are never processed.
+	for( auto& dependencies_pair : dependencies )
+	{
+		if( dependencies_pair.second.num_unprocessed_imports == 0 )
+		{
+			LoadedFile* const file= dependencies_pair.first;
+			tasks_runner.AddTask( [&parse_file, file]{ parse_file( *file ); } );
+		}
+	}
+
+	tasks_runner.Run( num_threads );
+}
+
 size_t LoadNode_r(
-	IVfs& vfs,
-	const SourceFilePathHashigFunction source_file_path_hashing_function,
-	const IVfs::Path& file_path,
-	const IVfs::Path& parent_file_path,
+	LoadingContext& context,
+	const IVfs::Path& full_file_path,
+	const IVfs::Path& file_path, // Used only for error messages.
 	std::vector<std::string>& processed_files_stack,
 	const SrcLoc& import_src_loc,
 	SourceGraph& result )
 {
-	const IVfs::Path full_file_path= vfs.GetFullFilePath( file_path, parent_file_path );
+	const SourceFilePathHashigFunction source_file_path_hashing_function= context.source_file_path_hashing_function;
+	ISourceGraphCache* const cache= context.cache;
+	SyntaxAnalysisResultsInterner* const interner= context.interner;
 
 	// Check for dependency loops.
 	const auto prev_file_it= std::find( processed_files_stack.begin(), processed_files_stack.end(), full_file_path );
@@ -44,13 +421,11 @@ size_t LoadNode_r(
 	result.nodes_storage.emplace_back();
 	result.nodes_storage[node_index].file_path= full_file_path;
 
-	result.nodes_storage[node_index].category=
-		vfs.IsFileFromSourcesDirectory( full_file_path )
-			? SourceGraph::Node::Category::SourceOrInternalImport
-			: SourceGraph::Node::Category::OtherImport;
+	LoadedFile& file= GetLoadedFile( context, full_file_path );
+
+	result.nodes_storage[node_index].category= file.category;
 
-	const std::optional<IVfs::FileContent> loaded_file= vfs.LoadFileContent( full_file_path );
-	if( loaded_file == std::nullopt )
+	if( file.content == nullptr )
 	{
 		LexSyntError error_message( "Can not read file \"" + (full_file_path.empty() ? file_path : full_file_path) + "\"", import_src_loc );
 		result.errors.push_back( std::move(error_message) );
@@ -58,7 +433,7 @@ size_t LoadNode_r(
 	}
 
 	// Check for allowing import after checking for file existence - in order to generate "file not found" error first.
-	if( !vfs.IsImportingFileAllowed( full_file_path ) )
+	if( !file.importing_allowed )
 	{
 		result.errors.emplace_back(
 			"Importing file \"" + (full_file_path.empty() ? file_path : full_file_path) + "\" isn't allowed.",
@@ -66,21 +441,41 @@ size_t LoadNode_r(
 		return ~0u;
 	}
 
-	LexicalAnalysisResult lex_result= LexicalAnalysis( *loaded_file );
+	const std::string& file_key= file.file_key;
 
-	for( LexSyntError error: lex_result.errors )
+	bool lexical_analysis_done= false;
+	const auto do_lexical_analysis=
+	[&]() -> bool
 	{
-		error.src_loc.SetFileIndex(uint32_t(node_index));
-		result.errors.push_back( std::move(error) );
-	}
+		if( file.lex_result == std::nullopt )
+		{
+			const TracedStep traced_step( context.tracer, "LexicalAnalysis", full_file_path );
+			file.lex_result= LexicalAnalysis( file.content->GetContent() );
+		}
+		lexical_analysis_done= true;
 
-	if( !lex_result.errors.empty() )
-		return ~0u;
+		for( LexSyntError error: file.lex_result->errors )
+		{
+			error.src_loc.SetFileIndex(uint32_t(node_index));
+			result.errors.push_back( std::move(error) );
+		}
+
+		if( !file.lex_result->errors.empty() )
+			return false;
 
-	for( Lexem& lexem :lex_result.lexems )
-		lexem.src_loc.SetFileIndex(uint32_t(node_index));
+		for( Lexem& lexem : file.lex_result->lexems )
+			lexem.src_loc.SetFileIndex(uint32_t(node_index));
 
-	const std::vector<Synt::Import> imports= Synt::ParseImports( lex_result.lexems );
+		return true;
+	};
+
+	// Imports are taken from cache or interner, if lexical analysis was skipped.
+	if( file.lex_result != std::nullopt && !do_lexical_analysis() )
+		return ~0u;
+
+	std::vector<Synt::Import> imports= file.imports;
+	for( Synt::Import& import : imports )
+		import.src_loc.SetFileIndex( uint32_t(node_index) );
 
 	result.nodes_storage[node_index].child_nodes_indices.resize( imports.size() );
 
@@ -93,17 +488,16 @@ size_t LoadNode_r(
 		const Synt::Import& import = imports[i];
 		const size_t child_node_index=
 			LoadNode_r(
-				vfs,
-				source_file_path_hashing_function,
+				context,
+				file.imports_full_paths[i],
 				import.import_name,
-				full_file_path,
 				processed_files_stack,
 				import.src_loc,
 				result );
 		if( child_node_index != ~0u )
 		{
-			if( const Synt::MacrosPtr macro= result.nodes_storage[child_node_index].ast.macros; macro != nullptr )
-				imported_macroses.push_back( macro );
+			if( const auto& child_ast= result.nodes_storage[child_node_index].ast; child_ast != nullptr && child_ast->macros != nullptr )
+				imported_macroses.push_back( child_ast->macros );
 			result.nodes_storage[node_index].child_nodes_indices[i]= child_node_index;
 		}
 	}
@@ -133,18 +527,140 @@ size_t LoadNode_r(
 
 	std::string file_path_hash= source_file_path_hashing_function( full_file_path );
 
+	const size_t macro_expansion_contexts_begin= result.macro_expansion_contexts->size();
+
+	// Free memory of loaded file, which is no longer needed.
+	const auto finish_node=
+	[&]()
+	{
+		file.lex_result= std::nullopt;
+		file.cached_node= std::nullopt;
+		file.cache_entry_data= std::nullopt;
+	};
+
+	// Take syntax analysis result, which may be shared with other source graphs.
+	// It is possible only if all indices inside it are the same.
+	// So, use a key, which includes node index, macro expansion contexts offset and imported macros with exact file indices.
+	// This limits sharing to source graphs where this file has the same position - usually if roots import common files in the same order.
+	// Making results independent of position would require remapping of file indices in all source locations of the syntax tree.
+	std::string interner_context_key;
+	if( interner != nullptr )
+	{
+		interner_context_key=
+			source_file_path_hashing_function( SerializeImportedMacros( result, merged_macroses, true ) ) + "_" +
+			std::to_string( node_index ) + "_" +
+			std::to_string( macro_expansion_contexts_begin );
+
+		if( const SyntaxAnalysisResultsInterner::EntryPtr entry= interner->Find( file_key, interner_context_key ) )
+		{
+			result.macro_expansion_contexts->insert(
+				result.macro_expansion_contexts->end(),
+				entry->macro_expansion_contexts.begin(),
+				entry->macro_expansion_contexts.end() );
+
+			result.errors.insert( result.errors.end(), entry->ast->error_messages.begin(), entry->ast->error_messages.end() );
+
+			result.nodes_storage[node_index].ast= entry->ast;
+			result.nodes_storage[node_index].file_path_hash= std::move(file_path_hash);
+			finish_node();
+			return node_index;
+		}
+	}
+
+	// Add result into the interner in order to reuse it later.
+	const auto intern_result=
+	[&]()
+	{
+		if( interner == nullptr )
+			return;
+
+		SyntaxAnalysisResultsInterner::Entry entry;
+		entry.ast= result.nodes_storage[node_index].ast;
+		entry.macro_expansion_contexts.assign(
+			result.macro_expansion_contexts->begin() + std::ptrdiff_t(macro_expansion_contexts_begin),
+			result.macro_expansion_contexts->end() );
+
+		result.nodes_storage[node_index].ast= interner->Add( file_key, interner_context_key, std::move(entry) )->ast;
+	};
+
+	// Syntax analysis result depends on imported macros, so, cache entry is valid only for same macros.
+	std::string imported_macros_hash;
+	if( cache != nullptr )
+		imported_macros_hash= source_file_path_hashing_function( SerializeImportedMacros( result, merged_macroses ) );
+
+	if( file.cached_node != std::nullopt )
+	{
+		if( file.cached_node->imported_macros_hash == imported_macros_hash &&
+			DeserializeSourceGraphNode( *file.cached_node, result, node_index ) )
+		{
+			result.nodes_storage[node_index].file_path_hash= std::move(file_path_hash);
+			intern_result();
+			finish_node();
+			return node_index;
+		}
+	}
+
+	// Use result of preliminary syntax analysis if it is the same as result of sequential analysis.
+	// It's true if node index is the same, no macro expansions were performed and all imported files have the same syntax analysis results.
+	bool preliminary_ast_is_valid=
+		file.preliminary_ast != nullptr &&
+		file.preliminary_node_index == node_index &&
+		!file.preliminary_ast_has_macro_expansions;
+	if( preliminary_ast_is_valid )
+	{
+		for( const IVfs::Path& import_full_path : file.imports_full_paths )
+		{
+			const auto it= context.files.find( import_full_path );
+			if( it != context.files.end() && it->second->preliminary_ast != nullptr && !it->second->preliminary_ast_used )
+				preliminary_ast_is_valid= false;
+		}
+	}
+
+	if( preliminary_ast_is_valid )
+	{
+		result.errors.insert( result.errors.end(), file.preliminary_ast->error_messages.begin(), file.preliminary_ast->error_messages.end() );
+
+		result.nodes_storage[node_index].ast= file.preliminary_ast;
+		result.nodes_storage[node_index].file_path_hash= std::move(file_path_hash);
+		file.preliminary_ast_used= true;
+		finish_node();
+		return node_index;
+	}
+
+	if( !lexical_analysis_done && !do_lexical_analysis() )
+		return ~0u;
+
 	// Make syntax analysis, using imported macroses.
 	Synt::SyntaxAnalysisResult synt_result=
-		Synt::SyntaxAnalysis(
-		lex_result.lexems,
-		std::move(merged_macroses),
-		result.macro_expansion_contexts,
-		file_path_hash );
+		[&]
+		{
+			const TracedStep traced_step( context.tracer, "SyntaxAnalysis", full_file_path );
+			return
+				Synt::SyntaxAnalysis(
+					file.lex_result->lexems,
+					std::move(merged_macroses),
+					result.macro_expansion_contexts,
+					file_path_hash );
+		}();
 
 	result.errors.insert( result.errors.end(), synt_result.error_messages.begin(), synt_result.error_messages.end() );
 
-	result.nodes_storage[node_index].ast= std::move( synt_result );
+	const bool has_errors= !synt_result.error_messages.empty();
+
+	result.nodes_storage[node_index].ast= std::make_shared<const Synt::SyntaxAnalysisResult>( std::move( synt_result ) );
 	result.nodes_storage[node_index].file_path_hash= std::move(file_path_hash);
+
+	// Store only results without errors, since errors are not serialized.
+	if( cache != nullptr && !has_errors )
+	{
+		if( const auto serialized_node=
+				SerializeSourceGraphNode( result, node_index, macro_expansion_contexts_begin, imported_macros_hash ) )
+			cache->StoreEntry( file_key, *serialized_node );
+	}
+
+	intern_result();
+	finish_node();
+
 	return node_index;
 }
 
@@ -154,17 +670,36 @@ SourceGraph LoadSourceGraph(
 	IVfs& vfs,
 	const SourceFilePathHashigFunction source_file_path_hashing_function,
 	const IVfs::Path& root_file_path,
-	const std::string_view prelude_code )
+	const std::string_view prelude_code,
+	ISourceGraphCache* const cache,
+	SyntaxAnalysisResultsInterner* const interner,
+	const size_t num_threads,
+	ISourceGraphLoadingTracer* const tracer )
 {
 	SourceGraph result;
 	result.macro_expansion_contexts= std::make_shared<Synt::MacroExpansionContexts>();
 
+	LoadingContext context{ vfs, source_file_path_hashing_function, cache, interner, tracer, {} };
+
+	const IVfs::Path root_file_full_path= vfs.GetFullFilePath( root_file_path, "" );
+
+	if( num_threads > 1 )
+	{
+		// Load and lex all files in parallel first.
+		PreloadFiles( context, root_file_full_path, num_threads );
+
+		// Syntax analysis results are normally taken from cache or interner.
+		// So, perform parallel syntax analysis only if they are not used.
+		if( cache == nullptr && interner == nullptr )
+			PerformPreliminarySyntaxAnalysis( context, root_file_full_path, num_threads );
+	}
+
+	// Build the graph sequentially, in order to obtain the same result as without parallel loading.
 	std::vector<std::string> processed_files_stack;
 	LoadNode_r(
-		vfs,
-		source_file_path_hashing_function,
+		context,
+		root_file_full_path,
 		root_file_path,
-		"",
 		processed_files_stack,
 		SrcLoc(0, 0, 0),
 		result );
@@ -206,7 +741,7 @@ SourceGraph LoadSourceGraph(
 		SourceGraph::Node prelude_node;
 		prelude_node.file_path= std::move(file_path);
 		prelude_node.file_path_hash= std::move(file_path_hash);
-		prelude_node.ast= std::move(synt_result);
+		prelude_node.ast= std::make_shared<const Synt::SyntaxAnalysisResult>( std::move(synt_result) );
 		prelude_node.category= SourceGraph::Node::Category::BuiltInPrelude;
 
 		result.nodes_storage.push_back( std::move(prelude_node) );
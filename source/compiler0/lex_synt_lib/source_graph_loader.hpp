@@ -1,5 +1,8 @@
 #pragma once
+#include "i_source_graph_cache.hpp"
+#include "i_source_graph_loading_tracer.hpp"
 #include "i_vfs.hpp"
+#include "syntax_analysis_results_interner.hpp"
 #include "syntax_analyzer.hpp"
 
 namespace U
@@ -20,7 +23,8 @@ struct SourceGraph
 		IVfs::Path file_path; // normalized
 		std::string file_path_hash;
 		std::vector<size_t> child_nodes_indices;
-		Synt::SyntaxAnalysisResult ast;
+		// Immutable, since it may be shared between multiple source graphs. Null if file loading failed.
+		std::shared_ptr<const Synt::SyntaxAnalysisResult> ast;
 		Category category= Category::SourceOrInternalImport;
 	};
 
@@ -38,6 +42,12 @@ SourceGraph LoadSourceGraph(
 	IVfs& vfs,
 	SourceFilePathHashigFunction source_file_path_hashing_function,
 	const IVfs::Path& root_file_path,
-	std::string_view prelude_code = "" );
+	std::string_view prelude_code = "",
+	ISourceGraphCache* cache= nullptr, // Optional cache for syntax analysis results of files.
+	SyntaxAnalysisResultsInterner* interner= nullptr, // Optional storage for sharing syntax analysis results between source graphs.
+	// If it's greater than 1, files are loaded and parsed in parallel. VFS should be thread-safe in such case.
+	// Result is the same as for sequential loading.
+	size_t num_threads= 1,
+	ISourceGraphLoadingTracer* tracer= nullptr ); // Optional tracer for measuring duration of files loading and parsing.
 
 } // namespace U
@@ -0,0 +1,1188 @@
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+#include "../../lex_synt_lib_common/assert.hpp"
+#include "source_graph_serialization.hpp"
+
+namespace U
+{
+
+namespace
+{
+
+// Increase this each time syntax elements or macro structures are changed.
+constexpr uint32_t c_format_version= 1;
+
+const char c_magic[4]= { 'U', 'S', 'G', 'N' };
+
+// Marker for SrcLoc with file index stored as-is.
+// Used for dummy SrcLoc (with zero line), which do not point to real files.
+constexpr uint32_t c_raw_file_index_marker= ~0u;
+
+} // namespace
+
+namespace Synt
+{
+
+namespace
+{
+
+//
+// Fields processing functions.
+// They are used both for writing (with const_cast) and reading.
+//
+
+template<typename S> void ProcessFields( S& s, RootNamespaceNameLookup& x ) { s( x.src_loc ); s( x.name ); }
+template<typename S> void ProcessFields( S& s, RootNamespaceNameLookupCompletion& x ) { s( x.src_loc ); s( x.name ); }
+template<typename S> void ProcessFields( S& s, NameLookup& x ) { s( x.src_loc ); s( x.name ); }
+template<typename S> void ProcessFields( S& s, NameLookupCompletion& x ) { s( x.src_loc ); s( x.name ); }
+template<typename S> void ProcessFields( S& s, IntegerNumericConstant& x ) { s( x.src_loc ); s( x.num ); s( x.type_suffix ); }
+template<typename S> void ProcessFields( S& s, FloatingPointNumericConstant& x ) { s( x.src_loc ); s( x.num ); s( x.type_suffix ); }
+template<typename S> void ProcessFields( S& s, BooleanConstant& x ) { s( x.src_loc ); s( x.value ); }
+template<typename S> void ProcessFields( S& s, MoveOperator& x ) { s( x.src_loc ); s( x.var_name ); }
+template<typename S> void ProcessFields( S& s, MoveOperatorCompletion& x ) { s( x.src_loc ); s( x.var_name ); }
+template<typename S> void ProcessFields( S& s, StringLiteral& x ) { s( x.src_loc ); s( x.value ); s( x.type_suffix ); }
+template<typename S> void ProcessFields( S& s, CharLiteral& x ) { s( x.src_loc ); s( x.code_point ); s( x.type_suffix ); }
+template<typename S> void ProcessFields( S& s, NamesScopeNameFetch& x ) { s( x.src_loc ); s( x.name ); s( x.base ); }
+template<typename S> void ProcessFields( S& s, NamesScopeNameFetchCompletion& x ) { s( x.src_loc ); s( x.name ); s( x.base ); }
+template<typename S> void ProcessFields( S& s, TemplateParameterization& x ) { s( x.src_loc ); s( x.template_args ); s( x.base ); }
+template<typename S> void ProcessFields( S& s, TupleType& x ) { s( x.src_loc ); s( x.element_types ); }
+template<typename S> void ProcessFields( S& s, RawPointerType& x ) { s( x.src_loc ); s( x.element_type ); }
+template<typename S> void ProcessFields( S& s, ArrayTypeName& x ) { s( x.src_loc ); s( x.element_type ); s( x.size ); }
+
+template<typename S> void ProcessFields( S& s, FunctionParam& x )
+{
+	s( x.src_loc );
+	s( x.name );
+	s( x.type );
+	s( x.mutability_modifier );
+	s( x.reference_modifier );
+}
+
+template<typename S> void ProcessFields( S& s, FunctionType& x )
+{
+	s( x.src_loc );
+	s( x.params );
+	s( x.calling_convention );
+	s( x.return_type );
+	s( x.references_pollution_expression );
+	s( x.return_value_reference_expression );
+	s( x.return_value_inner_references_expression );
+	s( x.return_value_mutability_modifier );
+	s( x.return_value_reference_modifier );
+	s( x.unsafe );
+}
+
+template<typename S> void ProcessFields( S& s, CoroutineType& x )
+{
+	s( x.src_loc );
+	s( x.inner_reference_mutability_modifier );
+	s( x.non_sync_tag );
+	s( x.return_type );
+	s( x.inner_references );
+	s( x.return_value_reference_expression );
+	s( x.return_value_inner_references_expression );
+	s( x.kind );
+	s( x.return_value_mutability_modifier );
+	s( x.return_value_reference_modifier );
+}
+
+template<typename S> void ProcessFields( S& s, TypeofTypeName& x ) { s( x.src_loc ); s( x.expression ); }
+template<typename S> void ProcessFields( S& s, TypeInfo& x ) { s( x.src_loc ); s( x.type ); }
+template<typename S> void ProcessFields( S& s, SameType& x ) { s( x.src_loc ); s( x.l ); s( x.r ); }
+template<typename S> void ProcessFields( S& s, NonSyncExpression& x ) { s( x.src_loc ); s( x.type ); }
+template<typename S> void ProcessFields( S& s, CallOperator& x ) { s( x.src_loc ); s( x.expression ); s( x.arguments ); }
+template<typename S> void ProcessFields( S& s, CallOperatorSignatureHelp& x ) { s( x.src_loc ); s( x.expression ); }
+template<typename S> void ProcessFields( S& s, SubscriptOperator& x ) { s( x.src_loc ); s( x.expression ); s( x.index ); }
+
+template<typename S> void ProcessFields( S& s, MemberAccessOperator& x )
+{
+	s( x.src_loc );
+	s( x.expression );
+	s( x.member_name );
+	s( x.template_args );
+	s( x.has_template_args );
+}
+
+template<typename S> void ProcessFields( S& s, AwaitOperator& x ) { s( x.src_loc ); s( x.expression ); }
+template<typename S> void ProcessFields( S& s, MemberAccessOperatorCompletion& x ) { s( x.src_loc ); s( x.expression ); s( x.member_name ); }
+template<typename S> void ProcessFields( S& s, UnaryMinus& x ) { s( x.src_loc ); s( x.expression ); }
+template<typename S> void ProcessFields( S& s, LogicalNot& x ) { s( x.src_loc ); s( x.expression ); }
+template<typename S> void ProcessFields( S& s, BitwiseNot& x ) { s( x.src_loc ); s( x.expression ); }
+template<typename S> void ProcessFields( S& s, SafeExpression& x ) { s( x.src_loc ); s( x.expression ); }
+template<typename S> void ProcessFields( S& s, UnsafeExpression& x ) { s( x.src_loc ); s( x.expression ); }
+template<typename S> void ProcessFields( S& s, BinaryOperator& x ) { s( x.src_loc ); s( x.operator_type ); s( x.left ); s( x.right ); }
+template<typename S> void ProcessFields( S& s, TernaryOperator& x ) { s( x.src_loc ); s( x.condition ); s( x.branches[0] ); s( x.branches[1] ); }
+template<typename S> void ProcessFields( S& s, ReferenceToRawPointerOperator& x ) { s( x.src_loc ); s( x.expression ); }
+template<typename S> void ProcessFields( S& s, RawPointerToReferenceOperator& x ) { s( x.src_loc ); s( x.expression ); }
+template<typename S> void ProcessFields( S& s, TakeOperator& x ) { s( x.src_loc ); s( x.expression ); }
+template<typename S> void ProcessFields( S& s, CastMut& x ) { s( x.src_loc ); s( x.expression ); }
+template<typename S> void ProcessFields( S& s, CastImut& x ) { s( x.src_loc ); s( x.expression ); }
+template<typename S> void ProcessFields( S& s, CastRef& x ) { s( x.src_loc ); s( x.type ); s( x.expression ); }
+template<typename S> void ProcessFields( S& s, CastRefUnsafe& x ) { s( x.src_loc ); s( x.type ); s( x.expression ); }
+template<typename S> void ProcessFields( S& s, Embed& x ) { s( x.src_loc ); s( x.element_type ); s( x.expression ); }
+template<typename S> void ProcessFields( S& s, ExternalFunctionAccess& x ) { s( x.src_loc ); s( x.type ); s( x.name ); }
+template<typename S> void ProcessFields( S& s, ExternalVariableAccess& x ) { s( x.src_loc ); s( x.type ); s( x.name ); }
+template<typename S> void ProcessFields( S& s, ZeroInitializer& x ) { s( x.src_loc ); }
+template<typename S> void ProcessFields( S& s, UninitializedInitializer& x ) { s( x.src_loc ); }
+template<typename S> void ProcessFields( S& s, SequenceInitializer& x ) { s( x.src_loc ); s( x.initializers ); s( x.filler ); }
+template<typename S> void ProcessFields( S& s, StructNamedInitializer& x ) { s( x.src_loc ); s( x.members_initializers ); }
+template<typename S> void ProcessFields( S& s, ConstructorInitializer& x ) { s( x.src_loc ); s( x.arguments ); }
+template<typename S> void ProcessFields( S& s, ConstructorInitializerSignatureHelp& x ) { s( x.src_loc ); s( x.arguments ); }
+
+template<typename S> void ProcessFields( S& s, StructNamedInitializer::MemberInitializer& x )
+{
+	s( x.src_loc );
+	s( x.name );
+	s( x.initializer );
+	s( x.completion_requested );
+}
+
+template<typename S> void ProcessFields( S& s, Label& x ) { s( x.src_loc ); s( x.name ); }
+template<typename S> void ProcessFields( S& s, Block& x ) { s( x.src_loc ); s( x.end_src_loc ); s( x.elements ); }
+template<typename S> void ProcessFields( S& s, ScopeBlock& x ) { s( x.src_loc ); s( x.block ); s( x.label ); s( x.safety ); }
+
+template<typename S> void ProcessFields( S& s, VariablesDeclaration::VariableEntry& x )
+{
+	s( x.src_loc );
+	s( x.name );
+	s( x.initializer );
+	s( x.mutability_modifier );
+	s( x.reference_modifier );
+	s( x.is_thread_local );
+}
+
+template<typename S> void ProcessFields( S& s, VariablesDeclaration& x ) { s( x.src_loc ); s( x.type ); s( x.variables ); }
+
+template<typename S> void ProcessFields( S& s, AutoVariableDeclaration& x )
+{
+	s( x.src_loc );
+	s( x.name );
+	s( x.initializer_expression );
+	s( x.mutability_modifier );
+	s( x.reference_modifier );
+}
+
+template<typename S> void ProcessFields( S& s, DecomposeDeclarationNamedComponent& x ) { s( x.src_loc ); s( x.name ); s( x.mutability_modifier ); }
+template<typename S> void ProcessFields( S& s, DecomposeDeclarationSequenceComponent& x ) { s( x.src_loc ); s( x.sub_components ); }
+template<typename S> void ProcessFields( S& s, DecomposeDeclarationStructComponent& x ) { s( x.src_loc ); s( x.entries ); }
+
+template<typename S> void ProcessFields( S& s, DecomposeDeclarationStructComponent::Entry& x )
+{
+	s( x.src_loc );
+	s( x.name );
+	s( x.component );
+	s( x.completion_requested );
+}
+
+template<typename S> void ProcessFields( S& s, DecomposeDeclaration& x ) { s( x.src_loc ); s( x.root_component ); s( x.initializer_expression ); }
+template<typename S> void ProcessFields( S& s, AllocaDeclaration& x ) { s( x.src_loc ); s( x.type ); s( x.name ); s( x.size ); }
+template<typename S> void ProcessFields( S& s, ReturnOperator& x ) { s( x.src_loc ); s( x.expression ); }
+template<typename S> void ProcessFields( S& s, YieldOperator& x ) { s( x.src_loc ); s( x.expression ); }
+template<typename S> void ProcessFields( S& s, WhileOperator& x ) { s( x.src_loc ); s( x.condition ); s( x.label ); s( x.block ); }
+template<typename S> void ProcessFields( S& s, LoopOperator& x ) { s( x.src_loc ); s( x.label ); s( x.block ); }
+
+template<typename S> void ProcessFields( S& s, RangeForOperator& x )
+{
+	s( x.src_loc );
+	s( x.loop_variable_name );
+	s( x.sequence );
+	s( x.label );
+	s( x.block );
+	s( x.reference_modifier );
+	s( x.mutability_modifier );
+}
+
+template<typename S> void ProcessFields( S& s, CStyleForOperator& x )
+{
+	s( x.src_loc );
+	s( x.variable_declaration_part );
+	s( x.loop_condition );
+	s( x.iteration_part_elements );
+	s( x.label );
+	s( x.block );
+}
+
+template<typename S> void ProcessFields( S& s, BreakOperator& x ) { s( x.src_loc ); s( x.label ); }
+template<typename S> void ProcessFields( S& s, ContinueOperator& x ) { s( x.src_loc ); s( x.label ); }
+
+template<typename S> void ProcessFields( S& s, WithOperator& x )
+{
+	s( x.src_loc );
+	s( x.variable_name );
+	s( x.expression );
+	s( x.block );
+	s( x.reference_modifier );
+	s( x.mutability_modifier );
+}
+
+template<typename S> void ProcessFields( S& s, IfOperator& x )
+{
+	s( x.src_loc );
+	s( x.end_src_loc );
+	s( x.condition );
+	s( x.block );
+	s( x.alternative );
+}
+
+template<typename S> void ProcessFields( S& s, StaticIfOperator& x ) { s( x.src_loc ); s( x.condition ); s( x.block ); s( x.alternative ); }
+
+template<typename S> void ProcessFields( S& s, IfCoroAdvanceOperator& x )
+{
+	s( x.src_loc );
+	s( x.end_src_loc );
+	s( x.variable_name );
+	s( x.expression );
+	s( x.block );
+	s( x.alternative );
+	s( x.reference_modifier );
+	s( x.mutability_modifier );
+}
+
+template<typename S> void ProcessFields( S& s, SwitchOperator::CaseRange& x ) { s( x.low ); s( x.high ); }
+template<typename S> void ProcessFields( S& s, SwitchOperator::Case& x ) { s( x.values ); s( x.block ); }
+template<typename S> void ProcessFields( S& s, SwitchOperator& x ) { s( x.src_loc ); s( x.end_src_loc ); s( x.value ); s( x.cases ); }
+template<typename S> void ProcessFields( S& s, SingleExpressionOperator& x ) { s( x.src_loc ); s( x.expression ); }
+template<typename S> void ProcessFields( S& s, AssignmentOperator& x ) { s( x.src_loc ); s( x.l_value ); s( x.r_value ); }
+
+template<typename S> void ProcessFields( S& s, CompoundAssignmentOperator& x )
+{
+	s( x.src_loc );
+	s( x.compound_operation );
+	s( x.l_value );
+	s( x.r_value );
+}
+
+template<typename S> void ProcessFields( S& s, IncrementOperator& x ) { s( x.src_loc ); s( x.expression ); }
+template<typename S> void ProcessFields( S& s, DecrementOperator& x ) { s( x.src_loc ); s( x.expression ); }
+template<typename S> void ProcessFields( S& s, StaticAssert& x ) { s( x.src_loc ); s( x.expression ); s( x.message ); }
+template<typename S> void ProcessFields( S& s, Halt& x ) { s( x.src_loc ); }
+template<typename S> void ProcessFields( S& s, HaltIf& x ) { s( x.src_loc ); s( x.condition ); }
+template<typename S> void ProcessFields( S& s, Function::NameComponent& x ) { s( x.name ); s( x.src_loc ); s( x.completion_requested ); }
+
+template<typename S> void ProcessFields( S& s, Function& x )
+{
+	s( x.src_loc );
+	s( x.name );
+	s( x.condition );
+	s( x.type );
+	s( x.constructor_initialization_list );
+	s( x.block );
+	s( x.coroutine_non_sync_tag );
+	s( x.overloaded_operator );
+	s( x.virtual_function_kind );
+	s( x.body_kind );
+	s( x.kind );
+	s( x.no_mangle );
+	s( x.no_discard );
+	s( x.is_conversion_constructor );
+	s( x.constexpr_ );
+}
+
+template<typename S> void ProcessFields( S& s, Lambda::CaptureListElement& x )
+{
+	s( x.src_loc );
+	s( x.name );
+	s( x.expression );
+	s( x.by_reference );
+	s( x.completion_requested );
+}
+
+template<typename S> void ProcessFields( S& s, Lambda& x ) { s( x.src_loc ); s( x.capture ); s( x.function ); }
+template<typename S> void ProcessFields( S& s, VariableInitialization& x ) { s( x.src_loc ); s( x.type ); s( x.initializer ); }
+template<typename S> void ProcessFields( S& s, TypeAlias& x ) { s( x.src_loc ); s( x.name ); s( x.value ); }
+template<typename S> void ProcessFields( S& s, Enum::Member& x ) { s( x.src_loc ); s( x.name ); }
+
+template<typename S> void ProcessFields( S& s, Enum& x )
+{
+	s( x.src_loc );
+	s( x.name );
+	s( x.underlying_type_name );
+	s( x.members );
+	s( x.no_discard );
+}
+
+template<typename S> void ProcessFields( S& s, Class& x )
+{
+	s( x.src_loc );
+	s( x.elements );
+	s( x.name );
+	s( x.parents );
+	s( x.non_sync_tag );
+	s( x.kind_attribute );
+	s( x.keep_fields_order );
+	s( x.no_discard );
+}
+
+template<typename S> void ProcessFields( S& s, ClassField& x )
+{
+	s( x.src_loc );
+	s( x.type );
+	s( x.name );
+	s( x.initializer );
+	s( x.reference_tag_expression );
+	s( x.inner_reference_tags_expression );
+	s( x.mutability_modifier );
+	s( x.reference_modifier );
+}
+
+template<typename S> void ProcessFields( S& s, TemplateParam::VariableParamData& x ) { s( x.type ); }
+template<typename S> void ProcessFields( S& s, TemplateParam& x ) { s( x.src_loc ); s( x.kind_data ); s( x.name ); }
+template<typename S> void ProcessFields( S& s, TypeTemplate::SignatureParam& x ) { s( x.name ); s( x.default_value ); }
+
+template<typename S> void ProcessFields( S& s, TypeTemplate& x )
+{
+	s( x.src_loc );
+	s( x.name );
+	s( x.params );
+	s( x.signature_params );
+	s( x.something );
+	s( x.is_short_form );
+}
+
+template<typename S> void ProcessFields( S& s, FunctionTemplate& x ) { s( x.src_loc ); s( x.params ); s( x.function ); }
+template<typename S> void ProcessFields( S& s, Namespace& x ) { s( x.src_loc ); s( x.name ); s( x.elements ); }
+template<typename S> void ProcessFields( S& s, Mixin& x ) { s( x.src_loc ); s( x.expression ); }
+template<typename S> void ProcessFields( S& s, Import& x ) { s( x.src_loc ); s( x.import_name ); }
+template<typename S> void ProcessFields( S& s, Lexem& x ) { s( x.text ); s( x.src_loc ); s( x.type ); }
+
+template<typename S> void ProcessFields( S& s, Macro::MatchElement& x )
+{
+	s( x.kind );
+	s( x.block_check_lexem_kind );
+	s( x.lexem );
+	s( x.name );
+	s( x.sub_elements );
+}
+
+template<typename S> void ProcessFields( S& s, Macro::ResultElement& x ) { s( x.kind ); s( x.lexem ); s( x.name ); s( x.sub_elements ); }
+
+template<typename S> void ProcessFields( S& s, Macro& x )
+{
+	s( x.src_loc );
+	s( x.name );
+	s( x.match_template_elements );
+	s( x.result_template_elements );
+}
+
+template<typename S> void ProcessFields( S& s, MacroExpansionContext& x ) { s( x.macro_name ); s( x.macro_declaration_src_loc ); s( x.src_loc ); }
+
+template<typename T, typename ... Ts>
+constexpr uint32_t GetTypeIndex()
+{
+	uint32_t index= 0;
+	const bool found= ( ( std::is_same_v<T, Ts> ? true : ( ++index, false ) ) || ... );
+	(void)found;
+	return index;
+}
+
+class Writer
+{
+public:
+	Writer( const SourceGraph& source_graph, const size_t macro_expansion_contexts_begin, const bool write_file_indices= false )
+		: source_graph_(source_graph)
+		, macro_expansion_contexts_begin_(macro_expansion_contexts_begin)
+		, write_file_indices_(write_file_indices)
+	{}
+
+	// Writer for declarations comparison. Source locations are skipped, bodies of some functions are collected (if declarations are not null).
+	Writer( const SourceGraph& source_graph, SourceGraphNodeDeclarations* const declarations )
+		: source_graph_(source_graph)
+		, macro_expansion_contexts_begin_(0)
+		, write_file_indices_(false)
+		, skip_src_locs_(true)
+		, declarations_(declarations)
+	{}
+
+	bool IsFailed() const { return failed_; }
+	const std::string& GetData() const { return data_; }
+	const std::vector<IVfs::Path>& GetReferencedFiles() const { return referenced_files_; }
+
+	void operator()( const bool b ) { WriteRaw( uint8_t(b ? 1 : 0) ); }
+	void operator()( const uint32_t x ) { WriteRaw( x ); }
+	void operator()( const uint64_t x ) { WriteRaw( x ); }
+
+	void operator()( const std::string& s )
+	{
+		WriteRaw( uint32_t(s.size()) );
+		data_+= s;
+	}
+
+	void operator()( const Int128& x ) { WriteRaw( x.lo ); WriteRaw( x.hi ); }
+
+	void operator()( const std::array<char, 8>& a ) { data_.append( a.data(), a.size() ); }
+
+	void operator()( const SrcLoc& src_loc )
+	{
+		if( skip_src_locs_ )
+			return;
+
+		const uint32_t file_index= src_loc.GetFileIndex();
+		if( src_loc.GetLine() == 0 )
+		{
+			WriteRaw( c_raw_file_index_marker );
+			WriteRaw( file_index );
+		}
+		else
+		{
+			const auto it= file_index_to_referenced_file_index_.find( file_index );
+			if( it == file_index_to_referenced_file_index_.end() )
+			{
+				if( file_index >= source_graph_.nodes_storage.size() )
+				{
+					failed_= true;
+					return;
+				}
+				const uint32_t referenced_file_index= uint32_t(referenced_files_.size());
+				referenced_files_.push_back( source_graph_.nodes_storage[file_index].file_path );
+				file_index_to_referenced_file_index_.emplace( file_index, referenced_file_index );
+				WriteRaw( referenced_file_index );
+			}
+			else
+				WriteRaw( it->second );
+
+			if( write_file_indices_ )
+				WriteRaw( file_index );
+		}
+
+		const uint32_t macro_expansion_index= src_loc.GetMacroExpansionIndex();
+		if( macro_expansion_index == SrcLoc::c_max_macro_expanison_index )
+			WriteRaw( macro_expansion_index );
+		else if( macro_expansion_index < macro_expansion_contexts_begin_ )
+			failed_= true; // Reference to macro expansion of other node.
+		else
+			WriteRaw( uint32_t( macro_expansion_index - macro_expansion_contexts_begin_ ) );
+
+		WriteRaw( src_loc.GetLine() );
+		WriteRaw( src_loc.GetColumn() );
+	}
+
+	void operator()( const ClassVisibilityLabel& x )
+	{
+		(*this)( x.src_loc );
+		(*this)( x.visibility );
+	}
+
+	void operator()( const Namespace& x )
+	{
+		prefix_.push_back( &x );
+		WriteFields( x );
+		prefix_.pop_back();
+	}
+
+	void operator()( const Class& x )
+	{
+		prefix_.push_back( &x );
+		WriteFields( x );
+		prefix_.pop_back();
+	}
+
+	// Templates are built lazily and lambdas are built together with enclosing code, so, write bodies of functions inside them.
+	void operator()( const TypeTemplate& x ) { ++bodies_required_depth_; WriteFields( x ); --bodies_required_depth_; }
+	void operator()( const FunctionTemplate& x ) { ++bodies_required_depth_; WriteFields( x ); --bodies_required_depth_; }
+	void operator()( const Lambda& x ) { ++bodies_required_depth_; WriteFields( x ); --bodies_required_depth_; }
+
+	void operator()( const Function& x )
+	{
+		// Bodies of constexpr functions and functions with auto return type may affect other program elements.
+		// Errors in bodies of functions from macro expansions are reported in expansion contexts, so, do not skip them too.
+		if( declarations_ == nullptr ||
+			bodies_required_depth_ > 0 ||
+			x.block == nullptr ||
+			x.constexpr_ ||
+			x.type.IsAutoReturn() ||
+			x.src_loc.GetMacroExpansionIndex() != SrcLoc::c_max_macro_expanison_index )
+		{
+			WriteFields( x );
+			return;
+		}
+
+		Writer body_writer( source_graph_, nullptr );
+		body_writer( x.constructor_initialization_list );
+		body_writer( x.block );
+		declarations_->functions.push_back( SourceGraphNodeDeclarations::FunctionWithBody{ prefix_, &x, body_writer.GetData() } );
+
+		// Write all fields except body.
+		(*this)( x.name );
+		(*this)( x.condition );
+		(*this)( x.type );
+		(*this)( x.constructor_initialization_list != nullptr );
+		(*this)( x.block != nullptr );
+		(*this)( x.coroutine_non_sync_tag );
+		(*this)( x.overloaded_operator );
+		(*this)( x.virtual_function_kind );
+		(*this)( x.body_kind );
+		(*this)( x.kind );
+		(*this)( x.no_mangle );
+		(*this)( x.no_discard );
+		(*this)( x.is_conversion_constructor );
+		(*this)( x.constexpr_ );
+	}
+
+	template<typename T>
+	void operator()( const std::vector<T>& v )
+	{
+		WriteRaw( uint32_t(v.size()) );
+		for( const T& el : v )
+			(*this)( el );
+	}
+
+	template<typename T>
+	void operator()( const std::optional<T>& o )
+	{
+		(*this)( o != std::nullopt );
+		if( o != std::nullopt )
+			(*this)( *o );
+	}
+
+	template<typename T>
+	void operator()( const ArenaPtr<const T>& ptr )
+	{
+		(*this)( ptr != nullptr );
+		if( ptr != nullptr )
+			(*this)( *ptr );
+	}
+
+	template<typename T>
+	void operator()( const std::shared_ptr<T>& ptr )
+	{
+		(*this)( ptr != nullptr );
+		if( ptr != nullptr )
+			(*this)( *ptr );
+	}
+
+	template<typename ... Ts>
+	void operator()( const std::variant<Ts...>& v )
+	{
+		WriteRaw( uint32_t(v.index()) );
+		std::visit( [&]( const auto& el ) { (*this)( el ); }, v );
+	}
+
+	template<typename ... Ts>
+	void operator()( const VariantLinkedList<Ts...>& list )
+	{
+		uint32_t size= 0;
+		list.Iter( [&]( const auto& ) { ++size; } );
+		WriteRaw( size );
+
+		list.Iter(
+			[&]( const auto& el )
+			{
+				WriteRaw( GetTypeIndex< std::decay_t<decltype(el)>, Ts... >() );
+				(*this)( el );
+			} );
+	}
+
+	template<typename K, typename V>
+	void operator()( const std::unordered_map<K, V>& m )
+	{
+		// Write elements in sorted order in order to obtain deterministic result.
+		std::vector< const std::pair<const K, V>* > elements;
+		elements.reserve( m.size() );
+		for( const auto& pair : m )
+			elements.push_back( &pair );
+
+		std::sort(
+			elements.begin(), elements.end(),
+			[]( const auto l, const auto r ) { return l->first < r->first; } );
+
+		WriteRaw( uint32_t(elements.size()) );
+		for( const auto pair : elements )
+		{
+			(*this)( pair->first );
+			(*this)( pair->second );
+		}
+	}
+
+	template<typename T>
+	void operator()( const T& x )
+	{
+		if constexpr( std::is_enum_v<T> )
+			WriteRaw( uint32_t(x) );
+		else if constexpr( std::is_empty_v<T> )
+		{} // Nothing to write.
+		else
+			WriteFields( x );
+	}
+
+private:
+	template<typename T>
+	void WriteFields( const T& x )
+	{
+		ProcessFields( *this, const_cast<T&>(x) ); // Writer doesn't modify anything.
+	}
+
+	template<typename T>
+	void WriteRaw( const T& x )
+	{
+		static_assert( std::is_trivially_copyable_v<T> );
+		char bytes[sizeof(T)];
+		std::memcpy( bytes, &x, sizeof(T) );
+		data_.append( bytes, sizeof(T) );
+	}
+
+private:
+	const SourceGraph& source_graph_;
+	const size_t macro_expansion_contexts_begin_;
+	const bool write_file_indices_;
+	const bool skip_src_locs_= false;
+	SourceGraphNodeDeclarations* const declarations_= nullptr;
+	std::string data_;
+	std::vector<IVfs::Path> referenced_files_;
+	std::unordered_map<uint32_t, uint32_t> file_index_to_referenced_file_index_;
+	std::vector<SourceGraphNodeDeclarations::PrefixComponent> prefix_;
+	uint32_t bodies_required_depth_= 0;
+	bool failed_= false;
+};
+
+template<typename T> struct Tag{};
+
+// Create value, which is later filled with read data.
+template<typename T>
+T MakeEmpty( Tag<T> )
+{
+	if constexpr( std::is_default_constructible_v<T> )
+		return T();
+	else
+		return T( SrcLoc() );
+}
+
+BooleanConstant MakeEmpty( Tag<BooleanConstant> ) { return BooleanConstant( SrcLoc(), false ); }
+ScopeBlock MakeEmpty( Tag<ScopeBlock> ) { return ScopeBlock( Block( SrcLoc() ) ); }
+
+NamesScopeNameFetch MakeEmpty( Tag<NamesScopeNameFetch> )
+{
+	return NamesScopeNameFetch{ SrcLoc(), "", RootNamespaceNameLookup( SrcLoc() ) };
+}
+
+NamesScopeNameFetchCompletion MakeEmpty( Tag<NamesScopeNameFetchCompletion> )
+{
+	return NamesScopeNameFetchCompletion{ SrcLoc(), "", RootNamespaceNameLookup( SrcLoc() ) };
+}
+
+TemplateParameterization MakeEmpty( Tag<TemplateParameterization> )
+{
+	return TemplateParameterization{ SrcLoc(), {}, RootNamespaceNameLookup( SrcLoc() ) };
+}
+
+DecomposeDeclaration MakeEmpty( Tag<DecomposeDeclaration> )
+{
+	return DecomposeDeclaration( SrcLoc(), DecomposeDeclarationNamedComponent( SrcLoc() ) );
+}
+
+DecomposeDeclarationStructComponent::Entry MakeEmpty( Tag<DecomposeDeclarationStructComponent::Entry> )
+{
+	return DecomposeDeclarationStructComponent::Entry{ SrcLoc(), "", DecomposeDeclarationNamedComponent( SrcLoc() ), false };
+}
+
+SwitchOperator::Case MakeEmpty( Tag<SwitchOperator::Case> )
+{
+	return SwitchOperator::Case{ SwitchOperator::DefaultPlaceholder(), Block( SrcLoc() ) };
+}
+
+class Reader
+{
+public:
+	Reader(
+		const std::string_view data,
+		Arena& arena,
+		std::vector<uint32_t> referenced_files_indices,
+		const uint32_t macro_expansion_contexts_begin,
+		const uint32_t num_macro_expansion_contexts )
+		: data_(data)
+		, arena_(arena)
+		, referenced_files_indices_(std::move(referenced_files_indices))
+		, macro_expansion_contexts_begin_(macro_expansion_contexts_begin)
+		, num_macro_expansion_contexts_(num_macro_expansion_contexts)
+	{}
+
+	bool IsFailed() const { return failed_; }
+	bool IsAtEnd() const { return data_.empty(); }
+
+	void SetNumMacroExpansionContexts( const uint32_t num_macro_expansion_contexts )
+	{
+		num_macro_expansion_contexts_= num_macro_expansion_contexts;
+	}
+
+	template<typename T>
+	T Read() { return Read( Tag<T>() ); }
+
+	// Read in-place. Used for fields processing.
+	template<typename T>
+	void operator()( T& x ) { x= Read<T>(); }
+
+	bool Read( Tag<bool> ) { return ReadRaw<uint8_t>() != 0; }
+	uint32_t Read( Tag<uint32_t> ) { return ReadRaw<uint32_t>(); }
+	uint64_t Read( Tag<uint64_t> ) { return ReadRaw<uint64_t>(); }
+
+	std::string Read( Tag<std::string> )
+	{
+		const uint32_t size= ReadRaw<uint32_t>();
+		if( size > data_.size() )
+		{
+			failed_= true;
+			return std::string();
+		}
+
+		std::string result( data_.substr( 0, size ) );
+		data_.remove_prefix( size );
+		return result;
+	}
+
+	Int128 Read( Tag<Int128> )
+	{
+		Int128 result;
+		result.lo= ReadRaw<uint64_t>();
+		result.hi= ReadRaw<uint64_t>();
+		return result;
+	}
+
+	std::array<char, 8> Read( Tag< std::array<char, 8> > )
+	{
+		std::array<char, 8> result{0};
+		if( data_.size() < result.size() )
+		{
+			failed_= true;
+			return result;
+		}
+
+		std::memcpy( result.data(), data_.data(), result.size() );
+		data_.remove_prefix( result.size() );
+		return result;
+	}
+
+	SrcLoc Read( Tag<SrcLoc> )
+	{
+		const uint32_t file_index_raw= ReadRaw<uint32_t>();
+		uint32_t file_index= 0;
+		if( file_index_raw == c_raw_file_index_marker )
+			file_index= ReadRaw<uint32_t>();
+		else if( file_index_raw < referenced_files_indices_.size() )
+			file_index= referenced_files_indices_[ file_index_raw ];
+		else
+			failed_= true;
+
+		uint32_t macro_expansion_index= ReadRaw<uint32_t>();
+		if( macro_expansion_index != SrcLoc::c_max_macro_expanison_index )
+		{
+			if( macro_expansion_index < num_macro_expansion_contexts_ )
+				macro_expansion_index+= macro_expansion_contexts_begin_;
+			else
+			{
+				failed_= true;
+				macro_expansion_index= SrcLoc::c_max_macro_expanison_index;
+			}
+		}
+
+		const uint32_t line= ReadRaw<uint32_t>();
+		const uint32_t column= ReadRaw<uint32_t>();
+
+		if( failed_ ||
+			file_index > SrcLoc::c_max_file_index ||
+			line > SrcLoc::c_max_line ||
+			column > SrcLoc::c_max_column )
+		{
+			failed_= true;
+			return SrcLoc();
+		}
+
+		SrcLoc result( file_index, line, column );
+		result.SetMacroExpansionIndex( macro_expansion_index );
+		return result;
+	}
+
+	ClassVisibilityLabel Read( Tag<ClassVisibilityLabel> )
+	{
+		const SrcLoc src_loc= Read<SrcLoc>();
+		const auto visibility= Read<ClassMemberVisibility>();
+		return ClassVisibilityLabel( src_loc, visibility );
+	}
+
+	template<typename T>
+	std::vector<T> Read( Tag< std::vector<T> > )
+	{
+		const uint32_t size= ReadSize();
+
+		std::vector<T> result;
+		result.reserve( size );
+		for( uint32_t i= 0; i < size; ++i )
+			result.push_back( Read<T>() );
+
+		return result;
+	}
+
+	template<typename T>
+	std::optional<T> Read( Tag< std::optional<T> > )
+	{
+		if( Read<bool>() )
+			return Read<T>();
+		return std::nullopt;
+	}
+
+	template<typename T>
+	ArenaPtr<const T> Read( Tag< ArenaPtr<const T> > )
+	{
+		if( Read<bool>() )
+			return arena_.New<const T>( Read<T>() );
+		return nullptr;
+	}
+
+	template<typename T>
+	std::shared_ptr<T> Read( Tag< std::shared_ptr<T> > )
+	{
+		if( Read<bool>() )
+			return std::make_shared<T>( Read<T>() );
+		return nullptr;
+	}
+
+	template<typename ... Ts>
+	std::variant<Ts...> Read( Tag< std::variant<Ts...> > )
+	{
+		return ReadVariantImpl<Ts...>( ReadRaw<uint32_t>(), std::index_sequence_for<Ts...>() );
+	}
+
+	template<typename ... Ts>
+	VariantLinkedList<Ts...> Read( Tag< VariantLinkedList<Ts...> > )
+	{
+		const uint32_t size= ReadSize();
+
+		typename VariantLinkedList<Ts...>::Builder builder( arena_ );
+		for( uint32_t i= 0; i < size; ++i )
+		{
+			const uint32_t index= ReadRaw<uint32_t>();
+
+			uint32_t current_index= 0;
+			const bool found= ( ( index == current_index++ ? ( builder.Append( Read<Ts>() ), true ) : false ) || ... );
+			if( !found )
+			{
+				failed_= true;
+				break;
+			}
+		}
+
+		return builder.Build();
+	}
+
+	template<typename K, typename V>
+	std::unordered_map<K, V> Read( Tag< std::unordered_map<K, V> > )
+	{
+		const uint32_t size= ReadSize();
+
+		std::unordered_map<K, V> result;
+		for( uint32_t i= 0; i < size; ++i )
+		{
+			K key= Read<K>();
+			result.emplace( std::move(key), Read<V>() );
+		}
+
+		return result;
+	}
+
+	template<typename T>
+	T Read( Tag<T> )
+	{
+		if constexpr( std::is_enum_v<T> )
+			return T( ReadRaw<uint32_t>() );
+		else if constexpr( std::is_empty_v<T> )
+			return T();
+		else
+		{
+			T result= MakeEmpty( Tag<T>() );
+			ProcessFields( *this, result );
+			return result;
+		}
+	}
+
+private:
+	template<typename T>
+	T ReadRaw()
+	{
+		static_assert( std::is_trivially_copyable_v<T> );
+		T result{};
+		if( data_.size() < sizeof(T) )
+		{
+			failed_= true;
+			return result;
+		}
+
+		std::memcpy( &result, data_.data(), sizeof(T) );
+		data_.remove_prefix( sizeof(T) );
+		return result;
+	}
+
+	uint32_t ReadSize()
+	{
+		// Each element takes at least one byte. So, larger sizes are definitely wrong.
+		const uint32_t size= ReadRaw<uint32_t>();
+		if( size > data_.size() )
+		{
+			failed_= true;
+			return 0;
+		}
+		return size;
+	}
+
+	template<typename ... Ts, size_t ... Indices>
+	std::variant<Ts...> ReadVariantImpl( uint32_t index, std::index_sequence<Indices...> )
+	{
+		if( index >= sizeof...(Ts) )
+		{
+			// Read first variant element instead. This is safe, since reading in failed state reads nothing.
+			failed_= true;
+			index= 0;
+		}
+
+		std::optional< std::variant<Ts...> > result;
+		( ( index == Indices ? ( result.emplace( std::in_place_index<Indices>, Read<Ts>() ), true ) : false ) || ... );
+		return std::move(*result);
+	}
+
+private:
+	std::string_view data_;
+	Arena& arena_; // Allocate syntax elements here.
+	const std::vector<uint32_t> referenced_files_indices_;
+	const uint32_t macro_expansion_contexts_begin_;
+	uint32_t num_macro_expansion_contexts_;
+	bool failed_= false;
+};
+
+} // namespace
+
+} // namespace Synt
+
+namespace
+{
+
+template<typename T>
+void AppendRaw( std::string& out, const T& x )
+{
+	static_assert( std::is_trivially_copyable_v<T> );
+	char bytes[sizeof(T)];
+	std::memcpy( bytes, &x, sizeof(T) );
+	out.append( bytes, sizeof(T) );
+}
+
+void AppendString( std::string& out, const std::string_view s )
+{
+	AppendRaw( out, uint32_t(s.size()) );
+	out+= s;
+}
+
+template<typename T>
+bool TakeRaw( std::string_view& data, T& out )
+{
+	static_assert( std::is_trivially_copyable_v<T> );
+	if( data.size() < sizeof(T) )
+		return false;
+
+	std::memcpy( &out, data.data(), sizeof(T) );
+	data.remove_prefix( sizeof(T) );
+	return true;
+}
+
+bool TakeString( std::string_view& data, std::string& out )
+{
+	uint32_t size= 0;
+	if( !TakeRaw( data, size ) || size > data.size() )
+		return false;
+
+	out= data.substr( 0, size );
+	data.remove_prefix( size );
+	return true;
+}
+
+} // namespace
+
+std::string SerializeImportedMacros( const SourceGraph& source_graph, const Synt::MacrosByContextMap& macros, const bool include_file_indices )
+{
+	Synt::Writer writer( source_graph, 0, include_file_indices );
+	writer( macros );
+
+	// Include paths of referenced files, since file indices may be different for different graphs.
+	std::string result;
+	AppendRaw( result, uint32_t( writer.GetReferencedFiles().size() ) );
+	for( const IVfs::Path& path : writer.GetReferencedFiles() )
+		AppendString( result, path );
+
+	result+= writer.GetData();
+	return result;
+}
+
+std::optional<std::string> SerializeSourceGraphNode(
+	const SourceGraph& source_graph,
+	const size_t node_index,
+	const size_t macro_expansion_contexts_begin,
+	const std::string_view imported_macros_hash )
+{
+	U_ASSERT( node_index < source_graph.nodes_storage.size() );
+	const SourceGraph::Node& node= source_graph.nodes_storage[node_index];
+	if( node.ast == nullptr )
+		return std::nullopt;
+
+	const Synt::MacroExpansionContexts& macro_expansion_contexts= *source_graph.macro_expansion_contexts;
+	U_ASSERT( macro_expansion_contexts_begin <= macro_expansion_contexts.size() );
+
+	Synt::Writer writer( source_graph, macro_expansion_contexts_begin );
+
+	writer( uint32_t( macro_expansion_contexts.size() - macro_expansion_contexts_begin ) );
+	for( size_t i= macro_expansion_contexts_begin; i < macro_expansion_contexts.size(); ++i )
+		writer( macro_expansion_contexts[i] );
+
+	writer( node.ast->macros );
+	writer( node.ast->program_elements );
+
+	if( writer.IsFailed() )
+		return std::nullopt;
+
+	std::string result;
+	result.append( c_magic, sizeof(c_magic) );
+	AppendRaw( result, c_format_version );
+
+	// Imports are stored separately, since they are needed before other data may be loaded.
+	AppendRaw( result, uint32_t( node.ast->imports.size() ) );
+	for( const Synt::Import& import : node.ast->imports )
+	{
+		AppendRaw( result, import.src_loc.GetLine() );
+		AppendRaw( result, import.src_loc.GetColumn() );
+		AppendString( result, import.import_name );
+	}
+
+	AppendString( result, imported_macros_hash );
+
+	AppendRaw( result, uint32_t( writer.GetReferencedFiles().size() ) );
+	for( const IVfs::Path& path : writer.GetReferencedFiles() )
+		AppendString( result, path );
+
+	result+= writer.GetData();
+
+	return result;
+}
+
+std::optional<SerializedSourceGraphNode> ReadSerializedSourceGraphNode( std::string_view data, const uint32_t file_index )
+{
+	if( data.size() < sizeof(c_magic) || std::memcmp( data.data(), c_magic, sizeof(c_magic) ) != 0 )
+		return std::nullopt;
+	data.remove_prefix( sizeof(c_magic) );
+
+	uint32_t format_version= 0;
+	if( !TakeRaw( data, format_version ) || format_version != c_format_version )
+		return std::nullopt;
+
+	SerializedSourceGraphNode result;
+
+	uint32_t num_imports= 0;
+	if( !TakeRaw( data, num_imports ) || num_imports > data.size() )
+		return std::nullopt;
+
+	result.imports.reserve( num_imports );
+	for( uint32_t i= 0; i < num_imports; ++i )
+	{
+		uint32_t line= 0, column= 0;
+		if( !TakeRaw( data, line ) || !TakeRaw( data, column ) || line > SrcLoc::c_max_line || column > SrcLoc::c_max_column )
+			return std::nullopt;
+
+		Synt::Import import( SrcLoc( file_index, line, column ) );
+		if( !TakeString( data, import.import_name ) )
+			return std::nullopt;
+
+		result.imports.push_back( std::move(import) );
+	}
+
+	if( !TakeString( data, result.imported_macros_hash ) )
+		return std::nullopt;
+
+	uint32_t num_referenced_files= 0;
+	if( !TakeRaw( data, num_referenced_files ) || num_referenced_files > data.size() )
+		return std::nullopt;
+
+	result.referenced_files.resize( num_referenced_files );
+	for( IVfs::Path& path : result.referenced_files )
+		if( !TakeString( data, path ) )
+			return std::nullopt;
+
+	result.body= data;
+	return result;
+}
+
+bool DeserializeSourceGraphNode( const SerializedSourceGraphNode& serialized_node, SourceGraph& source_graph, const size_t node_index )
+{
+	U_ASSERT( node_index < source_graph.nodes_storage.size() );
+
+	// Map referenced files to indices of already loaded nodes.
+	std::vector<uint32_t> referenced_files_indices;
+	referenced_files_indices.reserve( serialized_node.referenced_files.size() );
+	for( const IVfs::Path& path : serialized_node.referenced_files )
+	{
+		bool found= false;
+		for( size_t i= 0; i < source_graph.nodes_storage.size(); ++i )
+		{
+			if( source_graph.nodes_storage[i].file_path == path )
+			{
+				referenced_files_indices.push_back( uint32_t(i) );
+				found= true;
+				break;
+			}
+		}
+		if( !found )
+			return false;
+	}
+
+	Synt::MacroExpansionContexts& macro_expansion_contexts= *source_graph.macro_expansion_contexts;
+
+	Synt::SyntaxAnalysisResult ast;
+
+	Synt::Reader reader(
+		serialized_node.body,
+		ast.arena,
+		std::move(referenced_files_indices),
+		uint32_t( macro_expansion_contexts.size() ),
+		0 );
+
+	const uint32_t num_macro_expansion_contexts= reader.Read<uint32_t>();
+	// Avoid exceeding macro expansions limit, which may produce different result compared to normal parsing.
+	if( reader.IsFailed() ||
+		macro_expansion_contexts.size() + num_macro_expansion_contexts > Synt::c_max_macro_expansions )
+		return false;
+
+	// Nested macro expansions reference previous expansions, so, set expansions number before reading them.
+	reader.SetNumMacroExpansionContexts( num_macro_expansion_contexts );
+
+	Synt::MacroExpansionContexts new_macro_expansion_contexts;
+	new_macro_expansion_contexts.reserve( num_macro_expansion_contexts );
+	for( uint32_t i= 0; i < num_macro_expansion_contexts; ++i )
+		new_macro_expansion_contexts.push_back( reader.Read<Synt::MacroExpansionContext>() );
+
+	ast.imports= serialized_node.imports;
+	ast.macros= reader.Read<Synt::MacrosPtr>();
+	ast.program_elements= reader.Read<Synt::ProgramElementsList>();
+
+	if( reader.IsFailed() || !reader.IsAtEnd() || ast.macros == nullptr )
+		return false;
+
+	macro_expansion_contexts.insert(
+		macro_expansion_contexts.end(),
+		std::make_move_iterator( new_macro_expansion_contexts.begin() ),
+		std::make_move_iterator( new_macro_expansion_contexts.end() ) );
+
+	source_graph.nodes_storage[node_index].ast= std::make_shared<const Synt::SyntaxAnalysisResult>( std::move(ast) );
+	return true;
+}
+
+SourceGraphNodeDeclarations SerializeSourceGraphNodeDeclarations( const SourceGraph& source_graph, const size_t node_index )
+{
+	U_ASSERT( node_index < source_graph.nodes_storage.size() );
+	const SourceGraph::Node& node= source_graph.nodes_storage[node_index];
+
+	SourceGraphNodeDeclarations result;
+	if( node.ast == nullptr )
+		return result;
+
+	Synt::Writer writer( source_graph, &result );
+	writer( node.ast->program_elements );
+	result.data= writer.GetData();
+
+	return result;
+}
+
+} // namespace U
@@ -0,0 +1,60 @@
+#pragma once
+#include "source_graph_loader.hpp"
+
+namespace U
+{
+
+// Binary serialization of syntax analysis results of source graph nodes. Used for source graph caching.
+// File indices in SrcLoc are stored as file paths, macro expansion indices are stored relative to the first macro expansion of the node.
+// Serialized data depends on host byte order and is valid only for the same compiler version.
+
+struct SerializedSourceGraphNode
+{
+	std::vector<Synt::Import> imports;
+	std::string imported_macros_hash;
+	std::vector<IVfs::Path> referenced_files;
+	std::string_view body; // Points into source data.
+};
+
+// Serialize macros, imported into a node, in order to calculate hash of them.
+// If file indices are included, result is valid only for source graphs with same files order.
+std::string SerializeImportedMacros( const SourceGraph& source_graph, const Synt::MacrosByContextMap& macros, bool include_file_indices= false );
+
+// Macro expansions of the node are expected to be placed at the end of the macro expansion contexts storage, starting with given index.
+// Returns empty optional if serialization isn't possible.
+std::optional<std::string> SerializeSourceGraphNode(
+	const SourceGraph& source_graph,
+	size_t node_index,
+	size_t macro_expansion_contexts_begin,
+	std::string_view imported_macros_hash );
+
+// Read only node header, which is needed to load imports.
+// Returns empty optional if data is invalid.
+std::optional<SerializedSourceGraphNode> ReadSerializedSourceGraphNode( std::string_view data, uint32_t file_index );
+
+// Set syntax analysis result of given node and append its macro expansion contexts.
+// All referenced files should be already loaded.
+// Returns false if data is invalid.
+bool DeserializeSourceGraphNode( const SerializedSourceGraphNode& serialized_node, SourceGraph& source_graph, size_t node_index );
+
+struct SourceGraphNodeDeclarations
+{
+	using PrefixComponent= std::variant<const Synt::Namespace*, const Synt::Class*>;
+
+	struct FunctionWithBody
+	{
+		std::vector<PrefixComponent> prefix; // Namespaces and classes, where this function is located.
+		const Synt::Function* function= nullptr;
+		std::string body; // Serialized body without source locations.
+	};
+
+	std::string data; // Serialized program elements without source locations and skipped bodies.
+	std::vector<FunctionWithBody> functions; // Functions with skipped bodies, in order of appearance.
+};
+
+// Serialize program elements of a node, skipping source locations and bodies of functions, which can't affect anything outside these functions.
+// Two nodes with equal data differ only in element positions and bodies of such functions.
+// Pointers in result point to syntax elements of the given node.
+SourceGraphNodeDeclarations SerializeSourceGraphNodeDeclarations( const SourceGraph& source_graph, size_t node_index );
+
+} // namespace U
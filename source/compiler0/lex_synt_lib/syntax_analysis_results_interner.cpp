@@ -0,0 +1,71 @@
+#include "syntax_analysis_results_interner.hpp"
+
+namespace U
+{
+
+std::optional< std::vector<Synt::Import> > SyntaxAnalysisResultsInterner::GetImports( const std::string& file_key )
+{
+	const std::lock_guard<std::mutex> lock( mutex_ );
+
+	const auto it= files_.find( file_key );
+	if( it == files_.end() )
+		return std::nullopt;
+
+	return it->second.imports;
+}
+
+SyntaxAnalysisResultsInterner::EntryPtr SyntaxAnalysisResultsInterner::Find( const std::string& file_key, const std::string& context_key )
+{
+	const std::lock_guard<std::mutex> lock( mutex_ );
+
+	const auto file_it= files_.find( file_key );
+	if( file_it == files_.end() )
+		return nullptr;
+
+	const auto it= file_it->second.entries.find( context_key );
+	if( it == file_it->second.entries.end() )
+		return nullptr;
+
+	return it->second;
+}
+
+SyntaxAnalysisResultsInterner::EntryPtr SyntaxAnalysisResultsInterner::Add( const std::string& file_key, const std::string& context_key, Entry entry )
+{
+	const std::lock_guard<std::mutex> lock( mutex_ );
+
+	FileEntries& file_entries= files_[file_key];
+	if( file_entries.entries.empty() )
+		file_entries.imports= entry.ast->imports;
+
+	EntryPtr& entry_ptr= file_entries.entries[context_key];
+	if( entry_ptr == nullptr )
+		entry_ptr= std::make_shared<const Entry>( std::move(entry) );
+
+	return entry_ptr;
+}
+
+void SyntaxAnalysisResultsInterner::RemoveUnusedEntries()
+{
+	const std::lock_guard<std::mutex> lock( mutex_ );
+
+	// It's safe to check use count here, since new references to entries may be created only under the lock.
+	// An entry is unused if no one holds the entry itself and its syntax analysis result.
+	for( auto file_it= files_.begin(); file_it != files_.end(); )
+	{
+		auto& entries= file_it->second.entries;
+		for( auto it= entries.begin(); it != entries.end(); )
+		{
+			if( it->second.use_count() == 1 && it->second->ast.use_count() == 1 )
+				it= entries.erase(it);
+			else
+				++it;
+		}
+
+		if( entries.empty() )
+			file_it= files_.erase(file_it);
+		else
+			++file_it;
+	}
+}
+
+} // namespace U
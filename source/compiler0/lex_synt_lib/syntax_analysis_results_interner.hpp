@@ -0,0 +1,57 @@
+#pragma once
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+#include "syntax_analyzer.hpp"
+
+namespace U
+{
+
+// In-memory storage of syntax analysis results, which allows to share them between multiple source graphs.
+// Entries are identified by two keys - a key of the file (based on its path and contents)
+// and a key of the context (imported macros, file index, macro expansion contexts offset), since parsing result depends on them.
+// Syntax analysis results contain source graph-relative file indices and macro expansion contexts indices.
+// So, an entry is shared only if file has the same position in different source graphs, which isn't always the case.
+// Entries are not removed automatically, so, call "RemoveUnusedEntries" periodically.
+// This class is thread-safe.
+class SyntaxAnalysisResultsInterner
+{
+public:
+	struct Entry
+	{
+		std::shared_ptr<const Synt::SyntaxAnalysisResult> ast; // Non-null.
+		// Macro expansions performed during parsing. Should be appended to macro expansion contexts of the source graph.
+		Synt::MacroExpansionContexts macro_expansion_contexts;
+	};
+
+	using EntryPtr= std::shared_ptr<const Entry>;
+
+public:
+	// Returns imports of any added entry for given file.
+	std::optional< std::vector<Synt::Import> > GetImports( const std::string& file_key );
+
+	// Returns null if not found.
+	EntryPtr Find( const std::string& file_key, const std::string& context_key );
+
+	// Returns previously added entry, if it already exists.
+	EntryPtr Add( const std::string& file_key, const std::string& context_key, Entry entry );
+
+	// Free entries, which are not used outside.
+	void RemoveUnusedEntries();
+
+private:
+	struct FileEntries
+	{
+		std::vector<Synt::Import> imports;
+		std::unordered_map<std::string, EntryPtr> entries; // By context key.
+	};
+
+private:
+	std::mutex mutex_;
+	std::unordered_map<std::string, FileEntries> files_;
+};
+
+using SyntaxAnalysisResultsInternerPtr= std::shared_ptr<SyntaxAnalysisResultsInterner>;
+
+} // namespace U
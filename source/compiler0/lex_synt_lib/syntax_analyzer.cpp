@@ -135,6 +135,7 @@ public:
 	// Input lexems must outlive this class instance!
 	SyntaxAnalyzer(
 		const Lexems& lexems,
+		Arena& arena,
 		MacrosPtr macros,
 		MacroExpansionContextsPtr macro_expansion_contexts,
 		std::string macro_unique_identifiers_base_name,
@@ -303,6 +304,7 @@ private:
 	void PushErrorMessage();
 
 private:
+	Arena& arena_; // All syntax elements are allocated here.
 	LexSyntErrors error_messages_;
 	Lexems::const_iterator it_;
 	const Lexems::const_iterator it_end_;
@@ -318,11 +320,13 @@ private:
 
 SyntaxAnalyzer::SyntaxAnalyzer(
 	const Lexems& lexems,
+	Arena& arena,
 	MacrosPtr macros,
 	MacroExpansionContextsPtr macro_expansion_contexts,
 	std::string macro_unique_identifiers_base_name,
 	const size_t macro_expansion_depth )
-	: it_(lexems.begin())
+	: arena_(arena)
+	, it_(lexems.begin())
 	, it_end_(lexems.end())
 	, macro_unique_identifiers_base_name_(std::move(macro_unique_identifiers_base_name))
 	, last_error_it_(lexems.end())
@@ -753,7 +757,7 @@ ProgramElementsList SyntaxAnalyzer::ParseNamespaceBodyToNamespaceEnd()
 
 ProgramElementsList SyntaxAnalyzer::ParseNamespaceBodyImpl( const Lexem::Type end_lexem )
 {
-	ProgramElementsList::Builder result_builder;
+	ProgramElementsList::Builder result_builder( arena_ );
 
 	while( NotEndOfFile() )
 	{
@@ -946,7 +950,7 @@ template<size_t priority> Expression SyntaxAnalyzer::TryParseBinaryOperatorRight
 	{
 		if( it_->type == op_pair.first )
 		{
-			auto binary_operator= std::make_unique<BinaryOperator>( it_->src_loc );
+			auto binary_operator= arena_.New<BinaryOperator>( it_->src_loc );
 			NextLexem();
 
 			binary_operator->left= std::move(l);
@@ -979,7 +983,7 @@ Expression SyntaxAnalyzer::TryParseBinaryOperatorComponentPostfixOperator( Expre
 	{
 	case Lexem::Type::SquareBracketLeft:
 		{
-			auto subscript_opearator= std::make_unique<SubscriptOperator>( it_->src_loc );
+			auto subscript_opearator= arena_.New<SubscriptOperator>( it_->src_loc );
 			NextLexem();
 
 			subscript_opearator->expression= std::move(expr);
@@ -992,7 +996,7 @@ Expression SyntaxAnalyzer::TryParseBinaryOperatorComponentPostfixOperator( Expre
 
 	case Lexem::Type::BracketLeft:
 		{
-			auto call_operator= std::make_unique<CallOperator>( it_->src_loc );
+			auto call_operator= arena_.New<CallOperator>( it_->src_loc );
 
 			call_operator->expression= std::move(expr);
 
@@ -1001,7 +1005,7 @@ Expression SyntaxAnalyzer::TryParseBinaryOperatorComponentPostfixOperator( Expre
 				call_operator->arguments= std::move(*args);
 			else if( std::holds_alternative< SignatureHelpTag >( call_result ) )
 			{
-				auto signature_help_result= std::make_unique<CallOperatorSignatureHelp>( it_->src_loc );
+				auto signature_help_result= arena_.New<CallOperatorSignatureHelp>( it_->src_loc );
 				NextLexem();
 				signature_help_result->expression= std::move(call_operator->expression);
 				return std::move(signature_help_result);
@@ -1013,7 +1017,7 @@ Expression SyntaxAnalyzer::TryParseBinaryOperatorComponentPostfixOperator( Expre
 
 	case Lexem::Type::SignatureHelpBracketLeft:
 		{
-			auto call_operator_signature_help= std::make_unique<CallOperatorSignatureHelp>( it_->src_loc );
+			auto call_operator_signature_help= arena_.New<CallOperatorSignatureHelp>( it_->src_loc );
 			NextLexem();
 
 			call_operator_signature_help->expression= std::move(expr);
@@ -1027,7 +1031,7 @@ Expression SyntaxAnalyzer::TryParseBinaryOperatorComponentPostfixOperator( Expre
 
 			if( it_->type == Lexem::Type::Identifier && it_->text == Keywords::await_ )
 			{
-				auto await_operator= std::make_unique<AwaitOperator>( it_->src_loc );
+				auto await_operator= arena_.New<AwaitOperator>( it_->src_loc );
 				NextLexem();
 
 				await_operator->expression= std::move(expr);
@@ -1036,7 +1040,7 @@ Expression SyntaxAnalyzer::TryParseBinaryOperatorComponentPostfixOperator( Expre
 			}
 			else if( it_->type == Lexem::Type::Identifier )
 			{
-				auto member_access_operator= std::make_unique<MemberAccessOperator>( it_->src_loc );
+				auto member_access_operator= arena_.New<MemberAccessOperator>( it_->src_loc );
 				member_access_operator->member_name= it_->text;
 				NextLexem();
 
@@ -1052,7 +1056,7 @@ Expression SyntaxAnalyzer::TryParseBinaryOperatorComponentPostfixOperator( Expre
 			}
 			else if( it_->type == Lexem::Type::CompletionIdentifier )
 			{
-				auto member_access_operator_completion= std::make_unique<MemberAccessOperatorCompletion>( it_->src_loc );
+				auto member_access_operator_completion= arena_.New<MemberAccessOperatorCompletion>( it_->src_loc );
 				member_access_operator_completion->member_name= it_->text;
 				NextLexem();
 
@@ -1069,7 +1073,7 @@ Expression SyntaxAnalyzer::TryParseBinaryOperatorComponentPostfixOperator( Expre
 
 	case Lexem::Type::CompletionDot:
 		{
-			auto member_access_operator_completion= std::make_unique<MemberAccessOperatorCompletion>( it_->src_loc );
+			auto member_access_operator_completion= arena_.New<MemberAccessOperatorCompletion>( it_->src_loc );
 			member_access_operator_completion->member_name= "";
 			NextLexem();
 
@@ -1081,7 +1085,7 @@ Expression SyntaxAnalyzer::TryParseBinaryOperatorComponentPostfixOperator( Expre
 	case Lexem::Type::BraceLeft:
 		{
 			// Parse struct initializer for "{" in expression context.
-			auto variable_initialization= std::make_unique<VariableInitialization>( it_->src_loc );
+			auto variable_initialization= arena_.New<VariableInitialization>( it_->src_loc );
 			variable_initialization->type= std::move(expr);
 			variable_initialization->initializer= ParseStructNamedInitializer();
 
@@ -1099,7 +1103,7 @@ Expression SyntaxAnalyzer::ParseBinaryOperatorComponentCore()
 	{
 	case Lexem::Type::Minus:
 		{
-			auto unary_minus= std::make_unique<UnaryMinus>( it_->src_loc );
+			auto unary_minus= arena_.New<UnaryMinus>( it_->src_loc );
 			NextLexem();
 
 			unary_minus->expression= ParseBinaryOperatorComponent();
@@ -1107,7 +1111,7 @@ Expression SyntaxAnalyzer::ParseBinaryOperatorComponentCore()
 		}
 	case Lexem::Type::Exclamation:
 		{
-			auto logical_not= std::make_unique<LogicalNot>( it_->src_loc );
+			auto logical_not= arena_.New<LogicalNot>( it_->src_loc );
 			NextLexem();
 
 			logical_not->expression= ParseBinaryOperatorComponent();
@@ -1115,7 +1119,7 @@ Expression SyntaxAnalyzer::ParseBinaryOperatorComponentCore()
 		}
 	case Lexem::Type::Tilde:
 		{
-			auto bitwise_not= std::make_unique<BitwiseNot>( it_->src_loc );
+			auto bitwise_not= arena_.New<BitwiseNot>( it_->src_loc );
 			NextLexem();
 
 			bitwise_not->expression= ParseBinaryOperatorComponent();
@@ -1127,10 +1131,10 @@ Expression SyntaxAnalyzer::ParseBinaryOperatorComponentCore()
 	case Lexem::Type::IntegerNumber:
 		return ParseIntegerNumericConstant();
 	case Lexem::Type::FloatingPointNumber:
-		return std::make_unique< FloatingPointNumericConstant >( ParseFloatingPointNumericConstant() );
+		return arena_.New< FloatingPointNumericConstant >( ParseFloatingPointNumericConstant() );
 	case Lexem::Type::String:
 		{
-			auto string_literal= std::make_unique<StringLiteral>( it_->src_loc );
+			auto string_literal= arena_.New<StringLiteral>( it_->src_loc );
 			string_literal->value= it_->text;
 			NextLexem();
 
@@ -1183,7 +1187,7 @@ Expression SyntaxAnalyzer::ParseBinaryOperatorComponentCore()
 			if( it_->type == Lexem::Type::Question )
 			{
 				// Ternary operator.
-				auto ternary_operator= std::make_unique<TernaryOperator>( it_->src_loc );
+				auto ternary_operator= arena_.New<TernaryOperator>( it_->src_loc );
 				ternary_operator->condition= std::move(expr);
 				NextLexem();
 
@@ -1204,7 +1208,7 @@ Expression SyntaxAnalyzer::ParseBinaryOperatorComponentCore()
 			return TypeNameToExpression( ParseTypeName() );
 	case Lexem::Type::DollarLess:
 		{
-			auto reference_to_raw_pointer_operator= std::make_unique<ReferenceToRawPointerOperator>( it_->src_loc );
+			auto reference_to_raw_pointer_operator= arena_.New<ReferenceToRawPointerOperator>( it_->src_loc );
 			NextLexem();
 
 			reference_to_raw_pointer_operator->expression= ParseExpressionInBrackets();
@@ -1213,7 +1217,7 @@ Expression SyntaxAnalyzer::ParseBinaryOperatorComponentCore()
 		}
 	case Lexem::Type::DollarGreater:
 		{
-			auto raw_pointer_to_reference_operator= std::make_unique<RawPointerToReferenceOperator>( it_->src_loc );
+			auto raw_pointer_to_reference_operator= arena_.New<RawPointerToReferenceOperator>( it_->src_loc );
 			NextLexem();
 
 			raw_pointer_to_reference_operator->expression= ParseExpressionInBrackets();
@@ -1265,7 +1269,7 @@ Expression SyntaxAnalyzer::ParseBinaryOperatorComponentCore()
 		}
 		if( it_->text == Keywords::take_ )
 		{
-			auto take_operator= std::make_unique<TakeOperator>( it_->src_loc );
+			auto take_operator= arena_.New<TakeOperator>( it_->src_loc );
 			NextLexem();
 
 			take_operator->expression= ParseExpressionInBrackets();
@@ -1273,10 +1277,10 @@ Expression SyntaxAnalyzer::ParseBinaryOperatorComponentCore()
 			return std::move(take_operator);
 		}
 		if( it_->text == Keywords::lambda_ )
-			return std::make_unique<Lambda>( ParseLambda() );
+			return arena_.New<Lambda>( ParseLambda() );
 		if( it_->text == Keywords::cast_ref_ )
 		{
-			auto cast= std::make_unique<CastRef>( it_->src_loc );
+			auto cast= arena_.New<CastRef>( it_->src_loc );
 			NextLexem();
 			cast->type= ParseTypeNameInTemplateBrackets();
 			cast->expression= ParseExpressionInBrackets();
@@ -1285,7 +1289,7 @@ Expression SyntaxAnalyzer::ParseBinaryOperatorComponentCore()
 		}
 		if( it_->text == Keywords::cast_ref_unsafe_ )
 		{
-			auto cast= std::make_unique<CastRefUnsafe>( it_->src_loc );
+			auto cast= arena_.New<CastRefUnsafe>( it_->src_loc );
 			NextLexem();
 			cast->type= ParseTypeNameInTemplateBrackets();
 			cast->expression= ParseExpressionInBrackets();
@@ -1294,7 +1298,7 @@ Expression SyntaxAnalyzer::ParseBinaryOperatorComponentCore()
 		}
 		if( it_->text == Keywords::cast_imut_ )
 		{
-			auto cast= std::make_unique<CastImut>( it_->src_loc );
+			auto cast= arena_.New<CastImut>( it_->src_loc );
 			NextLexem();
 			cast->expression= ParseExpressionInBrackets();
 
@@ -1302,7 +1306,7 @@ Expression SyntaxAnalyzer::ParseBinaryOperatorComponentCore()
 		}
 		if( it_->text == Keywords::cast_mut_ )
 		{
-			auto cast= std::make_unique<CastMut>( it_->src_loc );
+			auto cast= arena_.New<CastMut>( it_->src_loc );
 			NextLexem();
 			cast->expression= ParseExpressionInBrackets();
 
@@ -1310,7 +1314,7 @@ Expression SyntaxAnalyzer::ParseBinaryOperatorComponentCore()
 		}
 		if( it_->text == Keywords::embed_ )
 		{
-			auto embed= std::make_unique<Embed>( it_->src_loc );
+			auto embed= arena_.New<Embed>( it_->src_loc );
 			NextLexem();
 
 			if( it_->type == Lexem::Type::TemplateBracketLeft )
@@ -1332,7 +1336,7 @@ Expression SyntaxAnalyzer::ParseBinaryOperatorComponentCore()
 			if( it_->type == Lexem::Type::Identifier && it_->text == Keywords::fn_ )
 			{
 				NextLexem();
-				auto external_function_access= std::make_unique<ExternalFunctionAccess>( src_loc );
+				auto external_function_access= arena_.New<ExternalFunctionAccess>( src_loc );
 
 				external_function_access->type= ParseTypeNameInTemplateBrackets();
 
@@ -1353,7 +1357,7 @@ Expression SyntaxAnalyzer::ParseBinaryOperatorComponentCore()
 			else if( it_->type == Lexem::Type::Identifier && it_->text == Keywords::var_ )
 			{
 				NextLexem();
-				auto external_variable_access= std::make_unique<ExternalVariableAccess>( src_loc );
+				auto external_variable_access= arena_.New<ExternalVariableAccess>( src_loc );
 
 				external_variable_access->type= ParseTypeNameInTemplateBrackets();
 
@@ -1376,7 +1380,7 @@ Expression SyntaxAnalyzer::ParseBinaryOperatorComponentCore()
 		}
 		if( it_->text == Keywords::typeinfo_ )
 		{
-			auto typeinfo_= std::make_unique<TypeInfo>(it_->src_loc );
+			auto typeinfo_= arena_.New<TypeInfo>(it_->src_loc );
 			NextLexem();
 			typeinfo_->type= ParseTypeNameInTemplateBrackets();
 
@@ -1384,7 +1388,7 @@ Expression SyntaxAnalyzer::ParseBinaryOperatorComponentCore()
 		}
 		if( it_->text == Keywords::same_type_ )
 		{
-			auto same_type= std::make_unique<SameType>(it_->src_loc );
+			auto same_type= arena_.New<SameType>(it_->src_loc );
 
 			NextLexem();
 			ExpectLexem( Lexem::Type::TemplateBracketLeft );
@@ -1397,7 +1401,7 @@ Expression SyntaxAnalyzer::ParseBinaryOperatorComponentCore()
 		}
 		if( it_->text == Keywords::non_sync_ )
 		{
-			auto non_sync_expression= std::make_unique<NonSyncExpression>(it_->src_loc );
+			auto non_sync_expression= arena_.New<NonSyncExpression>(it_->src_loc );
 			NextLexem();
 			non_sync_expression->type= ParseTypeNameInTemplateBrackets();
 
@@ -1405,7 +1409,7 @@ Expression SyntaxAnalyzer::ParseBinaryOperatorComponentCore()
 		}
 		if( it_->text == Keywords::safe_ )
 		{
-			auto expr= std::make_unique<SafeExpression>( it_->src_loc );
+			auto expr= arena_.New<SafeExpression>( it_->src_loc );
 			NextLexem();
 			expr->expression= ParseExpressionInBrackets();
 
@@ -1413,14 +1417,14 @@ Expression SyntaxAnalyzer::ParseBinaryOperatorComponentCore()
 		}
 		if( it_->text == Keywords::unsafe_ )
 		{
-			auto expr= std::make_unique<UnsafeExpression>( it_->src_loc );
+			auto expr= arena_.New<UnsafeExpression>( it_->src_loc );
 			NextLexem();
 			expr->expression= ParseExpressionInBrackets();
 
 			return std::move(expr);
 		}
 		if( it_->text == Keywords::mixin_ )
-			return std::make_unique<Mixin>( ParseExpressionMixin() );
+			return arena_.New<Mixin>( ParseExpressionMixin() );
 		if( it_->text == Keywords::fn_ ||
 			it_->text == Keywords::typeof_ ||
 			it_->text == Keywords::tup_ ||
@@ -1506,7 +1510,7 @@ void SyntaxAnalyzer::ParseFunctionTypeEnding( FunctionType& result )
 	if( it_->type == Lexem::Type::At )
 	{
 		NextLexem();
-		result.references_pollution_expression= std::make_unique<Expression>( ParseExpressionInBrackets() );
+		result.references_pollution_expression= arena_.New<Expression>( ParseExpressionInBrackets() );
 	}
 
 	if( it_->type == Lexem::Type::Identifier && it_->text == Keywords::unsafe_ )
@@ -1518,19 +1522,19 @@ void SyntaxAnalyzer::ParseFunctionTypeEnding( FunctionType& result )
 	if( it_->type == Lexem::Type::Identifier && it_->text == Keywords::call_conv_ )
 	{
 		NextLexem();
-		result.calling_convention= std::make_unique<Expression>( ParseExpressionInBrackets() );
+		result.calling_convention= arena_.New<Expression>( ParseExpressionInBrackets() );
 	}
 
 	if( it_->type == Lexem::Type::Colon )
 	{
 		NextLexem();
 
-		result.return_type= std::make_unique<TypeName>( ParseTypeName() );
+		result.return_type= arena_.New<TypeName>( ParseTypeName() );
 
 		if( it_->type == Lexem::Type::At )
 		{
 			NextLexem();
-			result.return_value_inner_references_expression= std::make_unique<Expression>( ParseExpressionInBrackets() );
+			result.return_value_inner_references_expression= arena_.New<Expression>( ParseExpressionInBrackets() );
 		}
 
 		if( it_->type == Lexem::Type::Ampersand )
@@ -1552,7 +1556,7 @@ void SyntaxAnalyzer::ParseFunctionTypeEnding( FunctionType& result )
 			if( it_->type == Lexem::Type::At )
 			{
 				NextLexem();
-				result.return_value_reference_expression= std::make_unique<Expression>( ParseExpressionInBrackets() );
+				result.return_value_reference_expression= arena_.New<Expression>( ParseExpressionInBrackets() );
 			}
 		}
 	}
@@ -1754,7 +1758,7 @@ Lambda SyntaxAnalyzer::ParseLambda()
 			false } );
 
 	// Lambdas always have a body.
-	result.function.block= std::make_unique<Block>( ParseBlock() );
+	result.function.block= arena_.New<Block>( ParseBlock() );
 
 	return result;
 }
@@ -1763,7 +1767,7 @@ TypeName SyntaxAnalyzer::ParseTypeName()
 {
 	if( it_->type == Lexem::Type::SquareBracketLeft )
 	{
-		auto array_type_name= std::make_unique<ArrayTypeName>(it_->src_loc);
+		auto array_type_name= arena_.New<ArrayTypeName>(it_->src_loc);
 
 		NextLexem();
 		array_type_name->element_type= ParseTypeName();
@@ -1827,7 +1831,7 @@ TypeName SyntaxAnalyzer::ParseTypeName()
 	}
 	else if( it_->type == Lexem::Type::Dollar )
 	{
-		auto raw_pointer_type= std::make_unique<RawPointerType>( it_->src_loc );
+		auto raw_pointer_type= arena_.New<RawPointerType>( it_->src_loc );
 		NextLexem();
 
 		ExpectLexem( Lexem::Type::BracketLeft );
@@ -1884,7 +1888,7 @@ TypeName SyntaxAnalyzer::ParseTypeName()
 		if( it_->type == Lexem::Type::At )
 		{
 			NextLexem();
-			coroutine_type.return_value_inner_references_expression= std::make_unique<Expression>( ParseExpressionInBrackets() );
+			coroutine_type.return_value_inner_references_expression= arena_.New<Expression>( ParseExpressionInBrackets() );
 		}
 
 		if( it_->type == Lexem::Type::Ampersand )
@@ -1909,16 +1913,16 @@ TypeName SyntaxAnalyzer::ParseTypeName()
 			if( it_->type == Lexem::Type::At )
 			{
 				NextLexem();
-				coroutine_type.return_value_reference_expression= std::make_unique<Expression>( ParseExpressionInBrackets() );
+				coroutine_type.return_value_reference_expression= arena_.New<Expression>( ParseExpressionInBrackets() );
 			}
 		}
 
-		return std::make_unique<CoroutineType>(std::move(coroutine_type));
+		return arena_.New<CoroutineType>(std::move(coroutine_type));
 	}
 	else if( it_->type == Lexem::Type::Identifier && it_->text == Keywords::fn_ )
-		return std::make_unique<FunctionType>( ParseFunctionType() );
+		return arena_.New<FunctionType>( ParseFunctionType() );
 	else if( it_->type == Lexem::Type::Identifier && it_->text == Keywords::mixin_ )
-		return std::make_unique<Mixin>( ParseExpressionMixin() );
+		return arena_.New<Mixin>( ParseExpressionMixin() );
 	else
 		return ComplexNameToTypeName( ParseComplexName() );
 }
@@ -1999,7 +2003,7 @@ ComplexName SyntaxAnalyzer::ParseComplexName()
 	{
 		if( it_->text == Keywords::typeof_ )
 		{
-			auto typeof_type_name= std::make_unique<TypeofTypeName>( it_->src_loc );
+			auto typeof_type_name= arena_.New<TypeofTypeName>( it_->src_loc );
 			NextLexem();
 			typeof_type_name->expression=  ParseExpressionInBrackets();
 			return ParseComplexNameTail( std::move( typeof_type_name ) );
@@ -2043,7 +2047,7 @@ ComplexName SyntaxAnalyzer::ParseComplexNameTail( ComplexName base )
 			const std::string& name= it_->text;
 			NextLexem();
 
-			return TryParseComplexNameTailWithTemplateArgs( std::make_unique<NamesScopeNameFetch>( NamesScopeNameFetch{ src_loc, name, std::move(base) } ) );
+			return TryParseComplexNameTailWithTemplateArgs( arena_.New<NamesScopeNameFetch>( NamesScopeNameFetch{ src_loc, name, std::move(base) } ) );
 		}
 		else if( it_->type == Lexem::Type::CompletionIdentifier )
 		{
@@ -2051,7 +2055,7 @@ ComplexName SyntaxAnalyzer::ParseComplexNameTail( ComplexName base )
 			const std::string& name= it_->text;
 			NextLexem();
 
-			return std::make_unique<NamesScopeNameFetchCompletion>( NamesScopeNameFetchCompletion{ src_loc, name, std::move(base) } );
+			return arena_.New<NamesScopeNameFetchCompletion>( NamesScopeNameFetchCompletion{ src_loc, name, std::move(base) } );
 		}
 		else
 		{
@@ -2065,7 +2069,7 @@ ComplexName SyntaxAnalyzer::ParseComplexNameTail( ComplexName base )
 		const std::string name= ""; // Complete with empty string.
 		NextLexem(); // Skip ::
 
-		return std::make_unique<NamesScopeNameFetchCompletion>( NamesScopeNameFetchCompletion{ src_loc, name, std::move(base) } );
+		return arena_.New<NamesScopeNameFetchCompletion>( NamesScopeNameFetchCompletion{ src_loc, name, std::move(base) } );
 	}
 	else
 		return base;
@@ -2076,7 +2080,7 @@ ComplexName SyntaxAnalyzer::TryParseComplexNameTailWithTemplateArgs( ComplexName
 	if( it_->type == Lexem::Type::TemplateBracketLeft )
 	{
 		const SrcLoc src_loc= it_->src_loc;
-		return ParseComplexNameTail( std::make_unique<TemplateParameterization>( TemplateParameterization{ src_loc, ParseTemplateArgs(), std::move(base) } ) );
+		return ParseComplexNameTail( arena_.New<TemplateParameterization>( TemplateParameterization{ src_loc, ParseTemplateArgs(), std::move(base) } ) );
 	}
 	else
 		return ParseComplexNameTail( std::move(base) );
@@ -2348,7 +2352,7 @@ VariablesDeclaration SyntaxAnalyzer::ParseVariablesDeclaration()
 
 		Initializer variable_initializer= ParseVariableInitializer();
 		if( !std::holds_alternative<EmptyVariant>( variable_initializer ) )
-			variable_entry.initializer= std::make_unique<Initializer>( std::move(variable_initializer) );
+			variable_entry.initializer= arena_.New<Initializer>( std::move(variable_initializer) );
 
 		if( it_->type == Lexem::Type::Comma )
 			NextLexem();
@@ -2397,7 +2401,7 @@ VariablesDeclaration SyntaxAnalyzer::ParseThreadLocalVariablesDeclaration()
 
 		Initializer initializer= ParseVariableInitializer();
 		if( !std::holds_alternative<EmptyVariant>( initializer ) )
-			variable_entry.initializer= std::make_unique<Initializer>( std::move(initializer) );
+			variable_entry.initializer= arena_.New<Initializer>( std::move(initializer) );
 
 		decl.variables.push_back( std::move(variable_entry) );
 
@@ -2834,7 +2838,7 @@ CStyleForOperator SyntaxAnalyzer::ParseCStyleForOperator()
 
 	ExpectSemicolon();
 
-	CStyleForOperator::IterationPartElementsList::Builder iteration_part_elements_list_builder;
+	CStyleForOperator::IterationPartElementsList::Builder iteration_part_elements_list_builder( arena_ );
 	while( NotEndOfFile() && it_->type != Lexem::Type::BracketRight )
 	{
 		if( it_->type == Lexem::Type::DoublePlus )
@@ -3270,7 +3274,7 @@ BlockElementsList SyntaxAnalyzer::ParseBlockElementsToBlockEnd()
 
 BlockElementsList SyntaxAnalyzer::ParseBlockElementsImpl( const Lexem::Type end_lexem )
 {
-	BlockElementsList::Builder result_builder;
+	BlockElementsList::Builder result_builder( arena_ );
 
 	while( NotEndOfFile() && it_->type != Lexem::Type::EndOfFile )
 	{
@@ -3463,13 +3467,13 @@ IfAlternativePtr SyntaxAnalyzer::TryParseIfAlternative()
 IfAlternativePtr SyntaxAnalyzer::ParseIfAlternative()
 {
 	if( it_->type == Lexem::Type::BraceLeft )
-		return std::make_unique<IfAlternative>( ParseBlock() );
+		return arena_.New<IfAlternative>( ParseBlock() );
 	if( it_->type == Lexem::Type::Identifier && it_->text == Keywords::if_ )
-		return std::make_unique<IfAlternative>( ParseIfOperator() );
+		return arena_.New<IfAlternative>( ParseIfOperator() );
 	if( it_->type == Lexem::Type::Identifier && it_->text == Keywords::static_if_ )
-		return std::make_unique<IfAlternative>( ParseStaticIfOperator() );
+		return arena_.New<IfAlternative>( ParseStaticIfOperator() );
 	if( it_->type == Lexem::Type::Identifier && it_->text == Keywords::if_coro_advance_ )
-		return std::make_unique<IfAlternative>( ParseIfCoroAdvanceOperator() );
+		return arena_.New<IfAlternative>( ParseIfCoroAdvanceOperator() );
 
 	// Accept macros, producing single element of if-alternative kind, as if-alternative.
 	if( it_->type == Lexem::Type::Identifier )
@@ -3494,7 +3498,7 @@ IfAlternativePtr SyntaxAnalyzer::ParseIfAlternative()
 				if( block.safety == ScopeBlock::Safety::None && block.label == std::nullopt )
 				{
 					// Accept only pure blocks without safety modifiers and labels.
-					return std::make_unique<IfAlternative>( std::move(block.block) );
+					return arena_.New<IfAlternative>( std::move(block.block) );
 				}
 				else
 				{
@@ -3507,11 +3511,11 @@ IfAlternativePtr SyntaxAnalyzer::ParseIfAlternative()
 			}
 
 			if( auto if_operator= list.TryTakeStart< IfOperator >() )
-				return std::make_unique<IfAlternative>( std::move( *if_operator ) );
+				return arena_.New<IfAlternative>( std::move( *if_operator ) );
 			if( auto static_if= list.TryTakeStart< StaticIfOperator >() )
-				return std::make_unique<IfAlternative>( std::move( *static_if ) );
+				return arena_.New<IfAlternative>( std::move( *static_if ) );
 			if( auto if_coro_advance_operator= list.TryTakeStart< IfCoroAdvanceOperator >() )
-				return std::make_unique<IfAlternative>( std::move( *if_coro_advance_operator ) );
+				return arena_.New<IfAlternative>( std::move( *if_coro_advance_operator ) );
 
 			LexSyntError error_message;
 			error_message.src_loc= it_->src_loc;
@@ -3577,7 +3581,7 @@ NonSyncTag SyntaxAnalyzer::TryParseNonSyncTag()
 		NextLexem();
 
 		if( it_->type == Lexem::Type::BracketLeft )
-			return std::make_unique<Expression>( ParseExpressionInBrackets() );
+			return arena_.New<Expression>( ParseExpressionInBrackets() );
 
 		return NonSyncTagTrue();
 	}
@@ -3977,7 +3981,7 @@ Function SyntaxAnalyzer::ParseFunction()
 	{
 		if( it_->type == Lexem::Type::BracketLeft )
 		{
-			auto constructor_initialization_list= std::make_unique<StructNamedInitializer>( it_->src_loc );
+			auto constructor_initialization_list= arena_.New<StructNamedInitializer>( it_->src_loc );
 			NextLexem();
 
 			while( NotEndOfFile() && it_->type != Lexem::Type::BracketRight )
@@ -4021,7 +4025,7 @@ Function SyntaxAnalyzer::ParseFunction()
 		}
 
 		if( it_->type == Lexem::Type::BraceLeft )
-			result.block= std::make_unique<Block>( ParseBlock() );
+			result.block= arena_.New<Block>( ParseBlock() );
 		else
 		{
 			PushErrorMessage();
@@ -4082,7 +4086,7 @@ ClassElementsList SyntaxAnalyzer::ParseClassBodyElementsToClassEnd()
 
 ClassElementsList SyntaxAnalyzer::ParseClassBodyElementsImpl( const Lexem::Type end_lexem )
 {
-	ClassElementsList::Builder result_builder;
+	ClassElementsList::Builder result_builder( arena_ );
 
 	while( NotEndOfFile() )
 	{
@@ -4238,7 +4242,7 @@ ClassElementsList SyntaxAnalyzer::ParseClassBodyElementsImpl( const Lexem::Type
 
 			Initializer field_initializer= ParseVariableInitializer();
 			if( !std::holds_alternative<EmptyVariant>( field_initializer ) )
-				field.initializer= std::make_unique<Initializer>( std::move(field_initializer) );
+				field.initializer= arena_.New<Initializer>( std::move(field_initializer) );
 
 			result_builder.Append( std::move( field ) );
 
@@ -4386,7 +4390,7 @@ SyntaxAnalyzer::TemplateVar SyntaxAnalyzer::ParseTemplate()
 	{
 		FunctionTemplate function_template( template_src_loc );
 		function_template.params= std::move(params);
-		function_template.function= std::make_unique<Function>(ParseFunction());
+		function_template.function= arena_.New<Function>(ParseFunction());
 		function_template.src_loc= function_template.function->src_loc;
 		return std::move(function_template);
 	}
@@ -4469,7 +4473,7 @@ SyntaxAnalyzer::TemplateVar SyntaxAnalyzer::ParseTemplate()
 			class_.keep_fields_order= keep_fields_order;
 			class_.no_discard= no_discard;
 			class_.parents= std::move(class_parents_list);
-			class_template.something= std::make_unique<Class>(std::move(class_));
+			class_template.something= arena_.New<Class>(std::move(class_));
 			return std::move(class_template);
 		}
 
@@ -4481,7 +4485,7 @@ SyntaxAnalyzer::TemplateVar SyntaxAnalyzer::ParseTemplate()
 			type_alias_template.name= name;
 			type_alias_template.is_short_form= is_short_form;
 
-			auto type_alias= std::make_unique<TypeAlias>( ParseTypeAliasBody() );
+			auto type_alias= arena_.New<TypeAlias>( ParseTypeAliasBody() );
 			type_alias->name= std::move(name);
 
 			type_alias_template.something= std::move(type_alias);
@@ -4554,7 +4558,7 @@ ParseFnResult SyntaxAnalyzer::ExpandMacro( const Macro& macro, ParseFnResult (Sy
 	}
 
 	// Prevent too many expansions.
-	const size_t total_expansions_limit= 32767;
+	const size_t total_expansions_limit= c_max_macro_expansions;
 	if( macro_expansion_contexts_->size() >= total_expansions_limit )
 	{
 		LexSyntError error_message;
@@ -4606,6 +4610,7 @@ ParseFnResult SyntaxAnalyzer::ExpandMacro( const Macro& macro, ParseFnResult (Sy
 	// For subsequent macro expansions use base name that contains also root expansion point (and more - full expansion path).
 	SyntaxAnalyzer result_analyzer(
 		result_lexems,
+		arena_,
 		macros_,
 		macro_expansion_contexts_,
 		macro_unique_identifiers_base_name,
@@ -5022,9 +5027,11 @@ void SyntaxAnalyzer::PushErrorMessage()
 
 std::vector<Import> ParseImports( const Lexems& lexems )
 {
+	Arena arena; // Imports don't contain elements allocated in an arena.
 	return
 		SyntaxAnalyzer(
 			lexems,
+			arena,
 			std::make_shared<MacrosByContextMap>(),
 			std::make_shared<MacroExpansionContexts>(),
 			"" ).ParseImports();
@@ -5036,11 +5043,16 @@ SyntaxAnalysisResult SyntaxAnalysis(
 	MacroExpansionContextsPtr macro_expansion_contexts,
 	std::string file_path_hash )
 {
-	return SyntaxAnalyzer(
-		lexems,
-		std::make_shared<MacrosByContextMap>( std::move(macros) ),
-		std::move(macro_expansion_contexts),
-		std::move(file_path_hash) ).DoAnalyzis();
+	Arena arena;
+	SyntaxAnalysisResult result=
+		SyntaxAnalyzer(
+			lexems,
+			arena,
+			std::make_shared<MacrosByContextMap>( std::move(macros) ),
+			std::move(macro_expansion_contexts),
+			std::move(file_path_hash) ).DoAnalyzis();
+	result.arena= std::move(arena);
+	return result;
 }
 
 NamespaceParsingResult ParseNamespaceElements(
@@ -5049,13 +5061,17 @@ NamespaceParsingResult ParseNamespaceElements(
 	MacroExpansionContextsPtr macro_expansion_contexts,
 	std::string file_path_hash )
 {
+	Arena arena;
 	SyntaxAnalyzer syntax_analyzer(
 		lexems,
+		arena,
 		std::move(macros),
 		std::move(macro_expansion_contexts),
 		std::move(file_path_hash) );
 
-	return syntax_analyzer.ParseStandaloneNamespaceElements();
+	auto result= syntax_analyzer.ParseStandaloneNamespaceElements();
+	result.arena= std::move(arena);
+	return result;
 }
 
 ClassElementsParsingResult ParseClassElements(
@@ -5064,13 +5080,17 @@ ClassElementsParsingResult ParseClassElements(
 	MacroExpansionContextsPtr macro_expansion_contexts, /* in-out contexts */
 	std::string file_path_hash )
 {
+	Arena arena;
 	SyntaxAnalyzer syntax_analyzer(
 		lexems,
+		arena,
 		std::move(macros),
 		std::move(macro_expansion_contexts),
 		std::move(file_path_hash) );
 
-	return syntax_analyzer.ParseStandaloneClassElements();
+	auto result= syntax_analyzer.ParseStandaloneClassElements();
+	result.arena= std::move(arena);
+	return result;
 }
 
 BlockElementsParsingResult ParseBlockElements(
@@ -5079,13 +5099,17 @@ BlockElementsParsingResult ParseBlockElements(
 	MacroExpansionContextsPtr macro_expansion_contexts,
 	std::string file_path_hash )
 {
+	Arena arena;
 	SyntaxAnalyzer syntax_analyzer(
 		lexems,
+		arena,
 		std::move(macros),
 		std::move(macro_expansion_contexts),
 		std::move(file_path_hash) );
 
-	return syntax_analyzer.ParseStandaloneBlockElements();
+	auto result= syntax_analyzer.ParseStandaloneBlockElements();
+	result.arena= std::move(arena);
+	return result;
 }
 
 TypeNameParsingResult ParseTypeName(
@@ -5094,13 +5118,17 @@ TypeNameParsingResult ParseTypeName(
 	MacroExpansionContextsPtr macro_expansion_contexts,
 	std::string file_path_hash )
 {
+	Arena arena;
 	SyntaxAnalyzer syntax_analyzer(
 		lexems,
+		arena,
 		std::move(macros),
 		std::move(macro_expansion_contexts),
 		std::move(file_path_hash) );
 
-	return syntax_analyzer.ParseStandaloneTypeName();
+	auto result= syntax_analyzer.ParseStandaloneTypeName();
+	result.arena= std::move(arena);
+	return result;
 }
 
 ExpressionParsingResult ParseExpression(
@@ -5109,13 +5137,17 @@ ExpressionParsingResult ParseExpression(
 	MacroExpansionContextsPtr macro_expansion_contexts,
 	std::string file_path_hash )
 {
+	Arena arena;
 	SyntaxAnalyzer syntax_analyzer(
 		lexems,
+		arena,
 		std::move(macros),
 		std::move(macro_expansion_contexts),
 		std::move(file_path_hash) );
 
-	return syntax_analyzer.ParseStandaloneExpression();
+	auto result= syntax_analyzer.ParseStandaloneExpression();
+	result.arena= std::move(arena);
+	return result;
 }
 
 } // namespace Synt
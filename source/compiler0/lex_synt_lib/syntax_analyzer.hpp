@@ -22,8 +22,13 @@ struct MacroExpansionContext
 using MacroExpansionContexts= std::vector<MacroExpansionContext>;
 using MacroExpansionContextsPtr = std::shared_ptr<MacroExpansionContexts>;
 
+// Prevent too many expansions.
+constexpr size_t c_max_macro_expansions= 32767;
+
 struct SyntaxAnalysisResult
 {
+	// Storage for all syntax elements of this result. Declared first in order to be destroyed last.
+	Arena arena;
 	std::vector<Import> imports;
 	MacrosPtr macros;
 	ProgramElementsList program_elements;
@@ -32,30 +37,35 @@ struct SyntaxAnalysisResult
 
 struct NamespaceParsingResult
 {
+	Arena arena;
 	ProgramElementsList namespace_elements;
 	LexSyntErrors error_messages;
 };
 
 struct ClassElementsParsingResult
 {
+	Arena arena;
 	ClassElementsList class_elements;
 	LexSyntErrors error_messages;
 };
 
 struct BlockElementsParsingResult
 {
+	Arena arena;
 	BlockElementsList block_elements;
 	LexSyntErrors error_messages;
 };
 
 struct TypeNameParsingResult
 {
+	Arena arena;
 	TypeName type_name;
 	LexSyntErrors error_messages;
 };
 
 struct ExpressionParsingResult
 {
+	Arena arena;
 	Expression expression;
 	LexSyntErrors error_messages;
 };
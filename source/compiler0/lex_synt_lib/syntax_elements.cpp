@@ -24,7 +24,7 @@ SrcLoc GetSrcLocImpl( const T& e )
 }
 
 template<typename T>
-SrcLoc GetSrcLocImpl( const std::unique_ptr<T>& e )
+SrcLoc GetSrcLocImpl( const ArenaPtr<T>& e )
 {
 	return GetSrcLocImpl(*e);
 }
@@ -38,14 +38,14 @@ SrcLoc GetSrcLocImpl( const std::variant<Args...>& v )
 } // namespace
 
 // Sizes for x86-64.
-// If one of types inside variant becomes too big, put it inside "unique_ptr".
+// If one of types inside variant becomes too big, put it inside "ArenaPtr".
 SIZE_ASSERT( ComplexName, 48u )
 SIZE_ASSERT( TypeName, 48u )
 SIZE_ASSERT( Expression, 48u )
 SIZE_ASSERT( Initializer, 56u )
-SIZE_ASSERT( BlockElementsList, 16u ) // Variant index + unique_ptr
-SIZE_ASSERT( ClassElementsList, 16u ) // Variant index + unique_ptr
-SIZE_ASSERT( ProgramElementsList, 16u ) // Variant index + unique_ptr
+SIZE_ASSERT( BlockElementsList, 16u ) // Variant index + ArenaPtr
+SIZE_ASSERT( ClassElementsList, 16u ) // Variant index + ArenaPtr
+SIZE_ASSERT( ProgramElementsList, 16u ) // Variant index + ArenaPtr
 
 bool FunctionType::IsAutoReturn() const
 {
@@ -22,9 +22,11 @@ namespace Synt
 	It is used widely for some structures, like Expressions.
 	But it is imprortant to use it wisely, in order to reduce total structs size and number of indirections.
 	It is fine to store terminal nodes directly (like number, boolean constant), sine such nodes are small.
-	Recursive nodes (like binary operators) should be stored in variant via pointer (unique_ptr), since indirection already required.
+	Recursive nodes (like binary operators) should be stored in variant via pointer (ArenaPtr), since indirection already required.
 	Doing so, instead of storing such nodes by-value and storing pointers inside them allows to reduce size of variant and reduce number of allocations.
 	Exception - node with single "vector" inside and (maybe) a little bit of extra data, that doesn't increase result variant size.
+
+	All nodes are allocated in an arena, owned by a syntax analysis result, so, the arena should outlive these nodes.
 */
 
 //
@@ -149,10 +151,10 @@ using ComplexName= std::variant<
 	NameLookup,
 	NameLookupCompletion,
 	// Non-terminal nodes (that contain ComplexName inside).
-	std::unique_ptr<const TypeofTypeName>,
-	std::unique_ptr<const NamesScopeNameFetch>,
-	std::unique_ptr<const NamesScopeNameFetchCompletion>,
-	std::unique_ptr<const TemplateParameterization>
+	ArenaPtr<const TypeofTypeName>,
+	ArenaPtr<const NamesScopeNameFetch>,
+	ArenaPtr<const NamesScopeNameFetchCompletion>,
+	ArenaPtr<const TemplateParameterization>
 	>;
 
 using TypeName= std::variant<
@@ -163,73 +165,73 @@ using TypeName= std::variant<
 	RootNamespaceNameLookupCompletion,
 	NameLookup,
 	NameLookupCompletion,
-	std::unique_ptr<const TypeofTypeName>,
-	std::unique_ptr<const NamesScopeNameFetch>,
-	std::unique_ptr<const NamesScopeNameFetchCompletion>,
-	std::unique_ptr<const TemplateParameterization>,
+	ArenaPtr<const TypeofTypeName>,
+	ArenaPtr<const NamesScopeNameFetch>,
+	ArenaPtr<const NamesScopeNameFetchCompletion>,
+	ArenaPtr<const TemplateParameterization>,
 	// Non-terminals.
 	TupleType, // Just vector of contained types.
-	std::unique_ptr<const RawPointerType>,
-	std::unique_ptr<const ArrayTypeName>,
-	std::unique_ptr<const FunctionType>,
-	std::unique_ptr<const CoroutineType>,
-	std::unique_ptr<const Mixin>
+	ArenaPtr<const RawPointerType>,
+	ArenaPtr<const ArrayTypeName>,
+	ArenaPtr<const FunctionType>,
+	ArenaPtr<const CoroutineType>,
+	ArenaPtr<const Mixin>
 	>;
 
 using Expression= std::variant<
 	EmptyVariant,
 	// Terminal nodes.
 	IntegerNumericConstant,
-	std::unique_ptr<const FloatingPointNumericConstant>, // Terminal, but too heavy, to store by-value.
+	ArenaPtr<const FloatingPointNumericConstant>, // Terminal, but too heavy, to store by-value.
 	BooleanConstant,
 	MoveOperator,
 	MoveOperatorCompletion,
-	std::unique_ptr<const StringLiteral>, // Terminal, but too heavy, to store by-value.
+	ArenaPtr<const StringLiteral>, // Terminal, but too heavy, to store by-value.
 	CharLiteral,
 	// Non-terminal nodes (with Expression or TypeName containing inside).
-	std::unique_ptr<const TypeInfo>,
-	std::unique_ptr<const SameType>,
-	std::unique_ptr<const NonSyncExpression>,
-	std::unique_ptr<const CallOperator>,
-	std::unique_ptr<const CallOperatorSignatureHelp>,
-	std::unique_ptr<const SubscriptOperator>,
-	std::unique_ptr<const MemberAccessOperator>,
-	std::unique_ptr<const MemberAccessOperatorCompletion>,
-	std::unique_ptr<const VariableInitialization>,
-	std::unique_ptr<const AwaitOperator>,
-	std::unique_ptr<const UnaryMinus>,
-	std::unique_ptr<const LogicalNot>,
-	std::unique_ptr<const BitwiseNot>,
-	std::unique_ptr<const SafeExpression>,
-	std::unique_ptr<const UnsafeExpression>,
-	std::unique_ptr<const BinaryOperator>,
-	std::unique_ptr<const TernaryOperator>,
-	std::unique_ptr<const ReferenceToRawPointerOperator>,
-	std::unique_ptr<const RawPointerToReferenceOperator>,
-	std::unique_ptr<const TakeOperator>,
-	std::unique_ptr<const Lambda>,
-	std::unique_ptr<const CastMut>,
-	std::unique_ptr<const CastImut>,
-	std::unique_ptr<const CastRef>,
-	std::unique_ptr<const CastRefUnsafe>,
-	std::unique_ptr<const Embed>,
-	std::unique_ptr<const ExternalFunctionAccess>,
-	std::unique_ptr<const ExternalVariableAccess>,
+	ArenaPtr<const TypeInfo>,
+	ArenaPtr<const SameType>,
+	ArenaPtr<const NonSyncExpression>,
+	ArenaPtr<const CallOperator>,
+	ArenaPtr<const CallOperatorSignatureHelp>,
+	ArenaPtr<const SubscriptOperator>,
+	ArenaPtr<const MemberAccessOperator>,
+	ArenaPtr<const MemberAccessOperatorCompletion>,
+	ArenaPtr<const VariableInitialization>,
+	ArenaPtr<const AwaitOperator>,
+	ArenaPtr<const UnaryMinus>,
+	ArenaPtr<const LogicalNot>,
+	ArenaPtr<const BitwiseNot>,
+	ArenaPtr<const SafeExpression>,
+	ArenaPtr<const UnsafeExpression>,
+	ArenaPtr<const BinaryOperator>,
+	ArenaPtr<const TernaryOperator>,
+	ArenaPtr<const ReferenceToRawPointerOperator>,
+	ArenaPtr<const RawPointerToReferenceOperator>,
+	ArenaPtr<const TakeOperator>,
+	ArenaPtr<const Lambda>,
+	ArenaPtr<const CastMut>,
+	ArenaPtr<const CastImut>,
+	ArenaPtr<const CastRef>,
+	ArenaPtr<const CastRefUnsafe>,
+	ArenaPtr<const Embed>,
+	ArenaPtr<const ExternalFunctionAccess>,
+	ArenaPtr<const ExternalVariableAccess>,
 	// Type name in expression context.
 	RootNamespaceNameLookup,
 	RootNamespaceNameLookupCompletion,
 	NameLookup,
 	NameLookupCompletion,
-	std::unique_ptr<const TypeofTypeName>,
-	std::unique_ptr<const NamesScopeNameFetch>,
-	std::unique_ptr<const NamesScopeNameFetchCompletion>,
-	std::unique_ptr<const TemplateParameterization>,
+	ArenaPtr<const TypeofTypeName>,
+	ArenaPtr<const NamesScopeNameFetch>,
+	ArenaPtr<const NamesScopeNameFetchCompletion>,
+	ArenaPtr<const TemplateParameterization>,
 	TupleType, // Just vector of contained types.
-	std::unique_ptr<const RawPointerType>,
-	std::unique_ptr<const ArrayTypeName>,
-	std::unique_ptr<const FunctionType>,
-	std::unique_ptr<const CoroutineType>,
-	std::unique_ptr<const Mixin>
+	ArenaPtr<const RawPointerType>,
+	ArenaPtr<const ArrayTypeName>,
+	ArenaPtr<const FunctionType>,
+	ArenaPtr<const CoroutineType>,
+	ArenaPtr<const Mixin>
 	>;
 
 using Initializer= std::variant<
@@ -247,7 +249,7 @@ using Initializer= std::variant<
 
 //
 // Block elements list structures.
-// Since size of each block element is so different, allocate each element in its own unique_ptr.
+// Since size of each block element is so different, allocate each element separately (in an arena).
 // Since we are already allocating, use linked list (via BlockElementsListNode template) in order to build list, instead of using extra allocation for vector.
 //
 
@@ -288,7 +290,7 @@ using IfAlternative= std::variant<
 	IfCoroAdvanceOperator
 	>;
 
-using IfAlternativePtr= std::unique_ptr<const IfAlternative>;
+using IfAlternativePtr= ArenaPtr<const IfAlternative>;
 
 using ClassElementsList= VariantLinkedList<
 	VariablesDeclaration,
@@ -319,7 +321,7 @@ using ProgramElementsList= VariantLinkedList<
 
 struct NonSyncTagNone{};
 struct NonSyncTagTrue{};
-using NonSyncTag= std::variant<NonSyncTagNone, NonSyncTagTrue, std::unique_ptr<const Expression>>;
+using NonSyncTag= std::variant<NonSyncTagNone, NonSyncTagTrue, ArenaPtr<const Expression>>;
 
 //
 // Enums definitions.
@@ -554,11 +556,11 @@ struct FunctionType
 public:
 	SrcLoc src_loc;
 	std::vector<FunctionParam> params;
-	std::unique_ptr<const Expression> calling_convention;
-	std::unique_ptr<const TypeName> return_type;
-	std::unique_ptr<const Expression> references_pollution_expression; // May be nullptr.
-	std::unique_ptr<const Expression> return_value_reference_expression; // May be nullptr.
-	std::unique_ptr<const Expression> return_value_inner_references_expression; // May be nullptr.
+	ArenaPtr<const Expression> calling_convention;
+	ArenaPtr<const TypeName> return_type;
+	ArenaPtr<const Expression> references_pollution_expression; // May be nullptr.
+	ArenaPtr<const Expression> return_value_reference_expression; // May be nullptr.
+	ArenaPtr<const Expression> return_value_inner_references_expression; // May be nullptr.
 
 	MutabilityModifier return_value_mutability_modifier= MutabilityModifier::None;
 	ReferenceModifier return_value_reference_modifier= ReferenceModifier::None;
@@ -584,8 +586,8 @@ public:
 	NonSyncTag non_sync_tag;
 	TypeName return_type;
 	std::vector<MutabilityModifier> inner_references;
-	std::unique_ptr<const Expression> return_value_reference_expression; // May be nullptr.
-	std::unique_ptr<const Expression> return_value_inner_references_expression; // May be nullptr.
+	ArenaPtr<const Expression> return_value_reference_expression; // May be nullptr.
+	ArenaPtr<const Expression> return_value_inner_references_expression; // May be nullptr.
 	Kind kind= Kind::Generator;
 	MutabilityModifier return_value_mutability_modifier= MutabilityModifier::None;
 	ReferenceModifier return_value_reference_modifier= ReferenceModifier::None;
@@ -967,7 +969,7 @@ struct VariablesDeclaration
 	{
 		SrcLoc src_loc;
 		std::string name;
-		std::unique_ptr<const Initializer> initializer; // May be null for types with default constructor.
+		ArenaPtr<const Initializer> initializer; // May be null for types with default constructor.
 		MutabilityModifier mutability_modifier= MutabilityModifier::None;
 		ReferenceModifier reference_modifier= ReferenceModifier::None;
 		bool is_thread_local= false; // Parsed only for global variables.
@@ -1347,8 +1349,8 @@ public:
 	std::vector<NameComponent> name; // A, A::B, A::B::C::D, ::A, ::A::B
 	Expression condition; // Empty variant if has no condition.
 	FunctionType type;
-	std::unique_ptr<const StructNamedInitializer> constructor_initialization_list;
-	std::unique_ptr<const Block> block;
+	ArenaPtr<const StructNamedInitializer> constructor_initialization_list;
+	ArenaPtr<const Block> block;
 	NonSyncTag coroutine_non_sync_tag; // Non-empty for generators and async functions
 	OverloadedOperator overloaded_operator= OverloadedOperator::None;
 	VirtualFunctionKind virtual_function_kind= VirtualFunctionKind::None;
@@ -1450,7 +1452,7 @@ struct ClassField
 	SrcLoc src_loc;
 	TypeName type;
 	std::string name;
-	std::unique_ptr<const Initializer> initializer; // May be null.
+	ArenaPtr<const Initializer> initializer; // May be null.
 	Expression reference_tag_expression; // EmptyVariant if none.
 	Expression inner_reference_tags_expression; // EmptyVariant if none.
 	MutabilityModifier mutability_modifier= MutabilityModifier::None;
@@ -1504,7 +1506,7 @@ struct TypeTemplate
 	std::vector<TemplateParam> params;
 	std::vector<SignatureParam> signature_params;
 
-	std::variant<std::unique_ptr<const Class>, std::unique_ptr<const TypeAlias>> something;
+	std::variant<ArenaPtr<const Class>, ArenaPtr<const TypeAlias>> something;
 
 	// Short form means that template params are also signature params.
 	bool is_short_form= false;
@@ -1518,7 +1520,7 @@ struct FunctionTemplate
 	SrcLoc src_loc;
 	std::vector<TemplateParam> params;
 
-	std::unique_ptr<const Function> function;
+	ArenaPtr<const Function> function;
 };
 
 struct Namespace
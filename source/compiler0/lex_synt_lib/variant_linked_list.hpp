@@ -1,12 +1,12 @@
 #pragma once
 #include <variant>
-#include <memory>
+#include "arena.hpp"
 
 namespace U
 {
 
 // Single-direction (relaitvely) compact linked list of different type values.
-// Each value is stored in separate allocation.
+// Each value is stored in separate allocation in an arena, which should outlive the list.
 // Size is not stored.
 template< typename ... ContainedTypes>
 class VariantLinkedList
@@ -47,7 +47,7 @@ private:
 	};
 
 	template<typename T>
-	using NodePtr= std::unique_ptr< Node<T> >;
+	using NodePtr= ArenaPtr< Node<T> >;
 
 	// Wrap variant element into struct, instead of unsing type alias for variant< ... >.
 	// Doing so we prevent quadratic complexity of mangled names construction.
@@ -62,8 +62,8 @@ public:
 	class Builder
 	{
 	public:
-		Builder()
-			: tail_(&result_.start_)
+		explicit Builder( Arena& arena )
+			: arena_(arena), tail_(&result_.start_)
 		{}
 
 		// This class stores raw pointer to itself. So, disable any move.
@@ -76,8 +76,8 @@ public:
 		void Append( T t )
 		{
 			using NodeT= Node<T>;
-			tail_->val= std::make_unique< NodeT >( NodeT{ std::move(t), VariantElement{} } );
-			tail_= & std::get< std::unique_ptr< NodeT > >( tail_->val )->next;
+			tail_->val= arena_.New< NodeT >( NodeT{ std::move(t), VariantElement{} } );
+			tail_= & std::get< NodePtr< T > >( tail_->val )->next;
 		}
 
 		// Append other list and make sure insertion position is at last element of that list.
@@ -96,6 +96,7 @@ public:
 		}
 
 	private:
+		Arena& arena_;
 		VariantLinkedList result_;
 		VariantElement* tail_= nullptr;
 	};
@@ -28,6 +28,40 @@ void TestLexResult( const std::string_view program_text, const Lexems& expected_
 	}
 }
 
+// Replace range in given text, update index incrementally and compare it against index built from scratch.
+void TestUpdateLineToLinearPositionIndex( const std::string_view text, const uint32_t range_start, const uint32_t range_end, const std::string_view new_range_text )
+{
+	LineToLinearPositionIndex index= BuildLineToLinearPositionIndex( text );
+
+	std::string new_text( text );
+	new_text.replace( range_start, range_end - range_start, new_range_text );
+
+	UpdateLineToLinearPositionIndex( new_text, range_start, range_end, uint32_t(new_range_text.size()), index );
+	U_TEST_ASSERT( index == BuildLineToLinearPositionIndex( new_text ) );
+}
+
+// Replace range in given text, update lexems incrementally and compare them against lexems of the whole new text.
+void TestUpdateLexems( const std::string_view text, const uint32_t range_start, const uint32_t range_end, const std::string_view new_range_text )
+{
+	LineToLinearPositionIndex index= BuildLineToLinearPositionIndex( text );
+	Lexems lexems= LexicalAnalysis( text ).lexems;
+
+	std::string new_text( text );
+	new_text.replace( range_start, range_end - range_start, new_range_text );
+
+	UpdateLineToLinearPositionIndex( new_text, range_start, range_end, uint32_t(new_range_text.size()), index );
+	U_TEST_ASSERT( UpdateLexems( new_text, index, range_start, uint32_t(new_range_text.size()), lexems ) );
+
+	const Lexems expected_lexems= LexicalAnalysis( new_text ).lexems;
+	U_TEST_ASSERT( lexems.size() == expected_lexems.size() );
+	for( size_t i= 0; i < expected_lexems.size(); ++i )
+	{
+		U_TEST_ASSERT( lexems[i].type == expected_lexems[i].type );
+		U_TEST_ASSERT( lexems[i].src_loc == expected_lexems[i].src_loc );
+		U_TEST_ASSERT( lexems[i].text == expected_lexems[i].text );
+	}
+}
+
 } // namespace
 
 U_TEST( PosInLine_Test0 )
@@ -201,6 +235,20 @@ U_TEST( ValidIdentifierTest )
 	U_TEST_ASSERT( !IsValidIdentifier( "()" ) );
 }
 
+U_TEST( MultilineCommentColumn_Test0 )
+{
+	// Columns after line endings inside multiline comment should be counted from line start.
+	static const char c_program_text[]= "/* a\nbc */ foo /*\r\n*/bar";
+
+	const Lexems expected_result
+	{
+		{ "foo", SrcLoc( 0, 2, 6 ), Lexem::Type::Identifier },
+		{ "bar", SrcLoc( 0, 3, 2 ), Lexem::Type::Identifier },
+	};
+
+	TestLexResult( c_program_text, expected_result );
+}
+
 U_TEST( LineToLinearPositionIndex_Test0 )
 {
 	static const char c_program_text[] = "";
@@ -287,6 +335,155 @@ U_TEST( LinearPositionToLine_Test1 )
 	U_TEST_ASSERT( LinearPositionToLine( index, 53 ) == 5 );
 }
 
+U_TEST( UpdateLineToLinearPositionIndex_Test0 )
+{
+	static const char c_program_text[] = "fn foo()\n{\n\tbar();\n}\n";
+
+	// Insertion.
+	TestUpdateLineToLinearPositionIndex( c_program_text, 0, 0, "" );
+	TestUpdateLineToLinearPositionIndex( c_program_text, 0, 0, "abc" );
+	TestUpdateLineToLinearPositionIndex( c_program_text, 0, 0, "\n\n" );
+	TestUpdateLineToLinearPositionIndex( c_program_text, 12, 12, "baz();\n\t" );
+	TestUpdateLineToLinearPositionIndex( c_program_text, 21, 21, "\nfn baz(){}" );
+	// Removal.
+	TestUpdateLineToLinearPositionIndex( c_program_text, 0, 3, "" );
+	TestUpdateLineToLinearPositionIndex( c_program_text, 8, 9, "" );
+	TestUpdateLineToLinearPositionIndex( c_program_text, 8, 11, "" );
+	TestUpdateLineToLinearPositionIndex( c_program_text, 5, 21, "" );
+	TestUpdateLineToLinearPositionIndex( c_program_text, 0, 21, "" );
+	// Replacement.
+	TestUpdateLineToLinearPositionIndex( c_program_text, 3, 6, "foo_bar" );
+	TestUpdateLineToLinearPositionIndex( c_program_text, 9, 12, "\n\n\n" );
+	TestUpdateLineToLinearPositionIndex( c_program_text, 10, 19, "x" );
+}
+
+U_TEST( UpdateLineToLinearPositionIndex_Test1 )
+{
+	// Two-symbol line endings may be formed or splitted by changes.
+	TestUpdateLineToLinearPositionIndex( "foo\rbar", 4, 4, "\n" );
+	TestUpdateLineToLinearPositionIndex( "foo\nbar", 3, 3, "\r" );
+	TestUpdateLineToLinearPositionIndex( "foo\r\nbar", 4, 4, "baz" );
+	TestUpdateLineToLinearPositionIndex( "foo\r\nbar", 4, 5, "" );
+	TestUpdateLineToLinearPositionIndex( "foo\r\nbar", 3, 4, "" );
+	TestUpdateLineToLinearPositionIndex( "foo\rX\nbar", 4, 5, "" );
+	TestUpdateLineToLinearPositionIndex( "foo\n\nbar", 3, 4, "\r" );
+	TestUpdateLineToLinearPositionIndex( "\r", 1, 1, "\n" );
+}
+
+U_TEST( UpdateLineToLinearPositionIndex_Test2 )
+{
+	// Various newlines.
+	const std::string_view text= c_various_newlines_text;
+	for( uint32_t range_start= 0; range_start <= text.size(); ++range_start )
+	{
+		for( uint32_t range_end= range_start; range_end <= text.size(); ++range_end )
+		{
+			// Avoid splitting of UTF-8 sequences.
+			if( ( range_start < text.size() && ( text[range_start] & 0b11000000 ) == 0b10000000 ) ||
+				( range_end < text.size() && ( text[range_end] & 0b11000000 ) == 0b10000000 ) )
+				continue;
+
+			TestUpdateLineToLinearPositionIndex( text, range_start, range_end, "" );
+			TestUpdateLineToLinearPositionIndex( text, range_start, range_end, "\n" );
+			TestUpdateLineToLinearPositionIndex( text, range_start, range_end, "\r" );
+			TestUpdateLineToLinearPositionIndex( text, range_start, range_end, "q\r\nw " );
+		}
+	}
+}
+
+U_TEST( UpdateLexems_Test0 )
+{
+	static const char c_program_text[]=
+	R"(
+		fn foo( i32 x ) : i32
+		{
+			// Some comment.
+			var f32 mut y= 0.5f, mut z= 42u;
+			auto s= "some string"u8;
+			return x + i32(y) * i32(z);
+		}
+
+		struct S
+		{
+			[ char8, 4 ] arr;
+		}
+	)";
+
+	const std::string_view text= c_program_text;
+	const auto find= [&]( const std::string_view s ) { return uint32_t( text.find( s ) ); };
+
+	// Change inside line.
+	TestUpdateLexems( text, find( "foo" ), find( "foo" ) + 3, "bar_baz" );
+	TestUpdateLexems( text, find( "0.5f" ), find( "0.5f" ), "1" );
+	TestUpdateLexems( text, find( "u8" ), find( "u8" ) + 2, "" );
+	TestUpdateLexems( text, find( "arr" ), find( "arr" ), "." );
+	// Add/remove lines.
+	TestUpdateLexems( text, find( "return" ), find( "return" ), "x= 33;\n\t\t\t" );
+	TestUpdateLexems( text, find( "var" ), find( "return" ), "" );
+	TestUpdateLexems( text, 0, find( "struct" ), "" );
+	TestUpdateLexems( text, find( "struct" ), uint32_t( text.size() ), "" );
+	TestUpdateLexems( text, uint32_t( text.size() ), uint32_t( text.size() ), "\nfn bar(){}\n" );
+	TestUpdateLexems( text, 0, 0, "\n\n\n" );
+	// Unfinished string/comment.
+	TestUpdateLexems( text, find( "some string" ), find( "some string" ), "\"" );
+	TestUpdateLexems( text, find( "// Some" ), find( "// Some" ) + 2, "/*" );
+}
+
+U_TEST( UpdateLexems_Test1 )
+{
+	// Comment start/end changes state of all following text.
+
+	static const char c_program_text[]=
+	R"(
+		fn foo()
+		{
+			/* a */
+			bar();
+			/* b /* c */ */
+			baz();
+		}
+	)";
+
+	const std::string_view text= c_program_text;
+	const auto find= [&]( const std::string_view s ) { return uint32_t( text.find( s ) ); };
+
+	TestUpdateLexems( text, find( "/* a */" ) + 6, find( "/* a */" ) + 7, "" );
+	TestUpdateLexems( text, find( "/* a */" ), find( "/* a */" ) + 2, "" );
+	TestUpdateLexems( text, find( "/* c */" ) + 6, find( "/* c */" ) + 7, "" );
+	TestUpdateLexems( text, find( "bar();" ), find( "bar();" ), "/*" );
+	TestUpdateLexems( text, find( "bar();" ), find( "bar();" ), "*/" );
+	TestUpdateLexems( text, find( "baz();" ), find( "baz();" ), "*/" );
+}
+
+U_TEST( UpdateLexems_Test2 )
+{
+	// Various changes of each position.
+	static const char c_program_text[]= "fn foo() {\n\tvar i32 x= 0;\n\t/*\n*/bar( \"str\"u8, x );\n}\r\n";
+	const std::string_view text= c_program_text;
+	for( uint32_t range_start= 0; range_start <= text.size(); ++range_start )
+	{
+		for( uint32_t range_end= range_start; range_end <= text.size(); ++range_end )
+		{
+			TestUpdateLexems( text, range_start, range_end, "" );
+			TestUpdateLexems( text, range_start, range_end, "\n" );
+			TestUpdateLexems( text, range_start, range_end, " q\r\n+ " );
+			TestUpdateLexems( text, range_start, range_end, "/*" );
+			TestUpdateLexems( text, range_start, range_end, "\"" );
+		}
+	}
+}
+
+U_TEST( ContainsNonASCIINewlines_Test0 )
+{
+	U_TEST_ASSERT( !ContainsNonASCIINewlines( "" ) );
+	U_TEST_ASSERT( !ContainsNonASCIINewlines( "foo\nbar\r\nbaz\f\v" ) );
+	U_TEST_ASSERT( !ContainsNonASCIINewlines( "фыва" ) );
+	U_TEST_ASSERT( ContainsNonASCIINewlines( c_various_newlines_text ) );
+	U_TEST_ASSERT( ContainsNonASCIINewlines( "a\u0085" ) );
+	U_TEST_ASSERT( ContainsNonASCIINewlines( "\u2028" ) );
+	U_TEST_ASSERT( ContainsNonASCIINewlines( "b\u2029c" ) );
+}
+
 U_TEST( IdentifierStartEndPosition_Test0 )
 {
 	static const char c_program_text[] = "foo  bar {baz} (qerty) ++*= []%%%";
@@ -0,0 +1,54 @@
+#include "../code_builder_lib/names_scope.hpp"
+#include "cpp_tests_launcher.hpp"
+
+namespace U
+{
+
+U_TEST( NamesScopeLookupCache_Test0 )
+{
+	// Cached lookup result should be invalidated after addition of a name into parent scope, which was used for lookup.
+	uint64_t lookup_caches_generation= 1;
+
+	NamesScope root( "", nullptr );
+	root.SetLookupCachesGenerationCounter( &lookup_caches_generation );
+
+	const auto child= std::make_shared<NamesScope>( "child", &root );
+	U_TEST_ASSERT( root.AddName( "child", NamesScopeValue( child, SrcLoc() ) ) != nullptr );
+	U_TEST_ASSERT( child->IsLookupCacheAllowed() );
+
+	// Search for name in root, like lookup starting from child scope does.
+	U_TEST_ASSERT( root.GetThisScopeValue( "a" ) == nullptr );
+
+	NamesScope::LookupCacheEntry entry;
+	entry.space= &root;
+	child->GetLookupCache().Add( "a", entry, child->GetLookupCachesGeneration() );
+	U_TEST_ASSERT( child->GetLookupCache().Find( "a", child->GetLookupCachesGeneration() ) != nullptr );
+
+	U_TEST_ASSERT( root.AddName( "b", NamesScopeValue( std::make_shared<NamesScope>( "b", &root ), SrcLoc() ) ) != nullptr );
+	U_TEST_ASSERT( child->GetLookupCache().Find( "a", child->GetLookupCachesGeneration() ) == nullptr );
+}
+
+U_TEST( NamesScopeLookupCache_Test1 )
+{
+	// Lookup caches generation counters of different code builders are independent.
+	uint64_t lookup_caches_generation0= 1;
+	uint64_t lookup_caches_generation1= 1;
+
+	NamesScope root0( "", nullptr );
+	root0.SetLookupCachesGenerationCounter( &lookup_caches_generation0 );
+	NamesScope root1( "", nullptr );
+	root1.SetLookupCachesGenerationCounter( &lookup_caches_generation1 );
+
+	NamesScope::LookupCacheEntry entry;
+	entry.space= &root1;
+	root1.GetLookupCache().Add( "a", entry, root1.GetLookupCachesGeneration() );
+
+	U_TEST_ASSERT( root0.GetThisScopeValue( "b" ) == nullptr );
+	U_TEST_ASSERT( root0.AddName( "b", NamesScopeValue( std::make_shared<NamesScope>( "b", &root0 ), SrcLoc() ) ) != nullptr );
+	U_TEST_ASSERT( lookup_caches_generation0 != 1 );
+
+	U_TEST_ASSERT( lookup_caches_generation1 == 1 );
+	U_TEST_ASSERT( root1.GetLookupCache().Find( "a", root1.GetLookupCachesGeneration() ) != nullptr );
+}
+
+} // namespace U
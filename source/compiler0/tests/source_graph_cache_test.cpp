@@ -0,0 +1,462 @@
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+
+#include "../../code_builder_lib_common/long_stable_hash.hpp"
+#include "../../tests/tests_lib/funcs_registrator.hpp"
+#include "../../tests/tests_lib/tests.hpp"
+#include "../lex_synt_lib/source_graph_serialization.hpp"
+
+namespace U
+{
+
+namespace
+{
+
+class TestVfs final : public IVfs
+{
+public:
+	std::unordered_map<Path, FileContent> files;
+
+public: // IVfs
+	virtual std::optional<FileContent> LoadFileContent( const Path& full_file_path ) override
+	{
+		const auto it= files.find( full_file_path );
+		if( it == files.end() )
+			return std::nullopt;
+		return it->second;
+	}
+
+	virtual Path GetFullFilePath( const Path& file_path, const Path& full_parent_file_path ) override
+	{
+		(void)full_parent_file_path;
+		return file_path;
+	}
+
+	virtual std::vector<PathCompletionItem> CompletePath( const Path& file_path_prefix, const Path& full_parent_file_path ) override
+	{
+		(void)file_path_prefix;
+		(void)full_parent_file_path;
+		return {};
+	}
+
+	virtual bool IsImportingFileAllowed( const Path& full_file_path ) override
+	{
+		(void)full_file_path;
+		return true;
+	}
+
+	virtual bool IsFileFromSourcesDirectory( const Path& full_file_path ) override
+	{
+		(void)full_file_path;
+		return true;
+	}
+};
+
+class TestSourceGraphCache final : public ISourceGraphCache
+{
+public:
+	std::unordered_map<std::string, std::string> entries;
+	size_t num_hits= 0;
+
+public: // ISourceGraphCache
+	virtual std::optional<std::string> LoadEntry( const std::string& key ) override
+	{
+		const auto it= entries.find( key );
+		if( it == entries.end() )
+			return std::nullopt;
+		++num_hits;
+		return it->second;
+	}
+
+	virtual void StoreEntry( const std::string& key, const std::string_view data ) override
+	{
+		entries[key]= std::string(data);
+	}
+};
+
+// Serialize all nodes in order to compare source graphs.
+std::string DumpSourceGraph( const SourceGraph& source_graph )
+{
+	std::string result;
+	for( size_t i= 0; i < source_graph.nodes_storage.size(); ++i )
+	{
+		const SourceGraph::Node& node= source_graph.nodes_storage[i];
+		result+= node.file_path;
+		result+= node.file_path_hash;
+		for( const size_t child_index : node.child_nodes_indices )
+			result+= std::to_string( child_index ) + ",";
+
+		const auto serialized_node= SerializeSourceGraphNode( source_graph, i, 0, "" );
+		U_TEST_ASSERT( serialized_node != std::nullopt );
+		result+= *serialized_node;
+	}
+	return result;
+}
+
+const char c_macros_file[]=
+R"(
+	?macro <? DEFINE_FN:namespace ?name:ident ?> -> <? fn ?name() : i32 { return 42; } ?>
+	struct S{ i32 x; f32 y; }
+)";
+
+const char c_middle_file[]=
+R"(
+	import "macros.u"
+	DEFINE_FN Foo
+)";
+
+const char c_root_file[]=
+R"(
+	import "middle.u"
+	import "macros.u"
+	DEFINE_FN Bar
+	fn Baz( S& s ) : i32
+	{
+		auto mut x= s.x;
+		for( auto mut i= 0; i < 10; ++i ) { x+= Foo() + Bar(); }
+		return x;
+	}
+)";
+
+U_TEST( SourceGraphCache_Test0 )
+{
+	// Loading with cache should produce the same result as loading without cache.
+
+	TestVfs vfs;
+	vfs.files["root.u"]= c_root_file;
+	vfs.files["middle.u"]= c_middle_file;
+	vfs.files["macros.u"]= c_macros_file;
+
+	const SourceGraph source_graph_no_cache= LoadSourceGraph( vfs, CalculateLongStableHash, "root.u" );
+	U_TEST_ASSERT( source_graph_no_cache.errors.empty() );
+
+	TestSourceGraphCache cache;
+
+	const SourceGraph source_graph_cold= LoadSourceGraph( vfs, CalculateLongStableHash, "root.u", "", &cache );
+	U_TEST_ASSERT( source_graph_cold.errors.empty() );
+	U_TEST_ASSERT( cache.num_hits == 0 );
+	U_TEST_ASSERT( cache.entries.size() == 3 );
+
+	const SourceGraph source_graph_warm= LoadSourceGraph( vfs, CalculateLongStableHash, "root.u", "", &cache );
+	U_TEST_ASSERT( source_graph_warm.errors.empty() );
+	U_TEST_ASSERT( cache.num_hits == 3 );
+
+	U_TEST_ASSERT( DumpSourceGraph( source_graph_cold ) == DumpSourceGraph( source_graph_no_cache ) );
+	U_TEST_ASSERT( DumpSourceGraph( source_graph_warm ) == DumpSourceGraph( source_graph_no_cache ) );
+	U_TEST_ASSERT( source_graph_warm.macro_expansion_contexts->size() == source_graph_no_cache.macro_expansion_contexts->size() );
+}
+
+U_TEST( SourceGraphCache_Test1 )
+{
+	// Changing of imported macros should invalidate cache entries of importing files.
+
+	TestVfs vfs;
+	vfs.files["root.u"]= c_root_file;
+	vfs.files["middle.u"]= c_middle_file;
+	vfs.files["macros.u"]= c_macros_file;
+
+	TestSourceGraphCache cache;
+	LoadSourceGraph( vfs, CalculateLongStableHash, "root.u", "", &cache );
+
+	vfs.files["macros.u"]=
+	R"(
+		?macro <? DEFINE_FN:namespace ?name:ident ?> -> <? fn ?name() : i32 { return 24; } ?>
+		struct S{ i32 x; f32 y; }
+	)";
+
+	const SourceGraph source_graph_no_cache= LoadSourceGraph( vfs, CalculateLongStableHash, "root.u" );
+	U_TEST_ASSERT( source_graph_no_cache.errors.empty() );
+
+	const SourceGraph source_graph= LoadSourceGraph( vfs, CalculateLongStableHash, "root.u", "", &cache );
+	U_TEST_ASSERT( source_graph.errors.empty() );
+	U_TEST_ASSERT( DumpSourceGraph( source_graph ) == DumpSourceGraph( source_graph_no_cache ) );
+}
+
+U_TEST( SourceGraphCache_Test2 )
+{
+	// Broken cache entries should be ignored.
+
+	TestVfs vfs;
+	vfs.files["root.u"]= c_root_file;
+	vfs.files["middle.u"]= c_middle_file;
+	vfs.files["macros.u"]= c_macros_file;
+
+	TestSourceGraphCache cache;
+	LoadSourceGraph( vfs, CalculateLongStableHash, "root.u", "", &cache );
+
+	for( auto& key_value_pair : cache.entries )
+		key_value_pair.second.resize( key_value_pair.second.size() / 2 );
+
+	const SourceGraph source_graph_no_cache= LoadSourceGraph( vfs, CalculateLongStableHash, "root.u" );
+	const SourceGraph source_graph= LoadSourceGraph( vfs, CalculateLongStableHash, "root.u", "", &cache );
+	U_TEST_ASSERT( source_graph.errors.empty() );
+	U_TEST_ASSERT( DumpSourceGraph( source_graph ) == DumpSourceGraph( source_graph_no_cache ) );
+}
+
+U_TEST( SyntaxAnalysisResultsInterner_Test0 )
+{
+	// Syntax analysis results of common imports should be shared between source graphs.
+
+	TestVfs vfs;
+	vfs.files["root.u"]= c_root_file;
+	vfs.files["root2.u"]= "import \"middle.u\" fn Qux(){}";
+	vfs.files["middle.u"]= c_middle_file;
+	vfs.files["macros.u"]= c_macros_file;
+
+	SyntaxAnalysisResultsInterner interner;
+
+	const SourceGraph source_graph0= LoadSourceGraph( vfs, CalculateLongStableHash, "root.u", "", nullptr, &interner );
+	const SourceGraph source_graph1= LoadSourceGraph( vfs, CalculateLongStableHash, "root.u", "", nullptr, &interner );
+	const SourceGraph source_graph2= LoadSourceGraph( vfs, CalculateLongStableHash, "root2.u", "", nullptr, &interner );
+	U_TEST_ASSERT( source_graph0.errors.empty() );
+	U_TEST_ASSERT( source_graph1.errors.empty() );
+	U_TEST_ASSERT( source_graph2.errors.empty() );
+
+	const SourceGraph source_graph_no_interner= LoadSourceGraph( vfs, CalculateLongStableHash, "root.u" );
+	U_TEST_ASSERT( DumpSourceGraph( source_graph0 ) == DumpSourceGraph( source_graph_no_interner ) );
+	U_TEST_ASSERT( DumpSourceGraph( source_graph1 ) == DumpSourceGraph( source_graph_no_interner ) );
+
+	// All nodes are the same for the same root.
+	U_TEST_ASSERT( source_graph0.nodes_storage.size() == source_graph1.nodes_storage.size() );
+	for( size_t i= 0; i < source_graph0.nodes_storage.size(); ++i )
+		U_TEST_ASSERT( source_graph0.nodes_storage[i].ast == source_graph1.nodes_storage[i].ast );
+
+	// Different roots, but same imports with same indices - imports should be shared.
+	U_TEST_ASSERT( source_graph2.nodes_storage.size() == source_graph0.nodes_storage.size() );
+	U_TEST_ASSERT( source_graph0.nodes_storage[0].ast != source_graph2.nodes_storage[0].ast );
+	for( size_t i= 1; i < source_graph0.nodes_storage.size(); ++i )
+	{
+		U_TEST_ASSERT( source_graph0.nodes_storage[i].file_path == source_graph2.nodes_storage[i].file_path );
+		U_TEST_ASSERT( source_graph0.nodes_storage[i].ast == source_graph2.nodes_storage[i].ast );
+	}
+}
+
+U_TEST( SyntaxAnalysisResultsInterner_Test1 )
+{
+	// Unused entries should be removed.
+
+	TestVfs vfs;
+	vfs.files["root.u"]= c_root_file;
+	vfs.files["middle.u"]= c_middle_file;
+	vfs.files["macros.u"]= c_macros_file;
+
+	SyntaxAnalysisResultsInterner interner;
+
+	std::weak_ptr<const Synt::SyntaxAnalysisResult> root_ast;
+	{
+		const SourceGraph source_graph= LoadSourceGraph( vfs, CalculateLongStableHash, "root.u", "", nullptr, &interner );
+		U_TEST_ASSERT( source_graph.errors.empty() );
+		root_ast= source_graph.nodes_storage.front().ast;
+
+		interner.RemoveUnusedEntries();
+		U_TEST_ASSERT( !root_ast.expired() ); // Still used by the source graph.
+	}
+
+	U_TEST_ASSERT( !root_ast.expired() ); // Still stored in the interner.
+	interner.RemoveUnusedEntries();
+	U_TEST_ASSERT( root_ast.expired() );
+}
+
+struct LoadedDeclarations
+{
+	SourceGraph source_graph; // Keep syntax elements alive.
+	SourceGraphNodeDeclarations declarations;
+};
+
+LoadedDeclarations LoadDeclarations( const std::string& text )
+{
+	TestVfs vfs;
+	vfs.files["root.u"]= text;
+
+	LoadedDeclarations result;
+	result.source_graph= LoadSourceGraph( vfs, CalculateLongStableHash, "root.u" );
+	U_TEST_ASSERT( result.source_graph.errors.empty() );
+	U_TEST_ASSERT( result.source_graph.nodes_storage.front().ast->error_messages.empty() );
+	result.declarations= SerializeSourceGraphNodeDeclarations( result.source_graph, 0 );
+	return result;
+}
+
+U_TEST( SourceGraphNodeDeclarations_Test0 )
+{
+	const LoadedDeclarations loaded_declarations= LoadDeclarations( "namespace NS { struct S { fn Foo( this ) : i32 { return 42; } } } fn Bar() {}" );
+	const SourceGraphNodeDeclarations& declarations= loaded_declarations.declarations;
+	U_TEST_ASSERT( declarations.functions.size() == 2u );
+	U_TEST_ASSERT( declarations.functions[0].function->name.back().name == "Foo" );
+	U_TEST_ASSERT( declarations.functions[0].prefix.size() == 2u );
+	U_TEST_ASSERT( std::holds_alternative<const Synt::Namespace*>( declarations.functions[0].prefix[0] ) );
+	U_TEST_ASSERT( std::holds_alternative<const Synt::Class*>( declarations.functions[0].prefix[1] ) );
+	U_TEST_ASSERT( declarations.functions[1].function->name.back().name == "Bar" );
+	U_TEST_ASSERT( declarations.functions[1].prefix.empty() );
+
+	// Positions do not matter.
+	const LoadedDeclarations loaded_declarations_moved= LoadDeclarations( "\n\n  namespace NS { struct S {\n fn Foo( this ) : i32 { return 42; } } }\nfn Bar() {}" );
+	const SourceGraphNodeDeclarations& declarations_moved= loaded_declarations_moved.declarations;
+	U_TEST_ASSERT( declarations_moved.data == declarations.data );
+	U_TEST_ASSERT( declarations_moved.functions.size() == 2u );
+	U_TEST_ASSERT( declarations_moved.functions[0].body == declarations.functions[0].body );
+	U_TEST_ASSERT( declarations_moved.functions[1].body == declarations.functions[1].body );
+
+	// Bodies are not included into declarations.
+	const LoadedDeclarations loaded_declarations_body_changed= LoadDeclarations( "namespace NS { struct S { fn Foo( this ) : i32 { return 24; } } } fn Bar() {}" );
+	const SourceGraphNodeDeclarations& declarations_body_changed= loaded_declarations_body_changed.declarations;
+	U_TEST_ASSERT( declarations_body_changed.data == declarations.data );
+	U_TEST_ASSERT( declarations_body_changed.functions.size() == 2u );
+	U_TEST_ASSERT( declarations_body_changed.functions[0].body != declarations.functions[0].body );
+	U_TEST_ASSERT( declarations_body_changed.functions[1].body == declarations.functions[1].body );
+
+	// Signature is included.
+	const LoadedDeclarations loaded_declarations_signature_changed= LoadDeclarations( "namespace NS { struct S { fn Foo( this ) : u32 { return 42u; } } } fn Bar() {}" );
+	const SourceGraphNodeDeclarations& declarations_signature_changed= loaded_declarations_signature_changed.declarations;
+	U_TEST_ASSERT( declarations_signature_changed.data != declarations.data );
+}
+
+U_TEST( SourceGraphNodeDeclarations_Test1 )
+{
+	// Bodies of constexpr functions, functions with auto return type and functions inside templates may affect other program elements.
+
+	const LoadedDeclarations loaded_declarations0= LoadDeclarations( "fn constexpr Foo() : i32 { return 42; } fn Bar() : auto { return 1; } template</type T/> struct Box { fn Baz() {} }" );
+	const SourceGraphNodeDeclarations& declarations0= loaded_declarations0.declarations;
+	U_TEST_ASSERT( declarations0.functions.empty() );
+
+	U_TEST_ASSERT( LoadDeclarations( "fn constexpr Foo() : i32 { return 24; } fn Bar() : auto { return 1; } template</type T/> struct Box { fn Baz() {} }" ).declarations.data != declarations0.data );
+	U_TEST_ASSERT( LoadDeclarations( "fn constexpr Foo() : i32 { return 42; } fn Bar() : auto { return 1u; } template</type T/> struct Box { fn Baz() {} }" ).declarations.data != declarations0.data );
+	U_TEST_ASSERT( LoadDeclarations( "fn constexpr Foo() : i32 { return 42; } fn Bar() : auto { return 1; } template</type T/> struct Box { fn Baz() { 0; } }" ).declarations.data != declarations0.data );
+}
+
+void CompareErrors( const LexSyntErrors& l, const LexSyntErrors& r )
+{
+	U_TEST_ASSERT( l.size() == r.size() );
+	for( size_t i= 0; i < l.size(); ++i )
+	{
+		U_TEST_ASSERT( l[i].text == r[i].text );
+		U_TEST_ASSERT( l[i].src_loc == r[i].src_loc );
+	}
+}
+
+U_TEST( ParallelSourceGraphLoading_Test0 )
+{
+	// Parallel loading should produce the same result as sequential loading.
+
+	TestVfs vfs;
+	vfs.files["root.u"]= c_root_file;
+	vfs.files["middle.u"]= c_middle_file;
+	vfs.files["macros.u"]= c_macros_file;
+	vfs.files["a.u"]= "import \"b.u\" import \"c.u\" fn A() : i32 { return B() + C(); }";
+	vfs.files["b.u"]= "import \"d.u\" fn B() : i32 { return D(); }";
+	vfs.files["c.u"]= "import \"d.u\" import \"macros.u\" fn C() : i32 { return D(); } DEFINE_FN CC";
+	vfs.files["d.u"]= "fn D() : i32 { return 0; }";
+	vfs.files["all.u"]= "import \"a.u\" import \"root.u\" import \"d.u\" fn All() {}";
+
+	const SourceGraph source_graph_sequential= LoadSourceGraph( vfs, CalculateLongStableHash, "all.u" );
+	U_TEST_ASSERT( source_graph_sequential.errors.empty() );
+	U_TEST_ASSERT( source_graph_sequential.nodes_storage.size() == 8 );
+
+	for( const size_t num_threads : { 2, 4, 16 } )
+	{
+		const SourceGraph source_graph_parallel= LoadSourceGraph( vfs, CalculateLongStableHash, "all.u", "", nullptr, nullptr, num_threads );
+		CompareErrors( source_graph_parallel.errors, source_graph_sequential.errors );
+		U_TEST_ASSERT( source_graph_parallel.macro_expansion_contexts->size() == source_graph_sequential.macro_expansion_contexts->size() );
+		U_TEST_ASSERT( DumpSourceGraph( source_graph_parallel ) == DumpSourceGraph( source_graph_sequential ) );
+	}
+}
+
+U_TEST( ParallelSourceGraphLoading_Test1 )
+{
+	// Errors should be the same as for sequential loading.
+
+	TestVfs vfs;
+	vfs.files["root.u"]= "import \"a.u\" import \"missing.u\" import \"lex_error.u\" import \"synt_error.u\" fn Root() {}";
+	vfs.files["a.u"]= "import \"b.u\" fn A() {}";
+	vfs.files["b.u"]= "import \"a.u\" fn B() {}"; // Import loop.
+	vfs.files["lex_error.u"]= "fn LexError() { ` }";
+	vfs.files["synt_error.u"]= "import \"b.u\" fn SyntError( { }";
+
+	const SourceGraph source_graph_sequential= LoadSourceGraph( vfs, CalculateLongStableHash, "root.u" );
+	U_TEST_ASSERT( !source_graph_sequential.errors.empty() );
+
+	for( const size_t num_threads : { 2, 4, 16 } )
+	{
+		const SourceGraph source_graph_parallel= LoadSourceGraph( vfs, CalculateLongStableHash, "root.u", "", nullptr, nullptr, num_threads );
+		CompareErrors( source_graph_parallel.errors, source_graph_sequential.errors );
+		U_TEST_ASSERT( source_graph_parallel.nodes_storage.size() == source_graph_sequential.nodes_storage.size() );
+		for( size_t i= 0; i < source_graph_parallel.nodes_storage.size(); ++i )
+		{
+			U_TEST_ASSERT( source_graph_parallel.nodes_storage[i].file_path == source_graph_sequential.nodes_storage[i].file_path );
+			U_TEST_ASSERT( source_graph_parallel.nodes_storage[i].child_nodes_indices == source_graph_sequential.nodes_storage[i].child_nodes_indices );
+			U_TEST_ASSERT( ( source_graph_parallel.nodes_storage[i].ast == nullptr ) == ( source_graph_sequential.nodes_storage[i].ast == nullptr ) );
+		}
+	}
+}
+
+class TestSourceGraphLoadingTracer final : public ISourceGraphLoadingTracer
+{
+public:
+	std::mutex mutex;
+	size_t num_threads_started= 0;
+	size_t num_threads_finished= 0;
+	std::unordered_map< std::thread::id, std::vector< std::pair<std::string, IVfs::Path> > > steps_stacks;
+	std::set< std::pair<std::string, IVfs::Path> > finished_steps;
+
+public: // ISourceGraphLoadingTracer
+	virtual void OnThreadStart() override
+	{
+		const std::lock_guard<std::mutex> lock( mutex );
+		++num_threads_started;
+	}
+
+	virtual void OnThreadFinish() override
+	{
+		const std::lock_guard<std::mutex> lock( mutex );
+		U_TEST_ASSERT( steps_stacks[ std::this_thread::get_id() ].empty() );
+		++num_threads_finished;
+	}
+
+	virtual void BeginStep( const std::string_view step_name, const IVfs::Path& file_path ) override
+	{
+		const std::lock_guard<std::mutex> lock( mutex );
+		steps_stacks[ std::this_thread::get_id() ].emplace_back( step_name, file_path );
+	}
+
+	virtual void EndStep() override
+	{
+		const std::lock_guard<std::mutex> lock( mutex );
+		auto& stack= steps_stacks[ std::this_thread::get_id() ];
+		U_TEST_ASSERT( !stack.empty() );
+		finished_steps.insert( std::move( stack.back() ) );
+		stack.pop_back();
+	}
+};
+
+U_TEST( SourceGraphLoadingTracer_Test0 )
+{
+	// Tracer should be notified about loading and parsing of each file, both for sequential and parallel loading.
+
+	TestVfs vfs;
+	vfs.files["a.u"]= "import \"b.u\" import \"c.u\" fn A() : i32 { return B() + C(); }";
+	vfs.files["b.u"]= "import \"c.u\" fn B() : i32 { return C(); }";
+	vfs.files["c.u"]= "fn C() : i32 { return 0; }";
+
+	for( const size_t num_threads : { 1, 4 } )
+	{
+		TestSourceGraphLoadingTracer tracer;
+		const SourceGraph source_graph= LoadSourceGraph( vfs, CalculateLongStableHash, "a.u", "", nullptr, nullptr, num_threads, &tracer );
+		U_TEST_ASSERT( source_graph.errors.empty() );
+
+		U_TEST_ASSERT( ( tracer.num_threads_started == 0 ) == ( num_threads == 1 ) );
+		U_TEST_ASSERT( tracer.num_threads_finished == tracer.num_threads_started );
+		for( const auto& stack_pair : tracer.steps_stacks )
+			U_TEST_ASSERT( stack_pair.second.empty() );
+
+		for( const IVfs::Path file_path : { "a.u", "b.u", "c.u" } )
+		{
+			U_TEST_ASSERT( tracer.finished_steps.count( std::make_pair( std::string("LoadFile"), file_path ) ) == 1 );
+			U_TEST_ASSERT( tracer.finished_steps.count( std::make_pair( std::string("SyntaxAnalysis"), file_path ) ) == 1 );
+		}
+	}
+}
+
+} // namespace
+
+} // namespace U
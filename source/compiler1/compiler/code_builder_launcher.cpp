@@ -129,9 +129,25 @@ CodeBuilderLaunchResult LaunchCodeBuilder(
 	const bool generate_debug_info,
 	const bool generate_tbaa_metadata,
 	const bool allow_unused_names,
+	const bool collect_template_instantiation_stats,
 	const ManglingScheme mangling_scheme,
-	const std::string_view prelude_code )
+	const std::string_view prelude_code,
+	ISourceGraphCache* const source_graph_cache,
+	IEmbedFilesCache* const embed_files_cache,
+	SyntaxAnalysisResultsInterner* const syntax_analysis_results_interner,
+	const uint32_t num_source_graph_loading_threads,
+	const uint32_t num_function_bodies_building_threads,
+	ISourceGraphLoadingTracer* const source_graph_loading_tracer )
 {
+	// Source graph caching, sharing, parallel loading, tracing, template instantiation stats, parallel functions bodies building and embedded files caching aren't implemented for Compiler1.
+	(void)collect_template_instantiation_stats;
+	(void)source_graph_cache;
+	(void)embed_files_cache;
+	(void)syntax_analysis_results_interner;
+	(void)num_source_graph_loading_threads;
+	(void)num_function_bodies_building_threads;
+	(void)source_graph_loading_tracer;
+
 	CodeBuilderLaunchResult result;
 
 	const LLVMModuleRef llvm_module=
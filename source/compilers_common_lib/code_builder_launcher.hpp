@@ -5,7 +5,12 @@
 
 #include "../lex_synt_lib_common/lex_synt_error.hpp"
 #include "../code_builder_lib_common/mangling.hpp"
+#include "../code_builder_lib_common/template_instantiation_stats.hpp"
+#include "../compiler0/lex_synt_lib/i_embed_files_cache.hpp"
+#include "../compiler0/lex_synt_lib/i_source_graph_cache.hpp"
+#include "../compiler0/lex_synt_lib/i_source_graph_loading_tracer.hpp"
 #include "../compiler0/lex_synt_lib/i_vfs.hpp"
+#include "../compiler0/lex_synt_lib/syntax_analysis_results_interner.hpp"
 #include "../code_builder_lib_common/code_builder_errors.hpp"
 
 namespace U
@@ -19,6 +24,8 @@ struct CodeBuilderLaunchResult
 	std::vector<IVfs::Path> dependent_files;
 
 	std::unique_ptr<llvm::Module> llvm_module;
+
+	TemplateInstantiationStatsList template_instantiation_stats;
 };
 
 // There are different implementations of this function for different implementations of CodeBuilderLib.
@@ -31,8 +38,15 @@ CodeBuilderLaunchResult LaunchCodeBuilder(
 	bool generate_debug_info,
 	bool generate_tbaa_metadata,
 	bool allow_unused_names,
+	bool collect_template_instantiation_stats, // Implementation may ignore it.
 	ManglingScheme mangling_scheme,
-	std::string_view prelude_code );
+	std::string_view prelude_code,
+	ISourceGraphCache* source_graph_cache, // May be null. Implementation may ignore it.
+	IEmbedFilesCache* embed_files_cache, // May be null. Implementation may ignore it.
+	SyntaxAnalysisResultsInterner* syntax_analysis_results_interner, // May be null. Implementation may ignore it.
+	uint32_t num_source_graph_loading_threads, // Implementation may ignore it.
+	uint32_t num_function_bodies_building_threads, // Implementation may ignore it.
+	ISourceGraphLoadingTracer* source_graph_loading_tracer ); // May be null. Implementation may ignore it.
 
 // Contains value of current compiler generation (0, 1, 2, etc.).
 // Is constant, but not "constexpr", because this constant is defined outside this header.
@@ -1,5 +1,7 @@
 #include <chrono>
+#include <future>
 #include <iostream>
+#include <optional>
 
 #include "../code_builder_lib_common/push_disable_llvm_warnings.hpp"
 #include <llvm/Analysis/CGSCCPassManager.h>
@@ -17,6 +19,7 @@
 #include <llvm/Linker/Linker.h>
 #include <llvm/MC/TargetRegistry.h>
 #include <llvm/Passes/PassBuilder.h>
+#include <llvm/Passes/StandardInstrumentations.h>
 #include <llvm/Support/CodeGen.h>
 #include <llvm/Support/CommandLine.h>
 #include <llvm/Support/FileSystem.h>
@@ -26,6 +29,8 @@
 #include <llvm/Support/Path.h>
 #include <llvm/Support/SourceMgr.h>
 #include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/ThreadPool.h>
+#include <llvm/Support/TimeProfiler.h>
 #include <llvm/Target/TargetMachine.h>
 #include <llvm/TargetParser/Host.h>
 #include <llvm/TargetParser/SubtargetFeature.h>
@@ -41,6 +46,8 @@
 #include "../compilers_support_lib/div_builtins.hpp"
 #include "../compilers_support_lib/errors_print.hpp"
 #include "../compilers_support_lib/prelude.hpp"
+#include "../compilers_support_lib/embed_files_cache.hpp"
+#include "../compilers_support_lib/source_graph_cache.hpp"
 #include "../compilers_support_lib/vfs.hpp"
 #include "../lex_synt_lib_common/assert.hpp"
 #include "../sprache_version/sprache_version.hpp"
@@ -54,6 +61,9 @@ namespace U
 namespace
 {
 
+// Release syntax analysis results of imports, not used by any source graph, each time so many input files were processed.
+constexpr size_t c_syntax_analysis_results_release_period= 32;
+
 void PrintAvailableTargets()
 {
 	std::string targets_list;
@@ -197,6 +207,12 @@ cl::opt<std::string> dep_file_name(
 	cl::Optional,
 	cl::cat(options_category) );
 
+cl::opt<bool> dep_file_embed_stats(
+	"dep-file-embed-stats",
+	cl::desc("Write statistics of embedded files loading into the dependency file (as comments). Note that some build systems (like Ninja) don't support comments in dependency files."),
+	cl::init(false),
+	cl::cat(options_category) );
+
 cl::opt<bool> tests_output(
 	"tests-output",
 	cl::desc("Print code builder errors in test mode."),
@@ -306,12 +322,65 @@ cl::opt<std::string> sysroot(
 	cl::Optional,
 	cl::cat(options_category) );
 
+cl::opt<uint32_t> jobs(
+	"jobs",
+	cl::desc("Number of threads for compilation. Multiple input source files are compiled in parallel, for single input file its imports are loaded in parallel. 0 - select automatically. Default is 1 - everything is done sequentially."),
+	cl::value_desc("N"),
+	cl::init(1),
+	cl::cat(options_category) );
+
+cl::opt<uint32_t> function_bodies_jobs(
+	"function-bodies-jobs",
+	cl::desc("Number of threads for building of functions bodies of each input source file. Each thread builds declarations of the whole file and bodies only of a part of functions of this file. 0 - select automatically. Default is 1 - functions bodies are built sequentially."),
+	cl::value_desc("N"),
+	cl::init(1),
+	cl::cat(options_category) );
+
+cl::opt<std::string> source_graph_cache_dir(
+	"source-graph-cache-dir",
+	cl::desc("Directory for caching of syntax analysis results of source files. Cache may be shared between multiple compiler invocations."),
+	cl::value_desc("path"),
+	cl::Optional,
+	cl::cat(options_category) );
+
 cl::opt<bool> print_time_stats(
 	"print-time-stats",
 	cl::desc("Print compilation time statistics."),
 	cl::init(false),
 	cl::cat(options_category) );
 
+cl::opt<std::string> time_trace(
+	"time-trace",
+	cl::desc("Write detailed compilation time profile into given file. Chrome trace event format is used, result may be viewed in chrome://tracing or in Perfetto UI."),
+	cl::value_desc("filename"),
+	cl::Optional,
+	cl::cat(options_category) );
+
+cl::opt<uint32_t> time_trace_granularity(
+	"time-trace-granularity",
+	cl::desc("Minimum duration of events recorded with \"time-trace\" option, in microseconds. Default is 500."),
+	cl::value_desc("microseconds"),
+	cl::init(500),
+	cl::cat(options_category) );
+
+cl::opt<std::string> template_instantiation_stats(
+	"template-instantiation-stats",
+	cl::desc("Write statistics of templates instantiation into given file in JSON format. For each template numbers of instantiations and cache hits, time spent and number of generated functions are collected."),
+	cl::value_desc("filename"),
+	cl::Optional,
+	cl::cat(options_category) );
+
+cl::opt< TemplateInstantiationStatsSortKey > template_instantiation_stats_sort(
+	"template-instantiation-stats-sort",
+	cl::init(TemplateInstantiationStatsSortKey::SelfTime),
+	cl::desc("Sort order of templates instantiation statistics:"),
+	cl::values(
+		clEnumValN( TemplateInstantiationStatsSortKey::SelfTime, "self-time", "By time of instantiation, excluding time of nested instantiations (default)." ),
+		clEnumValN( TemplateInstantiationStatsSortKey::TotalTime, "total-time", "By time of instantiation, including time of nested instantiations." ),
+		clEnumValN( TemplateInstantiationStatsSortKey::Instantiations, "instantiations", "By number of instantiations." ),
+		clEnumValN( TemplateInstantiationStatsSortKey::LLVMFunctions, "functions", "By number of generated functions." ) ),
+	cl::cat(options_category) );
+
 
 } // namespace Options
 
@@ -335,6 +404,41 @@ void ActiveFloatToAndFromInt128ConversionsExpansionHack()
 	}
 }
 
+// Records steps of source graph loading into LLVM time trace profiler.
+class TimeTraceSourceGraphLoadingTracer final : public ISourceGraphLoadingTracer
+{
+public:
+	TimeTraceSourceGraphLoadingTracer( const uint32_t granularity, std::string process_name )
+		: granularity_(granularity), process_name_( std::move(process_name) )
+	{}
+
+	void OnThreadStart() override
+	{
+		// Profiler instance is thread-local, so, create it for each loading thread.
+		llvm::timeTraceProfilerInitialize( granularity_, process_name_ );
+	}
+
+	void OnThreadFinish() override
+	{
+		// Pass results of this thread to the main thread.
+		llvm::timeTraceProfilerFinishThread();
+	}
+
+	void BeginStep( const std::string_view step_name, const IVfs::Path& file_path ) override
+	{
+		llvm::timeTraceProfilerBegin( step_name, file_path );
+	}
+
+	void EndStep() override
+	{
+		llvm::timeTraceProfilerEnd();
+	}
+
+private:
+	const uint32_t granularity_;
+	const std::string process_name_;
+};
+
 bool MustPreserveGlobalValue( const llvm::GlobalValue& global_value )
 {
 	const llvm::StringRef name= global_value.getName();
@@ -493,6 +597,7 @@ int Main( int argc, const char* argv[] )
 	Options::target_environment.removeArgument();
 	Options::mangling_scheme.removeArgument();
 	Options::dep_file_name.removeArgument();
+	Options::dep_file_embed_stats.removeArgument();
 	Options::tests_output.removeArgument();
 	Options::print_llvm_asm.removeArgument();
 	Options::print_llvm_asm_initial.removeArgument();
@@ -507,7 +612,21 @@ int Main( int argc, const char* argv[] )
 	Options::lto_mode.removeArgument();
 	Options::linker_args.removeArgument();
 	Options::sysroot.removeArgument();
+	Options::jobs.removeArgument();
+	Options::function_bodies_jobs.removeArgument();
+	Options::source_graph_cache_dir.removeArgument();
 	Options::print_time_stats.removeArgument();
+	Options::time_trace.removeArgument();
+	Options::time_trace_granularity.removeArgument();
+	Options::template_instantiation_stats.removeArgument();
+	Options::template_instantiation_stats_sort.removeArgument();
+
+	// Profiler should be initialized as early as possible, in order to record everything.
+	if( !Options::time_trace.empty() )
+		llvm::timeTraceProfilerInitialize( Options::time_trace_granularity, argv[0] );
+
+	// Top-level compilation phases. Emplacing of the next phase finishes the previous one.
+	std::optional<llvm::TimeTraceScope> phase_time_trace_scope;
 
 	if( Options::output_file_name.empty() && file_type != FileType::Null )
 	{
@@ -625,8 +744,12 @@ int Main( int argc, const char* argv[] )
 	std::unique_ptr<llvm::Module> result_module;
 	std::vector<IVfs::Path> deps_list;
 	std::vector<std::string> external_functions_for_internalization;
+	TemplateInstantiationStatsList template_instantiation_stats;
+	// Share embedded files between all input files.
+	std::unique_ptr<IEmbedFilesCache> embed_files_cache;
 
 	const auto time_point_start_frontend_work= Clock::now();
+	phase_time_trace_scope.emplace( "Frontend" );
 
 	if( Options::input_files_type == Options::InputFileType::Source )
 	{
@@ -654,24 +777,149 @@ int Main( int argc, const char* argv[] )
 		if( Options::print_prelude_code )
 			std::cout << prelude_code << std::endl;
 
+		std::unique_ptr<ISourceGraphCache> source_graph_cache;
+		if( !Options::source_graph_cache_dir.empty() )
+			source_graph_cache= CreateSourceGraphCacheOverSystemFS( Options::source_graph_cache_dir );
+
+		embed_files_cache= CreateEmbedFilesCacheOverSystemFS();
+
+		// Share syntax analysis results of common imports between input files.
+		std::optional<SyntaxAnalysisResultsInterner> syntax_analysis_results_interner;
+		if( Options::input_files.size() > 1 )
+			syntax_analysis_results_interner.emplace();
+
+		// Load imports in parallel only for single input file, since multiple input files are compiled in parallel.
+		uint32_t num_source_graph_loading_threads= 1;
+		if( Options::jobs != 1 && Options::input_files.size() == 1 )
+			num_source_graph_loading_threads= Options::jobs == 0 ? llvm::hardware_concurrency().compute_thread_count() : Options::jobs;
+
+		const uint32_t num_function_bodies_building_threads=
+			Options::function_bodies_jobs == 0 ? llvm::hardware_concurrency().compute_thread_count() : Options::function_bodies_jobs;
+
+		std::optional<TimeTraceSourceGraphLoadingTracer> source_graph_loading_tracer;
+		if( !Options::time_trace.empty() )
+			source_graph_loading_tracer.emplace( Options::time_trace_granularity, argv[0] );
+
+		const auto launch_code_builder=
+			[&]( const std::string& input_file, llvm::LLVMContext& context )
+			{
+				const llvm::TimeTraceScope time_trace_scope( "CompileSourceFile", input_file );
+				return
+					LaunchCodeBuilder(
+						input_file,
+						vfs,
+						context,
+						data_layout,
+						target_triple,
+						Options::generate_debug_info,
+						generate_tbaa_metadata,
+						Options::allow_unused_names,
+						!Options::template_instantiation_stats.empty(),
+						mangling_scheme,
+						prelude_code,
+						source_graph_cache.get(),
+						embed_files_cache.get(),
+						syntax_analysis_results_interner ? &*syntax_analysis_results_interner : nullptr,
+						num_source_graph_loading_threads,
+						num_function_bodies_building_threads,
+						source_graph_loading_tracer ? &*source_graph_loading_tracer : nullptr );
+			};
+
+		// Results for parallel compilation. Each input file is compiled in a separate thread with its own LLVM context.
+		// Result modules are serialized into bitcode and loaded later into the main context.
+		struct ParallelLaunchResult
+		{
+			CodeBuilderLaunchResult code_builder_launch_result;
+			llvm::SmallVector<char, 0> module_bitcode;
+		};
+		std::vector<ParallelLaunchResult> parallel_launch_results;
+		std::vector< std::shared_future<void> > parallel_launch_futures;
+
+		std::optional<llvm::ThreadPool> thread_pool;
+		if( Options::jobs != 1 && Options::input_files.size() > 1 )
+		{
+			thread_pool.emplace( Options::jobs == 0 ? llvm::hardware_concurrency() : llvm::hardware_concurrency( Options::jobs ) );
+
+			parallel_launch_results.resize( Options::input_files.size() );
+			parallel_launch_futures.reserve( Options::input_files.size() );
+			for( size_t i= 0; i < Options::input_files.size(); ++i )
+			{
+				parallel_launch_futures.push_back(
+					thread_pool->async(
+						[&, i]
+						{
+							// Profiler instance is thread-local, so, create it for each compilation task.
+							const bool init_time_trace_profiler= !Options::time_trace.empty() && !llvm::timeTraceProfilerEnabled();
+							if( init_time_trace_profiler )
+								llvm::timeTraceProfilerInitialize( Options::time_trace_granularity, argv[0] );
+
+							ParallelLaunchResult& result= parallel_launch_results[i];
+
+							llvm::LLVMContext thread_llvm_context;
+							result.code_builder_launch_result= launch_code_builder( Options::input_files[i], thread_llvm_context );
+
+							if( result.code_builder_launch_result.llvm_module != nullptr )
+							{
+								llvm::raw_svector_ostream stream( result.module_bitcode );
+								llvm::WriteBitcodeToFile( *result.code_builder_launch_result.llvm_module, stream );
+								// Destroy the module before destroying its context.
+								result.code_builder_launch_result.llvm_module= nullptr;
+							}
+
+							if( init_time_trace_profiler )
+								llvm::timeTraceProfilerFinishThread();
+						} ) );
+			}
+		}
+
+		// Process results in input files order, in order to produce deterministic output and deterministic errors order.
 		bool have_some_errors= false;
-		for( const std::string& input_file : Options::input_files )
+		for( size_t i= 0; i < Options::input_files.size(); ++i )
 		{
-			CodeBuilderLaunchResult code_builder_launch_result=
-				LaunchCodeBuilder(
-					input_file,
-					vfs,
-					llvm_context,
-					data_layout,
-					target_triple,
-					Options::generate_debug_info,
-					generate_tbaa_metadata,
-					Options::allow_unused_names,
-					mangling_scheme,
-					prelude_code );
+			const std::string& input_file= Options::input_files[i];
+
+			CodeBuilderLaunchResult code_builder_launch_result;
+			if( thread_pool == std::nullopt )
+				code_builder_launch_result= launch_code_builder( input_file, llvm_context );
+			else
+			{
+				parallel_launch_futures[i].wait();
+
+				ParallelLaunchResult& parallel_launch_result= parallel_launch_results[i];
+				code_builder_launch_result= std::move( parallel_launch_result.code_builder_launch_result );
+
+				if( !parallel_launch_result.module_bitcode.empty() )
+				{
+					llvm::Expected<std::unique_ptr<llvm::Module>> module_opt=
+						llvm::parseBitcodeFile(
+							llvm::MemoryBufferRef(
+								llvm::StringRef( parallel_launch_result.module_bitcode.data(), parallel_launch_result.module_bitcode.size() ),
+								input_file ),
+							llvm_context );
+					if( module_opt )
+						code_builder_launch_result.llvm_module= std::move(*module_opt);
+					else
+					{
+						// Module remains null, so file is treated as failed below, but its dependencies and errors are still processed.
+						llvm::consumeError( module_opt.takeError() );
+						std::cerr << "Failed to load compiled module for file \"" << input_file << "\"" << std::endl;
+						have_some_errors= true;
+					}
+				}
+
+				// Free memory as soon as possible.
+				parallel_launch_result.module_bitcode= llvm::SmallVector<char, 0>();
+			}
 
 			deps_list.insert( deps_list.end(), code_builder_launch_result.dependent_files.begin(), code_builder_launch_result.dependent_files.end() );
 
+			// Source graph of this file is already destroyed. Free syntax analysis results, which are no longer used.
+			// Do this periodically, since sharing is possible only if entries are still alive.
+			if( syntax_analysis_results_interner != std::nullopt && ( i + 1 ) % c_syntax_analysis_results_release_period == 0 )
+				syntax_analysis_results_interner->RemoveUnusedEntries();
+
+			MergeTemplateInstantiationStats( template_instantiation_stats, code_builder_launch_result.template_instantiation_stats );
+
 			PrintLexSyntErrors( code_builder_launch_result.dependent_files, code_builder_launch_result.lex_synt_errors, errors_format );
 
 			if( Options::tests_output )
@@ -811,6 +1059,7 @@ int Main( int argc, const char* argv[] )
 		U_ASSERT(false);
 
 	const auto time_point_start_intermediate_tweaks= Clock::now();
+	phase_time_trace_scope.emplace( "IntermediateTweaks" );
 
 	if( result_module == nullptr )
 	{
@@ -876,6 +1125,7 @@ int Main( int argc, const char* argv[] )
 	}
 
 	const auto time_point_start_optimization_passes= Clock::now();
+	phase_time_trace_scope.emplace( "Optimization" );
 
 	// Create and run optimization passes.
 	{
@@ -888,7 +1138,12 @@ int Main( int argc, const char* argv[] )
 		// Do not care about function address uniqueness.
 		tuning_options.MergeFunctions= optimization_level.getSpeedupLevel() > 0 || optimization_level.getSizeLevel() > 0;
 
-		llvm::PassBuilder pass_builder( target_machine.get(), tuning_options );
+		// Standard instrumentations are needed, in particular, for recording of each pass in time trace.
+		llvm::PassInstrumentationCallbacks pass_instrumentation_callbacks;
+		llvm::StandardInstrumentations standard_instrumentations( llvm_context, false /* debug logging */ );
+		standard_instrumentations.registerCallbacks( pass_instrumentation_callbacks );
+
+		llvm::PassBuilder pass_builder( target_machine.get(), tuning_options, std::nullopt, &pass_instrumentation_callbacks );
 
 		// Register all the basic analyses with the managers.
 		llvm::LoopAnalysisManager loop_analysis_manager;
@@ -963,6 +1218,7 @@ int Main( int argc, const char* argv[] )
 	}
 
 	const auto time_point_start_output_file_emitting= Clock::now();
+	phase_time_trace_scope.emplace( "OutputFileEmitting" );
 
 	// Translate functions with "visibility(default)" into "dllexport" for Windows dynamic libraries.
 	if( file_type == FileType::Dll && target_triple.getOS() == llvm::Triple::Win32 )
@@ -1109,9 +1365,42 @@ int Main( int argc, const char* argv[] )
 	DeduplicateAndFilterDepsList(deps_list);
 
 	if( !Options::dep_file_name.empty() &&
-		!WriteDepFile( Options::output_file_name, deps_list, Options::dep_file_name ) )
+		!WriteDepFile(
+			Options::output_file_name,
+			deps_list,
+			Options::dep_file_embed_stats && embed_files_cache != nullptr ? std::optional<IEmbedFilesCache::Stats>( embed_files_cache->GetStats() ) : std::nullopt,
+			Options::dep_file_name ) )
 		return 1;
 
+	if( !Options::template_instantiation_stats.empty() )
+	{
+		SortTemplateInstantiationStats( template_instantiation_stats, Options::template_instantiation_stats_sort );
+
+		std::error_code file_error_code;
+		llvm::raw_fd_ostream out_file_stream( Options::template_instantiation_stats, file_error_code );
+
+		WriteTemplateInstantiationStatsJSON( template_instantiation_stats, out_file_stream );
+
+		out_file_stream.flush();
+		if( out_file_stream.has_error() )
+		{
+			std::cerr << "Error while writing template instantiation stats file \"" << Options::template_instantiation_stats << "\": " << file_error_code.message() << std::endl;
+			return 1;
+		}
+	}
+
+	if( !Options::time_trace.empty() )
+	{
+		phase_time_trace_scope.reset();
+
+		if( llvm::Error error= llvm::timeTraceProfilerWrite( Options::time_trace, Options::output_file_name ) )
+		{
+			std::cerr << "Error while writing time trace file \"" << Options::time_trace << "\": " << llvm::toString( std::move(error) ) << std::endl;
+			return 1;
+		}
+		llvm::timeTraceProfilerCleanup();
+	}
+
 	const auto time_point_end= Clock::now();
 
 	if( Options::print_time_stats )
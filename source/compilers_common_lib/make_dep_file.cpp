@@ -53,6 +53,7 @@ void DeduplicateAndFilterDepsList( std::vector<IVfs::Path>& deps_list )
 bool WriteDepFile(
 	const std::string& out_file_path,
 	const std::vector<IVfs::Path>& deps_list, // Files list should not contain duplicates.
+	const std::optional<IEmbedFilesCache::Stats>& embed_files_stats,
 	const std::string& dep_file_path )
 {
 	std::string str= QuoteDepTargetString(out_file_path) + ":";
@@ -64,6 +65,15 @@ bool WriteDepFile(
 			str+= " \\\n";
 	}
 
+	if( embed_files_stats != std::nullopt && embed_files_stats->num_requests > 0 )
+	{
+		// Use comments, in order to keep the file valid for make-like build systems.
+		str+= "\n";
+		str+= "# embedded files: " + std::to_string( embed_files_stats->num_files ) + "\n";
+		str+= "# embed requests: " + std::to_string( embed_files_stats->num_requests ) + ", cache hits: " + std::to_string( embed_files_stats->num_hits ) + "\n";
+		str+= "# embed bytes loaded: " + std::to_string( embed_files_stats->bytes_loaded ) + ", reused: " + std::to_string( embed_files_stats->bytes_reused ) + "\n";
+	}
+
 	std::error_code file_error_code;
 	llvm::raw_fd_ostream deps_file_stream( dep_file_path, file_error_code );
 	deps_file_stream << str;
@@ -1,5 +1,6 @@
 #pragma once
-#include "../compiler0/lex_synt_lib/i_vfs.hpp"
+#include <optional>
+#include "../compiler0/lex_synt_lib/i_embed_files_cache.hpp"
 
 namespace U
 {
@@ -9,6 +10,7 @@ void DeduplicateAndFilterDepsList( std::vector<IVfs::Path>& deps_list );
 bool WriteDepFile(
 	const std::string& out_file_path,
 	const std::vector<IVfs::Path>& deps_list, // Files list should not contain duplicates.
+	const std::optional<IEmbedFilesCache::Stats>& embed_files_stats, // Written as comments, if present.
 	const std::string& dep_file_path );
 
 } // namespace U
@@ -5,6 +5,7 @@
 #include <llvm/IR/Verifier.h>
 #include <llvm/Linker/Linker.h>
 #include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/TimeProfiler.h>
 #include <llvm/Support/raw_os_ostream.h>
 #include <llvm/TargetParser/Triple.h>
 #include "../code_builder_lib_common/pop_llvm_warnings.hpp"
@@ -42,6 +43,15 @@ void RemoveAllComdats( llvm::Module& module )
 	}
 }
 
+bool HasNonDiscardableDefinitions( const llvm::Module& module )
+{
+	for( const llvm::GlobalValue& global_value : module.global_values() )
+		if( !global_value.isDeclaration() && !llvm::GlobalValue::isDiscardableIfUnused( global_value.getLinkage() ) )
+			return true;
+
+	return false;
+}
+
 } // namespace
 
 bool LinkCompilerBuiltinModules(
@@ -49,6 +59,8 @@ bool LinkCompilerBuiltinModules(
 	const HaltMode halt_mode,
 	const bool no_system_alloc )
 {
+	const llvm::TimeTraceScope time_trace_scope( "LinkCompilerBuiltinModules" );
+
 	// Generated by "bin2c.cmake" arrays.
 	#include "bc_files_headers/alloc_libc_32.h"
 	#include "bc_files_headers/alloc_libc_64.h"
@@ -115,8 +127,9 @@ bool LinkCompilerBuiltinModules(
 	// Link stdlib with result module.
 	for( const llvm::StringRef& asm_funcs_module : asm_funcs_modules )
 	{
+		// Load modules lazily - bodies of functions are materialized only if these functions are really linked.
 		llvm::Expected<std::unique_ptr<llvm::Module>> std_lib_module=
-			llvm::parseBitcodeFile(
+			llvm::getLazyBitcodeModule(
 				llvm::MemoryBufferRef( asm_funcs_module, "ustlib asm file" ),
 				result_module.getContext() );
 
@@ -148,7 +161,15 @@ bool LinkCompilerBuiltinModules(
 			return false;
 		}
 
-		llvm::Linker::linkModules( result_module, std::move(std_lib_module.get()) );
+		// Most of builtin functions have "linkonce_odr" linkage, so, link only these of them, which are used in the result module.
+		// This is much faster than full linking with following removal of unused functions.
+		// But link modules with definitions, which can't be discarded (like configurable halt handler), fully.
+		const unsigned int link_flags=
+			HasNonDiscardableDefinitions( *std_lib_module.get() )
+				? llvm::Linker::Flags::None
+				: llvm::Linker::Flags::LinkOnlyNeeded;
+
+		llvm::Linker::linkModules( result_module, std::move(std_lib_module.get()), link_flags );
 	}
 
 	return true;
@@ -0,0 +1,99 @@
+#include <mutex>
+#include <unordered_map>
+
+#include "../code_builder_lib_common/push_disable_llvm_warnings.hpp"
+#include <llvm/Support/FileSystem.h>
+#include "../code_builder_lib_common/pop_llvm_warnings.hpp"
+
+#include "embed_files_cache.hpp"
+
+namespace U
+{
+
+namespace
+{
+
+namespace fs= llvm::sys::fs;
+
+class EmbedFilesCacheOverSystemFS final : public IEmbedFilesCache
+{
+public: // IEmbedFilesCache
+	virtual EntryPtr LoadFile( IVfs& vfs, const IVfs::Path& full_file_path, const ContentHashingFunction content_hashing_function ) override
+	{
+		fs::file_status status;
+		const bool status_is_known= !fs::status( full_file_path, status ) && fs::is_regular_file( status );
+
+		if( status_is_known )
+		{
+			const std::lock_guard<std::mutex> lock( mutex_ );
+			++stats_.num_requests;
+
+			const auto it= entries_.find( full_file_path );
+			if( it != entries_.end() &&
+				it->second.modification_time == status.getLastModificationTime() &&
+				it->second.size == status.getSize() )
+			{
+				++stats_.num_hits;
+				stats_.bytes_reused+= it->second.entry->content->GetContent().size();
+				return it->second.entry;
+			}
+		}
+
+		// Load and hash file outside lock, in order to allow loading of different files in parallel.
+		// It's not a problem if the same file is loaded simultaneously by multiple threads.
+		IVfs::FileContentBufferPtr content= vfs.LoadFileContentBuffer( full_file_path );
+		if( content == nullptr )
+			return nullptr;
+
+		auto entry= std::make_shared<Entry>();
+		entry->content_hash= content_hashing_function( content->GetContent() );
+		entry->content= std::move(content);
+
+		const std::lock_guard<std::mutex> lock( mutex_ );
+		if( !status_is_known )
+			++stats_.num_requests;
+		stats_.bytes_loaded+= entry->content->GetContent().size();
+
+		if( status_is_known )
+		{
+			CacheEntry& cache_entry= entries_[ full_file_path ];
+			if( cache_entry.entry == nullptr )
+				++stats_.num_files;
+			cache_entry.modification_time= status.getLastModificationTime();
+			cache_entry.size= status.getSize();
+			cache_entry.entry= entry;
+		}
+		else
+			++stats_.num_files;
+
+		return entry;
+	}
+
+	virtual Stats GetStats() override
+	{
+		const std::lock_guard<std::mutex> lock( mutex_ );
+		return stats_;
+	}
+
+private:
+	struct CacheEntry
+	{
+		llvm::sys::TimePoint<> modification_time;
+		uint64_t size= 0;
+		EntryPtr entry;
+	};
+
+private:
+	std::mutex mutex_;
+	std::unordered_map<IVfs::Path, CacheEntry> entries_;
+	Stats stats_;
+};
+
+} // namespace
+
+std::unique_ptr<IEmbedFilesCache> CreateEmbedFilesCacheOverSystemFS()
+{
+	return std::make_unique<EmbedFilesCacheOverSystemFS>();
+}
+
+} // namespace U
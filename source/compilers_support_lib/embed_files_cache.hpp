@@ -0,0 +1,13 @@
+#pragma once
+#include <memory>
+
+#include "../compiler0/lex_synt_lib/i_embed_files_cache.hpp"
+
+namespace U
+{
+
+// Create in-memory cache, which identifies files by path, modification time and size (obtained from system file system).
+// Changed files are loaded again. Files which status can't be obtained aren't cached.
+std::unique_ptr<IEmbedFilesCache> CreateEmbedFilesCacheOverSystemFS();
+
+} // namespace U
@@ -0,0 +1,47 @@
+#include "../code_builder_lib_common/push_disable_llvm_warnings.hpp"
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/raw_ostream.h>
+#include "../code_builder_lib_common/pop_llvm_warnings.hpp"
+
+#include "file_utils.hpp"
+
+namespace U
+{
+
+namespace fs= llvm::sys::fs;
+namespace fsp= llvm::sys::path;
+
+bool WriteFileAtomically( const std::string& file_path, const std::string_view data )
+{
+	const llvm::StringRef parent_path= fsp::parent_path( file_path );
+	if( !parent_path.empty() && fs::create_directories( parent_path ) )
+		return false;
+
+	llvm::SmallString<256> temp_file_path;
+	int fd= -1;
+	if( fs::createUniqueFile( file_path + ".tmp-%%%%%%%%", fd, temp_file_path ) )
+		return false;
+
+	{
+		llvm::raw_fd_ostream stream( fd, /* shouldClose */ true );
+		stream.write( data.data(), data.size() );
+		stream.close();
+		if( stream.has_error() )
+		{
+			stream.clear_error();
+			fs::remove( temp_file_path );
+			return false;
+		}
+	}
+
+	if( fs::rename( temp_file_path, file_path ) )
+	{
+		fs::remove( temp_file_path );
+		return false;
+	}
+
+	return true;
+}
+
+} // namespace U
@@ -0,0 +1,14 @@
+#pragma once
+#include <string>
+#include <string_view>
+
+namespace U
+{
+
+// Write given data into file, creating parent directories if necessary.
+// Data is written into temporary file first and then this file is renamed.
+// This prevents reading of partially-written files by other threads and processes.
+// Returns false on failure.
+bool WriteFileAtomically( const std::string& file_path, std::string_view data );
+
+} // namespace U
@@ -0,0 +1,62 @@
+#include "../code_builder_lib_common/push_disable_llvm_warnings.hpp"
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
+#include "../code_builder_lib_common/pop_llvm_warnings.hpp"
+
+#include "file_utils.hpp"
+#include "source_graph_cache.hpp"
+
+namespace U
+{
+
+namespace
+{
+
+namespace fsp= llvm::sys::path;
+
+using fs_path= llvm::SmallString<256>;
+
+class SourceGraphCacheOverSystemFS final : public ISourceGraphCache
+{
+public:
+	explicit SourceGraphCacheOverSystemFS( std::string directory )
+		: directory_(std::move(directory))
+	{}
+
+public: // ISourceGraphCache
+	virtual std::optional<std::string> LoadEntry( const std::string& key ) override
+	{
+		const llvm::ErrorOr< std::unique_ptr<llvm::MemoryBuffer> > file_mapped=
+			llvm::MemoryBuffer::getFile( GetEntryPath( key ) );
+		if( !file_mapped || *file_mapped == nullptr )
+			return std::nullopt;
+
+		return std::string( (*file_mapped)->getBufferStart(), (*file_mapped)->getBufferEnd() );
+	}
+
+	virtual void StoreEntry( const std::string& key, const std::string_view data ) override
+	{
+		WriteFileAtomically( GetEntryPath( key ), data );
+	}
+
+private:
+	std::string GetEntryPath( const std::string& key ) const
+	{
+		fs_path result( directory_ );
+		fsp::append( result, key + ".usgc" );
+		return result.str().str();
+	}
+
+private:
+	const std::string directory_;
+};
+
+} // namespace
+
+std::unique_ptr<ISourceGraphCache> CreateSourceGraphCacheOverSystemFS( std::string directory )
+{
+	return std::make_unique<SourceGraphCacheOverSystemFS>( std::move(directory) );
+}
+
+} // namespace U
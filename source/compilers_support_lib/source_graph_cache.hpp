@@ -0,0 +1,14 @@
+#pragma once
+#include <memory>
+
+#include "../compiler0/lex_synt_lib/i_source_graph_cache.hpp"
+
+namespace U
+{
+
+// Create cache, storing each entry in separate file within given directory.
+// Directory is created if it doesn't exist.
+// Entries are written atomically, so, it's safe to use the same directory by multiple compiler processes simultaneously.
+std::unique_ptr<ISourceGraphCache> CreateSourceGraphCacheOverSystemFS( std::string directory );
+
+} // namespace U
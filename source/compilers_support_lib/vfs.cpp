@@ -59,27 +59,59 @@ bool IsWithinGivenDirectory( const llvm::StringRef full_file_path, const llvm::S
 	return directory_path_it == directory_path_it_end;
 }
 
+// Keeps memory-mapped file contents (or contents read into memory, if mapping is not possible).
+class MemoryBufferFileContent final : public IVfs::FileContentBuffer
+{
+public:
+	explicit MemoryBufferFileContent( std::unique_ptr<llvm::MemoryBuffer> buffer ) : buffer_( std::move(buffer) ) {}
+
+	std::string_view GetContent() const override
+	{
+		return std::string_view( buffer_->getBufferStart(), buffer_->getBufferSize() );
+	}
+
+private:
+	const std::unique_ptr<llvm::MemoryBuffer> buffer_;
+};
+
 class VfsOverSystemFS final : public IVfs
 {
 public:
 	VfsOverSystemFS(
 		std::vector<PrefixedIncludeDir> prefixed_include_dirs,
 		std::vector<fs_path> source_dirs,
-		bool prevent_imports_outside_given_directories )
+		bool prevent_imports_outside_given_directories,
+		bool files_may_be_modified )
 		: include_dirs_(std::move(prefixed_include_dirs))
 		, source_dirs_(std::move(source_dirs))
 		, prevent_imports_outside_given_directories_(prevent_imports_outside_given_directories)
+		, files_may_be_modified_(files_may_be_modified)
 	{}
 
 public: // IVfs
 	virtual std::optional<FileContent> LoadFileContent( const Path& full_file_path ) override
 	{
-		const llvm::ErrorOr< std::unique_ptr<llvm::MemoryBuffer> > file_mapped=
-			llvm::MemoryBuffer::getFile( full_file_path );
-		if( !file_mapped || *file_mapped == nullptr )
+		const FileContentBufferPtr buffer= LoadFileContentBuffer( full_file_path );
+		if( buffer == nullptr )
 			return std::nullopt;
 
-		return std::string( (*file_mapped)->getBufferStart(), (*file_mapped)->getBufferEnd() );
+		return FileContent( buffer->GetContent() );
+	}
+
+	virtual FileContentBufferPtr LoadFileContentBuffer( const Path& full_file_path ) override
+	{
+		// Null terminator isn't needed, so, files with size multiple of the page size may be mapped too.
+		// Volatile files are read into memory, since truncation of mapped file leads to crash on access to its contents.
+		llvm::ErrorOr< std::unique_ptr<llvm::MemoryBuffer> > file_mapped=
+			llvm::MemoryBuffer::getFile(
+				full_file_path,
+				/* IsText */ false,
+				/* RequiresNullTerminator */ false,
+				/* IsVolatile */ files_may_be_modified_ );
+		if( !file_mapped || *file_mapped == nullptr )
+			return nullptr;
+
+		return std::make_shared<MemoryBufferFileContent>( std::move(*file_mapped) );
 	}
 
 	virtual Path GetFullFilePath( const Path& file_path, const Path& full_parent_file_path ) override
@@ -379,6 +411,7 @@ private:
 	const std::vector<PrefixedIncludeDir> include_dirs_;
 	const std::vector<fs_path> source_dirs_;
 	const bool prevent_imports_outside_given_directories_;
+	const bool files_may_be_modified_;
 };
 
 } // namespace
@@ -387,7 +420,8 @@ std::unique_ptr<IVfs> CreateVfsOverSystemFS(
 	const llvm::ArrayRef<std::string> include_dirs,
 	const llvm::ArrayRef<std::string> source_dirs,
 	const bool prevent_imports_outside_given_directories,
-	const bool tolerate_errors )
+	const bool tolerate_errors,
+	const bool files_may_be_modified )
 {
 	const char* const separator= "::";
 	const size_t separator_size= std::strlen( separator );
@@ -473,7 +507,8 @@ std::unique_ptr<IVfs> CreateVfsOverSystemFS(
 		std::make_unique<VfsOverSystemFS>(
 			std::move(result_include_dirs),
 			std::move(source_dirs_normalized),
-			prevent_imports_outside_given_directories );
+			prevent_imports_outside_given_directories,
+			files_may_be_modified );
 }
 
 } // namespace U
@@ -8,10 +8,14 @@
 namespace U
 {
 
+// Result VFS has no mutable state and thus may be used from multiple threads simultaneously.
+// If "files_may_be_modified" is true, files contents are read into memory instead of memory-mapping.
+// Use this for long-living users of loaded files, since modification of mapped file may crash the process or may be blocked by the OS.
 std::unique_ptr<IVfs> CreateVfsOverSystemFS(
 	llvm::ArrayRef<std::string> include_dirs,
 	llvm::ArrayRef<std::string> source_dirs= {},
 	bool prevent_imports_outside_given_directories= false,
-	bool tolerate_errors= false );
+	bool tolerate_errors= false,
+	bool files_may_be_modified= false );
 
 } // namespace U
@@ -76,7 +76,7 @@ int main( int argc, const char* argv[] )
 	for( const std::string& import : force_import )
 		out_file << "import " << "\"" << import << "\"\n";
 
-	for( auto& unit : *parsed_units )
+	for( auto& unit : parsed_units->units )
 		U::Synt::WriteProgram( unit.second, out_file );
 
 	out_file.flush();
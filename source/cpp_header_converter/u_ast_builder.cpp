@@ -152,26 +152,26 @@ std::string TranslateIdentifier( const llvm::StringRef identifier )
 // Name including all parent namespaces/structs.
 using ItemFullName= std::vector<std::string>;
 
-Synt::ComplexName GetItemNameSyntaxElementImpl( Synt::ComplexName base, const llvm::ArrayRef<std::string> components )
+Synt::ComplexName GetItemNameSyntaxElementImpl( Arena& arena, Synt::ComplexName base, const llvm::ArrayRef<std::string> components )
 {
 	if( components.empty() )
 		return base;
 
 	auto names_scope_name_fetch=
-		std::make_unique<Synt::NamesScopeNameFetch>(
+		arena.New<Synt::NamesScopeNameFetch>(
 			Synt::NamesScopeNameFetch{ g_dummy_src_loc, components.front(), std::move(base) } );
 
-	return GetItemNameSyntaxElementImpl( std::move(names_scope_name_fetch), components.slice(1) );
+	return GetItemNameSyntaxElementImpl( arena, std::move(names_scope_name_fetch), components.slice(1) );
 }
 
-Synt::ComplexName GetItemNameSyntaxElement( const ItemFullName& item_name )
+Synt::ComplexName GetItemNameSyntaxElement( Arena& arena, const ItemFullName& item_name )
 {
 	Synt::RootNamespaceNameLookup root_namespace_name_lookup( g_dummy_src_loc );
 	root_namespace_name_lookup.name= item_name.front();
 
 	return
 		GetItemNameSyntaxElementImpl(
-			std::move( root_namespace_name_lookup ), llvm::ArrayRef<std::string>( item_name ).slice(1) );
+			arena, std::move( root_namespace_name_lookup ), llvm::ArrayRef<std::string>( item_name ).slice(1) );
 }
 
 Synt::TypeName CreateFundamentalTypeName( const std::string_view name )
@@ -220,14 +220,14 @@ std::optional<std::string> TranslateCallingConventionImpl( const clang::Function
 	return std::nullopt;
 }
 
-std::unique_ptr<const Synt::Expression> TranslateCallingConvention( const clang::FunctionType& in_type )
+ArenaPtr<const Synt::Expression> TranslateCallingConvention( Arena& arena, const clang::FunctionType& in_type )
 {
 	if( auto cc= TranslateCallingConventionImpl( in_type ) )
 	{
-		auto string_literal= std::make_unique<Synt::StringLiteral>( g_dummy_src_loc );
+		auto string_literal= arena.New<Synt::StringLiteral>( g_dummy_src_loc );
 		string_literal->value= std::move(*cc);
 
-		return std::make_unique<Synt::Expression>( std::move(string_literal) );
+		return arena.New<Synt::Expression>( std::move(string_literal) );
 	}
 
 	return nullptr;
@@ -338,6 +338,7 @@ class CppAstConsumer final : public clang::ASTConsumer
 public:
 	CppAstConsumer(
 		Synt::ProgramElementsList& out_elements,
+		Arena& arena,
 		const clang::SourceManager& source_manager,
 		clang::Preprocessor& preprocessor,
 		const clang::TargetInfo& target_info,
@@ -418,6 +419,7 @@ private:
 
 private:
 	Synt::ProgramElementsList& out_program_elements_;
+	Arena& arena_; // Allocate syntax elements here.
 
 	const clang::SourceManager& source_manager_;
 	clang::Preprocessor& preprocessor_;
@@ -449,6 +451,7 @@ private:
 
 CppAstConsumer::CppAstConsumer(
 	Synt::ProgramElementsList& out_elements,
+	Arena& arena,
 	const clang::SourceManager& source_manager,
 	clang::Preprocessor& preprocessor,
 	const clang::TargetInfo& target_info,
@@ -456,6 +459,7 @@ CppAstConsumer::CppAstConsumer(
 	const clang::LangOptions& lang_options,
 	const clang::ASTContext& ast_context )
 	: out_program_elements_(out_elements)
+	, arena_(arena)
 	, source_manager_(source_manager)
 	, preprocessor_(preprocessor)
 	, target_info_(target_info)
@@ -491,7 +495,7 @@ void CppAstConsumer::HandleTranslationUnit( clang::ASTContext& ast_context )
 		BuildTypeNamesMapImpl( type_names_map, prefix, root_namespace_ );
 	}
 
-	Synt::ProgramElementsList::Builder root_program_elements;
+	Synt::ProgramElementsList::Builder root_program_elements( arena_ );
 
 	EmitItemsSorted( root_program_elements, type_names_map, root_namespace_.items );
 
@@ -648,7 +652,7 @@ Synt::TypeName CppAstConsumer::TranslateType( const clang::Type& in_type, const
 {
 	// Records, typedefs, enums should have names in this map.
 	if( const auto named_type_it= type_names_map.find( &in_type ); named_type_it != type_names_map.end() )
-		return Synt::ComplexNameToTypeName( GetItemNameSyntaxElement( named_type_it->second ) );
+		return Synt::ComplexNameToTypeName( GetItemNameSyntaxElement( arena_, named_type_it->second ) );
 
 	if( const auto built_in_type= llvm::dyn_cast<clang::BuiltinType>(&in_type) )
 		return CreateFundamentalTypeName( GetUFundamentalType( *built_in_type ) );
@@ -675,7 +679,7 @@ Synt::TypeName CppAstConsumer::TranslateType( const clang::Type& in_type, const
 	else if( const auto complex_type= llvm::dyn_cast<clang::ComplexType>(&in_type) )
 	{
 		// For now translate complex types as arrays of two values of underlying types.
-		auto array_type= std::make_unique<Synt::ArrayTypeName>(g_dummy_src_loc);
+		auto array_type= arena_.New<Synt::ArrayTypeName>(g_dummy_src_loc);
 		array_type->element_type= TranslateType( *complex_type->getElementType().getTypePtr(), type_names_map );
 
 		Synt::IntegerNumericConstant numeric_constant( g_dummy_src_loc );
@@ -687,7 +691,7 @@ Synt::TypeName CppAstConsumer::TranslateType( const clang::Type& in_type, const
 	else if( const auto constant_array_type= llvm::dyn_cast<clang::ConstantArrayType>(&in_type) )
 	{
 		// For arrays with constant size use normal Ü array.
-		auto array_type= std::make_unique<Synt::ArrayTypeName>(g_dummy_src_loc);
+		auto array_type= arena_.New<Synt::ArrayTypeName>(g_dummy_src_loc);
 		array_type->element_type= TranslateType( *constant_array_type->getElementType().getTypePtr(), type_names_map );
 
 		array_type->size= TranslateNumericConstant( constant_array_type->getSize() );
@@ -697,14 +701,14 @@ Synt::TypeName CppAstConsumer::TranslateType( const clang::Type& in_type, const
 	else if( const auto incomplete_array_type= llvm::dyn_cast<clang::IncompleteArrayType>(&in_type) )
 	{
 		// Translate incomplete array types as raw pointers.
-		auto raw_pointer_type= std::make_unique<Synt::RawPointerType>( g_dummy_src_loc );
+		auto raw_pointer_type= arena_.New<Synt::RawPointerType>( g_dummy_src_loc );
 		raw_pointer_type->element_type= TranslateType( *incomplete_array_type->getArrayElementTypeNoTypeQual(), type_names_map );
 		return std::move(raw_pointer_type);
 	}
 	else if( const auto array_type= llvm::dyn_cast<clang::ArrayType>(&in_type) )
 	{
 		// For other kinds of array types use zero size.
-		auto out_array_type= std::make_unique<Synt::ArrayTypeName>(g_dummy_src_loc);
+		auto out_array_type= arena_.New<Synt::ArrayTypeName>(g_dummy_src_loc);
 		out_array_type->element_type= TranslateType( *array_type->getElementType().getTypePtr(), type_names_map );
 
 		Synt::IntegerNumericConstant numeric_constant( g_dummy_src_loc );
@@ -719,7 +723,7 @@ Synt::TypeName CppAstConsumer::TranslateType( const clang::Type& in_type, const
 		// It's not fully correct, since vector types may use custom alignment larger than element aligment.
 		// But at least result size matches, which is important if such type is used for a struct field.
 
-		auto out_array_type= std::make_unique<Synt::ArrayTypeName>(g_dummy_src_loc);
+		auto out_array_type= arena_.New<Synt::ArrayTypeName>(g_dummy_src_loc);
 		out_array_type->element_type= TranslateType( *vector_type->getElementType().getTypePtr(), type_names_map );
 
 		Synt::IntegerNumericConstant numeric_constant( g_dummy_src_loc );
@@ -731,7 +735,7 @@ Synt::TypeName CppAstConsumer::TranslateType( const clang::Type& in_type, const
 	else if( const auto decayed_type= llvm::dyn_cast<clang::DecayedType>(&in_type) )
 	{
 		// Decayed type - implicit array to pointer conversion.
-		auto raw_pointer_type= std::make_unique<Synt::RawPointerType>( g_dummy_src_loc );
+		auto raw_pointer_type= arena_.New<Synt::RawPointerType>( g_dummy_src_loc );
 		raw_pointer_type->element_type= TranslateType( *decayed_type->getPointeeType().getTypePtr(), type_names_map );
 
 		return std::move(raw_pointer_type);
@@ -762,9 +766,9 @@ Synt::TypeName CppAstConsumer::TranslateType( const clang::Type& in_type, const
 		}
 
 		if( const auto function_proto_type= llvm::dyn_cast<clang::FunctionProtoType>( function_type ) )
-			return std::make_unique<Synt::FunctionType>( TranslateFunctionType( *function_proto_type, type_names_map ) );
+			return arena_.New<Synt::FunctionType>( TranslateFunctionType( *function_proto_type, type_names_map ) );
 		else if( const auto function_no_proto_type= llvm::dyn_cast<clang::FunctionNoProtoType>( function_type ) )
-			return std::make_unique<Synt::FunctionType>( TranslateFunctionType( *function_no_proto_type, type_names_map ) );
+			return arena_.New<Synt::FunctionType>( TranslateFunctionType( *function_no_proto_type, type_names_map ) );
 	}
 	else if( llvm::isa<clang::FunctionProtoType>( &in_type ) )
 	{
@@ -775,7 +779,7 @@ Synt::TypeName CppAstConsumer::TranslateType( const clang::Type& in_type, const
 	}
 	else if( const auto pointer_type= llvm::dyn_cast<clang::PointerType>(&in_type) )
 	{
-		auto raw_pointer_type= std::make_unique<Synt::RawPointerType>( g_dummy_src_loc );
+		auto raw_pointer_type= arena_.New<Synt::RawPointerType>( g_dummy_src_loc );
 		raw_pointer_type->element_type= TranslateType( *pointer_type->getPointeeType().getTypePtr(), type_names_map );
 
 		return std::move(raw_pointer_type);
@@ -783,7 +787,7 @@ Synt::TypeName CppAstConsumer::TranslateType( const clang::Type& in_type, const
 	else if( const auto reference_type= llvm::dyn_cast<clang::ReferenceType>(&in_type) )
 	{
 		// Translate C++ references as raw pointers, since they are not so limited as Ü references.
-		auto raw_pointer_type= std::make_unique<Synt::RawPointerType>( g_dummy_src_loc );
+		auto raw_pointer_type= arena_.New<Synt::RawPointerType>( g_dummy_src_loc );
 		raw_pointer_type->element_type= TranslateType( *reference_type->getPointeeType().getTypePtr(), type_names_map );
 
 		return std::move(raw_pointer_type);
@@ -892,7 +896,7 @@ Synt::FunctionType CppAstConsumer::TranslateFunctionType( const clang::FunctionT
 	function_type.unsafe= true; // All C/C++ functions are unsafe.
 
 	const clang::Type* const return_type= in_type.getReturnType().getTypePtr();
-	function_type.return_type= std::make_unique<Synt::TypeName>( TranslateType( *return_type, type_names_map ) );
+	function_type.return_type= arena_.New<Synt::TypeName>( TranslateType( *return_type, type_names_map ) );
 
 	const clang::Type* return_type_desugared= return_type;
 	while(true)
@@ -916,7 +920,7 @@ Synt::FunctionType CppAstConsumer::TranslateFunctionType( const clang::FunctionT
 		}
 	}
 
-	function_type.calling_convention= TranslateCallingConvention( in_type );
+	function_type.calling_convention= TranslateCallingConvention( arena_, in_type );
 
 	return function_type;
 }
@@ -1145,7 +1149,7 @@ void CppAstConsumer::EmitItemsSorted( ListBuilder& out_items, const TypeNamesMap
 Synt::Namespace CppAstConsumer::EmitNamespaceItem(
 	const TypeNamesMap& type_names_map, std::string_view name, const NamespaceItemNamespace& item )
 {
-	Synt::ProgramElementsList::Builder items_builder;
+	Synt::ProgramElementsList::Builder items_builder( arena_ );
 
 	EmitItemsSorted( items_builder, type_names_map, item.items );
 
@@ -1159,7 +1163,7 @@ Synt::Namespace CppAstConsumer::EmitNamespaceItem(
 Synt::Class CppAstConsumer::EmitItemImpl(
 	const TypeNamesMap& type_names_map, const std::string_view name, const NamespaceItemNamespace& item )
 {
-	Synt::ClassElementsList::Builder class_items_builder;
+	Synt::ClassElementsList::Builder class_items_builder( arena_ );
 
 	EmitItemsSorted( class_items_builder, type_names_map, item.items );
 
@@ -1234,7 +1238,7 @@ Synt::Class CppAstConsumer::EmitItemImpl(
 
 			bool is_empty= record_declaration.fields().empty();
 
-			Synt::ClassElementsList::Builder class_elements;
+			Synt::ClassElementsList::Builder class_elements( arena_ );
 
 			if( const auto cxx_record= llvm::dyn_cast<clang::CXXRecordDecl>( &record_declaration ) )
 			{
@@ -1290,7 +1294,7 @@ Synt::Class CppAstConsumer::EmitItemImpl(
 					Synt::RawPointerType raw_pointer_type( g_dummy_src_loc );
 					raw_pointer_type.element_type= std::move(byte8_type);
 
-					field.type= std::make_unique<Synt::RawPointerType>( std::move( raw_pointer_type ) );
+					field.type= arena_.New<Synt::RawPointerType>( std::move( raw_pointer_type ) );
 
 					field.name= "ü_vptr";
 
@@ -1323,7 +1327,7 @@ Synt::Class CppAstConsumer::EmitItemImpl(
 					if( record_declaration.hasFlexibleArrayMember() && field_type.isIncompleteArrayType() )
 					{
 						// Create a zero-sized array for a flexible array member.
-						auto array_type= std::make_unique<Synt::ArrayTypeName>(g_dummy_src_loc);
+						auto array_type= arena_.New<Synt::ArrayTypeName>(g_dummy_src_loc);
 						array_type->element_type= TranslateType( *field_type.getArrayElementTypeNoTypeQual(), type_names_map );
 
 						Synt::IntegerNumericConstant numeric_constant( g_dummy_src_loc );
@@ -1363,7 +1367,7 @@ Synt::Class CppAstConsumer::EmitItemImpl(
 			class_.kind_attribute= Synt::ClassKindAttribute::Class;
 
 			// Add deleted default constructor.
-			Synt::ClassElementsList::Builder class_elements;
+			Synt::ClassElementsList::Builder class_elements( arena_ );
 			class_elements.Append( GetDeletedDefaultConstructor() );
 			class_.elements= class_elements.Build();
 		}
@@ -1380,7 +1384,7 @@ Synt::Class CppAstConsumer::EmitItemImpl(
 			class_.kind_attribute= Synt::ClassKindAttribute::Class;
 
 			// Add deleted default constructor.
-			Synt::ClassElementsList::Builder class_elements;
+			Synt::ClassElementsList::Builder class_elements( arena_ );
 			class_elements.Append( GetDeletedDefaultConstructor() );
 
 			EmitItemsSorted( class_elements, type_names_map, item.items );
@@ -1476,12 +1480,12 @@ Synt::VariablesDeclaration CppAstConsumer::EmitItemImpl(
 				unary_minus.expression= TranslateNumericConstant( -val );
 
 				constructor_initializer.arguments.push_back(
-					std::make_unique<const Synt::UnaryMinus>( std::move( unary_minus ) ) );
+					arena_.New<const Synt::UnaryMinus>( std::move( unary_minus ) ) );
 			}
 			else
 				constructor_initializer.arguments.push_back( TranslateNumericConstant( val ) );
 
-			var.initializer= std::make_unique<Synt::Initializer>( std::move(constructor_initializer) );
+			var.initializer= arena_.New<Synt::Initializer>( std::move(constructor_initializer) );
 		}
 
 		variables_declaration.variables.push_back( std::move( var ) );
@@ -1537,7 +1541,7 @@ Synt::VariablesDeclaration CppAstConsumer::EmitItemImpl(
 	Synt::VariablesDeclaration::VariableEntry entry;
 	entry.src_loc= g_dummy_src_loc;
 	entry.name= name;
-	entry.initializer= std::make_unique<Synt::Initializer>( std::move(initializer ) );
+	entry.initializer= arena_.New<Synt::Initializer>( std::move(initializer ) );
 	entry.mutability_modifier= Synt::MutabilityModifier::Constexpr;
 
 	variables_declaration.variables.push_back( std::move(entry) );
@@ -1566,7 +1570,7 @@ Synt::ClassElementsList CppAstConsumer::MakeOpaqueRecordElements(
 	default: U_ASSERT(false); break;
 	};
 
-	auto array_type= std::make_unique<Synt::ArrayTypeName>( g_dummy_src_loc );
+	auto array_type= arena_.New<Synt::ArrayTypeName>( g_dummy_src_loc );
 	array_type->element_type= CreateFundamentalTypeName( byte_name );
 
 	Synt::IntegerNumericConstant numeric_constant( g_dummy_src_loc );
@@ -1578,7 +1582,7 @@ Synt::ClassElementsList CppAstConsumer::MakeOpaqueRecordElements(
 	field.name+= "_contents";
 	field.type= std::move(array_type);
 
-	Synt::ClassElementsList::Builder class_elements;
+	Synt::ClassElementsList::Builder class_elements( arena_ );
 	class_elements.Append( std::move(field) );
 
 	EmitItemsSorted( class_elements, type_names_map, subitems );
@@ -1599,7 +1603,7 @@ Synt::Initializer CppAstConsumer::TranslateVariableInitializer_r( const clang::T
 			Synt::UnaryMinus unary_minus( g_dummy_src_loc );
 			unary_minus.expression= TranslateNumericConstant( -init_val_int );
 
-			initializer.arguments.push_back( std::make_unique<const Synt::UnaryMinus>( std::move( unary_minus ) ) );
+			initializer.arguments.push_back( arena_.New<const Synt::UnaryMinus>( std::move( unary_minus ) ) );
 		}
 		else
 			initializer.arguments.push_back( TranslateNumericConstant( init_val_int ) );
@@ -1616,13 +1620,13 @@ Synt::Initializer CppAstConsumer::TranslateVariableInitializer_r( const clang::T
 		{
 			Synt::UnaryMinus unary_minus( g_dummy_src_loc );
 			unary_minus.expression=
-				std::make_unique< Synt::FloatingPointNumericConstant >( TranslateNumericConstant( -init_val_float ) );
+				arena_.New< Synt::FloatingPointNumericConstant >( TranslateNumericConstant( -init_val_float ) );
 
-			initializer.arguments.push_back( std::make_unique<const Synt::UnaryMinus>( std::move( unary_minus ) ) );
+			initializer.arguments.push_back( arena_.New<const Synt::UnaryMinus>( std::move( unary_minus ) ) );
 		}
 		else
 			initializer.arguments.push_back(
-				std::make_unique< Synt::FloatingPointNumericConstant >( TranslateNumericConstant( init_val_float ) ) );
+				arena_.New< Synt::FloatingPointNumericConstant >( TranslateNumericConstant( init_val_float ) ) );
 
 		return std::move(initializer);
 	}
@@ -1791,7 +1795,7 @@ void CppAstConsumer::EmitDefinitionsForMacros( Synt::ProgramElementsList::Builde
 				auto_variable_declaration.mutability_modifier= Synt::MutabilityModifier::Constexpr;
 				auto_variable_declaration.name= macro_translated_name;
 
-				auto string_constant= std::make_unique<Synt::StringLiteral>( g_dummy_src_loc );
+				auto string_constant= arena_.New<Synt::StringLiteral>( g_dummy_src_loc );
 
 				if( string_literal_parser.isOrdinary() || string_literal_parser.isUTF8() )
 				{
@@ -1984,7 +1988,7 @@ Synt::Expression CppAstConsumer::TranslateNumericLiteral( const clang::Token& to
 			if( numeric_literal_parser.isUnsigned )
 			{
 				// Create "0 - x" instead of "-x" for negative unsinged constants, since Ü has no unary minus for unsigned integer types.
-				auto binary_operator= std::make_unique<Synt::BinaryOperator>( g_dummy_src_loc );
+				auto binary_operator= arena_.New<Synt::BinaryOperator>( g_dummy_src_loc );
 				binary_operator->operator_type= BinaryOperatorType::Sub;
 				{
 					Synt::IntegerNumericConstant zero( g_dummy_src_loc );
@@ -2003,7 +2007,7 @@ Synt::Expression CppAstConsumer::TranslateNumericLiteral( const clang::Token& to
 			}
 			else
 			{
-				auto minus= std::make_unique<Synt::UnaryMinus>( g_dummy_src_loc );
+				auto minus= arena_.New<Synt::UnaryMinus>( g_dummy_src_loc );
 				minus->expression= std::move( expression );
 				expression= std::move( minus );
 			}
@@ -2026,11 +2030,11 @@ Synt::Expression CppAstConsumer::TranslateNumericLiteral( const clang::Token& to
 		if( numeric_literal_parser.isFloat )
 			numeric_constant.type_suffix= "f";
 
-		Synt::Expression expression= std::make_unique< Synt::FloatingPointNumericConstant >( std::move( numeric_constant ) );
+		Synt::Expression expression= arena_.New< Synt::FloatingPointNumericConstant >( std::move( numeric_constant ) );
 
 		if( has_minus_sign )
 		{
-			auto minus= std::make_unique<Synt::UnaryMinus>( g_dummy_src_loc );
+			auto minus= arena_.New<Synt::UnaryMinus>( g_dummy_src_loc );
 			minus->expression= std::move( expression );
 			expression= std::move( minus );
 		}
@@ -2063,7 +2067,8 @@ std::unique_ptr<clang::ASTConsumer> CppAstProcessor::CreateASTConsumer(
 {
 	return
 		std::make_unique<CppAstConsumer>(
-			(*out_result_)[ in_file.str() ],
+			out_result_->units[ in_file.str() ],
+			out_result_->arena,
 			compiler_intance.getSourceManager(),
 			compiler_intance.getPreprocessor(),
 			compiler_intance.getTarget(),
@@ -10,7 +10,12 @@
 namespace U
 {
 
-using ParsedUnits= std::unordered_map< std::string, Synt::ProgramElementsList >;
+struct ParsedUnits
+{
+	Arena arena; // Syntax elements of all units are allocated here.
+	std::unordered_map< std::string, Synt::ProgramElementsList > units;
+};
+
 using ParsedUnitsPtr= std::shared_ptr<ParsedUnits>;
 
 struct DepFileOptions
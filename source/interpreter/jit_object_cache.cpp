@@ -0,0 +1,132 @@
+#include <cstring>
+
+#include "../code_builder_lib_common/push_disable_llvm_warnings.hpp"
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/raw_ostream.h>
+#include "../code_builder_lib_common/pop_llvm_warnings.hpp"
+
+#include "../code_builder_lib_common/long_stable_hash.hpp"
+#include "../compilers_support_lib/file_utils.hpp"
+#include "jit_object_cache.hpp"
+
+namespace U
+{
+
+namespace
+{
+
+namespace fsp= llvm::sys::path;
+
+using fs_path= llvm::SmallString<256>;
+
+// Entry layout: signature, number of dependency files, (path size, path, hash size, hash) for each dependency file, object file until the end.
+constexpr char c_entry_signature[]= "UJITOBJ1";
+
+void WriteUint32( llvm::raw_ostream& stream, const uint32_t value )
+{
+	char bytes[sizeof(uint32_t)];
+	std::memcpy( bytes, &value, sizeof(uint32_t) );
+	stream.write( bytes, sizeof(uint32_t) );
+}
+
+void WriteString( llvm::raw_ostream& stream, const llvm::StringRef str )
+{
+	WriteUint32( stream, uint32_t(str.size()) );
+	stream << str;
+}
+
+bool ReadUint32( llvm::StringRef& data, uint32_t& out_value )
+{
+	if( data.size() < sizeof(uint32_t) )
+		return false;
+
+	std::memcpy( &out_value, data.data(), sizeof(uint32_t) );
+	data= data.drop_front( sizeof(uint32_t) );
+	return true;
+}
+
+bool ReadString( llvm::StringRef& data, llvm::StringRef& out_str )
+{
+	uint32_t size= 0;
+	if( !ReadUint32( data, size ) || data.size() < size )
+		return false;
+
+	out_str= data.take_front( size );
+	data= data.drop_front( size );
+	return true;
+}
+
+} // namespace
+
+JitObjectCache::JitObjectCache( std::string directory )
+	: directory_(std::move(directory))
+{}
+
+std::unique_ptr<llvm::MemoryBuffer> JitObjectCache::LoadObject( IVfs& vfs, const std::string& key ) const
+{
+	const llvm::ErrorOr< std::unique_ptr<llvm::MemoryBuffer> > file_mapped=
+		llvm::MemoryBuffer::getFile( GetEntryPath( key ), /* IsText */ false, /* RequiresNullTerminator */ false );
+	if( !file_mapped || *file_mapped == nullptr )
+		return nullptr;
+
+	llvm::StringRef data= (*file_mapped)->getBuffer();
+
+	const llvm::StringRef signature( c_entry_signature, std::size(c_entry_signature) - 1 );
+	if( !data.startswith( signature ) )
+		return nullptr;
+	data= data.drop_front( signature.size() );
+
+	uint32_t num_dependency_files= 0;
+	if( !ReadUint32( data, num_dependency_files ) )
+		return nullptr;
+
+	for( uint32_t i= 0; i < num_dependency_files; ++i )
+	{
+		llvm::StringRef file_path, content_hash;
+		if( !ReadString( data, file_path ) || !ReadString( data, content_hash ) )
+			return nullptr;
+
+		const IVfs::FileContentBufferPtr content= vfs.LoadFileContentBuffer( file_path.str() );
+		if( content == nullptr || CalculateFileContentHash( content->GetContent() ) != content_hash )
+			return nullptr;
+	}
+
+	if( data.empty() )
+		return nullptr;
+
+	// Copy object, since JIT needs owning buffer with proper alignment.
+	return llvm::MemoryBuffer::getMemBufferCopy( data, key );
+}
+
+bool JitObjectCache::StoreObject( const std::string& key, const llvm::ArrayRef<DependencyFile> dependency_files, const llvm::StringRef object ) const
+{
+	std::string data;
+	llvm::raw_string_ostream stream( data );
+
+	stream << c_entry_signature;
+	WriteUint32( stream, uint32_t(dependency_files.size()) );
+	for( const DependencyFile& dependency_file : dependency_files )
+	{
+		WriteString( stream, dependency_file.file_path );
+		WriteString( stream, dependency_file.content_hash );
+	}
+	stream << object;
+	stream.flush();
+
+	return WriteFileAtomically( GetEntryPath( key ), data );
+}
+
+std::string JitObjectCache::CalculateFileContentHash( const std::string_view content )
+{
+	return CalculateLongStableHash( content );
+}
+
+std::string JitObjectCache::GetEntryPath( const std::string& key ) const
+{
+	fs_path result( directory_ );
+	fsp::append( result, key + ".ujo" );
+	return result.str().str();
+}
+
+} // namespace U
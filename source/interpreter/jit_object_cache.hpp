@@ -0,0 +1,47 @@
+#pragma once
+#include <memory>
+#include <string>
+
+#include "../code_builder_lib_common/push_disable_llvm_warnings.hpp"
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include "../code_builder_lib_common/pop_llvm_warnings.hpp"
+
+#include "../compiler0/lex_synt_lib/i_vfs.hpp"
+
+namespace U
+{
+
+// Persistent cache of native object files, produced by the interpreter for JIT execution.
+// Each entry is stored in separate file within given directory.
+// An entry contains an object file and a list of files (with their contents hashes) used for building it.
+// Entry is valid only if all these files are unchanged, so, loading of a valid entry requires no syntax analysis and no code building.
+// Entries are written atomically, so, it's safe to use the same directory by multiple interpreter processes simultaneously.
+class JitObjectCache
+{
+public:
+	struct DependencyFile
+	{
+		IVfs::Path file_path;
+		std::string content_hash;
+	};
+
+public:
+	explicit JitObjectCache( std::string directory );
+
+	// Returns null if there is no entry for given key or if some of the entry dependency files was changed.
+	std::unique_ptr<llvm::MemoryBuffer> LoadObject( IVfs& vfs, const std::string& key ) const;
+
+	// Directory is created if it doesn't exist. Returns false on failure.
+	bool StoreObject( const std::string& key, llvm::ArrayRef<DependencyFile> dependency_files, llvm::StringRef object ) const;
+
+	static std::string CalculateFileContentHash( std::string_view content );
+
+private:
+	std::string GetEntryPath( const std::string& key ) const;
+
+private:
+	const std::string directory_;
+};
+
+} // namespace U
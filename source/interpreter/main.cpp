@@ -3,13 +3,22 @@
 #include "../code_builder_lib_common/push_disable_llvm_warnings.hpp"
 #include <llvm/ExecutionEngine/MCJIT.h>
 #include <llvm/ExecutionEngine/SectionMemoryManager.h>
+#ifndef __EMSCRIPTEN__
+#include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#endif
+#include <llvm/IR/LegacyPassManager.h>
 #include <llvm/IR/Mangler.h>
 #include <llvm/Linker/Linker.h>
 #include <llvm/MC/TargetRegistry.h>
+#include <llvm/Object/ObjectFile.h>
+#include <llvm/Passes/PassBuilder.h>
 #include <llvm/Support/CommandLine.h>
 #include <llvm/Support/DynamicLibrary.h>
 #include <llvm/Support/InitLLVM.h>
+#include <llvm/Support/SmallVectorMemoryBuffer.h>
 #include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/Threading.h>
 #include <llvm/TargetParser/Host.h>
 #include <llvm/TargetParser/SubtargetFeature.h>
 #include "../code_builder_lib_common/pop_llvm_warnings.hpp"
@@ -23,6 +32,7 @@
 #include "../compilers_support_lib/prelude.hpp"
 #include "../compilers_support_lib/vfs.hpp"
 #include "../tests/tests_common.hpp"
+#include "jit_object_cache.hpp"
 
 namespace U
 {
@@ -217,6 +227,16 @@ void U_CALLING_CONVENTION StdErrPrint( const char* const ptr, const size_t size
 	std::cerr.flush();
 }
 
+#ifndef __EMSCRIPTEN__
+
+void LazyCompileFailure()
+{
+	std::cerr << "Lazy compilation of a function failed." << std::endl;
+	std::abort();
+}
+
+#endif
+
 } // namespace JitFuncs
 
 std::string GetNativeTargetFeaturesStr()
@@ -233,6 +253,307 @@ std::string GetNativeTargetFeaturesStr()
 	return features.getString();
 }
 
+enum class JitKind
+{
+	None, // Use interpreter.
+	MCJIT, // Compile the whole program before execution.
+	OrcLazy, // Compile each function just before its first call.
+};
+
+llvm::CodeGenOpt::Level GetCodeGenOptLevel( const llvm::OptimizationLevel optimization_level )
+{
+	if( optimization_level.getSpeedupLevel() >= 3 )
+		return llvm::CodeGenOpt::Aggressive;
+	if( optimization_level.getSpeedupLevel() >= 2 )
+		return llvm::CodeGenOpt::Default;
+	if( optimization_level.getSpeedupLevel() >= 1 || optimization_level.getSizeLevel() > 0 )
+		return llvm::CodeGenOpt::Less;
+	return llvm::CodeGenOpt::None;
+}
+
+// Run IR optimizations for the given module. Target machine may be null.
+// If "function_passes_only" is true, only function simplification passes are used.
+// This is needed for lazy JIT partitions, which contain only a couple of functions and declarations of all other functions -
+// module-level passes are almost useless for them and may even remove definitions the JIT expects.
+void OptimizeModule(
+	llvm::Module& module,
+	llvm::TargetMachine* const target_machine,
+	const llvm::OptimizationLevel optimization_level,
+	const bool function_passes_only )
+{
+	if( optimization_level == llvm::OptimizationLevel::O0 )
+		return;
+
+	llvm::PipelineTuningOptions tuning_options;
+	tuning_options.LoopUnrolling= optimization_level.getSpeedupLevel() > 0;
+	tuning_options.LoopVectorization= optimization_level.getSpeedupLevel() > 1 && optimization_level.getSizeLevel() < 2;
+	tuning_options.SLPVectorization= optimization_level.getSpeedupLevel() > 1 && optimization_level.getSizeLevel() < 2;
+
+	llvm::PassBuilder pass_builder( target_machine, tuning_options );
+
+	llvm::LoopAnalysisManager loop_analysis_manager;
+	llvm::FunctionAnalysisManager function_analysis_manager;
+	llvm::CGSCCAnalysisManager cg_analysis_manager;
+	llvm::ModuleAnalysisManager module_analysis_manager;
+	pass_builder.registerModuleAnalyses(module_analysis_manager);
+	pass_builder.registerCGSCCAnalyses(cg_analysis_manager);
+	pass_builder.registerFunctionAnalyses(function_analysis_manager);
+	pass_builder.registerLoopAnalyses(loop_analysis_manager);
+	pass_builder.crossRegisterProxies(
+		loop_analysis_manager,
+		function_analysis_manager,
+		cg_analysis_manager,
+		module_analysis_manager);
+
+	llvm::ModulePassManager module_pass_manager;
+	if( function_passes_only )
+		module_pass_manager.addPass(
+			llvm::createModuleToFunctionPassAdaptor(
+				pass_builder.buildFunctionSimplificationPipeline( optimization_level, llvm::ThinOrFullLTOPhase::None ) ) );
+	else
+		module_pass_manager= pass_builder.buildPerModuleDefaultPipeline( optimization_level );
+
+	module_pass_manager.run( module, module_analysis_manager );
+}
+
+// Returns null on failure.
+std::unique_ptr<llvm::MemoryBuffer> CompileModuleToObject( llvm::Module& module, llvm::TargetMachine& target_machine )
+{
+	llvm::SmallVector<char, 0> object_data;
+	llvm::raw_svector_ostream stream( object_data );
+
+	llvm::legacy::PassManager pass_manager;
+	if( target_machine.addPassesToEmitFile( pass_manager, stream, nullptr, llvm::CGFT_ObjectFile ) )
+		return nullptr;
+
+	pass_manager.run( module );
+
+	return std::make_unique<llvm::SmallVectorMemoryBuffer>( std::move(object_data), module.getName(), /* RequiresNullTerminator */ false );
+}
+
+// Build all input files and link them together with builtins. Returns null on errors.
+// Fills list of files (including imported and embedded ones) used for building.
+std::unique_ptr<llvm::Module> BuildProgramModule(
+	llvm::LLVMContext& llvm_context,
+	const IVfsSharedPtr& vfs,
+	const llvm::ArrayRef<std::string> input_files,
+	const std::string& prelude_code,
+	const llvm::DataLayout& data_layout,
+	const llvm::Triple& target_triple,
+	const bool generate_tbaa_metadata,
+	std::vector<IVfs::Path>& out_dependency_files )
+{
+	std::unique_ptr<llvm::Module> result_module;
+
+	const auto errors_format= ErrorsFormat::GCC;
+
+	bool have_some_errors= false;
+	for( const std::string& input_file : input_files )
+	{
+		SourceGraph source_graph= LoadSourceGraph( *vfs, CalculateLongStableHash, input_file, prelude_code );
+
+		std::vector<IVfs::Path> dependent_files;
+		dependent_files.reserve( source_graph.nodes_storage.size() );
+		for( const SourceGraph::Node& node : source_graph.nodes_storage )
+		{
+			dependent_files.push_back( node.file_path );
+			if( node.category != SourceGraph::Node::Category::BuiltInPrelude )
+				out_dependency_files.push_back( node.file_path );
+		}
+
+		PrintLexSyntErrors( dependent_files, source_graph.errors, errors_format );
+		if( !source_graph.errors.empty() )
+		{
+			have_some_errors= true;
+			continue;
+		}
+
+		CodeBuilderOptions options;
+		options.report_about_unused_names= false; // Do not require generating extra errors in interpreter.
+		options.mangling_scheme= ManglingScheme::ItaniumABI; // For simplicity use it even on Windows.
+		options.generate_tbaa_metadata= generate_tbaa_metadata;
+
+		CodeBuilder::BuildResult build_result=
+			CodeBuilder::BuildProgram(
+				llvm_context,
+				data_layout,
+				target_triple,
+				options,
+				std::make_shared<SourceGraph>( std::move(source_graph) ),
+				vfs );
+
+		PrintErrors( dependent_files, build_result.errors, errors_format );
+
+		for( IVfs::Path& embedded_file : build_result.embedded_files )
+			out_dependency_files.push_back( std::move(embedded_file) );
+
+		if( !build_result.errors.empty() || build_result.module == nullptr )
+		{
+			have_some_errors= true;
+			continue;
+		}
+
+		if( result_module == nullptr )
+			result_module= std::move( build_result.module );
+		else
+		{
+			const bool not_ok= llvm::Linker::linkModules( *result_module, std::move(build_result.module) );
+			if( not_ok )
+			{
+				std::cerr << "Error, linking file \"" << input_file << "\"" << std::endl;
+				have_some_errors= true;
+			}
+		}
+	}
+
+	if( have_some_errors )
+		return nullptr;
+
+	if( !LinkCompilerBuiltinModules(
+			*result_module,
+			HaltMode::Abort,
+			false // Enable system allocations
+				) )
+		return nullptr;
+
+	std::sort( out_dependency_files.begin(), out_dependency_files.end() );
+	out_dependency_files.erase( std::unique( out_dependency_files.begin(), out_dependency_files.end() ), out_dependency_files.end() );
+
+	return result_module;
+}
+
+#ifndef __EMSCRIPTEN__
+
+llvm::orc::JITTargetMachineBuilder CreateOrcTargetMachineBuilder(
+	const llvm::Triple& target_triple,
+	const llvm::StringRef cpu_name,
+	const std::string& features_str,
+	const llvm::OptimizationLevel optimization_level )
+{
+	llvm::orc::JITTargetMachineBuilder target_machine_builder( target_triple );
+	target_machine_builder.setCPU( cpu_name.str() );
+	target_machine_builder.getFeatures()= llvm::SubtargetFeatures( features_str );
+	target_machine_builder.setCodeGenOptLevel( GetCodeGenOptLevel( optimization_level ) );
+	return target_machine_builder;
+}
+
+// Either module or precompiled object should be provided.
+int RunWithOrcLazyJIT(
+	std::unique_ptr<llvm::LLVMContext> llvm_context,
+	std::unique_ptr<llvm::Module> module,
+	std::unique_ptr<llvm::MemoryBuffer> object,
+	const llvm::orc::JITTargetMachineBuilder& target_machine_builder,
+	const llvm::OptimizationLevel optimization_level,
+	const uint32_t num_compile_threads,
+	const std::string& entry_point_name,
+	const char* const program_name )
+{
+	// Functions are compiled on demand (when called first time) in separate compilation threads.
+	// Each lazily-compiled partition is cloned into its own context in such mode, so that partitions may be optimized and compiled in parallel.
+	auto jit_created=
+		llvm::orc::LLLazyJITBuilder()
+			.setJITTargetMachineBuilder( target_machine_builder )
+			.setNumCompileThreads( num_compile_threads )
+			.setLazyCompileFailureAddr( llvm::orc::ExecutorAddr::fromPtr( &JitFuncs::LazyCompileFailure ) )
+			.create();
+	if( !jit_created )
+	{
+		std::cerr << "Can't create JIT: " << llvm::toString( jit_created.takeError() ) << std::endl;
+		return 1;
+	}
+	const std::unique_ptr<llvm::orc::LLLazyJIT> jit= std::move(*jit_created);
+
+	// Compile only requested function, not the whole module.
+	jit->setPartitionFunction( llvm::orc::CompileOnDemandLayer::compileRequested );
+
+	if( optimization_level != llvm::OptimizationLevel::O0 )
+	{
+		// Optimize each partition just before its compilation.
+		// Create target machine for each partition, since this may be done in parallel.
+		jit->getIRTransformLayer().setTransform(
+			[target_machine_builder, optimization_level]( llvm::orc::ThreadSafeModule thread_safe_module, const llvm::orc::MaterializationResponsibility& )
+				-> llvm::Expected<llvm::orc::ThreadSafeModule>
+			{
+				auto partition_target_machine_builder= target_machine_builder;
+				auto target_machine= partition_target_machine_builder.createTargetMachine();
+				if( !target_machine )
+					return target_machine.takeError();
+
+				thread_safe_module.withModuleDo(
+					[&]( llvm::Module& m )
+					{
+						OptimizeModule( m, target_machine->get(), optimization_level, true );
+					} );
+
+				return std::move(thread_safe_module);
+			} );
+	}
+
+	llvm::orc::JITDylib& main_dylib= jit->getMainJITDylib();
+
+	// Allow to use functions of the host process (heap allocation functions, etc).
+	{
+		auto generator= llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess( jit->getDataLayout().getGlobalPrefix() );
+		if( !generator )
+		{
+			std::cerr << "Can't create symbols generator: " << llvm::toString( generator.takeError() ) << std::endl;
+			return 1;
+		}
+		main_dylib.addGenerator( std::move(*generator) );
+	}
+
+	{
+		const auto callable_flags= llvm::JITSymbolFlags::Exported | llvm::JITSymbolFlags::Callable;
+
+		llvm::orc::SymbolMap symbols;
+		symbols[ jit->mangleAndIntern( "abort" ) ]= { llvm::orc::ExecutorAddr::fromPtr( &std::abort ), callable_flags };
+		symbols[ jit->mangleAndIntern( "memcpy" ) ]= { llvm::orc::ExecutorAddr::fromPtr( &std::memcpy ), callable_flags };
+		symbols[ jit->mangleAndIntern( "memcmp" ) ]= { llvm::orc::ExecutorAddr::fromPtr( &std::memcmp ), callable_flags };
+		symbols[ jit->mangleAndIntern( "_ZN3ust12stdout_printENS_19random_access_rangeIcLb0EEE" ) ]=
+			{ llvm::orc::ExecutorAddr::fromPtr( &JitFuncs::StdOutPrint ), callable_flags };
+		symbols[ jit->mangleAndIntern( "_ZN3ust12stderr_printENS_19random_access_rangeIcLb0EEE" ) ]=
+			{ llvm::orc::ExecutorAddr::fromPtr( &JitFuncs::StdErrPrint ), callable_flags };
+
+		if( auto err= main_dylib.define( llvm::orc::absoluteSymbols( std::move(symbols) ) ) )
+		{
+			std::cerr << "Can't define JIT symbols: " << llvm::toString( std::move(err) ) << std::endl;
+			return 1;
+		}
+	}
+
+	if( object != nullptr )
+	{
+		if( auto err= jit->addObjectFile( std::move(object) ) )
+		{
+			std::cerr << "Can't add object into JIT: " << llvm::toString( std::move(err) ) << std::endl;
+			return 1;
+		}
+	}
+	else if( auto err= jit->addLazyIRModule( llvm::orc::ThreadSafeModule( std::move(module), std::move(llvm_context) ) ) )
+	{
+		std::cerr << "Can't add module into JIT: " << llvm::toString( std::move(err) ) << std::endl;
+		return 1;
+	}
+
+	auto main_function_address= jit->lookup( entry_point_name );
+	if( !main_function_address )
+	{
+		std::cerr << "Can't find entry point: " << llvm::toString( main_function_address.takeError() ) << std::endl;
+		return 1;
+	}
+
+	using MainFunctionType= int(*)( int argc, const char** argv );
+	const auto main_function= main_function_address->toPtr<MainFunctionType>();
+
+	// It's safe to pass argc + argv even into a function with no args, since C calling convention allows this.
+	// For now just pass empty command line (containing only executable name).
+	const int custom_argc= 1;
+	const char* custom_argv[]= { program_name, nullptr };
+	return main_function( custom_argc, custom_argv );
+}
+
+#endif // __EMSCRIPTEN__
+
 int Main( int argc, const char* argv[] )
 {
 	// HACK! Reset globals state from previous run (needed for emscripten).
@@ -272,7 +593,44 @@ int Main( int argc, const char* argv[] )
 
 	cl::opt<bool> use_jit(
 		"use-jit",
-		cl::desc("Use JIT."),
+		cl::desc("Use JIT. Same as --jit=mcjit."),
+		cl::init(false),
+		cl::cat(options_category) );
+
+	cl::opt<JitKind> jit_kind(
+		"jit",
+		cl::desc("Execution mode."),
+		cl::init(JitKind::None),
+		cl::values(
+			clEnumValN( JitKind::None, "none", "Use interpreter (default)." ),
+			clEnumValN( JitKind::MCJIT, "mcjit", "Compile the whole program before execution." ),
+			clEnumValN( JitKind::OrcLazy, "orc-lazy", "Compile each function lazily, just before its first call." ) ),
+		cl::cat(options_category) );
+
+	cl::opt<char> optimization_level_char(
+		"O",
+		cl::desc("Optimization level for JIT. [-O0, -O1, -O2, -O3, -Os or -Oz] (default = '-O0')"),
+		cl::Prefix,
+		cl::Optional,
+		cl::init('0'),
+		cl::cat(options_category) );
+
+	cl::opt<uint32_t> jit_threads(
+		"jit-threads",
+		cl::desc("Number of background compilation threads for lazy JIT. 0 means automatic selection."),
+		cl::init(0),
+		cl::cat(options_category) );
+
+	cl::opt<std::string> jit_cache_dir(
+		"jit-cache-dir",
+		cl::desc("Directory for caching of compiled programs between interpreter runs. Works only with JIT."),
+		cl::value_desc("dir"),
+		cl::init(""),
+		cl::cat(options_category) );
+
+	cl::opt<bool> jit_cache_prewarm(
+		"jit-cache-prewarm",
+		cl::desc("Only compile the program and store it into the JIT cache, do not execute it."),
 		cl::init(false),
 		cl::cat(options_category) );
 
@@ -289,12 +647,60 @@ int Main( int argc, const char* argv[] )
 		"Compiles provided files and emmideately executes result.\n";
 	llvm::cl::ParseCommandLineOptions( argc, argv, description );
 
+	if( use_jit && jit_kind == JitKind::None )
+		jit_kind= JitKind::MCJIT;
+
+#ifdef __EMSCRIPTEN__
+	if( jit_kind == JitKind::OrcLazy )
+	{
+		std::cerr << "Lazy JIT is not supported in this build." << std::endl;
+		return 1;
+	}
+#endif
+
+	llvm::OptimizationLevel optimization_level= llvm::OptimizationLevel::O0;
+		 if( optimization_level_char == '0' )
+		optimization_level= llvm::OptimizationLevel::O0;
+	else if( optimization_level_char == '1' )
+		optimization_level= llvm::OptimizationLevel::O1;
+	else if( optimization_level_char == '2' )
+		optimization_level= llvm::OptimizationLevel::O2;
+	else if( optimization_level_char == '3' )
+		optimization_level= llvm::OptimizationLevel::O3;
+	else if( optimization_level_char == 's' )
+		optimization_level= llvm::OptimizationLevel::Os;
+	else if( optimization_level_char == 'z' )
+		optimization_level= llvm::OptimizationLevel::Oz;
+	else
+	{
+		std::cerr << "Unknown optimization: " << optimization_level_char << std::endl;
+		return 1;
+	}
+
+	if( optimization_level != llvm::OptimizationLevel::O0 && jit_kind == JitKind::None )
+	{
+		// Optimized code may contain constructions (vector instructions, etc.) not supported by the interpreter.
+		std::cerr << "Optimization is supported only with JIT." << std::endl;
+		return 1;
+	}
+
+	if( !jit_cache_dir.empty() && jit_kind == JitKind::None )
+	{
+		std::cerr << "JIT cache is supported only with JIT." << std::endl;
+		return 1;
+	}
+	if( jit_cache_prewarm && jit_cache_dir.empty() )
+	{
+		std::cerr << "No JIT cache directory specified for prewarming." << std::endl;
+		return 1;
+	}
+
 	llvm::Triple target_triple( llvm::sys::getProcessTriple() );
 	const llvm::StringRef cpu_name= llvm::sys::getHostCPUName();
 	const std::string features_str= GetNativeTargetFeaturesStr();
 	std::unique_ptr<llvm::TargetMachine> target_machine;
 	llvm::DataLayout data_layout("");
-	if( use_jit )
+	if( jit_kind != JitKind::None )
 	{
 		// Initialize native target and create target machine only if using JIT.
 
@@ -323,7 +729,7 @@ int Main( int argc, const char* argv[] )
 				target_options,
 				std::optional<llvm::Reloc::Model>(),
 				std::optional<llvm::CodeModel::Model>(),
-				llvm::CodeGenOpt::None,
+				GetCodeGenOptLevel( optimization_level ),
 				true /* JIT */ ) );
 
 		if( target_machine == nullptr )
@@ -351,88 +757,82 @@ int Main( int argc, const char* argv[] )
 			false,
 			0 );
 
-	llvm::LLVMContext llvm_context;
-	std::unique_ptr<llvm::Module> result_module;
+	// Allocate context on heap, since lazy JIT takes ownership over it.
+	auto llvm_context= std::make_unique<llvm::LLVMContext>();
 
-	const auto errors_format= ErrorsFormat::GCC;
+	// Names of stdcall functions imported from system libraries can't be resolved for precompiled objects on 32-bit Windows (see below).
+	std::optional<JitObjectCache> jit_object_cache;
+	if( !jit_cache_dir.empty() && !( target_triple.getOS() == llvm::Triple::Win32 && target_triple.getArch() == llvm::Triple::x86 ) )
+		jit_object_cache.emplace( jit_cache_dir );
 
-	bool have_some_errors= false;
-	for( const std::string& input_file : input_files )
+	std::string jit_object_cache_key;
+	std::unique_ptr<llvm::MemoryBuffer> precompiled_object;
+	if( jit_object_cache != std::nullopt )
 	{
-		SourceGraph source_graph= LoadSourceGraph( *vfs, CalculateLongStableHash, input_file, prelude_code );
-
-		std::vector<IVfs::Path> dependent_files;
-		dependent_files.reserve( source_graph.nodes_storage.size() );
-		for( const SourceGraph::Node& node : source_graph.nodes_storage )
-			dependent_files.push_back( node.file_path );
-
-		PrintLexSyntErrors( dependent_files, source_graph.errors, errors_format );
-		if( !source_graph.errors.empty() )
+		// Include in the key everything (except source files contents) affecting result object.
+		// Source files contents are checked separately, using list of files stored in cache entry.
+		std::string key_data;
+		for( const llvm::StringRef key_part : {
+				llvm::StringRef( getFullVersion() ),
+				llvm::StringRef( LLVM_VERSION_STRING ),
+				llvm::StringRef( target_triple.str() ),
+				cpu_name,
+				llvm::StringRef( features_str ),
+				llvm::StringRef( prelude_code ) } )
 		{
-			have_some_errors= true;
-			continue;
+			key_data+= key_part;
+			key_data.push_back( '\0' );
 		}
-
-		CodeBuilderOptions options;
-		options.report_about_unused_names= false; // Do not require generating extra errors in interpreter.
-		options.mangling_scheme= ManglingScheme::ItaniumABI; // For simplicity use it even on Windows.
-
-		CodeBuilder::BuildResult build_result=
-			CodeBuilder::BuildProgram(
-				llvm_context,
-				data_layout,
-				target_triple,
-				options,
-				std::make_shared<SourceGraph>( std::move(source_graph) ),
-				vfs );
-
-		PrintErrors( dependent_files, build_result.errors, errors_format );
-
-		if( !build_result.errors.empty() || build_result.module == nullptr )
+		key_data.push_back( optimization_level_char );
+		key_data.push_back( char( jit_kind.getValue() ) );
+		key_data.push_back( '\0' );
+		for( const std::string& dir : include_dir )
 		{
-			have_some_errors= true;
-			continue;
+			key_data+= dir;
+			key_data.push_back( '\0' );
 		}
-
-		if( result_module == nullptr )
-			result_module= std::move( build_result.module );
-		else
+		key_data.push_back( '\0' );
+		for( const std::string& input_file : input_files )
 		{
-			const bool not_ok= llvm::Linker::linkModules( *result_module, std::move(build_result.module) );
-			if( not_ok )
-			{
-				std::cerr << "Error, linking file \"" << input_file << "\"" << std::endl;
-				have_some_errors= true;
-			}
+			key_data+= vfs->GetFullFilePath( input_file, "" );
+			key_data.push_back( '\0' );
 		}
-	}
 
-	if( have_some_errors )
-		return 1;
-
-	if( !LinkCompilerBuiltinModules(
-			*result_module,
-			HaltMode::Abort,
-			false // Enable system allocations
-				) )
-		return 1;
-
-	// TODO - run here optimizations?
-
-	const auto main_function_llvm= result_module->getFunction( entry_point_name );
-	if( main_function_llvm == nullptr )
-	{
-		std::cerr << "Can't find entry point!" << std::endl;
-		return 1;
+		jit_object_cache_key= CalculateLongStableHash( key_data );
+		precompiled_object= jit_object_cache->LoadObject( *vfs, jit_object_cache_key );
+		if( precompiled_object != nullptr && jit_cache_prewarm )
+			return 0;
 	}
 
-	if( use_jit )
+	std::unique_ptr<llvm::Module> result_module;
+	llvm::Function* main_function_llvm= nullptr;
+	if( precompiled_object == nullptr )
 	{
-		llvm::Mangler mangler;
+		std::vector<IVfs::Path> dependency_files;
+		result_module=
+			BuildProgramModule(
+				*llvm_context,
+				vfs,
+				input_files,
+				prelude_code,
+				data_layout,
+				target_triple,
+				optimization_level.getSpeedupLevel() > 0,
+				dependency_files );
+		if( result_module == nullptr )
+			return 1;
+
+		main_function_llvm= result_module->getFunction( entry_point_name );
+		if( main_function_llvm == nullptr )
+		{
+			std::cerr << "Can't find entry point!" << std::endl;
+			return 1;
+		}
 
-		if( target_triple.getOS() == llvm::Triple::Win32 )
+		if( jit_kind != JitKind::None && target_triple.getOS() == llvm::Triple::Win32 )
 		{
 			// A workaround of a bug in LLVM code - it can't load symbol names for x86_stdcall functions, since they are decorated like "_GetProcessHeap@0".
+			llvm::Mangler mangler;
 			llvm::sys::DynamicLibrary::LoadLibraryPermanently( "kernel32.dll", nullptr );
 			for( const llvm::Function& function : result_module->functions() )
 			{
@@ -448,8 +848,91 @@ int Main( int argc, const char* argv[] )
 			}
 		}
 
-		llvm::Function* const stdout_function= result_module->getFunction( "_ZN3ust12stdout_printENS_19random_access_rangeIcLb0EEE" );
-		llvm::Function* const stderr_function= result_module->getFunction( "_ZN3ust12stderr_printENS_19random_access_rangeIcLb0EEE" );
+		if( jit_object_cache != std::nullopt )
+		{
+			// Compile the whole program (even for lazy JIT), in order to store it into the cache.
+			// Use the same target machine settings as the JIT uses.
+			std::unique_ptr<llvm::TargetMachine> object_target_machine;
+#ifndef __EMSCRIPTEN__
+			if( jit_kind == JitKind::OrcLazy )
+			{
+				auto created_target_machine=
+					CreateOrcTargetMachineBuilder( target_triple, cpu_name, features_str, optimization_level ).createTargetMachine();
+				if( !created_target_machine )
+				{
+					std::cerr << "Error, creating target machine: " << llvm::toString( created_target_machine.takeError() ) << std::endl;
+					return 1;
+				}
+				object_target_machine= std::move(*created_target_machine);
+			}
+#endif
+			llvm::TargetMachine& target_machine_for_object= object_target_machine != nullptr ? *object_target_machine : *target_machine;
+
+			OptimizeModule( *result_module, &target_machine_for_object, optimization_level, false );
+
+			precompiled_object= CompileModuleToObject( *result_module, target_machine_for_object );
+			if( precompiled_object == nullptr )
+			{
+				std::cerr << "Error, compiling object file." << std::endl;
+				return 1;
+			}
+
+			std::vector<JitObjectCache::DependencyFile> dependency_files_hashed;
+			dependency_files_hashed.reserve( dependency_files.size() );
+			for( IVfs::Path& file_path : dependency_files )
+			{
+				const IVfs::FileContentBufferPtr content= vfs->LoadFileContentBuffer( file_path );
+				if( content == nullptr )
+					continue; // Embedding of a non-existing file is an error, so, such file can't be a dependency.
+
+				JitObjectCache::DependencyFile dependency_file;
+				dependency_file.content_hash= JitObjectCache::CalculateFileContentHash( content->GetContent() );
+				dependency_file.file_path= std::move(file_path);
+				dependency_files_hashed.push_back( std::move(dependency_file) );
+			}
+
+			if( !jit_object_cache->StoreObject( jit_object_cache_key, dependency_files_hashed, precompiled_object->getBuffer() ) )
+				std::cerr << "Warning, can't store an entry into the JIT cache in \"" << jit_cache_dir << "\"." << std::endl;
+
+			if( jit_cache_prewarm )
+				return 0;
+
+			// Run the program from the compiled object, in order to have the same behavior as for the next runs.
+			result_module= nullptr;
+		}
+	}
+
+#ifndef __EMSCRIPTEN__
+	if( jit_kind == JitKind::OrcLazy )
+	{
+		// Optimizations are performed lazily for each compiled function.
+		return
+			RunWithOrcLazyJIT(
+				std::move(llvm_context),
+				std::move(result_module),
+				std::move(precompiled_object),
+				CreateOrcTargetMachineBuilder( target_triple, cpu_name, features_str, optimization_level ),
+				optimization_level,
+				jit_threads == 0 ? llvm::hardware_concurrency().compute_thread_count() : jit_threads,
+				entry_point_name,
+				argv[0] );
+	}
+#endif
+
+	if( jit_kind == JitKind::MCJIT )
+	{
+		if( result_module != nullptr )
+		{
+			// The whole module is compiled before execution, so, it's possible to run whole module optimizations.
+			OptimizeModule( *result_module, target_machine.get(), optimization_level, false );
+		}
+		else
+		{
+			// Execution engine requires a module, so, create an empty one and add precompiled object.
+			result_module= std::make_unique<llvm::Module>( "jit_cache_stub", *llvm_context );
+			result_module->setDataLayout( data_layout );
+			result_module->setTargetTriple( target_triple.str() );
+		}
 
 		llvm::EngineBuilder builder(std::move(result_module));
 		std::string engine_creation_error_string;
@@ -464,32 +947,36 @@ int Main( int argc, const char* argv[] )
 			return 1;
 		}
 
+		if( precompiled_object != nullptr )
 		{
-			llvm::SmallString<128> name_mangled;
-			mangler.getNameWithPrefix( name_mangled, "abort", data_layout );
-			engine->addGlobalMapping( name_mangled, reinterpret_cast<uint64_t>( reinterpret_cast<void*>( &std::abort ) ) );
-		}
-		{
-			llvm::SmallString<128> name_mangled;
-			mangler.getNameWithPrefix( name_mangled, "memcpy", data_layout );
-			engine->addGlobalMapping( name_mangled, reinterpret_cast<uint64_t>( reinterpret_cast<void*>( &std::memcpy ) ) );
-		}
-		{
-			llvm::SmallString<128> name_mangled;
-			mangler.getNameWithPrefix( name_mangled, "memcmp", data_layout );
-			engine->addGlobalMapping( name_mangled, reinterpret_cast<uint64_t>( reinterpret_cast<void*>( &std::memcmp ) ) );
+			auto object_file= llvm::object::ObjectFile::createObjectFile( precompiled_object->getMemBufferRef() );
+			if( !object_file )
+			{
+				std::cerr << "Can't load object: " << llvm::toString( object_file.takeError() ) << std::endl;
+				return 1;
+			}
+			engine->addObjectFile( llvm::object::OwningBinary<llvm::object::ObjectFile>( std::move(*object_file), std::move(precompiled_object) ) );
 		}
 
-		if( stdout_function != nullptr )
-			engine->addGlobalMapping( stdout_function, reinterpret_cast<void*>( &JitFuncs::StdOutPrint ) );
-
-		if( stderr_function != nullptr )
-			engine->addGlobalMapping( stderr_function, reinterpret_cast<void*>( &JitFuncs::StdErrPrint ) );
+		const auto add_global_mapping=
+			[&]( const llvm::StringRef name, void* const address )
+			{
+				llvm::Mangler mangler;
+				llvm::SmallString<128> name_mangled;
+				mangler.getNameWithPrefix( name_mangled, name, data_layout );
+				engine->addGlobalMapping( name_mangled, reinterpret_cast<uint64_t>( address ) );
+			};
+
+		add_global_mapping( "abort", reinterpret_cast<void*>( &std::abort ) );
+		add_global_mapping( "memcpy", reinterpret_cast<void*>( &std::memcpy ) );
+		add_global_mapping( "memcmp", reinterpret_cast<void*>( &std::memcmp ) );
+		add_global_mapping( "_ZN3ust12stdout_printENS_19random_access_rangeIcLb0EEE", reinterpret_cast<void*>( &JitFuncs::StdOutPrint ) );
+		add_global_mapping( "_ZN3ust12stderr_printENS_19random_access_rangeIcLb0EEE", reinterpret_cast<void*>( &JitFuncs::StdErrPrint ) );
 
 		engine->finalizeObject();
 
 		using MainFunctionType= int(*)( int argc, const char** argv );
-		const auto main_function= reinterpret_cast<MainFunctionType>( engine->getPointerToFunction( main_function_llvm ) );
+		const auto main_function= reinterpret_cast<MainFunctionType>( engine->getFunctionAddress( entry_point_name ) );
 		if( main_function == nullptr )
 		{
 			std::cerr << "Can't find entry point!" << std::endl;
@@ -136,7 +136,7 @@ Synt::MacrosByContextMap TakeMacrosFromImports( const SourceGraph& source_graph
 
 	for( const size_t child_node_index : source_graph.nodes_storage.front().child_nodes_indices )
 	{
-		for( const auto& context_macro_map_pair : *source_graph.nodes_storage[child_node_index].ast.macros )
+		for( const auto& context_macro_map_pair : *source_graph.nodes_storage[child_node_index].ast->macros )
 		{
 			Synt::MacroMap& dst_map= merged_macroses[context_macro_map_pair.first];
 			for( const auto& macro_map_pair : context_macro_map_pair.second )
@@ -147,6 +147,145 @@ Synt::MacrosByContextMap TakeMacrosFromImports( const SourceGraph& source_graph
 	return merged_macroses;
 }
 
+// If too much functions were changed since last valid state, perform full rebuild in order to update this state.
+constexpr size_t c_max_changed_functions_to_check= 16;
+
+// Each check of changed functions creates new lambdas and template instantiations in code builder of last valid state.
+// Perform full rebuild after some number of checks in order to limit growth of this code builder.
+constexpr size_t c_max_changed_functions_checks= 32;
+
+bool IsInsideFunction( const SrcLoc& src_loc, const Synt::Function& function )
+{
+	U_ASSERT( function.block != nullptr );
+	const SrcLoc& begin= function.src_loc;
+	const SrcLoc& end= function.block->end_src_loc;
+
+	const auto line= src_loc.GetLine();
+	const auto column= src_loc.GetColumn();
+	return
+		( line > begin.GetLine() || ( line == begin.GetLine() && column >= begin.GetColumn() ) ) &&
+		( line < end.GetLine() || ( line == end.GetLine() && column <= end.GetColumn() ) );
+}
+
+using SrcLocMappingFunction= llvm::function_ref< std::optional<SrcLoc>( const SrcLoc& ) >;
+
+// Returns false if error can't be mapped.
+bool MapErrorPosition_r( CodeBuilderError& error, const SrcLocMappingFunction mapping_function )
+{
+	const std::optional<SrcLoc> src_loc_mapped= mapping_function( error.src_loc );
+	if( src_loc_mapped == std::nullopt )
+		return false;
+	error.src_loc= *src_loc_mapped;
+
+	if( error.template_context != nullptr )
+	{
+		// Make a copy of errors context, since it may be shared.
+		auto template_context= std::make_shared<TemplateErrorsContext>( *error.template_context );
+
+		CodeBuilderErrorsContainer errors_mapped;
+		errors_mapped.reserve( template_context->errors.size() );
+		for( CodeBuilderError& context_error : template_context->errors )
+		{
+			if( MapErrorPosition_r( context_error, mapping_function ) )
+				errors_mapped.push_back( std::move(context_error) );
+		}
+		template_context->errors= std::move(errors_mapped);
+
+		error.template_context= std::move(template_context);
+	}
+
+	return true;
+}
+
+// VFS wrapper, which returns given text for the document itself and uses base VFS for other files.
+// Thread-safe if base VFS is thread-safe.
+class DocumentTextVfs final : public IVfs
+{
+public:
+	DocumentTextVfs( IVfsSharedPtr base, IVfs::Path document_path, IVfs::FileContent document_text )
+		: base_(std::move(base)), document_path_(std::move(document_path)), document_text_(std::move(document_text))
+	{}
+
+public:
+	std::optional<FileContent> LoadFileContent( const Path& full_file_path ) override
+	{
+		if( full_file_path == document_path_ )
+			return document_text_;
+		return base_->LoadFileContent( full_file_path );
+	}
+
+	Path GetFullFilePath( const Path& file_path, const Path& full_parent_file_path ) override
+	{
+		return base_->GetFullFilePath( file_path, full_parent_file_path );
+	}
+
+	std::vector<PathCompletionItem> CompletePath( const Path& file_path_prefix, const Path& full_parent_file_path ) override
+	{
+		return base_->CompletePath( file_path_prefix, full_parent_file_path );
+	}
+
+	bool IsImportingFileAllowed( const Path& full_file_path ) override
+	{
+		return base_->IsImportingFileAllowed( full_file_path );
+	}
+
+	bool IsFileFromSourcesDirectory( const Path& full_file_path ) override
+	{
+		return base_->IsFileFromSourcesDirectory( full_file_path );
+	}
+
+private:
+	const IVfsSharedPtr base_;
+	const IVfs::Path document_path_;
+	const IVfs::FileContent document_text_;
+};
+
+struct CodeBuilderState
+{
+	std::unique_ptr<llvm::LLVMContext> llvm_context;
+	std::unique_ptr<CodeBuilder> code_builder;
+};
+
+CodeBuilderState BuildCodeBuilderState(
+	const CodeBuilder::SourceGraphPtr& source_graph,
+	const DocumentBuildOptions& build_options,
+	IVfsSharedPtr code_builder_vfs )
+{
+	CodeBuilderState result;
+
+	// Create separate LLVM context for each compiled state.
+	// It can't be shared between documents, since LLVM context isn't thread-safe
+	// and compiled states are used in the main thread (for completion, for example) while other documents are built in background.
+	result.llvm_context= std::make_unique<llvm::LLVMContext>();
+
+	// Disable almost all code builder options.
+	// We do not need to generate code here - only assist developer (retrieve errors, etc.).
+	CodeBuilderOptions options;
+	options.build_debug_info= false;
+	options.create_lifetimes= false;
+	options.generate_lifetime_start_end_debug_calls= false;
+	options.generate_tbaa_metadata= false;
+	options.report_about_unused_names= false;
+
+	// Specific options for the Language Server.
+	options.collect_definition_points= true;
+	options.skip_building_generated_functions= true;
+
+	result.code_builder=
+		CodeBuilder::BuildProgramAndLeaveInternalState(
+			*result.llvm_context,
+			build_options.data_layout,
+			build_options.target_triple,
+			options,
+			source_graph,
+			std::move(code_builder_vfs) );
+
+	// Reduce a bit memory footprint.
+	result.code_builder->DeleteFunctionsBodies();
+
+	return result;
+}
+
 } // namespace
 
 Document::Document(
@@ -154,11 +293,13 @@ Document::Document(
 	DocumentBuildOptions build_options,
 	IVfsSharedPtr vfs,
 	IVfsSharedPtr code_builder_vfs, // Must be thread-safe. Used for embedding files.
+	SyntaxAnalysisResultsInternerPtr syntax_analysis_results_interner,
 	Logger& log )
 	: path_(std::move(path))
 	, build_options_(std::move(build_options))
 	, vfs_(std::move(vfs))
 	, code_builder_vfs_(std::move(code_builder_vfs))
+	, syntax_analysis_results_interner_(std::move(syntax_analysis_results_interner))
 	, log_(log)
 {
 	SetText("");
@@ -169,9 +310,14 @@ void Document::SetText( std::string text )
 	text_= std::move(text);
 	text_changes_since_compiled_state_= std::nullopt; // Can't perform changes tracking when text is completely changed.
 	BuildLineToLinearPositionIndex( text_, line_to_linear_position_index_ );
+	lexems_= std::nullopt;
+	saved_text_= std::nullopt;
+	text_changes_since_saved_.clear();
 
 	modification_time_= DocumentClock::now();
+	last_usage_time_= modification_time_;
 	rebuild_required_= true;
+	CancelRunningRebuild();
 }
 
 void Document::UpdateText( const DocumentRange& range, const std::string_view new_text )
@@ -192,7 +338,19 @@ void Document::UpdateText( const DocumentRange& range, const std::string_view ne
 	}
 
 	text_.replace( size_t(*linear_position_start), size_t(*linear_position_end - *linear_position_start), new_text );
-	BuildLineToLinearPositionIndex( text_, line_to_linear_position_index_ );
+
+	// Avoid rescanning of the whole text - update only damaged region.
+	UpdateLineToLinearPositionIndex(
+		text_,
+		*linear_position_start,
+		*linear_position_end,
+		uint32_t(new_text.size()),
+		line_to_linear_position_index_ );
+
+	if( lexems_ != std::nullopt &&
+		( ContainsNonASCIINewlines( new_text ) ||
+			!UpdateLexems( text_, line_to_linear_position_index_, *linear_position_start, uint32_t(new_text.size()), *lexems_ ) ) )
+		lexems_= std::nullopt; // Rebuild them later, if necessary.
 
 	// Save changes sequence.
 	if( compiled_state_ != nullptr && text_changes_since_compiled_state_ != std::nullopt )
@@ -203,9 +361,13 @@ void Document::UpdateText( const DocumentRange& range, const std::string_view ne
 		change.new_count= uint32_t(new_text.size());
 		text_changes_since_compiled_state_->push_back( std::move(change) );
 	}
+	if( saved_text_ != std::nullopt )
+		text_changes_since_saved_.push_back( TextChange{ *linear_position_start, *linear_position_end, uint32_t(new_text.size()) } );
 
 	modification_time_= DocumentClock::now();
+	last_usage_time_= modification_time_;
 	rebuild_required_= true;
+	CancelRunningRebuild();
 }
 
 const std::string& Document::GetCurrentText() const
@@ -215,14 +377,72 @@ const std::string& Document::GetCurrentText() const
 
 const std::string& Document::GetTextForCompilation()
 {
-	if( in_rebuild_call_ )
-		return text_; // Force return raw text if this method was called indirectly from the "Rebuild" method.
-
 	TryTakeBackgroundStateUpdate();
 
 	// By providing text for compiled state we ensure dependent documents will build properly.
 	// Also this allows to perform proper mapping of "SrcLoc" to current state of the text.
-	return compiled_state_ == nullptr ? text_ : compiled_state_->text;
+	return compiled_state_ == nullptr ? text_ : *compiled_state_->text;
+}
+
+std::shared_ptr<const std::string> Document::GetTextForCompilationSnapshot()
+{
+	TryTakeBackgroundStateUpdate();
+
+	// Avoid copying text of compiled state - share it.
+	// Share only text itself, in order to not prolong lifetime of the whole compiled state.
+	if( compiled_state_ != nullptr )
+		return compiled_state_->text;
+	return std::make_shared<const std::string>( text_ );
+}
+
+void Document::SetTextIsSaved()
+{
+	saved_text_= text_;
+	saved_text_line_to_linear_position_index_= line_to_linear_position_index_;
+	text_changes_since_saved_.clear();
+}
+
+std::optional<DocumentPosition> Document::MapPositionToSavedText( const DocumentPosition& position ) const
+{
+	if( saved_text_ == std::nullopt )
+		return std::nullopt;
+	if( text_changes_since_saved_.empty() )
+		return position;
+
+	const std::optional<TextLinearPosition> linear_position= DocumentPositionToLinearPosition( position, text_, line_to_linear_position_index_ );
+	if( linear_position == std::nullopt )
+		return std::nullopt;
+
+	const std::optional<uint32_t> position_mapped= MapNewPositionToOldPosition( text_changes_since_saved_, *linear_position );
+	if( position_mapped == std::nullopt )
+		return std::nullopt;
+
+	return LinearPositionToDocumentPosition( *position_mapped, *saved_text_, saved_text_line_to_linear_position_index_ );
+}
+
+std::optional<DocumentRange> Document::MapSavedTextRangeToCurrentText( const DocumentRange& range ) const
+{
+	if( saved_text_ == std::nullopt )
+		return std::nullopt;
+	if( text_changes_since_saved_.empty() )
+		return range;
+
+	const std::optional<TextLinearPosition> start= DocumentPositionToLinearPosition( range.start, *saved_text_, saved_text_line_to_linear_position_index_ );
+	const std::optional<TextLinearPosition> end= DocumentPositionToLinearPosition( range.end, *saved_text_, saved_text_line_to_linear_position_index_ );
+	if( start == std::nullopt || end == std::nullopt )
+		return std::nullopt;
+
+	const std::optional<uint32_t> start_mapped= MapOldPositionToNewPosition( text_changes_since_saved_, *start );
+	const std::optional<uint32_t> end_mapped= MapOldPositionToNewPosition( text_changes_since_saved_, *end );
+	if( start_mapped == std::nullopt || end_mapped == std::nullopt || *end_mapped < *start_mapped )
+		return std::nullopt;
+
+	const std::optional<DocumentPosition> start_position= LinearPositionToDocumentPosition( *start_mapped, text_, line_to_linear_position_index_ );
+	const std::optional<DocumentPosition> end_position= LinearPositionToDocumentPosition( *end_mapped, text_, line_to_linear_position_index_ );
+	if( start_position == std::nullopt || end_position == std::nullopt )
+		return std::nullopt;
+
+	return DocumentRange{ *start_position, *end_position };
 }
 
 DocumentClock::time_point Document::GetModificationTime() const
@@ -232,7 +452,7 @@ DocumentClock::time_point Document::GetModificationTime() const
 
 bool Document::RebuildRequired() const
 {
-	return rebuild_required_;
+	return rebuild_required_ || restore_required_;
 }
 
 void Document::OnPossibleDependentFileChanged( const IVfs::Path& file_path_normalized )
@@ -253,11 +473,50 @@ void Document::OnPossibleDependentFileChanged( const IVfs::Path& file_path_norma
 			// TODO - maybe avoid updating maodification time and thus trigger immediate rebuild?
 			modification_time_= DocumentClock::now();
 			rebuild_required_= true;
+			CancelRunningRebuild();
 			return;
 		}
 	}
 }
 
+DocumentClock::time_point Document::GetLastUsageTime() const
+{
+	return last_usage_time_;
+}
+
+bool Document::HasCompiledState()
+{
+	TryTakeBackgroundStateUpdate();
+	return compiled_state_ != nullptr;
+}
+
+bool Document::HasCodeBuilderState()
+{
+	TryTakeBackgroundStateUpdate();
+	return compiled_state_ != nullptr && compiled_state_->code_builder != nullptr;
+}
+
+void Document::ReleaseCodeBuilderState()
+{
+	TryTakeBackgroundStateUpdate();
+	if( compiled_state_ == nullptr || compiled_state_->code_builder == nullptr )
+		return;
+
+	// Preserve everything except code builder and its LLVM context, which take almost all memory.
+	// Text and source graph are still needed for positions mapping, symbols and loading of dependent documents.
+	compiled_state_=
+		std::make_shared<const CompiledState>(
+			CompiledState{
+				compiled_state_->num_text_changes_at_compilation_task_start,
+				compiled_state_->text,
+				compiled_state_->line_to_linear_position_index,
+				compiled_state_->source_graph,
+				nullptr,
+				nullptr,
+				compiled_state_->errors,
+				compiled_state_->root_declarations } );
+}
+
 bool Document::RebuildIsRunning() const
 {
 	return compilation_future_.valid();
@@ -275,10 +534,17 @@ void Document::ResetRebuildFinishedFlag()
 	rebuild_finished_= false;
 }
 
+void Document::CancelRunningRebuild()
+{
+	if( compilation_future_.valid() && rebuild_cancelled_ != nullptr )
+		rebuild_cancelled_->store( true );
+}
+
 void Document::WaitUntilRebuildFinished()
 {
 	if( compilation_future_.valid() )
 		compilation_future_.wait();
+	TryTakeBackgroundStateUpdate();
 }
 
 const DiagnosticsByDocument& Document::GetDiagnostics() const
@@ -306,7 +572,7 @@ std::optional<Uri> Document::GetFileForImportPoint( const DocumentPosition& posi
 	const TextLinearPosition line_offset= compiled_state_->line_to_linear_position_index[line];
 	U_ASSERT( *linear_position >= line_offset );
 
-	const std::string_view line_text= std::string_view( compiled_state_->text ).substr( line_offset );
+	const std::string_view line_text= std::string_view( *compiled_state_->text ).substr( line_offset );
 	const TextLinearPosition offset_in_line= *linear_position - line_offset;
 
 	static const char whitespaces[]= " \t"; // Since we process only single line, use only spaces and tabs.
@@ -343,14 +609,15 @@ std::optional<SrcLocInDocument> Document::GetDefinitionPoint( const DocumentPosi
 {
 	TryTakeBackgroundStateUpdate();
 
-	if( compiled_state_ == nullptr )
+	CodeBuilder* const code_builder= GetCodeBuilder();
+	if( code_builder == nullptr )
 		return std::nullopt;
 
 	const auto src_loc= GetIdentifierStartSrcLoc( position );
 	if( src_loc == std::nullopt )
 		return std::nullopt;
 
-	if( const auto result_src_loc= compiled_state_->code_builder->GetDefinition( *src_loc ) )
+	if( const auto result_src_loc= code_builder->GetDefinition( *src_loc ) )
 	{
 		SrcLocInDocument location;
 		location.src_loc= *result_src_loc;
@@ -371,14 +638,15 @@ std::vector<DocumentRange> Document::GetHighlightLocations( const DocumentPositi
 {
 	TryTakeBackgroundStateUpdate();
 
-	if( compiled_state_ == nullptr )
+	CodeBuilder* const code_builder= GetCodeBuilder();
+	if( code_builder == nullptr )
 		return {};
 
 	const auto src_loc= GetIdentifierStartSrcLoc( position );
 	if( src_loc == std::nullopt )
 		return {};
 
-	const std::vector<SrcLoc> occurrences= compiled_state_->code_builder->GetAllOccurrences( *src_loc );
+	const std::vector<SrcLoc> occurrences= code_builder->GetAllOccurrences( *src_loc );
 
 	std::vector<DocumentRange> result;
 	result.reserve( occurrences.size() );
@@ -402,14 +670,15 @@ std::vector<SrcLocInDocument> Document::GetAllOccurrences( const DocumentPositio
 {
 	TryTakeBackgroundStateUpdate();
 
-	if( compiled_state_ == nullptr )
+	CodeBuilder* const code_builder= GetCodeBuilder();
+	if( code_builder == nullptr )
 		return {};
 
 	const auto src_loc= GetIdentifierStartSrcLoc( position );
 	if( src_loc == std::nullopt )
 		return {};
 
-	const std::vector<SrcLoc> occurrences= compiled_state_->code_builder->GetAllOccurrences( *src_loc );
+	const std::vector<SrcLoc> occurrences= code_builder->GetAllOccurrences( *src_loc );
 
 	// TODO - improve this.
 	// We need to extract occurences in other opended documents and maybe search for other files.
@@ -443,21 +712,23 @@ Symbols Document::GetSymbols()
 		// Normal case - use last valid state of syntax tree in order to build symbols.
 		return
 			BuildSymbols(
-				compiled_state_->source_graph->nodes_storage.front().ast,
+				*compiled_state_->source_graph->nodes_storage.front().ast,
 				// Map src_loc in compiled state to range in current state of the document.
 				[this]( const SrcLoc& src_loc ) { return GetIdentifierRange(src_loc); } );
 	}
 
 	// Backup for cases when document is not compiled yet.
 	// Since first document build may be delayed we need to provide symbols just after document was opened.
-	const SourceGraph source_graph= LoadSourceGraph( *vfs_, CalculateLongStableHash, path_, build_options_.prelude );
+	DocumentTextVfs vfs( vfs_, path_, text_ );
+	const SourceGraph source_graph=
+		LoadSourceGraph( vfs, CalculateLongStableHash, path_, build_options_.prelude, nullptr, syntax_analysis_results_interner_.get() );
 
-	if( source_graph.nodes_storage.empty() )
+	if( source_graph.nodes_storage.empty() || source_graph.nodes_storage.front().ast == nullptr )
 		return {};
 
 	return
 		BuildSymbols(
-			source_graph.nodes_storage.front().ast,
+			*source_graph.nodes_storage.front().ast,
 			// Use current state of the document text to get ranges for src_loc.
 			[this]( const SrcLoc& src_loc ) { return GetIdentifierCurrentRange(src_loc); } );
 }
@@ -466,7 +737,8 @@ std::vector<CompletionItem> Document::Complete( const DocumentPosition& position
 {
 	TryTakeBackgroundStateUpdate();
 
-	if( compiled_state_ == nullptr || compiled_state_->source_graph->nodes_storage.empty() )
+	CodeBuilder* const code_builder= GetCodeBuilder();
+	if( code_builder == nullptr || compiled_state_->source_graph->nodes_storage.empty() )
 	{
 		log_() << "Can't complete - document is not compiled" << std::endl;
 		return {};
@@ -495,7 +767,7 @@ std::vector<CompletionItem> Document::Complete( const DocumentPosition& position
 	}
 	const TextLinearPosition column_utf8_minus_one= *column_utf8 - 1u;
 
-	Lexems lexems= LexicalAnalysis( text_ ).lexems;
+	Lexems lexems= GetCurrentTextLexems();
 
 	SrcLoc src_loc;
 	if( line_text[ column_utf8_minus_one ] == '.' )
@@ -579,7 +851,7 @@ std::vector<CompletionItem> Document::Complete( const DocumentPosition& position
 	// Also it is too slow to recompile program for each completion.
 	const std::vector<CodeBuilder::CompletionItem> completion_result=
 		std::visit(
-			[&]( const auto& el ) { return compiled_state_->code_builder->Complete( lookup_result->prefix, *el ); },
+			[&]( const auto& el ) { return code_builder->Complete( lookup_result->prefix, *el ); },
 			lookup_result->global_item );
 
 	std::vector<CompletionItem> result_transformed;
@@ -714,7 +986,8 @@ std::vector<CodeBuilder::SignatureHelpItem> Document::GetSignatureHelp( const Do
 {
 	TryTakeBackgroundStateUpdate();
 
-	if( compiled_state_ == nullptr || compiled_state_->source_graph->nodes_storage.empty() )
+	CodeBuilder* const code_builder= GetCodeBuilder();
+	if( code_builder == nullptr || compiled_state_->source_graph->nodes_storage.empty() )
 	{
 		log_() << "Can't get signature help - document is not compiled" << std::endl;
 		return {};
@@ -751,7 +1024,7 @@ std::vector<CodeBuilder::SignatureHelpItem> Document::GetSignatureHelp( const Do
 	}
 
 	const char symbol= line_text[ column_utf8_minus_one ];
-	Lexems lexems= LexicalAnalysis( text_ ).lexems;
+	Lexems lexems= GetCurrentTextLexems();
 	const SrcLoc src_loc( 0, line, *column );
 	SrcLoc src_loc_for_search= src_loc;
 	if( symbol == '(' )
@@ -829,7 +1102,7 @@ std::vector<CodeBuilder::SignatureHelpItem> Document::GetSignatureHelp( const Do
 	// Also it is too slow to recompile program for each signature help.
 	return
 		std::visit(
-			[&]( const auto& el ) { return compiled_state_->code_builder->GetSignatureHelp( lookup_result->prefix, *el ); },
+			[&]( const auto& el ) { return code_builder->GetSignatureHelp( lookup_result->prefix, *el ); },
 			lookup_result->global_item );
 }
 
@@ -843,7 +1116,7 @@ std::optional<DocumentRange> Document::GetIdentifierRange( const SrcLoc& src_loc
 		return std::nullopt;
 
 	const TextLinearPosition line_start= compiled_state_->line_to_linear_position_index[ line ];
-	const std::string_view line_text= std::string_view(compiled_state_->text).substr( line_start );
+	const std::string_view line_text= std::string_view(*compiled_state_->text).substr( line_start );
 
 	const auto utf8_column= Utf32PositionToUtf8Position( line_text, src_loc.GetColumn() );
 	if( utf8_column == std::nullopt )
@@ -906,52 +1179,21 @@ void Document::StartRebuild( llvm::ThreadPool& thread_pool )
 		return;
 	}
 
-	// Reset rebuild flag. Even if rebuild fails, there is no reason to try another rebuild, unless document (or its dependencies) changed.
-	rebuild_required_= false;
-
-	// Perform lexical and syntax analysis synchronous.
-	// It is not possible to do this in background thread, since "LoadSourceGraph" uses VFS, which usage is not thread-safe.
-	// And there is a little reason to try to change this, since this step is relatively fast (no more than 100 ms on reasonable large file with a lot of imports).
-
-	diagnostics_.clear();
-
-	U_ASSERT( !in_rebuild_call_ );
-	in_rebuild_call_= true;
-	SourceGraph source_graph= LoadSourceGraph( *vfs_, CalculateLongStableHash, path_, build_options_.prelude );
-	in_rebuild_call_= false;
-
-	if( !source_graph.errors.empty() )
-	{
-		PopulateDiagnostics( source_graph.errors, text_, line_to_linear_position_index_, diagnostics_[Uri::FromFilePath(path_)] );
-		rebuild_finished_= true;
-		return;
-	}
-
-	if( source_graph.nodes_storage.empty() )
+	if( restore_required_ )
 	{
-		rebuild_finished_= true;
-		return;
-	}
-
-	// Take syntax errors only from this document.
-	const LexSyntErrors& synt_errors= source_graph.nodes_storage.front().ast.error_messages;
-	if( !synt_errors.empty() )
-	{
-		PopulateDiagnostics( synt_errors, text_, line_to_linear_position_index_,  diagnostics_[Uri::FromFilePath(path_)] );
-		rebuild_finished_= true;
-		return;
-	}
-
-	// Do not compile code if imports are not correct.
-	for( const SourceGraph::Node& node : source_graph.nodes_storage )
-	{
-		if( !node.ast.error_messages.empty() )
+		restore_required_= false;
+		if( compiled_state_ != nullptr && compiled_state_->code_builder == nullptr )
 		{
-			rebuild_finished_= true;
+			StartReleasedStateRestoring( thread_pool );
 			return;
 		}
+		if( !rebuild_required_ )
+			return; // State was already updated by another rebuild.
 	}
 
+	// Reset rebuild flag. Even if rebuild fails, there is no reason to try another rebuild, unless document (or its dependencies) changed.
+	rebuild_required_= false;
+
 	// If this is first rebuild - initialize changes tracking, in order to track changes, made during assynchronous compilation.
 	if( compiled_state_ == nullptr && text_changes_since_compiled_state_ == std::nullopt )
 		text_changes_since_compiled_state_= TextChangesSequence();
@@ -961,57 +1203,114 @@ void Document::StartRebuild( llvm::ThreadPool& thread_pool )
 	const size_t num_text_changes_at_compilation_task_start=
 		text_changes_since_compiled_state_== std::nullopt ? 0 : text_changes_since_compiled_state_->size();
 
-	// Start background compilation task, since compilation itself is relatively slow (a couple of seconds for reasonable large file).
-	// It is safe to do this, since compilation itself uses no data dependencies.
+	rebuild_cancelled_= std::make_shared<std::atomic<bool>>( false );
+
+	// Perform whole rebuild (including lexical and syntax analysis) in background thread, since it may be slow.
 	// Doing so we allow to execute some methods (completiong, highlighting, etc.) during compilation - without blocking whole language server.
+	// It is safe to do this, since background task uses only copies of document data, immutable last compiled state and thread-safe VFS.
 
 	auto update_func=
 		[
 			num_text_changes_at_compilation_task_start,
+			path= path_,
 			text= text_,
-			code_builder_vfs= code_builder_vfs_, // The only thing which may be mutated in background thread. So, it should be thread-safe.
 			line_to_linear_position_index= line_to_linear_position_index_,
-			source_graph= std::make_shared<const SourceGraph>( std::move(source_graph) ),
-			build_options= build_options_ // Capture copy of build options in case this update func outlives this class instance.
+			// Use raw text of this document, not text of last compiled state, which is returned by VFS.
+			vfs= std::make_shared<DocumentTextVfs>( vfs_, path_, text_ ),
+			code_builder_vfs= code_builder_vfs_,
+			syntax_analysis_results_interner= syntax_analysis_results_interner_,
+			prev_compiled_state= compiled_state_,
+			text_changes_since_prev_compiled_state= text_changes_since_compiled_state_,
+			changed_functions_check_allowed= num_changed_functions_checks_ < c_max_changed_functions_checks,
+			build_options= build_options_, // Capture copy of build options in case this update func outlives this class instance.
+			cancelled= rebuild_cancelled_
 		]
 		() mutable // Mutable in order to move captured variables.
 		{
-			// TODO - maybe avoid recreating context or even share it across multiple documents?
-			auto llvm_context= std::make_unique<llvm::LLVMContext>();
-
-			// Disable almost all code builder options.
-			// We do not need to generate code here - only assist developer (retrieve errors, etc.).
-			CodeBuilderOptions options;
-			options.build_debug_info= false;
-			options.create_lifetimes= false;
-			options.generate_lifetime_start_end_debug_calls= false;
-			options.generate_tbaa_metadata= false;
-			options.report_about_unused_names= false;
-
-			// Specific options for the Language Server.
-			options.collect_definition_points= true;
-			options.skip_building_generated_functions= true;
-
-			auto code_builder=
-				CodeBuilder::BuildProgramAndLeaveInternalState(
-					*llvm_context,
-					build_options.data_layout,
-					build_options.target_triple,
-					options,
-					source_graph,
-					std::move(code_builder_vfs) );
-
-			// Reduce a bit memory footprint.
-			code_builder->DeleteFunctionsBodies();
-
-			return std::make_shared<const CompiledState>(
-				CompiledState{
-					num_text_changes_at_compilation_task_start,
-					std::move(text),
-					std::move(line_to_linear_position_index),
-					std::move(source_graph),
-					std::move(llvm_context),
-					std::move(code_builder) } );
+			auto result= std::make_shared<RebuildResult>();
+
+			// Document may be changed while this task was waiting in the thread pool queue or while loading sources.
+			// Skip such stale rebuild in order to start actual one sooner.
+			// Do not cancel code building itself - it's better to finish it, since continuous typing may otherwise prevent obtaining any compiled state.
+			const auto is_cancelled=
+				[&]() -> bool
+				{
+					if( !cancelled->load() )
+						return false;
+					result->cancelled= true;
+					return true;
+				};
+
+			if( is_cancelled() )
+				return std::shared_ptr<const RebuildResult>( std::move(result) );
+
+			SourceGraph source_graph=
+				LoadSourceGraph( *vfs, CalculateLongStableHash, path, build_options.prelude, nullptr, syntax_analysis_results_interner.get() );
+
+			if( !source_graph.errors.empty() )
+			{
+				PopulateDiagnostics( source_graph.errors, text, line_to_linear_position_index, result->diagnostics[Uri::FromFilePath(path)] );
+				return std::shared_ptr<const RebuildResult>( std::move(result) );
+			}
+
+			if( source_graph.nodes_storage.empty() )
+				return std::shared_ptr<const RebuildResult>( std::move(result) );
+
+			// Take syntax errors only from this document.
+			const LexSyntErrors& synt_errors= source_graph.nodes_storage.front().ast->error_messages;
+			if( !synt_errors.empty() )
+			{
+				PopulateDiagnostics( synt_errors, text, line_to_linear_position_index, result->diagnostics[Uri::FromFilePath(path)] );
+				return std::shared_ptr<const RebuildResult>( std::move(result) );
+			}
+
+			// Do not compile code if imports are not correct.
+			for( const SourceGraph::Node& node : source_graph.nodes_storage )
+			{
+				if( node.ast == nullptr || !node.ast->error_messages.empty() )
+					return std::shared_ptr<const RebuildResult>( std::move(result) );
+			}
+
+			auto source_graph_ptr= std::make_shared<const SourceGraph>( std::move(source_graph) );
+
+			if( is_cancelled() )
+				return std::shared_ptr<const RebuildResult>( std::move(result) );
+
+			// Avoid slow full rebuild if only some function bodies were changed.
+			if( changed_functions_check_allowed && prev_compiled_state != nullptr && text_changes_since_prev_compiled_state != std::nullopt )
+			{
+				// Changes made since this task start are not related to this rebuild.
+				text_changes_since_prev_compiled_state->resize( num_text_changes_at_compilation_task_start );
+
+				result->changed_functions_check=
+					TryPrepareChangedFunctionsCheck(
+						prev_compiled_state,
+						*text_changes_since_prev_compiled_state,
+						source_graph_ptr,
+						text,
+						line_to_linear_position_index );
+				if( result->changed_functions_check != std::nullopt )
+					return std::shared_ptr<const RebuildResult>( std::move(result) );
+			}
+
+			CodeBuilderState code_builder_state= BuildCodeBuilderState( source_graph_ptr, build_options, std::move(code_builder_vfs) );
+
+			CodeBuilderErrorsContainer errors= code_builder_state.code_builder->TakeErrors();
+			SourceGraphNodeDeclarations root_declarations= SerializeSourceGraphNodeDeclarations( *source_graph_ptr, 0 );
+
+			result->compiled_state=
+				std::make_shared<const CompiledState>(
+					CompiledState{
+						num_text_changes_at_compilation_task_start,
+						std::make_shared<const std::string>( std::move(text) ),
+						std::move(line_to_linear_position_index),
+						std::move(source_graph_ptr),
+						std::move(code_builder_state.llvm_context),
+						std::move(code_builder_state.code_builder),
+						std::move(errors),
+						std::move(root_declarations) } );
+
+			return std::shared_ptr<const RebuildResult>( std::move(result) );
 		};
 
 	compilation_future_=
@@ -1024,6 +1323,57 @@ void Document::StartRebuild( llvm::ThreadPool& thread_pool )
 			} );
 }
 
+void Document::StartReleasedStateRestoring( llvm::ThreadPool& thread_pool )
+{
+	U_ASSERT( compiled_state_ != nullptr && compiled_state_->code_builder == nullptr );
+
+	log_() << "Restore released compiled state of " << path_ << std::endl;
+
+	// Restore state for the source graph of the compiled state in order to keep mapping of positions in compiled text valid.
+	// Do not reset rebuild flag - if document was changed, regular rebuild will be performed after restoring.
+	// It may check only changed functions using restored code builder.
+
+	// Restoring doesn't depend on current text, so, it can't become stale and can't be cancelled.
+	rebuild_cancelled_= nullptr;
+
+	auto restore_func=
+		[
+			released_compiled_state= compiled_state_,
+			code_builder_vfs= code_builder_vfs_,
+			build_options= build_options_ // Capture copy of build options in case this restore func outlives this class instance.
+		]
+		() mutable // Mutable in order to move captured variables.
+		{
+			auto result= std::make_shared<RebuildResult>();
+
+			CodeBuilderState code_builder_state=
+				BuildCodeBuilderState( released_compiled_state->source_graph, build_options, std::move(code_builder_vfs) );
+			code_builder_state.code_builder->TakeErrors(); // Errors of compiled state are already known.
+
+			result->restored_compiled_state=
+				std::make_shared<const CompiledState>(
+					CompiledState{
+						released_compiled_state->num_text_changes_at_compilation_task_start,
+						released_compiled_state->text,
+						released_compiled_state->line_to_linear_position_index,
+						released_compiled_state->source_graph,
+						std::move(code_builder_state.llvm_context),
+						std::move(code_builder_state.code_builder),
+						released_compiled_state->errors,
+						released_compiled_state->root_declarations } );
+
+			return std::shared_ptr<const RebuildResult>( std::move(result) );
+		};
+
+	compilation_future_=
+		thread_pool.async(
+			// Wrap lambda into copyable wrapper, like for rebuild.
+			[ lambda_ptr= std::make_shared< decltype(restore_func) >( std::move(restore_func) ) ]
+			{
+				return (*lambda_ptr)();
+			} );
+}
+
 void Document::TryTakeBackgroundStateUpdate()
 {
 	if( !compilation_future_.valid() )
@@ -1035,34 +1385,227 @@ void Document::TryTakeBackgroundStateUpdate()
 	if( status != std::future_status::ready )
 		return;
 
-	compiled_state_= nullptr;
-	compiled_state_= compilation_future_.get();
+	const RebuildResultPtr rebuild_result= compilation_future_.get();
 
 	// Make future invalid - mark it as empty.
-	compilation_future_= CompiledStateFuture();
+	compilation_future_= RebuildResultFuture();
+	rebuild_cancelled_= nullptr;
+
+	if( rebuild_result->cancelled )
+	{
+		log_() << "Stale rebuild of " << path_ << " was cancelled" << std::endl;
+		rebuild_required_= true;
+		return;
+	}
+
+	if( rebuild_result->restored_compiled_state != nullptr )
+	{
+		// Replace released state with the restored one. Text, source graph and diagnostics are the same.
+		if( compiled_state_ != nullptr && compiled_state_->code_builder == nullptr &&
+			compiled_state_->source_graph == rebuild_result->restored_compiled_state->source_graph )
+		{
+			compiled_state_= rebuild_result->restored_compiled_state;
+			num_changed_functions_checks_= 0;
+		}
+		return;
+	}
+
+	if( rebuild_result->changed_functions_check != std::nullopt )
+	{
+		const ChangedFunctionsCheck& check= *rebuild_result->changed_functions_check;
+		if( check.base_compiled_state != compiled_state_ )
+		{
+			// Code builder state was released during rebuild. Perform full rebuild later.
+			rebuild_required_= true;
+			return;
+		}
+
+		// Build changed functions in the last valid state.
+		// Do this here, since code builder of compiled state may be used only in the main thread.
+		// This blocks the main thread, but number of changed functions is limited, so, it's usually much faster than full rebuild.
+		CodeBuilderErrorsContainer errors=
+			compiled_state_->code_builder->CheckFunctions( check.changed_functions, *check.source_graph->macro_expansion_contexts );
+		errors.insert( errors.end(), check.preserved_errors.begin(), check.preserved_errors.end() );
+
+		++num_changed_functions_checks_;
+		if( num_changed_functions_checks_ >= c_max_changed_functions_checks )
+			rebuild_required_= true; // Replace grown code builder with a new one.
+
+		diagnostics_.clear();
+		PopulateDiagnostics( *check.source_graph, errors, check.text, check.line_to_linear_position_index, diagnostics_ );
+		rebuild_finished_= true;
+		return;
+	}
+
 	rebuild_finished_= true;
 
-	if( compiled_state_ != nullptr )
+	if( rebuild_result->compiled_state == nullptr )
 	{
-		if( text_changes_since_compiled_state_ == std::nullopt )
-			text_changes_since_compiled_state_= TextChangesSequence();
-		else
+		// Rebuild failed.
+		diagnostics_= rebuild_result->diagnostics;
+		return;
+	}
+
+	compiled_state_= nullptr;
+	compiled_state_= rebuild_result->compiled_state;
+	num_changed_functions_checks_= 0;
+
+	if( text_changes_since_compiled_state_ == std::nullopt )
+		text_changes_since_compiled_state_= TextChangesSequence();
+	else
+	{
+		// Reset changes made before update task start (for actual for task start moment).
+		// Preserve changes made during task running.
+		U_ASSERT( text_changes_since_compiled_state_->size() >= compiled_state_->num_text_changes_at_compilation_task_start );
+		text_changes_since_compiled_state_->erase(
+			text_changes_since_compiled_state_->begin(),
+			text_changes_since_compiled_state_->begin() + std::vector<TextChange>::iterator::difference_type( compiled_state_->num_text_changes_at_compilation_task_start ) );
+	}
+
+	diagnostics_.clear();
+	PopulateDiagnostics(
+		*compiled_state_->source_graph,
+		compiled_state_->errors,
+		*compiled_state_->text,
+		compiled_state_->line_to_linear_position_index,
+		diagnostics_ );
+}
+
+std::optional<Document::ChangedFunctionsCheck> Document::TryPrepareChangedFunctionsCheck(
+	const CompiledStatePtr& prev_compiled_state,
+	const TextChangesSequence& text_changes_since_prev_compiled_state,
+	const CodeBuilder::SourceGraphPtr& source_graph,
+	const std::string& text,
+	const LineToLinearPositionIndex& line_to_linear_position_index )
+{
+	const CompiledState& prev_state= *prev_compiled_state;
+	if( prev_state.code_builder == nullptr )
+		return std::nullopt;
+
+	const SourceGraph& prev_source_graph= *prev_state.source_graph;
+
+	// Imported files should be exactly the same.
+	// It's enough to compare syntax analysis results by pointers, since they are shared via interner.
+	// Prelude is not shared, but it is the same for all rebuilds of this document.
+	if( source_graph->nodes_storage.size() != prev_source_graph.nodes_storage.size() )
+		return std::nullopt;
+	for( size_t i= 0; i < source_graph->nodes_storage.size(); ++i )
+	{
+		const SourceGraph::Node& node= source_graph->nodes_storage[i];
+		const SourceGraph::Node& prev_node= prev_source_graph.nodes_storage[i];
+		if( node.file_path != prev_node.file_path ||
+			node.child_nodes_indices != prev_node.child_nodes_indices ||
+			node.category != prev_node.category )
+			return std::nullopt;
+		if( i != 0 && node.category != SourceGraph::Node::Category::BuiltInPrelude && node.ast != prev_node.ast )
+			return std::nullopt;
+	}
+
+	const SourceGraphNodeDeclarations declarations= SerializeSourceGraphNodeDeclarations( *source_graph, 0 );
+	const SourceGraphNodeDeclarations& prev_declarations= prev_state.root_declarations;
+	if( declarations.data != prev_declarations.data || declarations.functions.size() != prev_declarations.functions.size() )
+		return std::nullopt;
+
+	ChangedFunctionsCheck result;
+
+	std::vector<const Synt::Function*> prev_changed_functions;
+	for( size_t i= 0; i < declarations.functions.size(); ++i )
+	{
+		const SourceGraphNodeDeclarations::FunctionWithBody& function= declarations.functions[i];
+		const SourceGraphNodeDeclarations::FunctionWithBody& prev_function= prev_declarations.functions[i];
+		if( function.body == prev_function.body )
+			continue;
+
+		std::vector<CodeBuilder::CompletionRequestPrefixComponent> prefix;
+		prefix.reserve( function.prefix.size() );
+		for( const SourceGraphNodeDeclarations::PrefixComponent& component : function.prefix )
+			prefix.push_back( std::visit( []( const auto el ) -> CodeBuilder::CompletionRequestPrefixComponent { return el; }, component ) );
+
+		result.changed_functions.emplace_back( std::move(prefix), function.function );
+		prev_changed_functions.push_back( prev_function.function );
+	}
+
+	if( result.changed_functions.size() > c_max_changed_functions_to_check )
+		return std::nullopt;
+
+	// Reuse errors of the last valid state, except errors of changed functions.
+	// Preserve only template contexts of changed functions, since templates are instantiated only once and their errors will not be reported again.
+	// Errors of last valid state should be mapped to new text.
+	const auto map_src_loc=
+		[&]( const SrcLoc& src_loc ) -> std::optional<SrcLoc>
 		{
-			// Reset changes made before update task start (for actual for task start moment).
-			// Preserve changes made during task running.
-			U_ASSERT( text_changes_since_compiled_state_->size() >= compiled_state_->num_text_changes_at_compilation_task_start );
-			text_changes_since_compiled_state_->erase(
-				text_changes_since_compiled_state_->begin(),
-				text_changes_since_compiled_state_->begin() + std::vector<TextChange>::iterator::difference_type( compiled_state_->num_text_changes_at_compilation_task_start ) );
+			if( src_loc.GetFileIndex() != 0 )
+				return src_loc;
+
+			const uint32_t line= src_loc.GetLine();
+			if( line >= prev_state.line_to_linear_position_index.size() )
+				return std::nullopt;
+
+			const TextLinearPosition line_start= prev_state.line_to_linear_position_index[line];
+			const std::optional<uint32_t> column_utf8=
+				Utf32PositionToUtf8Position( std::string_view(*prev_state.text).substr( line_start ), src_loc.GetColumn() );
+			if( column_utf8 == std::nullopt )
+				return std::nullopt;
+
+			const std::optional<uint32_t> position_mapped= MapOldPositionToNewPosition( text_changes_since_prev_compiled_state, line_start + *column_utf8 );
+			if( position_mapped == std::nullopt )
+				return std::nullopt;
+
+			const uint32_t current_line= LinearPositionToLine( line_to_linear_position_index, *position_mapped );
+			if( current_line >= line_to_linear_position_index.size() )
+				return std::nullopt;
+
+			const TextLinearPosition current_line_start= line_to_linear_position_index[current_line];
+			const std::optional<uint32_t> current_column=
+				Utf8PositionToUtf32Position( std::string_view(text).substr( current_line_start ), *position_mapped - current_line_start );
+			if( current_column == std::nullopt )
+				return std::nullopt;
+
+			SrcLoc result( 0, current_line, *current_column );
+			result.SetMacroExpansionIndex( src_loc.GetMacroExpansionIndex() );
+			return result;
+		};
+
+	for( const CodeBuilderError& prev_error : prev_state.errors )
+	{
+		if( prev_error.code != CodeBuilderErrorCode::TemplateContext && prev_error.src_loc.GetFileIndex() == 0 )
+		{
+			bool is_inside_changed_function= false;
+			for( const Synt::Function* const prev_function : prev_changed_functions )
+				is_inside_changed_function|= IsInsideFunction( prev_error.src_loc, *prev_function );
+			if( is_inside_changed_function )
+				continue;
 		}
 
-		PopulateDiagnostics(
-			*compiled_state_->source_graph,
-			compiled_state_->code_builder->TakeErrors(),
-			compiled_state_->text,
-			compiled_state_->line_to_linear_position_index,
-			diagnostics_ );
+		CodeBuilderError error= prev_error;
+		if( MapErrorPosition_r( error, map_src_loc ) )
+			result.preserved_errors.push_back( std::move(error) );
+	}
+
+	result.base_compiled_state= prev_compiled_state;
+	result.source_graph= source_graph;
+	result.text= text;
+	result.line_to_linear_position_index= line_to_linear_position_index;
+
+	return result;
+}
+
+CodeBuilder* Document::GetCodeBuilder()
+{
+	if( compiled_state_ == nullptr )
+		return nullptr;
+
+	last_usage_time_= DocumentClock::now();
+
+	if( compiled_state_->code_builder == nullptr )
+	{
+		// Code builder state was released. Do not restore it here, since it's slow and blocks processing of other requests.
+		// Request restoring in background instead. Requests are answered without code builder until it is finished.
+		restore_required_= true;
+		return nullptr;
 	}
+
+	return compiled_state_->code_builder.get();
 }
 
 std::optional<TextLinearPosition> Document::GetPositionInLastValidText( const DocumentPosition& position ) const
@@ -1084,7 +1627,7 @@ std::optional<TextLinearPosition> Document::GetPositionInLastValidText( const Do
 	if( last_valid_text_position == std::nullopt )
 		return std::nullopt;
 
-	if( *last_valid_text_position >= compiled_state_->text.size() )
+	if( *last_valid_text_position >= compiled_state_->text->size() )
 		return std::nullopt;
 
 	return last_valid_text_position;
@@ -1107,7 +1650,7 @@ std::optional<SrcLoc> Document::GetIdentifierStartSrcLoc( const DocumentPosition
 	const TextLinearPosition line_offset= compiled_state_->line_to_linear_position_index[line];
 	U_ASSERT( *linear_position >= line_offset );
 
-	const std::string_view line_text= std::string_view( compiled_state_->text ).substr( line_offset );
+	const std::string_view line_text= std::string_view( *compiled_state_->text ).substr( line_offset );
 
 	const std::optional<TextLinearPosition> column_utf8= GetIdentifierStartForPosition( line_text, *linear_position - line_offset );
 	if( column_utf8 == std::nullopt )
@@ -1120,6 +1663,19 @@ std::optional<SrcLoc> Document::GetIdentifierStartSrcLoc( const DocumentPosition
 	return SrcLoc( 0, line, *column_utf32 );
 }
 
+Lexems Document::GetCurrentTextLexems()
+{
+	if( lexems_ != std::nullopt )
+		return *lexems_;
+
+	Lexems lexems= LexicalAnalysis( text_ ).lexems;
+	// Lexems can't be updated incrementally for texts with non-ASCII newlines, so, do not cache them.
+	if( !ContainsNonASCIINewlines( text_ ) )
+		lexems_= lexems;
+
+	return lexems;
+}
+
 } // namespace LangServer
 
 } // namespace U
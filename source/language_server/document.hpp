@@ -1,9 +1,11 @@
 #pragma once
+#include <atomic>
 #include "../code_builder_lib_common/push_disable_llvm_warnings.hpp"
 #include <llvm/Support/ThreadPool.h>
 #include "../code_builder_lib_common/pop_llvm_warnings.hpp"
 #include "../compiler0/code_builder_lib/code_builder.hpp"
 #include "../lex_synt_lib/source_graph_loader.hpp"
+#include "../compiler0/lex_synt_lib/source_graph_serialization.hpp"
 #include "completion.hpp"
 #include "document_symbols.hpp"
 #include "diagnostics.hpp"
@@ -32,10 +34,12 @@ public:
 	Document(
 		IVfs::Path path,
 		DocumentBuildOptions build_options,
-		// Shouldn't be thread-safe. Used only synchroniously to load source graph.
+		// Must be thread-safe. Used in background thread to load source graph.
 		IVfsSharedPtr vfs,
 		// Must be thread-safe. Used for embedding files.
 		IVfsSharedPtr code_builder_vfs,
+		// May be null. Used to share syntax analysis results of common imports between documents.
+		SyntaxAnalysisResultsInternerPtr syntax_analysis_results_interner,
 		Logger& log );
 
 public: // Document text stuff.
@@ -47,12 +51,31 @@ public: // Document text stuff.
 	// Returns text of last valid state or raw text if there is no last valid state.
 	const std::string& GetTextForCompilation();
 
+	// Same as above, but result may be used in other threads.
+	std::shared_ptr<const std::string> GetTextForCompilationSnapshot();
+
+	// Remember current text as text saved on disk.
+	// Workspace symbols index is built for saved files, so, positions should be mapped between saved and current text.
+	void SetTextIsSaved();
+
+	// Returns none if saved text is unknown or if position is within changed range.
+	std::optional<DocumentPosition> MapPositionToSavedText( const DocumentPosition& position ) const;
+	std::optional<DocumentRange> MapSavedTextRangeToCurrentText( const DocumentRange& range ) const;
+
 public: // State tracking.
 	DocumentClock::time_point GetModificationTime() const;
 	bool RebuildRequired() const;
 
 	void OnPossibleDependentFileChanged( const IVfs::Path& file_path_normalized );
 
+	// Time of last modification or request, which requires compiled state.
+	DocumentClock::time_point GetLastUsageTime() const;
+
+	bool HasCompiledState();
+	bool HasCodeBuilderState();
+	// Release code builder state in order to reduce memory usage. It is restored in background on demand.
+	void ReleaseCodeBuilderState();
+
 	bool RebuildIsRunning() const;
 	bool RebuildFinished();
 	void ResetRebuildFinishedFlag();
@@ -99,53 +122,118 @@ private:
 	// This metod checks if compilation future has a new result. If so - it updates compiled state.
 	void TryTakeBackgroundStateUpdate();
 
+	// Mark running rebuild as stale. It will be cancelled, if it has not yet started building code.
+	void CancelRunningRebuild();
+
 	// Map position in current document text to position in last valid state text.
 	std::optional<TextLinearPosition> GetPositionInLastValidText( const DocumentPosition& position ) const;
 
 	// Return SrcLoc for last valid state, based on input position of current document state.
 	std::optional<SrcLoc> GetIdentifierStartSrcLoc( const DocumentPosition& position ) const;
 
+	// Returns null if there is no compiled state or if code builder state was released.
+	// In the last case restoring of this state in background is requested.
+	CodeBuilder* GetCodeBuilder();
+
+	// Build code builder state for source graph of released compiled state in background thread.
+	void StartReleasedStateRestoring( llvm::ThreadPool& thread_pool );
+
+	// Get lexems of current text. They are cached and updated incrementally on text changes.
+	Lexems GetCurrentTextLexems();
+
 private:
 	struct CompiledState
 	{
 		size_t num_text_changes_at_compilation_task_start= 0; // Used only when updating state.
-		std::string text;
+		std::shared_ptr<const std::string> text; // Shared with documents texts snapshot. Never null.
 		LineToLinearPositionIndex line_to_linear_position_index;
 		CodeBuilder::SourceGraphPtr source_graph;
 		std::unique_ptr<llvm::LLVMContext> llvm_context;
 		std::unique_ptr<CodeBuilder> code_builder; // Still may be modified in const state because of indirection.
+		CodeBuilderErrorsContainer errors;
+		SourceGraphNodeDeclarations root_declarations; // Used to detect changes only in function bodies.
 	};
 
 	// Use shared_ptr, since llvm::ThreadPool returns only shared_future, that can return only immutable result.
 	// So, we can't move-out result and take cheap copy of shared_ptr instead.
 	using CompiledStatePtr= std::shared_ptr<const CompiledState>;
 
+	// Data for checking only changed functions using last valid state, if nothing except function bodies was changed.
+	struct ChangedFunctionsCheck
+	{
+		CompiledStatePtr base_compiled_state; // Last valid state, which code builder should be used for check.
+		CodeBuilder::SourceGraphPtr source_graph;
+		std::vector< std::pair< std::vector<CodeBuilder::CompletionRequestPrefixComponent>, const Synt::Function* > > changed_functions;
+		CodeBuilderErrorsContainer preserved_errors; // Errors of last valid state outside changed functions, mapped to new text.
+		std::string text;
+		LineToLinearPositionIndex line_to_linear_position_index;
+	};
+
+	struct RebuildResult
+	{
+		// Non-null if full rebuild was successful.
+		CompiledStatePtr compiled_state;
+		// Non-empty if only function bodies were changed. Check itself should be performed in the main thread.
+		std::optional<ChangedFunctionsCheck> changed_functions_check;
+		// Non-null if released compiled state was restored.
+		CompiledStatePtr restored_compiled_state;
+		// Diagnostics for failed rebuild (lexical or syntax errors).
+		DiagnosticsByDocument diagnostics;
+		// True if rebuild became stale and was cancelled before building code. Nothing should be updated in such case.
+		bool cancelled= false;
+	};
+
+	using RebuildResultPtr= std::shared_ptr<const RebuildResult>;
+
 	// llvm::ThreadPool uses shared_future.
-	using CompiledStateFuture= std::shared_future<CompiledStatePtr>;
+	using RebuildResultFuture= std::shared_future<RebuildResultPtr>;
+
+private:
+	// Called in background thread.
+	// Returns empty optional if it isn't possible to check only changed functions and full rebuild is required.
+	static std::optional<ChangedFunctionsCheck> TryPrepareChangedFunctionsCheck(
+		const CompiledStatePtr& prev_compiled_state,
+		const TextChangesSequence& text_changes_since_prev_compiled_state,
+		const CodeBuilder::SourceGraphPtr& source_graph,
+		const std::string& text,
+		const LineToLinearPositionIndex& line_to_linear_position_index );
 
 private:
 	const IVfs::Path path_;
 	const DocumentBuildOptions build_options_;
 	const IVfsSharedPtr vfs_;
 	const IVfsSharedPtr code_builder_vfs_; // Must be thread-safe.
+	const SyntaxAnalysisResultsInternerPtr syntax_analysis_results_interner_;
 	Logger& log_;
 
 	std::string text_;
 	LineToLinearPositionIndex line_to_linear_position_index_; // Index is allways actual for current text.
+	// Lexems of current text. Built lazily (since they are needed only for completion and signature help) and updated incrementally.
+	std::optional<Lexems> lexems_;
 	std::optional<TextChangesSequence> text_changes_since_compiled_state_;
 
+	// Empty if it's unknown whether current text was saved.
+	std::optional<std::string> saved_text_;
+	LineToLinearPositionIndex saved_text_line_to_linear_position_index_;
+	TextChangesSequence text_changes_since_saved_;
+
 	DocumentClock::time_point modification_time_;
+	DocumentClock::time_point last_usage_time_;
 	bool rebuild_required_= true;
-
-	bool in_rebuild_call_= false;
+	// Set if released code builder state was requested.
+	bool restore_required_= false;
 
 	// Compiled state (source text + source graph + code builder).
 	// It is updated relatively rarely - not for each text change.
 	// It is impossible to update it for each change, because not each change produces syntaxically-correct program
 	// and because update is too slow.
 	CompiledStatePtr compiled_state_;
+	// Number of checks of changed functions performed using code builder of compiled state.
+	size_t num_changed_functions_checks_= 0;
 
-	CompiledStateFuture compilation_future_;
+	RebuildResultFuture compilation_future_;
+	// Flag for cancellation of running rebuild. Each rebuild has its own flag.
+	std::shared_ptr<std::atomic<bool>> rebuild_cancelled_;
 	bool rebuild_finished_= false;
 
 	DiagnosticsByDocument diagnostics_;
@@ -1,3 +1,4 @@
+#include <set>
 #include "../code_builder_lib_common/push_disable_llvm_warnings.hpp"
 #include <llvm/TargetParser/Host.h>
 #include "../code_builder_lib_common/pop_llvm_warnings.hpp"
@@ -55,6 +56,20 @@ DocumentBuildOptions CreateBuildOptions( Logger& log )
 	return build_options;
 }
 
+std::unique_ptr<SymbolIndex> CreateSymbolIndex( Logger& log, const DocumentBuildOptions& build_options )
+{
+	if( !Options::background_index )
+	{
+		log() << "Background index is disabled" << std::endl;
+		return nullptr;
+	}
+
+	return std::make_unique<SymbolIndex>( log, build_options, Options::index_dir, Options::index_threads );
+}
+
+// Limit number of results in order to avoid sending huge responses for short queries.
+constexpr size_t c_max_workspace_symbols= 512;
+
 } // namespace
 
 DocumentManager::DocumentManagerVfs::DocumentManagerVfs(
@@ -71,34 +86,41 @@ std::optional<IVfs::FileContent> DocumentManager::DocumentManagerVfs::LoadFileCo
 {
 	const Uri file_uri= Uri::FromFilePath( full_file_path );
 
-	if( const auto it= documents_container_->documents.find( file_uri ); it != documents_container_->documents.end() )
-		return it->second.GetTextForCompilation();
-	if( const auto it= documents_container_->unmanaged_files.find( file_uri ); it != documents_container_->unmanaged_files.end() )
 	{
-		// TODO - detect changes in unmanaged files and reload them if it is necessary.
-		if( it->second == std::nullopt )
-			return std::nullopt;
-		return it->second->content;
+		const std::lock_guard<std::mutex> lock( documents_container_->files_mutex );
+
+		if( const auto it= documents_container_->documents_texts.find( file_uri ); it != documents_container_->documents_texts.end() )
+			return *it->second;
+		if( const auto it= documents_container_->unmanaged_files.find( file_uri ); it != documents_container_->unmanaged_files.end() )
+		{
+			// TODO - detect changes in unmanaged files and reload them if it is necessary.
+			if( it->second == std::nullopt )
+				return std::nullopt;
+			return it->second->content;
+		}
 	}
 
-	// Load unmanaged file.
+	// Load unmanaged file. Do not hold lock during loading, since it may be slow.
 	log_() << "Load unmanaged file " << full_file_path << std::endl;
 
-	std::optional<UnmanagedFile>& unmanaged_file= documents_container_->unmanaged_files[file_uri];
-
-	std::optional<IVfs::FileContent> content= base_vfs_->LoadFileContent( full_file_path );
+	std::optional<UnmanagedFile> unmanaged_file;
 
-	if( content == std::nullopt )
+	if( std::optional<IVfs::FileContent> content= base_vfs_->LoadFileContent( full_file_path ) )
 	{
-		log_() << "Failed to load unmanaged file " << full_file_path << std::endl;
-		return std::nullopt;
+		unmanaged_file= UnmanagedFile{};
+		unmanaged_file->content= std::move(*content);
+		unmanaged_file->line_to_linear_position_index= BuildLineToLinearPositionIndex( unmanaged_file->content );
 	}
+	else
+		log_() << "Failed to load unmanaged file " << full_file_path << std::endl;
 
-	unmanaged_file= UnmanagedFile{};
-	unmanaged_file->content= std::move(*content);
-	unmanaged_file->line_to_linear_position_index= BuildLineToLinearPositionIndex( unmanaged_file->content );
+	const std::lock_guard<std::mutex> lock( documents_container_->files_mutex );
 
-	return unmanaged_file->content;
+	// Preserve file, which may be already loaded in another thread.
+	const auto it= documents_container_->unmanaged_files.emplace( file_uri, std::move(unmanaged_file) ).first;
+	if( it->second == std::nullopt )
+		return std::nullopt;
+	return it->second->content;
 }
 
 IVfs::Path DocumentManager::DocumentManagerVfs::GetFullFilePath( const Path& file_path, const Path& full_parent_file_path )
@@ -118,6 +140,8 @@ DocumentManager::DocumentManager( Logger& log, std::string installation_director
 	, build_options_( CreateBuildOptions(log_) )
 	, vfs_manager_( log, std::move(installation_directory) )
 	, documents_container_( std::make_shared<DocumentsContainer>() )
+	, syntax_analysis_results_interner_( std::make_shared<SyntaxAnalysisResultsInterner>() )
+	, symbol_index_( CreateSymbolIndex( log_, build_options_ ) )
 {}
 
 Document* DocumentManager::Open( const Uri& uri, std::string text )
@@ -129,9 +153,13 @@ Document* DocumentManager::Open( const Uri& uri, std::string text )
 		return nullptr;
 	}
 
-	documents_container_->unmanaged_files.erase( uri ); // Now we manage this file.
+	{
+		const std::lock_guard<std::mutex> lock( documents_container_->files_mutex );
+		documents_container_->unmanaged_files.erase( uri ); // Now we manage this file.
+	}
 
 	const auto base_vfs= vfs_manager_.GetVFSForDocument( uri );
+	const IVfs::Path file_path_normalized= base_vfs->GetFullFilePath( *file_path, "" );
 
 	// First add docuemnt into a map.
 	const auto it_bool_pair=
@@ -142,16 +170,23 @@ Document* DocumentManager::Open( const Uri& uri, std::string text )
 					std::move( *file_path ),
 					build_options_,
 					std::make_shared<DocumentManagerVfs>( log_, base_vfs, documents_container_ ),
-					// Pass base VFS for CodeBuilder VFS, because we require here thread-safe VFS class instance.
+					// Pass base VFS for CodeBuilder VFS, in order to avoid caching of embedded files, which may be large.
 					// This isn't ideal, because no managed files can be loaded in such cases.
-					// There is also no caching.
-					// But it is good enough, because eliminates complicated synchronization issues.
 					base_vfs,
+					syntax_analysis_results_interner_,
 					log_ ) ) );
 
 	Document& document= it_bool_pair.first->second;
 	document.SetText( std::move(text) );
 
+	if( symbol_index_ != nullptr )
+	{
+		// Usually opened document text is the same as file content. Remember this in order to use the index for this document.
+		const std::optional<IVfs::FileContent> file_content= base_vfs->LoadFileContent( file_path_normalized );
+		if( file_content != std::nullopt && *file_content == document.GetCurrentText() )
+			document.SetTextIsSaved();
+	}
+
 	// Do not build document right now - perform delayed rebuild later.
 
 	return &document;
@@ -169,11 +204,41 @@ void DocumentManager::Close( const Uri& uri )
 {
 	documents_container_->documents.erase( uri );
 	all_diagnostics_.erase( uri );
+
+	const std::lock_guard<std::mutex> lock( documents_container_->files_mutex );
+	documents_container_->documents_texts.erase( uri );
+}
+
+void DocumentManager::OnDocumentSaved( const Uri& uri )
+{
+	if( symbol_index_ == nullptr )
+		return;
+
+	if( const auto it= documents_container_->documents.find( uri ); it != documents_container_->documents.end() )
+		it->second.SetTextIsSaved();
+
+	const std::optional<std::string> file_path= uri.AsFilePath();
+	if( file_path == std::nullopt )
+		return;
+
+	const IVfsSharedPtr base_vfs= vfs_manager_.GetVFSForDocument( uri );
+	const IVfs::Path file_path_normalized= base_vfs->GetFullFilePath( *file_path, "" );
+
+	// Reindex saved file itself and all files importing it, since their definition points may be changed.
+	if( SymbolIndex::IsIndexableFile( file_path_normalized ) )
+		symbol_index_->ScheduleIndexing( file_path_normalized, base_vfs );
+
+	for( const IVfs::Path& dependent_file_path : symbol_index_->GetDependentFiles( file_path_normalized ) )
+	{
+		if( dependent_file_path != file_path_normalized )
+			symbol_index_->ScheduleIndexing( dependent_file_path, vfs_manager_.GetVFSForDocument( Uri::FromFilePath( dependent_file_path ) ) );
+	}
 }
 
 DocumentClock::duration DocumentManager::PerfromDelayedRebuild( llvm::ThreadPool& thread_pool )
 {
 	// Check for finished async rebuilds of documents.
+	bool some_rebuild_finished= false;
 	for( auto& document_pair : documents_container_->documents )
 	{
 		const Uri& uri= document_pair.first;
@@ -181,6 +246,7 @@ DocumentClock::duration DocumentManager::PerfromDelayedRebuild( llvm::ThreadPool
 		if( document.RebuildFinished() )
 		{
 			document.ResetRebuildFinishedFlag();
+			some_rebuild_finished= true;
 
 			// Notify other documents about change in order to trigger rebuilding of dependent documents.
 			if( const auto file_path= uri.AsFilePath() )
@@ -195,22 +261,56 @@ DocumentClock::duration DocumentManager::PerfromDelayedRebuild( llvm::ThreadPool
 		}
 	}
 
+	// Free syntax analysis results, used only by previous states of rebuilt documents.
+	if( some_rebuild_finished )
+	{
+		ReleaseLeastRecentlyUsedDocumentsStates();
+		syntax_analysis_results_interner_->RemoveUnusedEntries();
+	}
+
 	const auto rebuild_delay= std::chrono::milliseconds(1000); // TODO - make it configurable.
 	const auto current_time= DocumentClock::now();
 
 	// Start documents rebuilding (if necessary).
+	std::vector<Document*> documents_to_rebuild;
+	size_t num_running_rebuilds= 0;
 	for( auto& document_pair : documents_container_->documents )
 	{
 		Document& document= document_pair.second;
-		if( document.RebuildRequired() )
+		if( document.RebuildIsRunning() )
+			++num_running_rebuilds;
+		else if( document.RebuildRequired() )
 		{
 			const auto modification_time= document.GetModificationTime();
 			if( modification_time <= current_time && (current_time - modification_time) >= rebuild_delay )
-				document.StartRebuild( thread_pool );
-
+				documents_to_rebuild.push_back( &document );
 		}
 	}
 
+	// Start rebuilding of most recently used documents first - likely user works with them right now.
+	// Documents rebuilt only because of changes in their dependencies have older usage time and thus are rebuilt later.
+	// Do not start more rebuilds than number of threads, since thread pool processes tasks in order of addition.
+	// Remaining documents will be rebuilt later, after some of running rebuilds are finished.
+	std::sort(
+		documents_to_rebuild.begin(), documents_to_rebuild.end(),
+		[]( const Document* const l, const Document* const r ) { return l->GetLastUsageTime() > r->GetLastUsageTime(); } );
+
+	const size_t max_running_rebuilds= std::max( size_t(thread_pool.getThreadCount()), size_t(1) );
+	if( num_running_rebuilds >= max_running_rebuilds )
+		documents_to_rebuild.clear();
+	else if( documents_to_rebuild.size() > max_running_rebuilds - num_running_rebuilds )
+		documents_to_rebuild.resize( max_running_rebuilds - num_running_rebuilds );
+
+	if( !documents_to_rebuild.empty() )
+	{
+		UpdateDocumentsTextsSnapshot();
+		for( Document* const document : documents_to_rebuild )
+			document->StartRebuild( thread_pool );
+	}
+
+	// Workspaces may be found while opening documents, so, check for new ones.
+	ScheduleWorkspaceIndexing();
+
 	// Calculate minimal time to next document rebuild.
 	// Start with reasonably great value.
 	DocumentClock::duration wait_time= std::chrono::duration_cast<DocumentClock::duration>( std::chrono::seconds(5) );
@@ -234,6 +334,63 @@ DocumentClock::duration DocumentManager::PerfromDelayedRebuild( llvm::ThreadPool
 	return wait_time;
 }
 
+void DocumentManager::ReleaseLeastRecentlyUsedDocumentsStates()
+{
+	const size_t max_compiled_documents= Options::max_compiled_documents;
+	if( max_compiled_documents == 0 )
+		return;
+
+	std::vector<Document*> compiled_documents;
+	for( auto& document_pair : documents_container_->documents )
+	{
+		if( document_pair.second.HasCodeBuilderState() )
+			compiled_documents.push_back( &document_pair.second );
+	}
+
+	if( compiled_documents.size() <= max_compiled_documents )
+		return;
+
+	std::sort(
+		compiled_documents.begin(), compiled_documents.end(),
+		[]( const Document* const l, const Document* const r ) { return l->GetLastUsageTime() > r->GetLastUsageTime(); } );
+
+	for( size_t i= max_compiled_documents; i < compiled_documents.size(); ++i )
+		compiled_documents[i]->ReleaseCodeBuilderState();
+
+	log_() << "Released compiled state of " << ( compiled_documents.size() - max_compiled_documents ) << " documents" << std::endl;
+}
+
+void DocumentManager::UpdateDocumentsTextsSnapshot()
+{
+	// Take texts before locking, since taking them may update documents states.
+	std::vector< std::pair< Uri, std::shared_ptr<const std::string> > > texts;
+	texts.reserve( documents_container_->documents.size() );
+	for( auto& document_pair : documents_container_->documents )
+		texts.emplace_back( document_pair.first, document_pair.second.GetTextForCompilationSnapshot() );
+
+	const std::lock_guard<std::mutex> lock( documents_container_->files_mutex );
+	for( auto& uri_text_pair : texts )
+		documents_container_->documents_texts[ uri_text_pair.first ]= std::move( uri_text_pair.second );
+}
+
+void DocumentManager::ScheduleWorkspaceIndexing()
+{
+	if( symbol_index_ == nullptr )
+		return;
+
+	for( const std::string& directory : vfs_manager_.GetWorkspaceDirectories() )
+	{
+		if( !indexed_workspace_directories_.insert( directory ).second )
+			continue; // Already indexed.
+
+		log_() << "Schedule indexing of workspace directory \"" << directory << "\"" << std::endl;
+
+		// Do not traverse directory here, since it may be slow and block processing of requests.
+		// Use VFS of the directory itself for all its files - all of them have the same includes.
+		symbol_index_->ScheduleDirectoryIndexing( directory, vfs_manager_.GetVFSForDocument( Uri::FromFilePath( directory ) ) );
+	}
+}
+
 bool DocumentManager::DiagnosticsWereUpdated() const
 {
 	return diagnostics_updated_;
@@ -266,6 +423,16 @@ std::optional<RangeInDocument> DocumentManager::GetDefinitionPoint( const Positi
 	if( const auto result_position= document.GetDefinitionPoint( position.position ) )
 		return GetDocumentIdentifierRangeOrDummy( *result_position );
 
+	// Document may be not compiled yet or its compiled state may be released. Try to use the index in such case.
+	if( symbol_index_ != nullptr && !document.HasCodeBuilderState() )
+	{
+		if( const auto index_position= MapPositionToIndexedText( position ) )
+		{
+			if( auto definition_point= symbol_index_->GetDefinitionPoint( *index_position ) )
+				return MapIndexedRangeToCurrentText( std::move(*definition_point) );
+		}
+	}
+
 	return std::nullopt;
 }
 
@@ -290,13 +457,45 @@ std::vector<RangeInDocument> DocumentManager::GetAllOccurrences( const PositionI
 		return {};
 	}
 
-	const std::vector<SrcLocInDocument> occurences= it->second.GetAllOccurrences( position.position );
+	Document& document= it->second;
+
+	const std::vector<SrcLocInDocument> occurences= document.GetAllOccurrences( position.position );
 
 	std::vector<RangeInDocument> result;
 	result.reserve( occurences.size() );
 	for( const SrcLocInDocument& document_src_loc : occurences )
 		result.push_back( GetDocumentIdentifierRangeOrDummy( document_src_loc ) );
 
+	if( symbol_index_ == nullptr )
+		return result;
+
+	// Document itself knows only about files it imports. Use index to find occurrences in other files.
+	// Search via definition point, since text of the document may be changed since it was indexed.
+	std::optional<PositionInDocument> index_position;
+	if( const auto definition_point= document.GetDefinitionPoint( position.position ) )
+	{
+		const RangeInDocument definition_range= GetDocumentIdentifierRangeOrDummy( *definition_point );
+		index_position= MapPositionToIndexedText( PositionInDocument{ definition_range.range.start, definition_range.uri } );
+	}
+	else if( result.empty() && !document.HasCodeBuilderState() )
+		index_position= MapPositionToIndexedText( position );
+
+	if( index_position == std::nullopt )
+		return result;
+
+	// Results of document compilation are more actual, so, take from index only files not covered by them.
+	std::set<Uri> files_with_document_results;
+	for( const RangeInDocument& range_in_document : result )
+		files_with_document_results.insert( range_in_document.uri );
+
+	for( RangeInDocument& range_in_document : symbol_index_->GetAllOccurrences( *index_position ) )
+	{
+		if( files_with_document_results.count( range_in_document.uri ) != 0 )
+			continue;
+		if( auto range_mapped= MapIndexedRangeToCurrentText( std::move(range_in_document) ) )
+			result.push_back( std::move(*range_mapped) );
+	}
+
 	return result;
 }
 
@@ -340,6 +539,38 @@ std::vector<CodeBuilder::SignatureHelpItem> DocumentManager::GetSignatureHelp( c
 	return it->second.GetSignatureHelp( position.position );
 }
 
+std::vector<WorkspaceSymbol> DocumentManager::GetWorkspaceSymbols( const std::string_view query )
+{
+	if( symbol_index_ == nullptr )
+		return {};
+
+	return symbol_index_->FindSymbols( query, c_max_workspace_symbols );
+}
+
+std::optional<PositionInDocument> DocumentManager::MapPositionToIndexedText( const PositionInDocument& position ) const
+{
+	const auto it= documents_container_->documents.find( position.uri );
+	if( it == documents_container_->documents.end() )
+		return position;
+
+	if( const auto position_mapped= it->second.MapPositionToSavedText( position.position ) )
+		return PositionInDocument{ *position_mapped, position.uri };
+
+	return std::nullopt;
+}
+
+std::optional<RangeInDocument> DocumentManager::MapIndexedRangeToCurrentText( RangeInDocument range ) const
+{
+	const auto it= documents_container_->documents.find( range.uri );
+	if( it == documents_container_->documents.end() )
+		return std::move(range);
+
+	if( const auto range_mapped= it->second.MapSavedTextRangeToCurrentText( range.range ) )
+		return RangeInDocument{ *range_mapped, std::move(range.uri) };
+
+	return std::nullopt;
+}
+
 RangeInDocument DocumentManager::GetDocumentIdentifierRangeOrDummy( const SrcLocInDocument& document_src_loc ) const
 {
 	if( auto range= GetDocumentIdentifierRange( document_src_loc ) )
@@ -358,6 +589,7 @@ std::optional<DocumentRange> DocumentManager::GetDocumentIdentifierRange( const
 	if( const auto it= documents_container_->documents.find( document_src_loc.uri ); it != documents_container_->documents.end() )
 		return it->second.GetIdentifierRange( document_src_loc.src_loc );
 
+	const std::lock_guard<std::mutex> lock( documents_container_->files_mutex );
 	if( const auto it= documents_container_->unmanaged_files.find( document_src_loc.uri ); it != documents_container_->unmanaged_files.end() )
 	{
 		if( it->second != std::nullopt )
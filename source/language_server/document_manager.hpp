@@ -1,5 +1,7 @@
 #pragma once
+#include <unordered_set>
 #include "document.hpp"
+#include "symbol_index.hpp"
 #include "vfs_manager.hpp"
 
 namespace U
@@ -21,6 +23,9 @@ public:
 	Document* GetDocument( const Uri& uri );
 	void Close( const Uri& uri );
 
+	// Update background index for saved document and files depending on it.
+	void OnDocumentSaved( const Uri& uri );
+
 	// Returns duration to next document update. This method may be called again after returned time is passed.
 	// It is possible to call this method earlier, but it likely will not rebuild anything.
 	// May return zero duration.
@@ -47,7 +52,24 @@ public: // Wrappers for document founctionality. Use them to perform proper rang
 
 	std::vector<CodeBuilder::SignatureHelpItem> GetSignatureHelp( const PositionInDocument& position );
 
+public: // Workspace-wide requests. They use background index and return nothing if it is disabled.
+	std::vector<WorkspaceSymbol> GetWorkspaceSymbols( std::string_view query );
+
 private:
+	// Limit memory usage by releasing internal compiler state of documents, which were not used recently.
+	void ReleaseLeastRecentlyUsedDocumentsStates();
+
+	// Update texts of documents, which are visible for background rebuilds via VFS.
+	void UpdateDocumentsTextsSnapshot();
+
+	// Schedule background indexing of all files within newly found workspace directories.
+	void ScheduleWorkspaceIndexing();
+
+	// Symbol index contains positions of saved files. Map positions of opened documents (which may contain unsaved changes) to them and back.
+	// Positions of not opened files are returned as is.
+	std::optional<PositionInDocument> MapPositionToIndexedText( const PositionInDocument& position ) const;
+	std::optional<RangeInDocument> MapIndexedRangeToCurrentText( RangeInDocument range ) const;
+
 	RangeInDocument GetDocumentIdentifierRangeOrDummy( const SrcLocInDocument& document_src_loc ) const;
 	std::optional<DocumentRange> GetDocumentIdentifierRange( const SrcLocInDocument& document_src_loc ) const;
 
@@ -61,7 +83,13 @@ private:
 	struct DocumentsContainer
 	{
 		// TODO - use unordered map.
+		// Accessed only in the main thread.
 		std::map<Uri, Document> documents;
+
+		// Data below is accessed also from background threads (via VFS). Lock mutex before accessing it.
+		std::mutex files_mutex;
+		// Snapshot of documents texts for compilation. It is updated before starting rebuilding of documents.
+		std::map<Uri, std::shared_ptr<const std::string>> documents_texts;
 		std::map<Uri, std::optional<UnmanagedFile>> unmanaged_files;
 	};
 
@@ -70,6 +98,7 @@ private:
 
 	// VFS wrapper, that allows to read managed documents and also caches unmanaged files reads.
 	// Use this to load source graph for documents.
+	// It is thread-safe - documents are read from texts snapshot, not directly.
 	// It is not so efficient, because full lexical and synax analysis for all imports is performed for a document.
 	// But there is no way to do another way, since core compiler structures like SourceGraph and SrcLoc use index-based sources identifying.
 	class DocumentManagerVfs final : public IVfs
@@ -116,8 +145,15 @@ private:
 
 	const DocumentsContainerPtr documents_container_;
 
+	// Common for all documents. Allows to avoid parsing common imports for each document.
+	const SyntaxAnalysisResultsInternerPtr syntax_analysis_results_interner_;
+
 	DiagnosticsBySourceDocument all_diagnostics_;
 	bool diagnostics_updated_= true;
+
+	// Null if background indexing is disabled.
+	std::unique_ptr<SymbolIndex> symbol_index_;
+	std::unordered_set<std::string> indexed_workspace_directories_;
 };
 
 } // namespace LangServer
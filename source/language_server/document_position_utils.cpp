@@ -22,6 +22,24 @@ std::optional<TextLinearPosition> DocumentPositionToLinearPosition( const Docume
 	return line_linear_pos + *column_offset;
 }
 
+std::optional<DocumentPosition> LinearPositionToDocumentPosition( const TextLinearPosition position, const std::string_view text, const LineToLinearPositionIndex& line_to_linear_position_index )
+{
+	if( position > text.size() )
+		return std::nullopt;
+
+	const uint32_t line= LinearPositionToLine( line_to_linear_position_index, position );
+	if( line >= line_to_linear_position_index.size() )
+		return std::nullopt;
+
+	const TextLinearPosition line_linear_pos= line_to_linear_position_index[ line ];
+
+	const auto character= Utf8PositionToUtf16Position( text.substr( line_linear_pos ), position - line_linear_pos );
+	if( character == std::nullopt )
+		return std::nullopt;
+
+	return DocumentPosition{ line, *character };
+}
+
 std::optional<DocumentRange> SrcLocToDocumentIdentifierRange( const SrcLoc& src_loc, const std::string_view program_text, const LineToLinearPositionIndex& line_to_linear_position_index )
 {
 	const uint32_t line= src_loc.GetLine();
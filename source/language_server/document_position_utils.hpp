@@ -12,6 +12,9 @@ namespace LangServer
 // Complexity is linear.
 std::optional<TextLinearPosition> DocumentPositionToLinearPosition( const DocumentPosition& pos, std::string_view text, const LineToLinearPositionIndex& line_to_linear_position_index );
 
+// Inverse operation for function above.
+std::optional<DocumentPosition> LinearPositionToDocumentPosition( TextLinearPosition position, std::string_view text, const LineToLinearPositionIndex& line_to_linear_position_index );
+
 std::optional<DocumentRange> SrcLocToDocumentIdentifierRange( const SrcLoc& src_loc, std::string_view program_text, const LineToLinearPositionIndex& line_to_linear_position_index );
 
 } //namespace LangServer
@@ -275,11 +275,11 @@ struct Visitor
 		symbol.selection_range= symbol.range; // TODO - set it properly.
 		symbol.kind= SymbolKind::Class;
 
-		if( const auto class_= std::get_if< std::unique_ptr<const Synt::Class> >( &type_template.something ) )
+		if( const auto class_= std::get_if< ArenaPtr<const Synt::Class> >( &type_template.something ) )
 		{
 			symbol.children= BuildProgramModel_r( (*class_)->elements, src_loc_to_range_mapping_function );
 		}
-		if( std::get_if<std::unique_ptr<const Synt::TypeAlias>>( &type_template.something ) != nullptr )
+		if( std::get_if<ArenaPtr<const Synt::TypeAlias>>( &type_template.something ) != nullptr )
 		{}
 
 		result.push_back( std::move(symbol) );
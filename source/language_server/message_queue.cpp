@@ -7,31 +7,69 @@ namespace U
 namespace LangServer
 {
 
+namespace
+{
+
+// Returns document of a request, if newer request of the same kind for the same document makes this request useless.
+// Only requests related to current cursor position are superseded - completion, signature help, highlighting.
+const Uri* GetSupersedableRequestDocument( const RequestParams& params )
+{
+	if( const auto complete= std::get_if<Requests::Complete>( &params ) )
+		return &complete->position.uri;
+	if( const auto signature_help= std::get_if<Requests::SignatureHelp>( &params ) )
+		return &signature_help->position.uri;
+	if( const auto highlight= std::get_if<Requests::Highlight>( &params ) )
+		return &highlight->position.uri;
+	return nullptr;
+}
+
+} // namespace
+
 void MessageQueue::Push( Message message )
 {
 	{
 		const std::lock_guard<std::mutex> guard(mutex_);
 
-		// Process cancellation specially - clear requests from queue.
+		// Process cancellation specially - cancel requests in queue.
+		// Do not remove them, since a response is still required for a cancelled request.
 		if( const auto notification= std::get_if<Notification>( &message ) )
 		{
 			if( const auto cancel= std::get_if<Notifications::CancelRequest>( notification ) )
 			{
-				const auto new_end_it=
-					std::remove_if(
-						queue_.begin(), queue_.end(),
-						[&]( const Message& m )
-						{
-							if( const auto request= std::get_if<Request>( &m ) )
-								return request->id == cancel->id;
-							return false;
-						} );
-
-				queue_.erase( new_end_it, queue_.end() );
+				for( Message& m : queue_ )
+				{
+					if( const auto request= std::get_if<Request>( &m ) )
+					{
+						if( request->id == cancel->id )
+							request->params= RequestCancelled{};
+					}
+				}
 				return;
 			}
 		}
 
+		// Cancel previous requests superseded by this request.
+		// This allows to respond faster during fast typing, when an IDE sends many completion requests, but only the last one is really needed.
+		if( const auto new_request= std::get_if<Request>( &message ) )
+		{
+			if( const Uri* const new_request_document= GetSupersedableRequestDocument( new_request->params ) )
+			{
+				for( Message& m : queue_ )
+				{
+					if( const auto request= std::get_if<Request>( &m ) )
+					{
+						if( request->params.index() != new_request->params.index() )
+							continue;
+						if( const Uri* const request_document= GetSupersedableRequestDocument( request->params ) )
+						{
+							if( *request_document == *new_request_document )
+								request->params= RequestCancelled{};
+						}
+					}
+				}
+			}
+		}
+
 		queue_.push_back( std::move(message) );
 	}
 	condition_variable_.notify_one();
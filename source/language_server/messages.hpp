@@ -21,6 +21,9 @@ struct MethodNotFound
 	std::string method_name;
 };
 
+// Replaces params of a request, which was cancelled (by client or by newer request) before processing.
+struct RequestCancelled{};
+
 namespace Requests
 {
 
@@ -63,6 +66,11 @@ struct Rename
 	std::string new_name;
 };
 
+struct WorkspaceSymbols
+{
+	std::string query;
+};
+
 } // namespace Requests
 
 using RequestId= std::variant<std::string, int64_t>;
@@ -70,6 +78,7 @@ using RequestId= std::variant<std::string, int64_t>;
 using RequestParams= std::variant<
 	InvalidParams,
 	MethodNotFound,
+	RequestCancelled,
 	Requests::Initialize,
 	Requests::Shutdown,
 	Requests::Symbols,
@@ -78,7 +87,8 @@ using RequestParams= std::variant<
 	Requests::Complete,
 	Requests::SignatureHelp,
 	Requests::Highlight,
-	Requests::Rename >;
+	Requests::Rename,
+	Requests::WorkspaceSymbols >;
 
 struct Request
 {
@@ -36,6 +36,33 @@ inline cl::opt<uint32_t> num_threads(
 	cl::Optional,
 	cl::cat(options_category) );
 
+inline cl::opt<uint32_t> max_compiled_documents(
+	"max-compiled-documents",
+	cl::desc("Maximum number of documents with compiled state kept in memory. States of least recently used documents are released and restored in background on demand. Until restoring is finished, requests for such documents are answered only using the background index (if it is enabled). Default is 0 - no limit."),
+	cl::value_desc("non-negative whole number"),
+	cl::init(0),
+	cl::cat(options_category) );
+
+inline cl::opt<bool> background_index(
+	"background-index",
+	cl::desc("Index all source files of known workspaces in background. This allows to find references, definitions and symbols in files, which are not opened. Indexing builds each workspace file, which takes significant CPU time after start and memory for the index, so, it's disabled by default."),
+	cl::init(false),
+	cl::cat(options_category) );
+
+inline cl::opt<std::string> index_dir(
+	"index-dir",
+	cl::desc("Directory for storing the background index. Stored index is reused after restart for unchanged files. If not specified, the index is kept only in memory."),
+	cl::value_desc("dir"),
+	cl::Optional,
+	cl::cat(options_category) );
+
+inline cl::opt<uint32_t> index_threads(
+	"index-threads",
+	cl::desc("Number of threads for background indexing."),
+	cl::value_desc("positive whole number"),
+	cl::init(1),
+	cl::cat(options_category) );
+
 inline cl::list<std::string> build_dir(
 	"build-dir",
 	cl::Prefix,
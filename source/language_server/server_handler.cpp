@@ -190,6 +190,19 @@ RequestParams ParseTextDocumentRename( const Json::Value& params )
 	return Requests::Rename{ std::move( *position_in_document ), new_name->str() };
 }
 
+RequestParams ParseWorkspaceSymbol( const Json::Value& params )
+{
+	const auto obj= params.getAsObject();
+	if( obj == nullptr )
+		return InvalidParams{ "Not an object!" };
+
+	const auto query= obj->getString( "query" );
+	if( query == std::nullopt )
+		return InvalidParams{ "No query!" };
+
+	return Requests::WorkspaceSymbols{ query->str() };
+}
+
 RequestParams ParseRequestParams( const std::string_view method, const Json::Value& params )
 {
 	if( method == "initialize" )
@@ -210,6 +223,8 @@ RequestParams ParseRequestParams( const std::string_view method, const Json::Val
 		return ParseTextDocumentHighlight( params );
 	if( method == "textDocument/rename" )
 		return ParseTextDocumentRename( params );
+	if( method == "workspace/symbol" )
+		return ParseWorkspaceSymbol( params );
 
 	return MethodNotFound{ std::string(method) };
 }
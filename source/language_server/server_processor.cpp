@@ -18,6 +18,7 @@ enum class ErrorCode : int32_t
 	MethodNotFound = -32601,
 	InvalidParams = -32602,
 	InternalError = -32603,
+	RequestCancelled = -32800,
 	RequestFailed = -32803,
 };
 
@@ -170,6 +171,17 @@ ServerProcessor::ServerResponse ServerProcessor::HandleRequestImpl( const Method
 	return ServerResponse( Json::Object(), Json::Value(std::move(error)) );
 }
 
+ServerProcessor::ServerResponse ServerProcessor::HandleRequestImpl( const RequestCancelled& request_cancelled )
+{
+	(void)request_cancelled;
+
+	// Client still expects a response for a cancelled request.
+	Json::Object error;
+	error["code"]= int32_t(ErrorCode::RequestCancelled);
+	error["message"]= "Request was cancelled.";
+	return ServerResponse( Json::Value(nullptr), Json::Value(std::move(error)) );
+}
+
 ServerProcessor::ServerResponse ServerProcessor::HandleRequestImpl( const Requests::Initialize& initiailize )
 {
 	(void)initiailize;
@@ -185,6 +197,7 @@ ServerProcessor::ServerResponse ServerProcessor::HandleRequestImpl( const Reques
 		capabilities["documentHighlightProvider"]= true;
 		capabilities["documentSymbolProvider"]= true;
 		capabilities["renameProvider"]= true;
+		capabilities["workspaceSymbolProvider"]= true;
 
 		{
 			Json::Object link_provider;
@@ -397,6 +410,29 @@ ServerProcessor::ServerResponse ServerProcessor::HandleRequestImpl( const Reques
 	return result;
 }
 
+ServerProcessor::ServerResponse ServerProcessor::HandleRequestImpl( const Requests::WorkspaceSymbols& workspace_symbols )
+{
+	Json::Array result;
+
+	for( const WorkspaceSymbol& symbol : document_manager_.GetWorkspaceSymbols( workspace_symbols.query ) )
+	{
+		Json::Object out_location;
+		out_location["range"]= DocumentRangeToJson( symbol.location.range );
+		out_location["uri"]= symbol.location.uri.ToString();
+
+		Json::Object out_symbol;
+		out_symbol["name"]= symbol.name;
+		out_symbol["kind"]= int32_t(symbol.kind);
+		out_symbol["location"]= std::move(out_location);
+		if( !symbol.container_name.empty() )
+			out_symbol["containerName"]= symbol.container_name;
+
+		result.push_back( std::move(out_symbol) );
+	}
+
+	return result;
+}
+
 void ServerProcessor::HandleNotificationImpl( const InvalidParams& invalid_params )
 {
 	log_() << "Invalid params: " << invalid_params.message << std::endl;
@@ -457,13 +493,15 @@ void ServerProcessor::HandleNotificationImpl( const Notifications::TextDocumentW
 
 void ServerProcessor::HandleNotificationImpl( const Notifications::TextDocumentDidSave& text_document_did_save )
 {
-	// There is no reason for now to handle this notification somehow.
 	log_() << "Did save document " << text_document_did_save.uri.ToString() << std::endl;
+
+	document_manager_.OnDocumentSaved( text_document_did_save.uri );
 }
 
 void ServerProcessor::HandleNotificationImpl( const Notifications::CancelRequest& cancel_request )
 {
 	// Assume that cancellation is performing before this handler - in messages queue itself.
+	// Requests are processed synchronously, so, there is no way to cancel a request, which is already started.
 	(void)cancel_request;
 }
 
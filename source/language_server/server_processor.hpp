@@ -62,6 +62,7 @@ private:
 	// Requests.
 	ServerResponse HandleRequestImpl( const InvalidParams& invalid_params );
 	ServerResponse HandleRequestImpl( const MethodNotFound& method_not_fund );
+	ServerResponse HandleRequestImpl( const RequestCancelled& request_cancelled );
 	ServerResponse HandleRequestImpl( const Requests::Initialize& initiailize );
 	ServerResponse HandleRequestImpl( const Requests::Shutdown& shutdown );
 	ServerResponse HandleRequestImpl( const Requests::Symbols& symbols );
@@ -71,6 +72,7 @@ private:
 	ServerResponse HandleRequestImpl( const Requests::SignatureHelp& signature_help );
 	ServerResponse HandleRequestImpl( const Requests::Highlight& highlight );
 	ServerResponse HandleRequestImpl( const Requests::Rename& rename );
+	ServerResponse HandleRequestImpl( const Requests::WorkspaceSymbols& workspace_symbols );
 
 	// Notifications.
 	void HandleNotificationImpl( const InvalidParams& invalid_params );
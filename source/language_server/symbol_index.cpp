@@ -0,0 +1,717 @@
+#include "../code_builder_lib_common/push_disable_llvm_warnings.hpp"
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/raw_ostream.h>
+#include "../code_builder_lib_common/pop_llvm_warnings.hpp"
+
+#include "../code_builder_lib_common/long_stable_hash.hpp"
+#include "../compilers_support_lib/file_utils.hpp"
+#include "document_position_utils.hpp"
+#include "json.hpp"
+#include "symbol_index.hpp"
+
+namespace U
+{
+
+namespace LangServer
+{
+
+namespace
+{
+
+namespace fs= llvm::sys::fs;
+namespace fsp= llvm::sys::path;
+
+using fs_path= llvm::SmallString<256>;
+
+// Increase it each time entries format or contents are changed.
+constexpr uint32_t c_storage_format_version= 1;
+
+const llvm::StringRef c_entry_file_extension= ".usi";
+
+// Release syntax analysis results of imports each time so many entries were built.
+constexpr uint32_t c_syntax_analysis_results_release_period= 32;
+
+std::string CalculateOptionsHash( const DocumentBuildOptions& build_options )
+{
+	std::string str;
+	str+= std::to_string( c_storage_format_version );
+	str+= "\n";
+	str+= build_options.target_triple.str();
+	str+= "\n";
+	str+= build_options.data_layout.getStringRepresentation();
+	str+= "\n";
+	str+= build_options.prelude;
+	return CalculateLongStableHash( str );
+}
+
+struct LoadedFile
+{
+	IVfs::FileContentBufferPtr content;
+	LineToLinearPositionIndex line_to_linear_position_index;
+};
+
+// Store ranges as plain arrays in order to reduce index files size.
+void DocumentRangeToJson( const DocumentRange& range, Json::Array& out )
+{
+	out.push_back( range.start.line );
+	out.push_back( range.start.character );
+	out.push_back( range.end.line );
+	out.push_back( range.end.character );
+}
+
+std::optional<uint32_t> JsonToUint32( const Json::Value& value )
+{
+	const auto i= value.getAsInteger();
+	if( i == std::nullopt || *i < 0 || *i > int64_t(std::numeric_limits<uint32_t>::max()) )
+		return std::nullopt;
+	return uint32_t(*i);
+}
+
+std::optional<DocumentRange> JsonToDocumentRange( const Json::Array& arr, const size_t offset )
+{
+	if( arr.size() < offset + 4 )
+		return std::nullopt;
+
+	const auto start_line= JsonToUint32( arr[offset + 0] );
+	const auto start_character= JsonToUint32( arr[offset + 1] );
+	const auto end_line= JsonToUint32( arr[offset + 2] );
+	const auto end_character= JsonToUint32( arr[offset + 3] );
+	if( start_line == std::nullopt || start_character == std::nullopt || end_line == std::nullopt || end_character == std::nullopt )
+		return std::nullopt;
+
+	return DocumentRange{ { *start_line, *start_character }, { *end_line, *end_character } };
+}
+
+bool RangeContainsPosition( const DocumentRange& range, const DocumentPosition& position )
+{
+	return !( position < range.start ) && !( range.end < position );
+}
+
+} // namespace
+
+SymbolIndex::SymbolIndex( Logger& log, DocumentBuildOptions build_options, std::string storage_directory, const uint32_t num_threads )
+	: log_(log)
+	, build_options_(std::move(build_options))
+	, storage_directory_(std::move(storage_directory))
+	, options_hash_( CalculateOptionsHash( build_options_ ) )
+	, syntax_analysis_results_interner_( std::make_shared<SyntaxAnalysisResultsInterner>() )
+	, thread_pool_( llvm::hardware_concurrency( std::max( num_threads, 1u ) ) )
+{
+	log_() << "Create symbol index with " << thread_pool_.getThreadCount() << " threads";
+	if( !storage_directory_.empty() )
+		log_() << ", storage directory \"" << storage_directory_ << "\"";
+	log_() << std::endl;
+}
+
+SymbolIndex::~SymbolIndex()
+{
+	// Skip all pending tasks, wait only for running ones.
+	shutting_down_= true;
+	thread_pool_.wait();
+}
+
+void SymbolIndex::ScheduleIndexing( const IVfs::Path& file_path, IVfsSharedPtr vfs )
+{
+	{
+		const std::lock_guard<std::mutex> lock( mutex_ );
+		if( !scheduled_files_.insert( file_path ).second )
+			return;
+	}
+
+	thread_pool_.async(
+		[this, file_path, vfs= std::move(vfs)]
+		{
+			IndexFile( file_path, vfs );
+		} );
+}
+
+void SymbolIndex::ScheduleDirectoryIndexing( const std::string& directory_path, IVfsSharedPtr vfs )
+{
+	thread_pool_.async(
+		[this, directory_path, vfs= std::move(vfs)]
+		{
+			IndexDirectory( directory_path, vfs );
+		} );
+}
+
+bool SymbolIndex::IsIndexableFile( const llvm::StringRef file_path )
+{
+	const llvm::StringRef extension= fsp::extension( file_path );
+	return extension == ".u" || extension == ".iu";
+}
+
+std::vector<IVfs::Path> SymbolIndex::GetDependentFiles( const IVfs::Path& file_path ) const
+{
+	std::vector<IVfs::Path> result;
+
+	const std::lock_guard<std::mutex> lock( mutex_ );
+	for( const auto& entry_pair : entries_ )
+	{
+		for( const DependencyFile& dependency_file : entry_pair.second->dependency_files )
+		{
+			if( dependency_file.file_path == file_path )
+			{
+				result.push_back( entry_pair.first );
+				break;
+			}
+		}
+	}
+
+	std::sort( result.begin(), result.end() );
+	return result;
+}
+
+void SymbolIndex::WaitForIndexing()
+{
+	thread_pool_.wait();
+}
+
+std::optional<RangeInDocument> SymbolIndex::GetDefinitionPoint( const PositionInDocument& position ) const
+{
+	const std::optional<std::string> file_path= position.uri.AsFilePath();
+	if( file_path == std::nullopt )
+		return std::nullopt;
+
+	const std::lock_guard<std::mutex> lock( mutex_ );
+
+	const std::optional<DefinitionKey> definition= FindDefinition( *file_path, position.position );
+	if( definition == std::nullopt )
+		return std::nullopt;
+
+	return RangeInDocument{ definition->range, Uri::FromFilePath( definition->file_path ) };
+}
+
+std::vector<RangeInDocument> SymbolIndex::GetAllOccurrences( const PositionInDocument& position ) const
+{
+	const std::optional<std::string> file_path= position.uri.AsFilePath();
+	if( file_path == std::nullopt )
+		return {};
+
+	std::vector< std::pair<IVfs::Path, DocumentRange> > occurrences;
+	{
+		const std::lock_guard<std::mutex> lock( mutex_ );
+
+		const std::optional<DefinitionKey> definition= FindDefinition( *file_path, position.position );
+		if( definition == std::nullopt )
+			return {};
+
+		occurrences.emplace_back( definition->file_path, definition->range );
+
+		for( const auto& entry_pair : entries_ )
+		{
+			const Entry& entry= *entry_pair.second;
+			for( const Link& link : entry.links )
+			{
+				if( link.definition.range == definition->range && entry.files[ link.definition.file_index ] == definition->file_path )
+					occurrences.emplace_back( entry_pair.first, link.usage_range );
+			}
+		}
+	}
+
+	// Remove duplicates - definition point itself may be recorded as usage.
+	std::sort( occurrences.begin(), occurrences.end() );
+	occurrences.erase( std::unique( occurrences.begin(), occurrences.end() ), occurrences.end() );
+
+	std::vector<RangeInDocument> result;
+	result.reserve( occurrences.size() );
+	for( const auto& occurrence : occurrences )
+		result.push_back( RangeInDocument{ occurrence.second, Uri::FromFilePath( occurrence.first ) } );
+
+	return result;
+}
+
+std::vector<WorkspaceSymbol> SymbolIndex::FindSymbols( const std::string_view query, const size_t max_result_size ) const
+{
+	const std::string query_lower= llvm::StringRef( query ).lower();
+
+	std::vector<WorkspaceSymbol> result;
+	{
+		const std::lock_guard<std::mutex> lock( mutex_ );
+		for( const auto& entry_pair : entries_ )
+		{
+			for( const EntrySymbol& symbol : entry_pair.second->symbols )
+			{
+				if( !query_lower.empty() && llvm::StringRef( symbol.name ).lower().find( query_lower ) == std::string::npos )
+					continue;
+
+				WorkspaceSymbol out_symbol;
+				out_symbol.name= symbol.name;
+				out_symbol.container_name= symbol.container_name;
+				out_symbol.kind= symbol.kind;
+				out_symbol.location= RangeInDocument{ symbol.range, Uri::FromFilePath( entry_pair.first ) };
+				result.push_back( std::move(out_symbol) );
+			}
+		}
+	}
+
+	// Make result deterministic - sort it by name, than by location.
+	std::sort(
+		result.begin(), result.end(),
+		[]( const WorkspaceSymbol& l, const WorkspaceSymbol& r )
+		{
+			return
+				std::tie( l.name, l.location.uri, l.location.range ) <
+				std::tie( r.name, r.location.uri, r.location.range );
+		} );
+
+	if( result.size() > max_result_size )
+		result.resize( max_result_size );
+
+	return result;
+}
+
+void SymbolIndex::IndexFile( const IVfs::Path& file_path, const IVfsSharedPtr& vfs )
+{
+	// Remove scheduling mark before indexing itself, in order to allow scheduling again, if file is changed during indexing.
+	{
+		const std::lock_guard<std::mutex> lock( mutex_ );
+		scheduled_files_.erase( file_path );
+	}
+
+	if( shutting_down_ )
+		return;
+
+	EntryPtr entry= TryLoadEntryFromStorage( file_path, *vfs );
+	if( entry == nullptr )
+	{
+		entry= BuildEntry( file_path, vfs );
+		if( entry != nullptr && !storage_directory_.empty() )
+			StoreEntry( file_path, *entry );
+	}
+
+	const std::lock_guard<std::mutex> lock( mutex_ );
+	if( entry == nullptr )
+		entries_.erase( file_path );
+	else
+		entries_[ file_path ]= std::move(entry);
+}
+
+void SymbolIndex::IndexDirectory( const std::string& directory_path, const IVfsSharedPtr& vfs )
+{
+	log_() << "Search files for indexing in directory \"" << directory_path << "\"" << std::endl;
+
+	size_t num_files= 0;
+	std::error_code ec;
+	for( fs::recursive_directory_iterator it( directory_path, ec ), it_end; it != it_end && !ec; it.increment( ec ) )
+	{
+		if( shutting_down_ )
+			return;
+
+		if( it->type() != fs::file_type::regular_file || !IsIndexableFile( it->path() ) )
+			continue;
+
+		ScheduleIndexing( vfs->GetFullFilePath( it->path(), "" ), vfs );
+		++num_files;
+	}
+
+	log_() << "Scheduled indexing of " << num_files << " files in directory \"" << directory_path << "\"" << std::endl;
+}
+
+SymbolIndex::EntryPtr SymbolIndex::BuildEntry( const IVfs::Path& file_path, const IVfsSharedPtr& vfs )
+{
+	log_() << "Index file " << file_path << std::endl;
+
+	SourceGraph source_graph=
+		LoadSourceGraph( *vfs, CalculateLongStableHash, file_path, build_options_.prelude, nullptr, syntax_analysis_results_interner_.get() );
+
+	if( ( ++num_built_entries_ ) % c_syntax_analysis_results_release_period == 0 )
+		syntax_analysis_results_interner_->RemoveUnusedEntries();
+
+	if( source_graph.nodes_storage.empty() || source_graph.nodes_storage.front().ast == nullptr )
+	{
+		log_() << "Failed to load file " << file_path << " for indexing" << std::endl;
+		return nullptr;
+	}
+
+	auto entry= std::make_shared<Entry>();
+
+	// Load contents of all files (except prelude) in order to calculate ranges and content hashes.
+	// Map source graph nodes to entry files.
+	std::vector<std::optional<LoadedFile>> loaded_files;
+	std::vector<std::optional<uint32_t>> node_index_to_file_index;
+	loaded_files.resize( source_graph.nodes_storage.size() );
+	node_index_to_file_index.resize( source_graph.nodes_storage.size() );
+	for( size_t i= 0; i < source_graph.nodes_storage.size(); ++i )
+	{
+		const SourceGraph::Node& node= source_graph.nodes_storage[i];
+		if( node.category == SourceGraph::Node::Category::BuiltInPrelude )
+			continue;
+
+		const std::optional<FileStatus> status_before_loading= GetFileStatus( node.file_path );
+		IVfs::FileContentBufferPtr content= vfs->LoadFileContentBuffer( node.file_path );
+		if( content == nullptr )
+		{
+			if( i == 0 )
+				return nullptr;
+			continue;
+		}
+
+		entry->dependency_files.push_back( DependencyFile{ node.file_path, GetFileContentHash( node.file_path, content->GetContent(), status_before_loading ) } );
+
+		LoadedFile loaded_file;
+		loaded_file.line_to_linear_position_index= BuildLineToLinearPositionIndex( content->GetContent() );
+		loaded_file.content= std::move(content);
+		loaded_files[i]= std::move(loaded_file);
+
+		node_index_to_file_index[i]= uint32_t( entry->files.size() );
+		entry->files.push_back( node.file_path );
+	}
+
+	const LoadedFile& root_file= *loaded_files.front();
+
+	{
+		const Symbols symbols=
+			BuildSymbols(
+				*source_graph.nodes_storage.front().ast,
+				[&]( const SrcLoc& src_loc )
+				{
+					return SrcLocToDocumentIdentifierRange( src_loc, root_file.content->GetContent(), root_file.line_to_linear_position_index );
+				} );
+
+		CollectEntrySymbols( symbols, "", entry->symbols );
+	}
+
+	// Record only symbols for files with errors. Do not build code in such case, like it's done for documents.
+	bool has_errors= !source_graph.errors.empty();
+	for( const SourceGraph::Node& node : source_graph.nodes_storage )
+		has_errors|= node.ast == nullptr || !node.ast->error_messages.empty();
+
+	if( has_errors || shutting_down_ )
+		return entry;
+
+	std::vector< std::pair<SrcLoc, SrcLoc> > definition_points;
+	{
+		// Use the same options as for documents.
+		CodeBuilderOptions options;
+		options.build_debug_info= false;
+		options.create_lifetimes= false;
+		options.generate_lifetime_start_end_debug_calls= false;
+		options.generate_tbaa_metadata= false;
+		options.report_about_unused_names= false;
+		options.collect_definition_points= true;
+		options.skip_building_generated_functions= true;
+
+		llvm::LLVMContext llvm_context;
+
+		const auto code_builder=
+			CodeBuilder::BuildProgramAndLeaveInternalState(
+				llvm_context,
+				build_options_.data_layout,
+				build_options_.target_triple,
+				options,
+				std::make_shared<const SourceGraph>( std::move(source_graph) ),
+				vfs );
+
+		definition_points= code_builder->GetAllDefinitionPoints();
+	}
+
+	for( const auto& definition_point : definition_points )
+	{
+		const SrcLoc& usage_src_loc= definition_point.first;
+		const SrcLoc& definition_src_loc= definition_point.second;
+
+		// Record usages only in the root file - other files are indexed separately.
+		if( usage_src_loc.GetFileIndex() != 0 )
+			continue;
+
+		const uint32_t definition_node_index= definition_src_loc.GetFileIndex();
+		if( definition_node_index >= node_index_to_file_index.size() || node_index_to_file_index[ definition_node_index ] == std::nullopt )
+			continue; // Prelude or failed to load file.
+
+		const LoadedFile& definition_file= *loaded_files[ definition_node_index ];
+
+		const std::optional<DocumentRange> usage_range=
+			SrcLocToDocumentIdentifierRange( usage_src_loc, root_file.content->GetContent(), root_file.line_to_linear_position_index );
+		const std::optional<DocumentRange> definition_range=
+			SrcLocToDocumentIdentifierRange( definition_src_loc, definition_file.content->GetContent(), definition_file.line_to_linear_position_index );
+		if( usage_range == std::nullopt || definition_range == std::nullopt )
+			continue;
+
+		entry->links.push_back( Link{ *usage_range, EntryLocation{ *node_index_to_file_index[ definition_node_index ], *definition_range } } );
+	}
+
+	std::sort(
+		entry->links.begin(), entry->links.end(),
+		[]( const Link& l, const Link& r ) { return l.usage_range < r.usage_range; } );
+
+	return entry;
+}
+
+SymbolIndex::EntryPtr SymbolIndex::TryLoadEntryFromStorage( const IVfs::Path& file_path, IVfs& vfs )
+{
+	if( storage_directory_.empty() )
+		return nullptr;
+
+	const llvm::ErrorOr< std::unique_ptr<llvm::MemoryBuffer> > file_mapped=
+		llvm::MemoryBuffer::getFile( GetStorageEntryPath( file_path ), /* IsText */ true, /* RequiresNullTerminator */ false );
+	if( !file_mapped || *file_mapped == nullptr )
+		return nullptr;
+
+	llvm::Expected<Json::Value> json_parsed= Json::parse( (*file_mapped)->getBuffer() );
+	if( !json_parsed )
+	{
+		llvm::consumeError( json_parsed.takeError() );
+		return nullptr;
+	}
+
+	const Json::Object* const root= json_parsed->getAsObject();
+	if( root == nullptr )
+		return nullptr;
+
+	// Entry is valid only if it was created with the same options for the same file and all used files are unchanged.
+	if( root->getString( "options_hash" ) != llvm::StringRef( options_hash_ ) )
+		return nullptr;
+
+	const Json::Array* const files= root->getArray( "files" );
+	const Json::Array* const dependency_files= root->getArray( "dependency_files" );
+	const Json::Array* const links= root->getArray( "links" );
+	const Json::Array* const symbols= root->getArray( "symbols" );
+	if( files == nullptr || dependency_files == nullptr || links == nullptr || symbols == nullptr )
+		return nullptr;
+
+	auto entry= std::make_shared<Entry>();
+
+	for( const Json::Value& file : *files )
+	{
+		const auto file_str= file.getAsString();
+		if( file_str == std::nullopt )
+			return nullptr;
+		entry->files.push_back( file_str->str() );
+	}
+
+	if( entry->files.empty() || entry->files.front() != file_path )
+		return nullptr;
+
+	for( const Json::Value& dependency_file : *dependency_files )
+	{
+		const Json::Object* const dependency_file_obj= dependency_file.getAsObject();
+		if( dependency_file_obj == nullptr )
+			return nullptr;
+
+		const auto dependency_file_path= dependency_file_obj->getString( "path" );
+		const auto content_hash= dependency_file_obj->getString( "hash" );
+		if( dependency_file_path == std::nullopt || content_hash == std::nullopt )
+			return nullptr;
+
+		const std::optional<std::string> actual_content_hash= GetFileContentHash( dependency_file_path->str(), vfs );
+		if( actual_content_hash == std::nullopt || *actual_content_hash != *content_hash )
+			return nullptr; // File was changed or removed.
+
+		entry->dependency_files.push_back( DependencyFile{ dependency_file_path->str(), content_hash->str() } );
+	}
+
+	for( const Json::Value& link : *links )
+	{
+		const Json::Array* const link_arr= link.getAsArray();
+		if( link_arr == nullptr || link_arr->size() != 9 )
+			return nullptr;
+
+		const std::optional<DocumentRange> usage_range= JsonToDocumentRange( *link_arr, 0 );
+		const std::optional<uint32_t> definition_file_index= JsonToUint32( (*link_arr)[4] );
+		const std::optional<DocumentRange> definition_range= JsonToDocumentRange( *link_arr, 5 );
+		if( usage_range == std::nullopt || definition_file_index == std::nullopt || definition_range == std::nullopt ||
+			*definition_file_index >= entry->files.size() )
+			return nullptr;
+
+		entry->links.push_back( Link{ *usage_range, EntryLocation{ *definition_file_index, *definition_range } } );
+	}
+
+	for( const Json::Value& symbol : *symbols )
+	{
+		const Json::Object* const symbol_obj= symbol.getAsObject();
+		if( symbol_obj == nullptr )
+			return nullptr;
+
+		const auto name= symbol_obj->getString( "name" );
+		const auto container_name= symbol_obj->getString( "container" );
+		const auto kind= symbol_obj->getInteger( "kind" );
+		const Json::Array* const range_arr= symbol_obj->getArray( "range" );
+		if( name == std::nullopt || container_name == std::nullopt || kind == std::nullopt || range_arr == nullptr )
+			return nullptr;
+
+		const std::optional<DocumentRange> range= JsonToDocumentRange( *range_arr, 0 );
+		if( range == std::nullopt )
+			return nullptr;
+
+		EntrySymbol entry_symbol;
+		entry_symbol.name= name->str();
+		entry_symbol.container_name= container_name->str();
+		entry_symbol.kind= SymbolKind( *kind );
+		entry_symbol.range= *range;
+		entry->symbols.push_back( std::move(entry_symbol) );
+	}
+
+	log_() << "Loaded index of file " << file_path << " from storage" << std::endl;
+
+	return entry;
+}
+
+void SymbolIndex::StoreEntry( const IVfs::Path& file_path, const Entry& entry )
+{
+	Json::Object root;
+	root["options_hash"]= options_hash_;
+
+	{
+		Json::Array files;
+		for( const IVfs::Path& file : entry.files )
+			files.push_back( file );
+		root["files"]= std::move(files);
+	}
+	{
+		Json::Array dependency_files;
+		for( const DependencyFile& dependency_file : entry.dependency_files )
+		{
+			Json::Object dependency_file_obj;
+			dependency_file_obj["path"]= dependency_file.file_path;
+			dependency_file_obj["hash"]= dependency_file.content_hash;
+			dependency_files.push_back( std::move(dependency_file_obj) );
+		}
+		root["dependency_files"]= std::move(dependency_files);
+	}
+	{
+		Json::Array links;
+		for( const Link& link : entry.links )
+		{
+			Json::Array link_arr;
+			DocumentRangeToJson( link.usage_range, link_arr );
+			link_arr.push_back( link.definition.file_index );
+			DocumentRangeToJson( link.definition.range, link_arr );
+			links.push_back( std::move(link_arr) );
+		}
+		root["links"]= std::move(links);
+	}
+	{
+		Json::Array symbols;
+		for( const EntrySymbol& symbol : entry.symbols )
+		{
+			Json::Object symbol_obj;
+			symbol_obj["name"]= symbol.name;
+			symbol_obj["container"]= symbol.container_name;
+			symbol_obj["kind"]= int32_t(symbol.kind);
+
+			Json::Array range_arr;
+			DocumentRangeToJson( symbol.range, range_arr );
+			symbol_obj["range"]= std::move(range_arr);
+
+			symbols.push_back( std::move(symbol_obj) );
+		}
+		root["symbols"]= std::move(symbols);
+	}
+
+	std::string data;
+	llvm::raw_string_ostream stream( data );
+	stream << Json::Value( std::move(root) );
+	stream.flush();
+
+	if( !WriteFileAtomically( GetStorageEntryPath( file_path ), data ) )
+		log_() << "Failed to write symbol index file for " << file_path << std::endl;
+}
+
+std::string SymbolIndex::GetFileContentHash(
+	const IVfs::Path& file_path,
+	const std::string_view content,
+	const std::optional<FileStatus>& status_before_loading )
+{
+	std::string content_hash= CalculateLongStableHash( content );
+
+	// Remember hash in order to avoid reading this file again while it's unchanged.
+	// Do this only if file wasn't changed during loading, since otherwise hash of old content may be associated with status of new content.
+	if( status_before_loading != std::nullopt && GetFileStatus( file_path ) == status_before_loading )
+	{
+		const std::lock_guard<std::mutex> lock( file_hash_cache_mutex_ );
+		file_hash_cache_[ file_path ]= FileHashCacheItem{ *status_before_loading, content_hash };
+	}
+
+	return content_hash;
+}
+
+std::optional<std::string> SymbolIndex::GetFileContentHash( const IVfs::Path& file_path, IVfs& vfs )
+{
+	const std::optional<FileStatus> status= GetFileStatus( file_path );
+	if( status != std::nullopt )
+	{
+		const std::lock_guard<std::mutex> lock( file_hash_cache_mutex_ );
+		if( const auto it= file_hash_cache_.find( file_path ); it != file_hash_cache_.end() && it->second.status == *status )
+			return it->second.content_hash;
+	}
+
+	const IVfs::FileContentBufferPtr content= vfs.LoadFileContentBuffer( file_path );
+	if( content == nullptr )
+		return std::nullopt;
+
+	return GetFileContentHash( file_path, content->GetContent(), status );
+}
+
+std::string SymbolIndex::GetStorageEntryPath( const IVfs::Path& file_path ) const
+{
+	fs_path result( storage_directory_ );
+	fsp::append( result, CalculateLongStableHash( file_path ) + c_entry_file_extension );
+	return result.str().str();
+}
+
+std::optional<SymbolIndex::FileStatus> SymbolIndex::GetFileStatus( const IVfs::Path& file_path )
+{
+	fs::file_status status;
+	if( fs::status( file_path, status ) )
+		return std::nullopt;
+
+	return FileStatus{ status.getLastModificationTime(), status.getSize() };
+}
+
+std::optional<SymbolIndex::DefinitionKey> SymbolIndex::FindDefinition( const IVfs::Path& file_path, const DocumentPosition& position ) const
+{
+	// First search for usage in the entry of given file.
+	if( const auto it= entries_.find( file_path ); it != entries_.end() )
+	{
+		const Entry& entry= *it->second;
+
+		// Links are sorted by usage range, so, find the last link starting not after given position.
+		const auto link_it=
+			std::upper_bound(
+				entry.links.begin(), entry.links.end(),
+				position,
+				[]( const DocumentPosition& p, const Link& link ) { return p < link.usage_range.start; } );
+		if( link_it != entry.links.begin() )
+		{
+			const Link& link= *std::prev( link_it );
+			if( RangeContainsPosition( link.usage_range, position ) )
+				return DefinitionKey{ entry.files[ link.definition.file_index ], link.definition.range };
+		}
+	}
+
+	// Given position may be a definition itself. Search for it in all entries.
+	for( const auto& entry_pair : entries_ )
+	{
+		const Entry& entry= *entry_pair.second;
+		for( const Link& link : entry.links )
+		{
+			if( RangeContainsPosition( link.definition.range, position ) && entry.files[ link.definition.file_index ] == file_path )
+				return DefinitionKey{ file_path, link.definition.range };
+		}
+	}
+
+	return std::nullopt;
+}
+
+void SymbolIndex::CollectEntrySymbols( const Symbols& symbols, const std::string& container_name, std::vector<EntrySymbol>& out_symbols )
+{
+	for( const Symbol& symbol : symbols )
+	{
+		EntrySymbol entry_symbol;
+		entry_symbol.name= symbol.name;
+		entry_symbol.container_name= container_name;
+		entry_symbol.kind= symbol.kind;
+		entry_symbol.range= symbol.selection_range;
+		out_symbols.push_back( std::move(entry_symbol) );
+
+		if( !symbol.children.empty() )
+			CollectEntrySymbols( symbol.children, container_name.empty() ? symbol.name : ( container_name + "::" + symbol.name ), out_symbols );
+	}
+}
+
+} // namespace LangServer
+
+} // namespace U
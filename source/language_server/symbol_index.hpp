@@ -0,0 +1,180 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include "../code_builder_lib_common/push_disable_llvm_warnings.hpp"
+#include <llvm/Support/Chrono.h>
+#include <llvm/Support/ThreadPool.h>
+#include "../code_builder_lib_common/pop_llvm_warnings.hpp"
+#include "document.hpp"
+
+namespace U
+{
+
+namespace LangServer
+{
+
+struct WorkspaceSymbol
+{
+	std::string name;
+	std::string container_name;
+	SymbolKind kind= SymbolKind::None;
+	RangeInDocument location;
+};
+
+// Workspace-wide index of symbols definitions and usages.
+// It is filled in background - each indexed file is built as a root of its own source graph and collected definition points are recorded.
+// Usages are recorded only for root files (each workspace file is indexed itself), definitions may be located in any imported file.
+// Ranges are recorded for files contents at indexing time, so, unsaved changes of opened documents aren't reflected here.
+// If storage directory is specified, index entries are stored there and are reused (after restart) if all files used for building an entry are unchanged.
+// All public methods are thread-safe. Queries don't require any compiled state.
+class SymbolIndex
+{
+public:
+	// Logger should live long enough!
+	// Storage directory may be empty - in such case index is kept only in memory.
+	SymbolIndex( Logger& log, DocumentBuildOptions build_options, std::string storage_directory, uint32_t num_threads );
+	~SymbolIndex();
+
+	SymbolIndex( const SymbolIndex& )= delete;
+	SymbolIndex& operator=( const SymbolIndex& )= delete;
+
+public:
+	// Schedule (re)indexing of given file in background. VFS must be thread-safe.
+	// Does nothing if this file is already scheduled.
+	void ScheduleIndexing( const IVfs::Path& file_path, IVfsSharedPtr vfs );
+
+	// Schedule indexing of all source files in given directory (recursively). Given VFS is used for all these files.
+	// Directory traversal itself is performed in background too, since it may be slow for large directories.
+	void ScheduleDirectoryIndexing( const std::string& directory_path, IVfsSharedPtr vfs );
+
+	static bool IsIndexableFile( llvm::StringRef file_path );
+
+	// Get list of indexed files, entries of which depend on given file (including this file itself).
+	std::vector<IVfs::Path> GetDependentFiles( const IVfs::Path& file_path ) const;
+
+	// Wait synchronously until all scheduled indexing tasks are finished. Use only in tests.
+	void WaitForIndexing();
+
+public: // Queries.
+	std::optional<RangeInDocument> GetDefinitionPoint( const PositionInDocument& position ) const;
+
+	// Returns definition point and all usages points. Result is sorted.
+	std::vector<RangeInDocument> GetAllOccurrences( const PositionInDocument& position ) const;
+
+	// Search symbols with names containing given query (case-insensitive). Empty query matches all symbols.
+	std::vector<WorkspaceSymbol> FindSymbols( std::string_view query, size_t max_result_size ) const;
+
+private:
+	// Location within index entry. File is specified as index in entry files list.
+	struct EntryLocation
+	{
+		uint32_t file_index= 0;
+		DocumentRange range;
+	};
+
+	struct Link
+	{
+		DocumentRange usage_range; // Always within root file.
+		EntryLocation definition;
+	};
+
+	struct EntrySymbol
+	{
+		std::string name;
+		std::string container_name;
+		SymbolKind kind= SymbolKind::None;
+		DocumentRange range;
+	};
+
+	struct DependencyFile
+	{
+		IVfs::Path file_path;
+		std::string content_hash;
+	};
+
+	struct Entry
+	{
+		// First file is root.
+		std::vector<IVfs::Path> files;
+		// Sorted by usage range.
+		std::vector<Link> links;
+		std::vector<EntrySymbol> symbols;
+		std::vector<DependencyFile> dependency_files;
+	};
+
+	using EntryPtr= std::shared_ptr<const Entry>;
+
+	struct FileStatus
+	{
+		llvm::sys::TimePoint<> modification_time;
+		uint64_t size= 0;
+
+		bool operator==( const FileStatus& other ) const
+		{
+			return modification_time == other.modification_time && size == other.size;
+		}
+	};
+
+	struct FileHashCacheItem
+	{
+		FileStatus status;
+		std::string content_hash;
+	};
+
+	struct DefinitionKey
+	{
+		IVfs::Path file_path;
+		DocumentRange range;
+	};
+
+private:
+	void IndexFile( const IVfs::Path& file_path, const IVfsSharedPtr& vfs );
+	void IndexDirectory( const std::string& directory_path, const IVfsSharedPtr& vfs );
+
+	EntryPtr BuildEntry( const IVfs::Path& file_path, const IVfsSharedPtr& vfs );
+
+	EntryPtr TryLoadEntryFromStorage( const IVfs::Path& file_path, IVfs& vfs );
+	void StoreEntry( const IVfs::Path& file_path, const Entry& entry );
+
+	// File status should be obtained before loading of file content.
+	std::string GetFileContentHash( const IVfs::Path& file_path, std::string_view content, const std::optional<FileStatus>& status_before_loading );
+	std::optional<std::string> GetFileContentHash( const IVfs::Path& file_path, IVfs& vfs );
+
+	std::string GetStorageEntryPath( const IVfs::Path& file_path ) const;
+
+	static std::optional<FileStatus> GetFileStatus( const IVfs::Path& file_path );
+
+	// Requires locked mutex.
+	std::optional<DefinitionKey> FindDefinition( const IVfs::Path& file_path, const DocumentPosition& position ) const;
+
+	static void CollectEntrySymbols( const Symbols& symbols, const std::string& container_name, std::vector<EntrySymbol>& out_symbols );
+
+private:
+	Logger& log_;
+	const DocumentBuildOptions build_options_;
+	const std::string storage_directory_;
+	// Hash of all options affecting entries contents.
+	const std::string options_hash_;
+
+	std::atomic<bool> shutting_down_{ false };
+
+	mutable std::mutex mutex_;
+	std::unordered_map<IVfs::Path, EntryPtr> entries_;
+	std::unordered_set<IVfs::Path> scheduled_files_;
+
+	std::mutex file_hash_cache_mutex_;
+	std::unordered_map<IVfs::Path, FileHashCacheItem> file_hash_cache_;
+
+	// Common for all indexed files. Allows to avoid parsing common imports for each file.
+	const SyntaxAnalysisResultsInternerPtr syntax_analysis_results_interner_;
+	std::atomic<uint32_t> num_built_entries_{ 0 };
+
+	// Should be destroyed first, since tasks access other fields.
+	llvm::ThreadPool thread_pool_;
+};
+
+} // namespace LangServer
+
+} // namespace U
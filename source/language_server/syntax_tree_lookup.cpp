@@ -44,7 +44,7 @@ void FindImplVariant( const std::variant<Args...>& v )
 }
 
 template<typename T>
-void FindImpl( const std::unique_ptr<T>& el )
+void FindImpl( const ArenaPtr<T>& el )
 {
 	if( el == nullptr )
 		return;
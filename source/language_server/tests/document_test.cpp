@@ -44,6 +44,8 @@ DocumentBuildOptions GetTestDocumentBuildOptions()
 
 using DocumentsContainer= std::map<IVfs::Path, Document*>;
 
+// This VFS reads other documents directly, which isn't thread-safe.
+// But it's fine for tests, since they wait synchronously until rebuild is finished.
 class TestVfs final : public IVfs
 {
 public:
@@ -134,7 +136,7 @@ U_TEST( DocumentSetText_Test0 )
 	const auto vfs= std::make_shared<TestVfs>(documents);
 
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	U_TEST_ASSERT( document.GetCurrentText() == "" );
@@ -163,7 +165,7 @@ U_TEST( DocumentUpdateText_Test0 )
 	const auto vfs= std::make_shared<TestVfs>(documents);
 
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "auto x= 0;\nauto y= x;" );
@@ -202,12 +204,49 @@ U_TEST( DocumentUpdateText_Test0 )
 	U_TEST_ASSERT( document.GetCurrentText() == "" );
 }
 
+U_TEST( DocumentSavedTextMapping_Test0 )
+{
+	DocumentsContainer documents;
+	const auto vfs= std::make_shared<TestVfs>(documents);
+
+	const IVfs::Path path= "/test.u";
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
+	documents[path]= &document;
+
+	document.SetText( "fn Foo() {}\nfn Bar() { Foo(); }" );
+
+	// Saved text is unknown.
+	U_TEST_ASSERT( document.MapPositionToSavedText( DocumentPosition{ 2, 12 } ) == std::nullopt );
+
+	document.SetTextIsSaved();
+	U_TEST_ASSERT( document.MapPositionToSavedText( DocumentPosition{ 2, 12 } ) == DocumentPosition( { 2, 12 } ) );
+
+	// Add unsaved line at start.
+	document.UpdateText( DocumentRange{ { 1, 0 }, { 1, 0 } }, "struct S{}\n" );
+	U_TEST_ASSERT( document.MapPositionToSavedText( DocumentPosition{ 3, 12 } ) == DocumentPosition( { 2, 12 } ) );
+	U_TEST_ASSERT( document.MapPositionToSavedText( DocumentPosition{ 1, 3 } ) == std::nullopt ); // Within inserted text.
+	U_TEST_ASSERT( document.MapSavedTextRangeToCurrentText( DocumentRange{ { 1, 3 }, { 1, 6 } } ) == DocumentRange( { { 2, 3 }, { 2, 6 } } ) );
+
+	// Rename "Foo" without saving.
+	document.UpdateText( DocumentRange{ { 2, 3 }, { 2, 6 } }, "FooRenamed" );
+	U_TEST_ASSERT( document.MapPositionToSavedText( DocumentPosition{ 2, 4 } ) == std::nullopt );
+	U_TEST_ASSERT( document.MapSavedTextRangeToCurrentText( DocumentRange{ { 2, 11 }, { 2, 14 } } ) == DocumentRange( { { 3, 11 }, { 3, 14 } } ) );
+
+	// Now current text is saved.
+	document.SetTextIsSaved();
+	U_TEST_ASSERT( document.MapPositionToSavedText( DocumentPosition{ 2, 4 } ) == DocumentPosition( { 2, 4 } ) );
+
+	// Text is completely replaced - it's unknown whether it's saved.
+	document.SetText( "fn Baz() {}" );
+	U_TEST_ASSERT( document.MapSavedTextRangeToCurrentText( DocumentRange{ { 1, 3 }, { 1, 6 } } ) == std::nullopt );
+}
+
 U_TEST( DocumentRebuild_Test0 )
 {
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	U_TEST_ASSERT( document.RebuildFinished() == false );
@@ -224,7 +263,7 @@ U_TEST( DocumentRebuild_Test1 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "auto x= 0;" );
@@ -252,7 +291,7 @@ U_TEST( DocumentRebuild_Test2 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "auto x= 0;" );
@@ -272,12 +311,168 @@ U_TEST( DocumentRebuild_Test2 )
 	U_TEST_ASSERT( document.GetTextForCompilation() == "auto x= 0;" );
 }
 
+U_TEST( DocumentRebuild_Test3 )
+{
+	// If only function bodies were changed, only these functions should be checked, without full rebuild.
+
+	DocumentsContainer documents;
+	const auto vfs= std::make_shared<TestVfs>(documents);
+	const IVfs::Path path= "/test.u";
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, std::make_shared<SyntaxAnalysisResultsInterner>(), g_tests_logger );
+	documents[path]= &document;
+
+	const auto get_diagnostics_lines=
+		[&]
+		{
+			std::vector<uint32_t> lines;
+			const auto it= document.GetDiagnostics().find( Uri::FromFilePath( path ) );
+			if( it != document.GetDiagnostics().end() )
+			{
+				for( const DocumentDiagnostic& diagnostic : it->second )
+					lines.push_back( diagnostic.range.start.line );
+			}
+			std::sort( lines.begin(), lines.end() );
+			return lines;
+		};
+
+	const std::string initial_text= "fn Foo() : i32 { return 0; }\nfn Bar() { auto y= unknown_name; }";
+	document.SetText( initial_text );
+
+	document.StartRebuild( g_tests_thread_pool );
+	document.WaitUntilRebuildFinished();
+	U_TEST_ASSERT( document.RebuildFinished() == true );
+	document.ResetRebuildFinishedFlag();
+	U_TEST_ASSERT( document.GetTextForCompilation() == initial_text );
+	U_TEST_ASSERT( get_diagnostics_lines() == std::vector<uint32_t>{ 2 } );
+
+	// Add an error into body of the first function. Error in the second function should be moved.
+	document.UpdateText( DocumentRange{ { 1, 17 }, { 1, 17 } }, "wrong_name;\n" );
+	document.StartRebuild( g_tests_thread_pool );
+	document.WaitUntilRebuildFinished();
+	U_TEST_ASSERT( document.RebuildFinished() == true );
+	document.ResetRebuildFinishedFlag();
+	U_TEST_ASSERT( document.GetTextForCompilation() == initial_text ); // Compiled state is not changed.
+	U_TEST_ASSERT( get_diagnostics_lines() == ( std::vector<uint32_t>{ 1, 3 } ) );
+
+	// Fix error in the second function.
+	document.UpdateText( DocumentRange{ { 3, 19 }, { 3, 31 } }, "Foo()" );
+	U_TEST_ASSERT( document.GetCurrentText() == "fn Foo() : i32 { wrong_name;\nreturn 0; }\nfn Bar() { auto y= Foo(); }" );
+	document.StartRebuild( g_tests_thread_pool );
+	document.WaitUntilRebuildFinished();
+	document.ResetRebuildFinishedFlag();
+	U_TEST_ASSERT( document.GetTextForCompilation() == initial_text );
+	U_TEST_ASSERT( get_diagnostics_lines() == std::vector<uint32_t>{ 1 } );
+
+	// Change of function signature requires full rebuild.
+	document.UpdateText( DocumentRange{ { 3, 6 }, { 3, 6 } }, "2" );
+	U_TEST_ASSERT( document.GetCurrentText() == "fn Foo() : i32 { wrong_name;\nreturn 0; }\nfn Bar2() { auto y= Foo(); }" );
+	document.StartRebuild( g_tests_thread_pool );
+	document.WaitUntilRebuildFinished();
+	document.ResetRebuildFinishedFlag();
+	U_TEST_ASSERT( document.GetTextForCompilation() == document.GetCurrentText() );
+	U_TEST_ASSERT( get_diagnostics_lines() == std::vector<uint32_t>{ 1 } );
+}
+
+U_TEST( DocumentRebuild_Test4 )
+{
+	// Released compiler state should be restored on demand in background.
+
+	DocumentsContainer documents;
+	const auto vfs= std::make_shared<TestVfs>(documents);
+	const IVfs::Path path= "/test.u";
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, std::make_shared<SyntaxAnalysisResultsInterner>(), g_tests_logger );
+	documents[path]= &document;
+
+	const std::string text= "fn Foo() {}\nfn Bar() { Foo(); }";
+	document.SetText( text );
+
+	document.StartRebuild( g_tests_thread_pool );
+	document.WaitUntilRebuildFinished();
+	document.ResetRebuildFinishedFlag();
+	U_TEST_ASSERT( document.RebuildRequired() == false );
+	U_TEST_ASSERT( document.HasCodeBuilderState() );
+	U_TEST_ASSERT( document.GetDefinitionPoint( DocumentPosition{ 2, 11 } ) != std::nullopt );
+
+	document.ReleaseCodeBuilderState();
+	U_TEST_ASSERT( !document.HasCodeBuilderState() );
+	U_TEST_ASSERT( document.GetTextForCompilation() == text ); // Text is preserved.
+	U_TEST_ASSERT( document.RebuildRequired() == false );
+
+	// Request needing compiler state can't be answered, but it triggers restoring.
+	U_TEST_ASSERT( document.GetDefinitionPoint( DocumentPosition{ 2, 11 } ) == std::nullopt );
+	U_TEST_ASSERT( !document.HasCodeBuilderState() );
+	U_TEST_ASSERT( document.RebuildRequired() == true );
+
+	document.StartRebuild( g_tests_thread_pool );
+	document.WaitUntilRebuildFinished();
+	U_TEST_ASSERT( document.HasCodeBuilderState() );
+	U_TEST_ASSERT( document.RebuildRequired() == false ); // Nothing was changed, so, no rebuild is needed after restoring.
+	U_TEST_ASSERT( document.GetDefinitionPoint( DocumentPosition{ 2, 11 } ) != std::nullopt );
+
+	// Changes made after compilation are still handled properly with restored state.
+	document.UpdateText( DocumentRange{ { 1, 0 }, { 1, 0 } }, "\n" );
+	U_TEST_ASSERT( document.GetDefinitionPoint( DocumentPosition{ 3, 11 } ) != std::nullopt );
+
+	// Release state again and change text before restoring.
+	document.ReleaseCodeBuilderState();
+	document.UpdateText( DocumentRange{ { 1, 0 }, { 1, 0 } }, "\n" );
+	U_TEST_ASSERT( document.GetDefinitionPoint( DocumentPosition{ 4, 11 } ) == std::nullopt );
+
+	document.StartRebuild( g_tests_thread_pool );
+	document.WaitUntilRebuildFinished();
+	U_TEST_ASSERT( document.HasCodeBuilderState() );
+	U_TEST_ASSERT( document.GetTextForCompilation() == text ); // Restored state has the same text.
+	U_TEST_ASSERT( document.RebuildRequired() == true ); // Changed text still should be compiled.
+	U_TEST_ASSERT( document.GetDefinitionPoint( DocumentPosition{ 4, 11 } ) != std::nullopt );
+}
+
+U_TEST( DocumentRebuild_Test5 )
+{
+	// Checks of changed functions are limited, full rebuild should be performed after some number of checks.
+
+	DocumentsContainer documents;
+	const auto vfs= std::make_shared<TestVfs>(documents);
+	const IVfs::Path path= "/test.u";
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, std::make_shared<SyntaxAnalysisResultsInterner>(), g_tests_logger );
+	documents[path]= &document;
+
+	const std::string initial_text= "fn Foo() : i32 { return 0; }";
+	document.SetText( initial_text );
+
+	document.StartRebuild( g_tests_thread_pool );
+	document.WaitUntilRebuildFinished();
+	document.ResetRebuildFinishedFlag();
+	U_TEST_ASSERT( document.GetTextForCompilation() == initial_text );
+
+	size_t num_checks= 0;
+	for( size_t i= 0; i < 64; ++i )
+	{
+		// Change only function body.
+		document.UpdateText( DocumentRange{ { 1, 17 }, { 1, 17 } }, "{}" );
+		document.StartRebuild( g_tests_thread_pool );
+		document.WaitUntilRebuildFinished();
+		document.ResetRebuildFinishedFlag();
+
+		if( document.GetTextForCompilation() == document.GetCurrentText() )
+			break; // Full rebuild was performed.
+
+		U_TEST_ASSERT( document.GetTextForCompilation() == initial_text );
+		++num_checks;
+	}
+
+	// Some checks were performed, but eventually full rebuild happened.
+	U_TEST_ASSERT( num_checks > 0 );
+	U_TEST_ASSERT( num_checks < 64 );
+	U_TEST_ASSERT( document.GetTextForCompilation() == document.GetCurrentText() );
+	U_TEST_ASSERT( document.GetDiagnostics().empty() || document.GetDiagnostics().begin()->second.empty() );
+}
+
 U_TEST( DocumentCompletion_Test0 )
 {
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "auto xyz= 0;\nauto qwerty= 0;\nvar i33 xrt= 0;" );
@@ -310,7 +505,7 @@ U_TEST( DocumentCompletion_Test1 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	// Completion with search inside the word.
@@ -333,7 +528,7 @@ U_TEST( DocumentCompletion_Test2 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	// Completion is case-insensetive.
@@ -355,7 +550,7 @@ U_TEST( DocumentCompletion_Test3 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	// Completion returns nothing.
@@ -377,7 +572,7 @@ U_TEST( DocumentCompletion_Test4 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( " auto var3= 0; namespace NN{ auto var4= 0; } auto var5= 0;" );
@@ -413,7 +608,7 @@ U_TEST( DocumentCompletion_Test5 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "struct S{ i32 field; fn Foo(); } fn S::Foo(){}" );
@@ -435,7 +630,7 @@ U_TEST( DocumentCompletion_Test6 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( " struct S{ type GHMQ= i32; fn Foo(); i32 lol; }" );
@@ -493,7 +688,7 @@ U_TEST( DocumentCompletion_Test7 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( " namespace Abc{ auto x= 0; type Tt= f32; fn Qwerty(); enum EE{A, B, C} var i32 el= 0; }" );
@@ -526,7 +721,7 @@ U_TEST( DocumentCompletion_Test8 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( " struct S{ i32 field0; i32 field1; i32 other_field; f32 rr; type ll= bool; fn some_func(); type typef= i32; type ftype= i32; struct Inner_f{} } var S s= zero_init;" );
@@ -559,7 +754,7 @@ U_TEST( DocumentCompletion_Test9 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( " struct S{ op++(S &mut s); op()(this); op-(S& s) : S; } var S s= zero_init;" );
@@ -581,7 +776,7 @@ U_TEST( DocumentCompletion_Test10 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	// Completion inside function. Later defined variables and variables in outer scope are not visible.
@@ -621,7 +816,7 @@ U_TEST( DocumentCompletion_Test11 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "namespace NN{  } type CustomType= i32; fn Foo();" );
@@ -667,7 +862,7 @@ U_TEST( DocumentCompletion_Test12 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	// Completion inside function inside struct inside struct inside a couple of namespaces.
@@ -715,7 +910,7 @@ U_TEST( DocumentCompletion_Test13 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "fn foo(i32 mut qwerty){  }" );
@@ -736,7 +931,7 @@ U_TEST( DocumentCompletion_Test14 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( " struct S{ i32 a; i32 b; i32 wtf; fn Foo(); type T= i32; }" );
@@ -757,7 +952,7 @@ U_TEST( DocumentCompletion_Test15 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "struct S{  i32 field0; i32 field1; i32 other_field; i32 lol; }" );
@@ -778,7 +973,7 @@ U_TEST( DocumentCompletion_Test16 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	// Complete in complex function name.
@@ -834,7 +1029,7 @@ U_TEST( DocumentCompletion_Test17 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "fn foo(){ auto mut lol= Some::A; } enum Some{ A, B, C } " );
@@ -855,7 +1050,7 @@ U_TEST( DocumentCompletion_Test18 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "" );
@@ -876,7 +1071,7 @@ U_TEST( DocumentCompletion_Test19 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "template</ type Qwerty /> struct Box{ }" );
@@ -897,7 +1092,7 @@ U_TEST( DocumentCompletion_Test20 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "" );
@@ -918,7 +1113,7 @@ U_TEST( DocumentCompletion_Test21 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "template</ type Qwerty /> struct Box {}" );
@@ -939,7 +1134,7 @@ U_TEST( DocumentCompletion_Test22 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "" );
@@ -960,7 +1155,7 @@ U_TEST( DocumentCompletion_Test23 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "template</ type T, T value_arg /> struct Box</ value_arg /> {}" );
@@ -984,7 +1179,7 @@ U_TEST( DocumentCompletion_Test24 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "template</ type T, size_type S /> fn foo( [ T, S ]& arr_arg ) {} " );
@@ -1009,7 +1204,7 @@ U_TEST( DocumentCompletion_Test25 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "fn Foo() { var i32 external_variable= 0; auto f = lambda[&](){  }; }" );
@@ -1031,7 +1226,7 @@ U_TEST( DocumentCompletion_Test26 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "fn Foo() { var i32 external_variable= 0; auto f = lambda[](){}; }" );
@@ -1053,7 +1248,7 @@ U_TEST( DocumentCompletion_Test27 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "fn Foo() { var i32 external_variable= 0; auto f = lambda[](){}; }" );
@@ -1075,7 +1270,7 @@ U_TEST( DocumentCompletion_Test28 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "struct S{ i32 some; } fn Foo(){  }" );
@@ -1097,7 +1292,7 @@ U_TEST( DocumentCompletion_Test29 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "struct Some{} fn Foo(){  }" );
@@ -1119,7 +1314,7 @@ U_TEST( DocumentCompletion_Test30 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "struct S{ i32 some; } fn Foo(){  }" );
@@ -1141,7 +1336,7 @@ U_TEST( DocumentCompletion_Test31 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "static_assert(true); fn Foo(){  }" );
@@ -1163,7 +1358,7 @@ U_TEST( DocumentCompletion_Test32 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "mixin(\"\"); fn Foo(){  }" );
@@ -1185,7 +1380,7 @@ U_TEST( DocumentCompletion_Test33 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "auto spaced_string= \"   \"; mixin( \" \" );" );
@@ -1207,7 +1402,7 @@ U_TEST( DocumentCompletion_Test34 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "template</type T/> struct S{ fn Foo(this); } fn Bar( S</i32/> s ) {  } " );
@@ -1228,7 +1423,7 @@ U_TEST( DocumentCompletion_Test35 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "struct S{ i32 for_glory; } fn Foo( S mut s ) { auto {  } = move(s); }" );
@@ -1249,7 +1444,7 @@ U_TEST( DocumentCompletion_Test36 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "template</type T/> struct S{ template<//> fn Bar(){} } fn Foo( S</i32/> s ) {    }" );
@@ -1270,7 +1465,7 @@ U_TEST( DocumentCompletion_Test37 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "class A polymorph { struct Some{} } class B : A { fn Foo() {  } }" );
@@ -1291,7 +1486,7 @@ U_TEST( DocumentCompletion_Test39 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "fn Foo() {  } fn async Bar(); " );
@@ -1312,7 +1507,7 @@ U_TEST( DocumentSignatureHelp_Test0 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "fn bar(){} fn foo();" );
@@ -1333,7 +1528,7 @@ U_TEST( DocumentSignatureHelp_Test1 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "fn bar(){} fn foo( i32 x ); fn foo( f32 y, bool z ) : f64; fn foo( [ i32, 2 ] &mut a, tup[ f32, void ] t ) unsafe : i32 &mut;" );
@@ -1354,7 +1549,7 @@ U_TEST( DocumentSignatureHelp_Test2 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	// Only last component of the function name is used.
@@ -1375,7 +1570,7 @@ U_TEST( DocumentSignatureHelp_Test3 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	// Type names as they are writen are used - without unwrapping type aliases and calculating variable values.
@@ -1396,7 +1591,7 @@ U_TEST( DocumentSignatureHelp_Test4 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	// Should properly suggest signature of method call.
@@ -1417,7 +1612,7 @@ U_TEST( DocumentSignatureHelp_Test5 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	// Should properly suggest signature of method call.
@@ -1438,7 +1633,7 @@ U_TEST( DocumentSignatureHelp_Test6 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	// Should properly suggest signature of method call.
@@ -1459,7 +1654,7 @@ U_TEST( DocumentSignatureHelp_Test7 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	// Should properly suggest signature of static method call.
@@ -1480,7 +1675,7 @@ U_TEST( DocumentSignatureHelp_Test8 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	// Should properly suggest call to generated constructor.
@@ -1501,7 +1696,7 @@ U_TEST( DocumentSignatureHelp_Test9 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	// Should properly suggest call to generated destructor.
@@ -1522,7 +1717,7 @@ U_TEST( DocumentSignatureHelp_Test10 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	// Should provide signature help for temp variable construction.
@@ -1543,7 +1738,7 @@ U_TEST( DocumentSignatureHelp_Test11 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	// Should provide signature help for function pointer call.
@@ -1564,7 +1759,7 @@ U_TEST( DocumentSignatureHelp_Test12 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	// Should properly suggest call to overloaded operator ().
@@ -1585,7 +1780,7 @@ U_TEST( DocumentSignatureHelp_Test13 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	// Should provide signature help for variable construction.
@@ -1606,7 +1801,7 @@ U_TEST( DocumentSignatureHelp_Test14 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	// Should provide signature help for ",", that is part of call operator.
@@ -1627,7 +1822,7 @@ U_TEST( DocumentSignatureHelp_Test15 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	// Should provide signature help for"," in variable construction.
@@ -1648,7 +1843,7 @@ U_TEST( DocumentSignatureHelp_Test16 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	// Should provide signature help for ")" and return outer function.
@@ -1669,7 +1864,7 @@ U_TEST( DocumentSignatureHelp_Test17 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	// Should provide no signature help for ")" that terminates call operator.
@@ -1690,7 +1885,7 @@ U_TEST( DocumentSignatureHelp_Test18 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	// Should suggest template function.
@@ -1711,7 +1906,7 @@ U_TEST( DocumentSignatureHelp_Test19 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	// Should suggest template function with explicit args.
@@ -1732,11 +1927,11 @@ U_TEST( Document_GetFileForImportPoint_Test0 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	const IVfs::Path imported_path= "/some.iu";
-	Document imported_document(  path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document imported_document(  path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[ imported_path ]= &imported_document;
 
 	document.SetText( "import \"some.iu\" " );
@@ -1753,11 +1948,11 @@ U_TEST( Document_GetFileForImportPoint_Test1 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	const IVfs::Path imported_path= "/some_global.iu";
-	Document imported_document( imported_path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document imported_document( imported_path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[ imported_path ]= &imported_document;
 
 	document.SetText( "import \"/some_global.iu\" " );
@@ -1776,7 +1971,7 @@ U_TEST( Document_GetFileForImportPoint_Test2 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "auto this_is_not_import= 0;" );
@@ -1794,11 +1989,11 @@ U_TEST( Document_GetFileForImportPoint_Test3 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	const IVfs::Path imported_path= "/some.iu";
-	Document imported_document(  path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document imported_document(  path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[ imported_path ]= &imported_document;
 
 	document.SetText( "import \"some.iu\"         " );
@@ -1817,11 +2012,11 @@ U_TEST( Document_GetFileForImportPoint_Test4 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	const IVfs::Path imported_path= "/file with spaces.iu";
-	Document imported_document(  path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document imported_document(  path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[ imported_path ]= &imported_document;
 
 	// Should properly handle whitespaces in import line and in import string.
@@ -1842,7 +2037,7 @@ U_TEST( Document_CompleteImport_Test0 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "import \"" );
@@ -1858,7 +2053,7 @@ U_TEST( Document_CompleteImport_Test1 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	document.SetText( "import \"som" );
@@ -1874,7 +2069,7 @@ U_TEST( Document_CompleteImport_Test2 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	// Should handle whitespaces around "import" properly.
@@ -1891,7 +2086,7 @@ U_TEST( Document_CompleteImport_Test3 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	// Should complete import even if it's not syntactically-correct to do so.
@@ -1913,7 +2108,7 @@ U_TEST( Document_CompleteImport_Test4 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	// Should not compete import if there is no ".
@@ -1928,7 +2123,7 @@ U_TEST( Document_CompleteImport_Test5 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	// Should complete long import between other imports.
@@ -1951,7 +2146,7 @@ U_TEST( Document_CompleteImport_Test6 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	// Should not compete import after second ".
@@ -1966,7 +2161,7 @@ U_TEST( Document_CompleteImport_Test7 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	// Should not compete import after second ".
@@ -1981,7 +2176,7 @@ U_TEST( Document_CompleteImport_Test8 )
 	DocumentsContainer documents;
 	const auto vfs= std::make_shared<TestVfs>(documents);
 	const IVfs::Path path= "/test.u";
-	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, g_tests_logger );
+	Document document( path, GetTestDocumentBuildOptions(), vfs, vfs, nullptr, g_tests_logger );
 	documents[path]= &document;
 
 	// Should not compete import after second ".
@@ -0,0 +1,86 @@
+#include "../message_queue.hpp"
+#include "../../tests/tests_lib/funcs_registrator.hpp"
+#include "../../tests/tests_lib/tests.hpp"
+
+namespace U
+{
+
+namespace LangServer
+{
+
+namespace
+{
+
+PositionInDocument MakePosition( const std::string& file_path, const uint32_t line )
+{
+	return PositionInDocument{ DocumentPosition{ line, 0 }, Uri::FromFilePath( file_path ) };
+}
+
+// Returns request params index or nullopt if it isn't a request.
+std::optional<size_t> PopRequestParamsKind( MessageQueue& queue, const RequestId& expected_id )
+{
+	const std::optional<Message> message= queue.TryPop( std::chrono::milliseconds(0) );
+	if( message == std::nullopt )
+		return std::nullopt;
+
+	const auto request= std::get_if<Request>( &*message );
+	if( request == nullptr || request->id != expected_id )
+		return std::nullopt;
+
+	return request->params.index();
+}
+
+template<typename T>
+size_t GetRequestParamsKind()
+{
+	return RequestParams( T{} ).index();
+}
+
+U_TEST( MessageQueue_Test0 )
+{
+	// Cancelled request is preserved in queue, but its params are replaced.
+
+	MessageQueue queue;
+	queue.Push( Request{ int64_t(1), Requests::Definition{ MakePosition( "/a.u", 1 ) } } );
+	queue.Push( Request{ int64_t(2), Requests::References{ MakePosition( "/a.u", 2 ) } } );
+	queue.Push( Notification( Notifications::CancelRequest{ int64_t(1) } ) );
+	queue.Push( Notification( Notifications::CancelRequest{ int64_t(33) } ) ); // Unknown request.
+
+	U_TEST_ASSERT( PopRequestParamsKind( queue, int64_t(1) ) == GetRequestParamsKind<RequestCancelled>() );
+	U_TEST_ASSERT( PopRequestParamsKind( queue, int64_t(2) ) == GetRequestParamsKind<Requests::References>() );
+	U_TEST_ASSERT( queue.TryPop( std::chrono::milliseconds(0) ) == std::nullopt );
+}
+
+U_TEST( MessageQueue_Test1 )
+{
+	// Completion request is cancelled by newer completion request for the same document.
+
+	MessageQueue queue;
+	queue.Push( Request{ int64_t(1), Requests::Complete{ MakePosition( "/a.u", 1 ) } } );
+	queue.Push( Request{ int64_t(2), Requests::Complete{ MakePosition( "/b.u", 1 ) } } );
+	queue.Push( Request{ int64_t(3), Requests::SignatureHelp{ MakePosition( "/a.u", 1 ) } } );
+	queue.Push( Request{ int64_t(4), Requests::Complete{ MakePosition( "/a.u", 2 ) } } );
+
+	U_TEST_ASSERT( PopRequestParamsKind( queue, int64_t(1) ) == GetRequestParamsKind<RequestCancelled>() );
+	U_TEST_ASSERT( PopRequestParamsKind( queue, int64_t(2) ) == GetRequestParamsKind<Requests::Complete>() ); // Other document.
+	U_TEST_ASSERT( PopRequestParamsKind( queue, int64_t(3) ) == GetRequestParamsKind<Requests::SignatureHelp>() ); // Other kind.
+	U_TEST_ASSERT( PopRequestParamsKind( queue, int64_t(4) ) == GetRequestParamsKind<Requests::Complete>() );
+}
+
+U_TEST( MessageQueue_Test2 )
+{
+	// Requests, which don't depend on cursor position, aren't superseded.
+
+	MessageQueue queue;
+	queue.Push( Request{ int64_t(1), Requests::References{ MakePosition( "/a.u", 1 ) } } );
+	queue.Push( Request{ int64_t(2), Requests::References{ MakePosition( "/a.u", 2 ) } } );
+
+	U_TEST_ASSERT( PopRequestParamsKind( queue, int64_t(1) ) == GetRequestParamsKind<Requests::References>() );
+	U_TEST_ASSERT( PopRequestParamsKind( queue, int64_t(2) ) == GetRequestParamsKind<Requests::References>() );
+}
+
+} // namespace
+
+} // namespace LangServer
+
+} // namespace U
@@ -0,0 +1,201 @@
+#include "../symbol_index.hpp"
+#include "../../compilers_support_lib/prelude.hpp"
+#include "../../lex_synt_lib_common/assert.hpp"
+#include "../../tests/tests_lib/funcs_registrator.hpp"
+#include "../../tests/tests_lib/tests.hpp"
+#include "../../tests/tests_common.hpp"
+
+namespace U
+{
+
+namespace LangServer
+{
+
+namespace
+{
+
+DocumentBuildOptions GetTestDocumentBuildOptions()
+{
+	DocumentBuildOptions build_options
+	{
+		llvm::DataLayout( GetTestsDataLayout() ),
+		llvm::Triple( llvm::sys::getDefaultTargetTriple() ),
+		"",
+	};
+
+	const llvm::StringRef features;
+	const llvm::StringRef cpu_name;
+	const char optimization_level= '0';
+	const bool generate_debug_info= 0;
+	const uint32_t compiler_generation= 0;
+	build_options.prelude=
+		GenerateCompilerPreludeCode(
+			build_options.target_triple,
+			build_options.data_layout,
+			features,
+			cpu_name,
+			optimization_level,
+			generate_debug_info,
+			compiler_generation );
+
+	return build_options;
+}
+
+using FilesContainer= std::map<IVfs::Path, std::string>;
+
+// Files are not modified during indexing, so, it's fine to read them in background threads.
+class TestVfs final : public IVfs
+{
+public:
+	explicit TestVfs( FilesContainer files )
+		: files_(std::move(files))
+	{}
+
+	virtual std::optional<FileContent> LoadFileContent( const Path& full_file_path ) override
+	{
+		if( const auto it= files_.find( full_file_path ); it != files_.end() )
+			return it->second;
+
+		return std::nullopt;
+	}
+
+	virtual Path GetFullFilePath( const Path& file_path, const Path& full_parent_file_path ) override
+	{
+		U_UNUSED(full_parent_file_path);
+		if( !file_path.empty() && file_path.front() == '/' )
+			return file_path;
+		return "/" + file_path;
+	}
+
+	virtual std::vector<PathCompletionItem> CompletePath(
+		const Path& file_path_prefix, const Path& full_parent_file_path ) override
+	{
+		U_UNUSED(file_path_prefix);
+		U_UNUSED(full_parent_file_path);
+		return {};
+	}
+
+	virtual bool IsImportingFileAllowed( const Path& full_file_path ) override
+	{
+		U_UNUSED(full_file_path);
+		return true;
+	}
+
+	virtual bool IsFileFromSourcesDirectory( const Path& full_file_path ) override
+	{
+		U_UNUSED(full_file_path);
+		return true;
+	}
+
+private:
+	const FilesContainer files_;
+};
+
+Logger g_tests_logger( std::cout );
+
+bool ContainsRange( const llvm::ArrayRef<RangeInDocument> ranges, const IVfs::Path& file_path, const DocumentRange& range )
+{
+	for( const RangeInDocument& range_in_document : ranges )
+	{
+		if( range_in_document.uri == Uri::FromFilePath( file_path ) && range_in_document.range == range )
+			return true;
+	}
+	return false;
+}
+
+U_TEST( SymbolIndex_Test0 )
+{
+	// Find usages in files, which import file with definition.
+
+	FilesContainer files;
+	files["/a.u"]= "fn Foo() {}\nstruct Bar{}";
+	files["/b.u"]= "import \"a.u\"\nfn Baz() { Foo(); }";
+	files["/c.u"]= "import \"a.u\"\nfn Qwerty() { Foo(); var Bar b= zero_init; }";
+
+	const auto vfs= std::make_shared<TestVfs>( files );
+
+	SymbolIndex symbol_index( g_tests_logger, GetTestDocumentBuildOptions(), "", 2 );
+	for( const auto& file_pair : files )
+		symbol_index.ScheduleIndexing( file_pair.first, vfs );
+	symbol_index.WaitForIndexing();
+
+	const DocumentRange foo_definition_range{ { 1, 3 }, { 1, 6 } };
+	const DocumentRange foo_usage_b_range{ { 2, 11 }, { 2, 14 } };
+	const DocumentRange foo_usage_c_range{ { 2, 14 }, { 2, 17 } };
+
+	{ // Get definition for usage in "b".
+		const auto definition= symbol_index.GetDefinitionPoint( PositionInDocument{ { 2, 12 }, Uri::FromFilePath( "/b.u" ) } );
+		U_TEST_ASSERT( definition != std::nullopt );
+		U_TEST_ASSERT( definition->uri == Uri::FromFilePath( "/a.u" ) );
+		U_TEST_ASSERT( definition->range == foo_definition_range );
+	}
+	{ // Get all occurrences for definition - usages in both importing files should be found.
+		const std::vector<RangeInDocument> occurrences= symbol_index.GetAllOccurrences( PositionInDocument{ { 1, 4 }, Uri::FromFilePath( "/a.u" ) } );
+		U_TEST_ASSERT( ContainsRange( occurrences, "/a.u", foo_definition_range ) );
+		U_TEST_ASSERT( ContainsRange( occurrences, "/b.u", foo_usage_b_range ) );
+		U_TEST_ASSERT( ContainsRange( occurrences, "/c.u", foo_usage_c_range ) );
+	}
+	{ // Get all occurrences from usage in one file - usage in other file should be found.
+		const std::vector<RangeInDocument> occurrences= symbol_index.GetAllOccurrences( PositionInDocument{ { 2, 15 }, Uri::FromFilePath( "/c.u" ) } );
+		U_TEST_ASSERT( ContainsRange( occurrences, "/a.u", foo_definition_range ) );
+		U_TEST_ASSERT( ContainsRange( occurrences, "/b.u", foo_usage_b_range ) );
+	}
+	{ // Usage of other symbol shouldn't be found.
+		const std::vector<RangeInDocument> occurrences= symbol_index.GetAllOccurrences( PositionInDocument{ { 2, 12 }, Uri::FromFilePath( "/b.u" ) } );
+		U_TEST_ASSERT( !ContainsRange( occurrences, "/c.u", DocumentRange{ { 2, 25 }, { 2, 28 } } ) );
+	}
+	{ // Dependent files include the file itself.
+		const std::vector<IVfs::Path> dependent_files= symbol_index.GetDependentFiles( "/a.u" );
+		U_TEST_ASSERT( dependent_files == std::vector<IVfs::Path>( { "/a.u", "/b.u", "/c.u" } ) );
+	}
+	{
+		const std::vector<IVfs::Path> dependent_files= symbol_index.GetDependentFiles( "/b.u" );
+		U_TEST_ASSERT( dependent_files == std::vector<IVfs::Path>( { "/b.u" } ) );
+	}
+}
+
+U_TEST( SymbolIndex_Test1 )
+{
+	// Search workspace symbols.
+
+	FilesContainer files;
+	files["/a.u"]= "fn Foo() {}\nnamespace NS { struct FooBar{} }";
+	files["/b.u"]= "fn SomeFunc() {}\nstruct Baz{}";
+
+	const auto vfs= std::make_shared<TestVfs>( files );
+
+	SymbolIndex symbol_index( g_tests_logger, GetTestDocumentBuildOptions(), "", 1 );
+	for( const auto& file_pair : files )
+		symbol_index.ScheduleIndexing( file_pair.first, vfs );
+	symbol_index.WaitForIndexing();
+
+	{ // Case-insensitive search. Functions names contain full declaration.
+		const std::vector<WorkspaceSymbol> symbols= symbol_index.FindSymbols( "foo", 100 );
+		U_TEST_ASSERT( symbols.size() == 2 );
+		U_TEST_ASSERT( symbols[0].name == "FooBar" );
+		U_TEST_ASSERT( symbols[0].container_name == "NS" );
+		U_TEST_ASSERT( symbols[0].location.uri == Uri::FromFilePath( "/a.u" ) );
+		U_TEST_ASSERT( symbols[1].name.find( "Foo" ) != std::string::npos );
+		U_TEST_ASSERT( symbols[1].container_name == "" );
+		U_TEST_ASSERT( symbols[1].kind == SymbolKind::Function );
+	}
+	{
+		const std::vector<WorkspaceSymbol> symbols= symbol_index.FindSymbols( "BAZ", 100 );
+		U_TEST_ASSERT( symbols.size() == 1 );
+		U_TEST_ASSERT( symbols[0].name == "Baz" );
+		U_TEST_ASSERT( symbols[0].location.uri == Uri::FromFilePath( "/b.u" ) );
+	}
+	{ // Empty query matches all symbols, result size is limited.
+		U_TEST_ASSERT( symbol_index.FindSymbols( "", 100 ).size() == 5 );
+		U_TEST_ASSERT( symbol_index.FindSymbols( "", 3 ).size() == 3 );
+	}
+	{ // Nothing found.
+		U_TEST_ASSERT( symbol_index.FindSymbols( "unknown", 100 ).empty() );
+	}
+}
+
+} // namespace
+
+} // namespace LangServer
+
+} // namespace U
@@ -17,52 +17,6 @@ namespace LangServer
 namespace
 {
 
-// A wrapper which prevents unsynchronized VFS access.
-// All methods are thread-safe.
-class ThreadSafeVfsWrapper final : public IVfs
-{
-public:
-	explicit ThreadSafeVfsWrapper( std::unique_ptr<IVfs> base )
-		: base_( std::move(base) )
-	{}
-
-public:
-	std::optional<FileContent> LoadFileContent( const Path& full_file_path ) override
-	{
-		std::lock_guard<std::mutex> lock(mutex_);
-		return base_->LoadFileContent( full_file_path );
-	}
-
-	Path GetFullFilePath( const Path& file_path, const Path& full_parent_file_path ) override
-	{
-		std::lock_guard<std::mutex> lock(mutex_);
-		return base_->GetFullFilePath( file_path, full_parent_file_path );
-	}
-
-	virtual std::vector<PathCompletionItem> CompletePath(
-		const Path& file_path_prefix, const Path& full_parent_file_path ) override
-	{
-		std::lock_guard<std::mutex> lock(mutex_);
-		return base_->CompletePath( file_path_prefix, full_parent_file_path );
-	}
-
-	bool IsImportingFileAllowed( const Path& full_file_path ) override
-	{
-		std::lock_guard<std::mutex> lock(mutex_);
-		return base_->IsImportingFileAllowed( full_file_path );
-	}
-
-	bool IsFileFromSourcesDirectory( const Path& full_file_path ) override
-	{
-		std::lock_guard<std::mutex> lock(mutex_);
-		return base_->IsFileFromSourcesDirectory( full_file_path );
-	}
-
-private:
-	std::mutex mutex_;
-	const std::unique_ptr<IVfs> base_;
-};
-
 bool PathComponentsAreEqual( const llvm::StringRef l, const llvm::StringRef r )
 {
 #ifdef WIN32
@@ -176,15 +130,29 @@ IVfsSharedPtr VFSManager::GetVFSForDocument( const Uri& uri )
 
 	log_() << "Create new VFS instance for document \"" << uri.ToString() << std::endl;
 
-	auto vfs=
-		std::make_shared<ThreadSafeVfsWrapper>(
-			// Tolerate missing directories in language server. It's not that bad if a directory is missing.
-			CreateVfsOverSystemFS( includes, {}, false, true /* tolerate_errors */ ) );
+	// VFS over system FS has no mutable state, so, it may be used without any synchronization in background rebuilds.
+	// Tolerate missing directories in language server. It's not that bad if a directory is missing.
+	// Files may be modified while loaded contents are still used by long-living compiled state, so, avoid memory-mapping them.
+	IVfsSharedPtr vfs= CreateVfsOverSystemFS( includes, {}, false, true /* tolerate_errors */, true /* files_may_be_modified */ );
 
 	vfs_cache_.emplace( std::move(includes), vfs );
 	return vfs;
 }
 
+std::vector<std::string> VFSManager::GetWorkspaceDirectories() const
+{
+	std::vector<std::string> result;
+	for( const auto& groups_of_a_build_directory : workspace_directories_groups_ )
+	{
+		for( const WorkspaceDirectoriesGroup& group : groups_of_a_build_directory.second )
+			result.insert( result.end(), group.directories.begin(), group.directories.end() );
+	}
+
+	std::sort( result.begin(), result.end() );
+	result.erase( std::unique( result.begin(), result.end() ), result.end() );
+	return result;
+}
+
 const WorkspaceDirectoriesGroup* VFSManager::FindDirectoriesGroupForFile( const std::string& file_path ) const
 {
 	for( const auto& groups_of_a_build_directory : workspace_directories_groups_ )
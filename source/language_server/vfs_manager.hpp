@@ -21,6 +21,10 @@ public:
 	// Result instance is thread-safe.
 	IVfsSharedPtr GetVFSForDocument( const Uri& uri );
 
+	// Get source directories of all workspaces found so far.
+	// This list may grow after requesting VFS for a document from previously unknown workspace.
+	std::vector<std::string> GetWorkspaceDirectories() const;
+
 private:
 	const WorkspaceDirectoriesGroup* FindDirectoriesGroupForFile( const std::string& file_path ) const;
 
@@ -0,0 +1,24 @@
+if( NOT DEFINED COMPILER OR NOT DEFINED SOURCE OR NOT DEFINED OUT_DIR )
+	message( FATAL_ERROR "Not enough arguments. Usage: cmake -DCOMPILER=<compiler> -DSOURCE=<source_file> -DOUT_DIR=<dir> -P compare_diagnostics.cmake" )
+endif()
+
+# Compile given source with errors sequentially and with multiple functions bodies building threads.
+# Both compilations should fail with identical diagnostics.
+foreach( JOBS 1 4 )
+	execute_process(
+		COMMAND ${COMPILER} ${SOURCE} -o ${OUT_DIR}/errors_${JOBS}.o --function-bodies-jobs=${JOBS}
+		RESULT_VARIABLE RESULT_${JOBS}
+		OUTPUT_VARIABLE OUTPUT_${JOBS}
+		ERROR_VARIABLE OUTPUT_${JOBS} )
+
+	if( RESULT_${JOBS} EQUAL 0 )
+		message( FATAL_ERROR "Compilation with --function-bodies-jobs=${JOBS} succeeded, but it should fail" )
+	endif()
+	if( NOT OUTPUT_${JOBS} MATCHES "Unreferenced name" )
+		message( FATAL_ERROR "Compilation with --function-bodies-jobs=${JOBS} produced no unused names errors:\n${OUTPUT_${JOBS}}" )
+	endif()
+endforeach()
+
+if( NOT OUTPUT_1 STREQUAL OUTPUT_4 )
+	message( FATAL_ERROR "Diagnostics are different.\nSequential build:\n${OUTPUT_1}\nPartitioned build:\n${OUTPUT_4}" )
+endif()
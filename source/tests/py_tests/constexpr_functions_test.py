@@ -920,6 +920,50 @@ def ConstexprFunction_RecursiveCall_Test1():
 	tests_lib.build_program( c_program_text )
 
 
+def ConstexprFunction_RepeatedEvaluation_Test0():
+	# Same functions are evaluated many times with different arguments.
+	c_program_text= """
+		fn constexpr Classify( u32 x ) : u32
+		{
+			var u32 mut r= x;
+			switch( x % 4u )
+			{
+				0u -> { r= 10u; },
+				1u -> { r= 20u; },
+				default -> {},
+			}
+			return r;
+		}
+
+		fn constexpr SumTable( u32 n ) : u32
+		{
+			var [ u32, 64 ] mut table= zero_init;
+			var u32 mut i= 0u;
+			while( i < n )
+			{
+				table[i]= Classify( i ) + i * i;
+				++i;
+			}
+
+			var u32 mut sum= 0u;
+			i= 0u;
+			while( i < n )
+			{
+				sum+= table[i];
+				++i;
+			}
+			return sum;
+		}
+
+		static_assert( SumTable( 0u ) == 0u );
+		static_assert( SumTable( 1u ) == 10u );
+		static_assert( SumTable( 4u ) == 49u );
+		static_assert( SumTable( 4u ) == 49u );
+		static_assert( SumTable( 64u ) == SumTable( 63u ) + 63u + 63u * 63u );
+	"""
+	tests_lib.build_program( c_program_text )
+
+
 def ConstexprStaticMethodBuilding_Test0():
 	c_program_text= """
 		struct S